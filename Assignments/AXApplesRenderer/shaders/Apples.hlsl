@@ -23,13 +23,23 @@ cbuffer PerMeshConstants : register(b0)
     float4x4 viewMatrix;
     float4x4 projectionMatrix;
     int interLOD;
+    float2 viewportSize;
+    float4x4 inverseProjectionMatrix;
 }
 
+// With FRUIT_COMPACT_OUTPUT, a vertex takes 28 instead of 44 bytes: the pixel shader decodes the octahedral
+// coordinates and reconstructs the view space position from SV_POSITION. The shading differs slightly, as decoding the
+// interpolated octahedral coordinates is not the same as interpolating the decoded ones: the directions differ by up to
+// 0.053 rad (3 degrees) on the 3 x 3 grid and less on finer grids (FruitCompactOutputError::maxInterpolationAngle).
 struct MeshShaderOutput
 {
     float4 position : SV_POSITION;
+#ifdef FRUIT_COMPACT_OUTPUT
+    float2 encodedCoordinates : TEXCOORD0;
+#else
     float3 viewSpacePosition : POSITION;
     float3 decodedCoordinates : TEXCOORD0;
+#endif
     float positionOffset : TEXCOORD1;
 };
 
@@ -121,8 +131,13 @@ void MS_main(
     {
         viewSpacePosition = mul(viewMatrix, float4(coordinates, 1.0f));
         triangleVertices[index].position = mul(projectionMatrix, viewSpacePosition);
+#ifdef FRUIT_COMPACT_OUTPUT
+        // The grid parameters are the octahedral encoding of SPHERICAL_COORDINATES.
+        triangleVertices[index].encodedCoordinates = float2(X_REMAPPED, Y_REMAPPED);
+#else
         triangleVertices[index].viewSpacePosition = viewSpacePosition;
         triangleVertices[index].decodedCoordinates = SPHERICAL_COORDINATES;
+#endif
         triangleVertices[index].positionOffset = positionOffset;
         index += INTRA_LOD_QUADRAT;
         coordinates.x += INTER_DISTANCE;
@@ -157,17 +172,31 @@ void MS_main(
 
 }
 
+float3 reconstructViewSpacePosition(float4 position)
+{
+    const float2 ndc = float2(2.0f * position.x / viewportSize.x - 1.0f, 1.0f - 2.0f * position.y / viewportSize.y);
+    const float4 viewSpacePosition = mul(inverseProjectionMatrix, float4(ndc, position.z, 1.0f));
+    return viewSpacePosition.xyz / viewSpacePosition.w;
+}
+
 float4 PS_main(MeshShaderOutput input)
     : SV_TARGET
 {
-    float3 evaluatedCoordinates = calculateFruitCoordinates(input.decodedCoordinates);
+#ifdef FRUIT_COMPACT_OUTPUT
+    const float3 decodedCoordinates = octDecode(input.encodedCoordinates);
+    const float3 viewSpacePosition = reconstructViewSpacePosition(input.position);
+#else
+    const float3 decodedCoordinates = input.decodedCoordinates;
+    const float3 viewSpacePosition = input.viewSpacePosition;
+#endif
+    float3 evaluatedCoordinates = calculateFruitCoordinates(decodedCoordinates);
     
     evaluatedCoordinates = mul(viewMatrix, float4(evaluatedCoordinates, 1.0f));
     evaluatedCoordinates.x += input.positionOffset;
     float3 l = normalize(LIGHT_DIRECTION);
     float3 n = normalize(cross(ddx(evaluatedCoordinates), ddy(evaluatedCoordinates)));
     
-    float3 v = normalize(-input.viewSpacePosition);
+    float3 v = normalize(-viewSpacePosition);
     float3 h = normalize(l + v);
     float f_diffuse = max(0.0f, dot(n, l));
     float f_specular = pow(max(0.0f, dot(n, h)), SPECULAR_EXPONENT.w);
@@ -15,11 +15,14 @@ private:
   {
     f32v3 m_backgroundColor     = {0.0f, 0.0f, 0.0f};
     i32   m_intraLevelOfDetails = 1;
+    bool  m_compactOutput       = false;
   };
 
   UiData m_uiData;
 
   ComPtr<ID3D12PipelineState> m_pipelineState;
+  //! Compiled with FRUIT_COMPACT_OUTPUT.
+  ComPtr<ID3D12PipelineState> m_compactPipelineState;
   ComPtr<ID3D12PipelineState> m_wireFramePipelineState;
   ComPtr<ID3D12RootSignature> m_rootSignature;
 
@@ -28,7 +31,7 @@ private:
   void createRootSignature()
   {
     CD3DX12_ROOT_PARAMETER rootParameters[1] = {};
-    rootParameters[0].InitAsConstants(33, 0, 0, D3D12_SHADER_VISIBILITY_ALL);
+    rootParameters[0].InitAsConstants(52, 0, 0, D3D12_SHADER_VISIBILITY_ALL);
 
     CD3DX12_ROOT_SIGNATURE_DESC descRootSignature;
     descRootSignature.Init(1, rootParameters, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_NONE);
@@ -43,12 +46,18 @@ private:
   }
 
 
-  void createPipeline()
+  //! \param compactOutput Compiles the shaders with FRUIT_COMPACT_OUTPUT into m_compactPipelineState.
+  void createPipeline(bool compactOutput)
   {
+    std::vector<const wchar_t*> defines;
+    if (compactOutput)
+    {
+      defines = {L"-D", L"FRUIT_COMPACT_OUTPUT"};
+    }
     const auto meshShader = compileShader(
-        L"../../../assignments/AXApplesRenderer/shaders/Apples.hlsl", L"MS_main", L"ms_6_5");
+        L"../../../assignments/AXApplesRenderer/shaders/Apples.hlsl", L"MS_main", L"ms_6_5", defines);
     const auto pixelShader = compileShader(
-        L"../../../assignments/AXApplesRenderer/shaders/Apples.hlsl", L"PS_main", L"ps_6_5");
+        L"../../../assignments/AXApplesRenderer/shaders/Apples.hlsl", L"PS_main", L"ps_6_5", defines);
 
     D3DX12_MESH_SHADER_PIPELINE_STATE_DESC psoDesc = {};
     psoDesc.pRootSignature                         = m_rootSignature.Get();
@@ -76,7 +85,8 @@ private:
     streamDesc.pPipelineStateSubobjectStream = &psoStream;
     streamDesc.SizeInBytes                   = sizeof(psoStream);
 
-    throwIfFailed(getDevice()->CreatePipelineState(&streamDesc, IID_PPV_ARGS(&m_pipelineState)));
+    throwIfFailed(getDevice()->CreatePipelineState(
+        &streamDesc, IID_PPV_ARGS(compactOutput ? &m_compactPipelineState : &m_pipelineState)));
 
     std::cout << "Pipeline created successfully!" << std::endl;
   }
@@ -88,7 +98,8 @@ public:
   {
     m_examinerController.setTranslationVector(f32v3(0.0f, 0.0f, 3.0f));
     createRootSignature();
-    createPipeline();
+    createPipeline(false);
+    createPipeline(true);
   }
 
   void checkForMeshShaderSupport()
@@ -134,13 +145,18 @@ public:
     commandList->RSSetScissorRects(1, &getRectScissor());
     const auto projectionMatrix =
         glm::perspectiveFovLH_ZO<f32>(glm::radians(45.0f), (f32)getWidth(), (f32)getHeight(), 0.0001f, 10000.0f);
-    const auto viewMatrix = m_examinerController.getTransformationMatrix();
-    commandList->SetPipelineState(m_pipelineState.Get());
+    const auto  viewMatrix              = m_examinerController.getTransformationMatrix();
+    const auto  inverseProjectionMatrix = glm::inverse(projectionMatrix);
+    const f32v2 viewportSize(static_cast<f32>(getWidth()), static_cast<f32>(getHeight()));
+    commandList->SetPipelineState(m_uiData.m_compactOutput ? m_compactPipelineState.Get() : m_pipelineState.Get());
     commandList->SetGraphicsRootSignature(m_rootSignature.Get());
 
     commandList->SetGraphicsRoot32BitConstants(0, 16, &viewMatrix, 0);
     commandList->SetGraphicsRoot32BitConstants(0, 16, &projectionMatrix, 16);
     commandList->SetGraphicsRoot32BitConstants(0, 1, &m_uiData.m_intraLevelOfDetails, 32);
+    // viewportSize shares the register of interLOD; inverseProjectionMatrix starts at the next one.
+    commandList->SetGraphicsRoot32BitConstants(0, 2, &viewportSize, 33);
+    commandList->SetGraphicsRoot32BitConstants(0, 16, &inverseProjectionMatrix, 36);
 
     commandList->DispatchMesh(1, 1, 1);
   }
@@ -153,6 +169,7 @@ public:
     ImGui::Begin("Configuration");
     ImGui::ColorEdit3("Background Color", &m_uiData.m_backgroundColor[0]);
     ImGui::SliderInt("Inter Level of Detail", &m_uiData.m_intraLevelOfDetails, 1, 28);
+    ImGui::Checkbox("Compact Outputs (28 instead of 44 bytes per vertex)", &m_uiData.m_compactOutput);
     ImGui::End();
   }
 };
@@ -0,0 +1,102 @@
+// Generated by writeFruitTopologyHLSL() of gimslib from FRUIT_TOPOLOGY. Do not edit.
+static const uint FRUIT_TOPOLOGY_NUM_LODS = 5;
+static const uint FRUIT_TOPOLOGY_INTRA_LODS[5] = {3, 5, 7, 9, 11};
+static const uint FRUIT_TOPOLOGY_VERTEX_OFFSETS[5] = {0, 9, 34, 83, 164};
+static const uint FRUIT_TOPOLOGY_TRIANGLE_OFFSETS[5] = {0, 8, 40, 112, 240};
+
+static const float2 FRUIT_TOPOLOGY_PARAMETERS[285] = {
+    float2(-1, -1), float2(0, -1), float2(1, -1), float2(-1, 0), float2(0, 0), float2(1, 0), float2(-1, 1), float2(0, 1),
+    float2(1, 1), float2(-1, -1), float2(-0.5, -1), float2(0, -1), float2(0.5, -1), float2(1, -1), float2(-1, -0.5), float2(-0.5, -0.5),
+    float2(0, -0.5), float2(0.5, -0.5), float2(1, -0.5), float2(-1, 0), float2(-0.5, 0), float2(0, 0), float2(0.5, 0), float2(1, 0),
+    float2(-1, 0.5), float2(-0.5, 0.5), float2(0, 0.5), float2(0.5, 0.5), float2(1, 0.5), float2(-1, 1), float2(-0.5, 1), float2(0, 1),
+    float2(0.5, 1), float2(1, 1), float2(-1, -1), float2(-0.666666627, -1), float2(-0.333333313, -1), float2(0, -1), float2(0.333333373, -1), float2(0.666666627, -1),
+    float2(1, -1), float2(-1, -0.666666627), float2(-0.666666627, -0.666666627), float2(-0.333333313, -0.666666627), float2(0, -0.666666627), float2(0.333333373, -0.666666627), float2(0.666666627, -0.666666627), float2(1, -0.666666627),
+    float2(-1, -0.333333313), float2(-0.666666627, -0.333333313), float2(-0.333333313, -0.333333313), float2(0, -0.333333313), float2(0.333333373, -0.333333313), float2(0.666666627, -0.333333313), float2(1, -0.333333313), float2(-1, 0),
+    float2(-0.666666627, 0), float2(-0.333333313, 0), float2(0, 0), float2(0.333333373, 0), float2(0.666666627, 0), float2(1, 0), float2(-1, 0.333333373), float2(-0.666666627, 0.333333373),
+    float2(-0.333333313, 0.333333373), float2(0, 0.333333373), float2(0.333333373, 0.333333373), float2(0.666666627, 0.333333373), float2(1, 0.333333373), float2(-1, 0.666666627), float2(-0.666666627, 0.666666627), float2(-0.333333313, 0.666666627),
+    float2(0, 0.666666627), float2(0.333333373, 0.666666627), float2(0.666666627, 0.666666627), float2(1, 0.666666627), float2(-1, 1), float2(-0.666666627, 1), float2(-0.333333313, 1), float2(0, 1),
+    float2(0.333333373, 1), float2(0.666666627, 1), float2(1, 1), float2(-1, -1), float2(-0.75, -1), float2(-0.5, -1), float2(-0.25, -1), float2(0, -1),
+    float2(0.25, -1), float2(0.5, -1), float2(0.75, -1), float2(1, -1), float2(-1, -0.75), float2(-0.75, -0.75), float2(-0.5, -0.75), float2(-0.25, -0.75),
+    float2(0, -0.75), float2(0.25, -0.75), float2(0.5, -0.75), float2(0.75, -0.75), float2(1, -0.75), float2(-1, -0.5), float2(-0.75, -0.5), float2(-0.5, -0.5),
+    float2(-0.25, -0.5), float2(0, -0.5), float2(0.25, -0.5), float2(0.5, -0.5), float2(0.75, -0.5), float2(1, -0.5), float2(-1, -0.25), float2(-0.75, -0.25),
+    float2(-0.5, -0.25), float2(-0.25, -0.25), float2(0, -0.25), float2(0.25, -0.25), float2(0.5, -0.25), float2(0.75, -0.25), float2(1, -0.25), float2(-1, 0),
+    float2(-0.75, 0), float2(-0.5, 0), float2(-0.25, 0), float2(0, 0), float2(0.25, 0), float2(0.5, 0), float2(0.75, 0), float2(1, 0),
+    float2(-1, 0.25), float2(-0.75, 0.25), float2(-0.5, 0.25), float2(-0.25, 0.25), float2(0, 0.25), float2(0.25, 0.25), float2(0.5, 0.25), float2(0.75, 0.25),
+    float2(1, 0.25), float2(-1, 0.5), float2(-0.75, 0.5), float2(-0.5, 0.5), float2(-0.25, 0.5), float2(0, 0.5), float2(0.25, 0.5), float2(0.5, 0.5),
+    float2(0.75, 0.5), float2(1, 0.5), float2(-1, 0.75), float2(-0.75, 0.75), float2(-0.5, 0.75), float2(-0.25, 0.75), float2(0, 0.75), float2(0.25, 0.75),
+    float2(0.5, 0.75), float2(0.75, 0.75), float2(1, 0.75), float2(-1, 1), float2(-0.75, 1), float2(-0.5, 1), float2(-0.25, 1), float2(0, 1),
+    float2(0.25, 1), float2(0.5, 1), float2(0.75, 1), float2(1, 1), float2(-1, -1), float2(-0.800000012, -1), float2(-0.600000024, -1), float2(-0.399999976, -1),
+    float2(-0.199999988, -1), float2(0, -1), float2(0.200000048, -1), float2(0.399999976, -1), float2(0.600000024, -1), float2(0.799999952, -1), float2(1, -1), float2(-1, -0.800000012),
+    float2(-0.800000012, -0.800000012), float2(-0.600000024, -0.800000012), float2(-0.399999976, -0.800000012), float2(-0.199999988, -0.800000012), float2(0, -0.800000012), float2(0.200000048, -0.800000012), float2(0.399999976, -0.800000012), float2(0.600000024, -0.800000012),
+    float2(0.799999952, -0.800000012), float2(1, -0.800000012), float2(-1, -0.600000024), float2(-0.800000012, -0.600000024), float2(-0.600000024, -0.600000024), float2(-0.399999976, -0.600000024), float2(-0.199999988, -0.600000024), float2(0, -0.600000024),
+    float2(0.200000048, -0.600000024), float2(0.399999976, -0.600000024), float2(0.600000024, -0.600000024), float2(0.799999952, -0.600000024), float2(1, -0.600000024), float2(-1, -0.399999976), float2(-0.800000012, -0.399999976), float2(-0.600000024, -0.399999976),
+    float2(-0.399999976, -0.399999976), float2(-0.199999988, -0.399999976), float2(0, -0.399999976), float2(0.200000048, -0.399999976), float2(0.399999976, -0.399999976), float2(0.600000024, -0.399999976), float2(0.799999952, -0.399999976), float2(1, -0.399999976),
+    float2(-1, -0.199999988), float2(-0.800000012, -0.199999988), float2(-0.600000024, -0.199999988), float2(-0.399999976, -0.199999988), float2(-0.199999988, -0.199999988), float2(0, -0.199999988), float2(0.200000048, -0.199999988), float2(0.399999976, -0.199999988),
+    float2(0.600000024, -0.199999988), float2(0.799999952, -0.199999988), float2(1, -0.199999988), float2(-1, 0), float2(-0.800000012, 0), float2(-0.600000024, 0), float2(-0.399999976, 0), float2(-0.199999988, 0),
+    float2(0, 0), float2(0.200000048, 0), float2(0.399999976, 0), float2(0.600000024, 0), float2(0.799999952, 0), float2(1, 0), float2(-1, 0.200000048), float2(-0.800000012, 0.200000048),
+    float2(-0.600000024, 0.200000048), float2(-0.399999976, 0.200000048), float2(-0.199999988, 0.200000048), float2(0, 0.200000048), float2(0.200000048, 0.200000048), float2(0.399999976, 0.200000048), float2(0.600000024, 0.200000048), float2(0.799999952, 0.200000048),
+    float2(1, 0.200000048), float2(-1, 0.399999976), float2(-0.800000012, 0.399999976), float2(-0.600000024, 0.399999976), float2(-0.399999976, 0.399999976), float2(-0.199999988, 0.399999976), float2(0, 0.399999976), float2(0.200000048, 0.399999976),
+    float2(0.399999976, 0.399999976), float2(0.600000024, 0.399999976), float2(0.799999952, 0.399999976), float2(1, 0.399999976), float2(-1, 0.600000024), float2(-0.800000012, 0.600000024), float2(-0.600000024, 0.600000024), float2(-0.399999976, 0.600000024),
+    float2(-0.199999988, 0.600000024), float2(0, 0.600000024), float2(0.200000048, 0.600000024), float2(0.399999976, 0.600000024), float2(0.600000024, 0.600000024), float2(0.799999952, 0.600000024), float2(1, 0.600000024), float2(-1, 0.799999952),
+    float2(-0.800000012, 0.799999952), float2(-0.600000024, 0.799999952), float2(-0.399999976, 0.799999952), float2(-0.199999988, 0.799999952), float2(0, 0.799999952), float2(0.200000048, 0.799999952), float2(0.399999976, 0.799999952), float2(0.600000024, 0.799999952),
+    float2(0.799999952, 0.799999952), float2(1, 0.799999952), float2(-1, 1), float2(-0.800000012, 1), float2(-0.600000024, 1), float2(-0.399999976, 1), float2(-0.199999988, 1), float2(0, 1),
+    float2(0.200000048, 1), float2(0.399999976, 1), float2(0.600000024, 1), float2(0.799999952, 1), float2(1, 1)
+};
+
+static const uint3 FRUIT_TOPOLOGY_TRIANGLES[440] = {
+    uint3(0, 1, 3), uint3(1, 4, 3), uint3(1, 2, 5), uint3(5, 4, 1), uint3(3, 4, 7), uint3(7, 6, 3), uint3(4, 5, 7), uint3(5, 8, 7),
+    uint3(0, 1, 5), uint3(1, 6, 5), uint3(1, 2, 6), uint3(2, 7, 6), uint3(2, 3, 8), uint3(8, 7, 2), uint3(3, 4, 9), uint3(9, 8, 3),
+    uint3(5, 6, 10), uint3(6, 11, 10), uint3(6, 7, 11), uint3(7, 12, 11), uint3(7, 8, 13), uint3(13, 12, 7), uint3(8, 9, 14), uint3(14, 13, 8),
+    uint3(10, 11, 16), uint3(16, 15, 10), uint3(11, 12, 17), uint3(17, 16, 11), uint3(12, 13, 17), uint3(13, 18, 17), uint3(13, 14, 18), uint3(14, 19, 18),
+    uint3(15, 16, 21), uint3(21, 20, 15), uint3(16, 17, 22), uint3(22, 21, 16), uint3(17, 18, 22), uint3(18, 23, 22), uint3(18, 19, 23), uint3(19, 24, 23),
+    uint3(0, 1, 7), uint3(1, 8, 7), uint3(1, 2, 8), uint3(2, 9, 8), uint3(2, 3, 9), uint3(3, 10, 9), uint3(3, 4, 11), uint3(11, 10, 3),
+    uint3(4, 5, 12), uint3(12, 11, 4), uint3(5, 6, 13), uint3(13, 12, 5), uint3(7, 8, 14), uint3(8, 15, 14), uint3(8, 9, 15), uint3(9, 16, 15),
+    uint3(9, 10, 16), uint3(10, 17, 16), uint3(10, 11, 18), uint3(18, 17, 10), uint3(11, 12, 19), uint3(19, 18, 11), uint3(12, 13, 20), uint3(20, 19, 12),
+    uint3(14, 15, 21), uint3(15, 22, 21), uint3(15, 16, 22), uint3(16, 23, 22), uint3(16, 17, 23), uint3(17, 24, 23), uint3(17, 18, 25), uint3(25, 24, 17),
+    uint3(18, 19, 26), uint3(26, 25, 18), uint3(19, 20, 27), uint3(27, 26, 19), uint3(21, 22, 29), uint3(29, 28, 21), uint3(22, 23, 30), uint3(30, 29, 22),
+    uint3(23, 24, 31), uint3(31, 30, 23), uint3(24, 25, 31), uint3(25, 32, 31), uint3(25, 26, 32), uint3(26, 33, 32), uint3(26, 27, 33), uint3(27, 34, 33),
+    uint3(28, 29, 36), uint3(36, 35, 28), uint3(29, 30, 37), uint3(37, 36, 29), uint3(30, 31, 38), uint3(38, 37, 30), uint3(31, 32, 38), uint3(32, 39, 38),
+    uint3(32, 33, 39), uint3(33, 40, 39), uint3(33, 34, 40), uint3(34, 41, 40), uint3(35, 36, 43), uint3(43, 42, 35), uint3(36, 37, 44), uint3(44, 43, 36),
+    uint3(37, 38, 45), uint3(45, 44, 37), uint3(38, 39, 45), uint3(39, 46, 45), uint3(39, 40, 46), uint3(40, 47, 46), uint3(40, 41, 47), uint3(41, 48, 47),
+    uint3(0, 1, 9), uint3(1, 10, 9), uint3(1, 2, 10), uint3(2, 11, 10), uint3(2, 3, 11), uint3(3, 12, 11), uint3(3, 4, 12), uint3(4, 13, 12),
+    uint3(4, 5, 14), uint3(14, 13, 4), uint3(5, 6, 15), uint3(15, 14, 5), uint3(6, 7, 16), uint3(16, 15, 6), uint3(7, 8, 17), uint3(17, 16, 7),
+    uint3(9, 10, 18), uint3(10, 19, 18), uint3(10, 11, 19), uint3(11, 20, 19), uint3(11, 12, 20), uint3(12, 21, 20), uint3(12, 13, 21), uint3(13, 22, 21),
+    uint3(13, 14, 23), uint3(23, 22, 13), uint3(14, 15, 24), uint3(24, 23, 14), uint3(15, 16, 25), uint3(25, 24, 15), uint3(16, 17, 26), uint3(26, 25, 16),
+    uint3(18, 19, 27), uint3(19, 28, 27), uint3(19, 20, 28), uint3(20, 29, 28), uint3(20, 21, 29), uint3(21, 30, 29), uint3(21, 22, 30), uint3(22, 31, 30),
+    uint3(22, 23, 32), uint3(32, 31, 22), uint3(23, 24, 33), uint3(33, 32, 23), uint3(24, 25, 34), uint3(34, 33, 24), uint3(25, 26, 35), uint3(35, 34, 25),
+    uint3(27, 28, 36), uint3(28, 37, 36), uint3(28, 29, 37), uint3(29, 38, 37), uint3(29, 30, 38), uint3(30, 39, 38), uint3(30, 31, 39), uint3(31, 40, 39),
+    uint3(31, 32, 41), uint3(41, 40, 31), uint3(32, 33, 42), uint3(42, 41, 32), uint3(33, 34, 43), uint3(43, 42, 33), uint3(34, 35, 44), uint3(44, 43, 34),
+    uint3(36, 37, 46), uint3(46, 45, 36), uint3(37, 38, 47), uint3(47, 46, 37), uint3(38, 39, 48), uint3(48, 47, 38), uint3(39, 40, 49), uint3(49, 48, 39),
+    uint3(40, 41, 49), uint3(41, 50, 49), uint3(41, 42, 50), uint3(42, 51, 50), uint3(42, 43, 51), uint3(43, 52, 51), uint3(43, 44, 52), uint3(44, 53, 52),
+    uint3(45, 46, 55), uint3(55, 54, 45), uint3(46, 47, 56), uint3(56, 55, 46), uint3(47, 48, 57), uint3(57, 56, 47), uint3(48, 49, 58), uint3(58, 57, 48),
+    uint3(49, 50, 58), uint3(50, 59, 58), uint3(50, 51, 59), uint3(51, 60, 59), uint3(51, 52, 60), uint3(52, 61, 60), uint3(52, 53, 61), uint3(53, 62, 61),
+    uint3(54, 55, 64), uint3(64, 63, 54), uint3(55, 56, 65), uint3(65, 64, 55), uint3(56, 57, 66), uint3(66, 65, 56), uint3(57, 58, 67), uint3(67, 66, 57),
+    uint3(58, 59, 67), uint3(59, 68, 67), uint3(59, 60, 68), uint3(60, 69, 68), uint3(60, 61, 69), uint3(61, 70, 69), uint3(61, 62, 70), uint3(62, 71, 70),
+    uint3(63, 64, 73), uint3(73, 72, 63), uint3(64, 65, 74), uint3(74, 73, 64), uint3(65, 66, 75), uint3(75, 74, 65), uint3(66, 67, 76), uint3(76, 75, 66),
+    uint3(67, 68, 76), uint3(68, 77, 76), uint3(68, 69, 77), uint3(69, 78, 77), uint3(69, 70, 78), uint3(70, 79, 78), uint3(70, 71, 79), uint3(71, 80, 79),
+    uint3(0, 1, 11), uint3(1, 12, 11), uint3(1, 2, 12), uint3(2, 13, 12), uint3(2, 3, 13), uint3(3, 14, 13), uint3(3, 4, 14), uint3(4, 15, 14),
+    uint3(4, 5, 15), uint3(5, 16, 15), uint3(5, 6, 17), uint3(17, 16, 5), uint3(6, 7, 18), uint3(18, 17, 6), uint3(7, 8, 19), uint3(19, 18, 7),
+    uint3(8, 9, 20), uint3(20, 19, 8), uint3(9, 10, 21), uint3(21, 20, 9), uint3(11, 12, 22), uint3(12, 23, 22), uint3(12, 13, 23), uint3(13, 24, 23),
+    uint3(13, 14, 24), uint3(14, 25, 24), uint3(14, 15, 25), uint3(15, 26, 25), uint3(15, 16, 26), uint3(16, 27, 26), uint3(16, 17, 28), uint3(28, 27, 16),
+    uint3(17, 18, 29), uint3(29, 28, 17), uint3(18, 19, 30), uint3(30, 29, 18), uint3(19, 20, 31), uint3(31, 30, 19), uint3(20, 21, 32), uint3(32, 31, 20),
+    uint3(22, 23, 33), uint3(23, 34, 33), uint3(23, 24, 34), uint3(24, 35, 34), uint3(24, 25, 35), uint3(25, 36, 35), uint3(25, 26, 36), uint3(26, 37, 36),
+    uint3(26, 27, 37), uint3(27, 38, 37), uint3(27, 28, 39), uint3(39, 38, 27), uint3(28, 29, 40), uint3(40, 39, 28), uint3(29, 30, 41), uint3(41, 40, 29),
+    uint3(30, 31, 42), uint3(42, 41, 30), uint3(31, 32, 43), uint3(43, 42, 31), uint3(33, 34, 44), uint3(34, 45, 44), uint3(34, 35, 45), uint3(35, 46, 45),
+    uint3(35, 36, 46), uint3(36, 47, 46), uint3(36, 37, 47), uint3(37, 48, 47), uint3(37, 38, 48), uint3(38, 49, 48), uint3(38, 39, 50), uint3(50, 49, 38),
+    uint3(39, 40, 51), uint3(51, 50, 39), uint3(40, 41, 52), uint3(52, 51, 40), uint3(41, 42, 53), uint3(53, 52, 41), uint3(42, 43, 54), uint3(54, 53, 42),
+    uint3(44, 45, 55), uint3(45, 56, 55), uint3(45, 46, 56), uint3(46, 57, 56), uint3(46, 47, 57), uint3(47, 58, 57), uint3(47, 48, 58), uint3(48, 59, 58),
+    uint3(48, 49, 59), uint3(49, 60, 59), uint3(49, 50, 61), uint3(61, 60, 49), uint3(50, 51, 62), uint3(62, 61, 50), uint3(51, 52, 63), uint3(63, 62, 51),
+    uint3(52, 53, 64), uint3(64, 63, 52), uint3(53, 54, 65), uint3(65, 64, 53), uint3(55, 56, 67), uint3(67, 66, 55), uint3(56, 57, 68), uint3(68, 67, 56),
+    uint3(57, 58, 69), uint3(69, 68, 57), uint3(58, 59, 70), uint3(70, 69, 58), uint3(59, 60, 71), uint3(71, 70, 59), uint3(60, 61, 71), uint3(61, 72, 71),
+    uint3(61, 62, 72), uint3(62, 73, 72), uint3(62, 63, 73), uint3(63, 74, 73), uint3(63, 64, 74), uint3(64, 75, 74), uint3(64, 65, 75), uint3(65, 76, 75),
+    uint3(66, 67, 78), uint3(78, 77, 66), uint3(67, 68, 79), uint3(79, 78, 67), uint3(68, 69, 80), uint3(80, 79, 68), uint3(69, 70, 81), uint3(81, 80, 69),
+    uint3(70, 71, 82), uint3(82, 81, 70), uint3(71, 72, 82), uint3(72, 83, 82), uint3(72, 73, 83), uint3(73, 84, 83), uint3(73, 74, 84), uint3(74, 85, 84),
+    uint3(74, 75, 85), uint3(75, 86, 85), uint3(75, 76, 86), uint3(76, 87, 86), uint3(77, 78, 89), uint3(89, 88, 77), uint3(78, 79, 90), uint3(90, 89, 78),
+    uint3(79, 80, 91), uint3(91, 90, 79), uint3(80, 81, 92), uint3(92, 91, 80), uint3(81, 82, 93), uint3(93, 92, 81), uint3(82, 83, 93), uint3(83, 94, 93),
+    uint3(83, 84, 94), uint3(84, 95, 94), uint3(84, 85, 95), uint3(85, 96, 95), uint3(85, 86, 96), uint3(86, 97, 96), uint3(86, 87, 97), uint3(87, 98, 97),
+    uint3(88, 89, 100), uint3(100, 99, 88), uint3(89, 90, 101), uint3(101, 100, 89), uint3(90, 91, 102), uint3(102, 101, 90), uint3(91, 92, 103), uint3(103, 102, 91),
+    uint3(92, 93, 104), uint3(104, 103, 92), uint3(93, 94, 104), uint3(94, 105, 104), uint3(94, 95, 105), uint3(95, 106, 105), uint3(95, 96, 106), uint3(96, 107, 106),
+    uint3(96, 97, 107), uint3(97, 108, 107), uint3(97, 98, 108), uint3(98, 109, 108), uint3(99, 100, 111), uint3(111, 110, 99), uint3(100, 101, 112), uint3(112, 111, 100),
+    uint3(101, 102, 113), uint3(113, 112, 101), uint3(102, 103, 114), uint3(114, 113, 102), uint3(103, 104, 115), uint3(115, 114, 103), uint3(104, 105, 115), uint3(105, 116, 115),
+    uint3(105, 106, 116), uint3(106, 117, 116), uint3(106, 107, 117), uint3(107, 118, 117), uint3(107, 108, 118), uint3(108, 119, 118), uint3(108, 109, 119), uint3(109, 120, 119)
+};
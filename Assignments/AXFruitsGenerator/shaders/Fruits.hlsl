@@ -1,10 +1,14 @@
+#include "FruitTopology.hlsli"
+
 static const uint NUM_THREADS_X = 128;
 static const uint NUM_THREADS_Y = 1;
 static const uint NUM_THREADS_Z = 1;
 static const uint NUM_VERTICES = 256;
 static const uint NUM_TRIANGLES = 256;
+static const uint MAX_TILE_QUADS = 11;
+static const uint AS_GROUP_SIZE = 32;
 
-static const float INTER_DISTANCE = 2.5f;
+static const uint FRUIT_INSTANCE_FLAT_SHADING = 1;
 
 static const float3 LIGHT_DIRECTION = float3(0.0f, 0.0f, -1.0f);
 static const float3 AMBIENT_COLOR = float3(0.0f, 0.0f, 0.0f);
@@ -16,19 +20,58 @@ cbuffer PerMeshConstants : register(b0)
 {
     float4x4 viewMatrix;
     float4x4 projectionMatrix;
+    // Amplification shader groups per instance, enough for the tiles of the finest grid of the frame.
+    uint groupsPerInstance;
+    uint cullTiles;
+    float2 viewportSize;
+    // Index of group 0 of the dispatch, which is split into dispatches of at most 65535 groups.
+    uint firstGroup;
+}
+
+// FruitInstanceRecord of gimslib, built and uploaded by FruitInstanceBufferBuilder.
+struct FruitInstanceData
+{
+    float4 rotation;
+    float3 position;
+    uint flags;
     float4 p0;
     float4 p1;
     float4 p2;
     float4 p3;
-    int interLOD;
-}
+    // The grid selected for the instance on the CPU, and where its tile bounds start in tileBounds.
+    uint gridSize;
+    uint firstTileBounds;
+    // Set only for grids of 4 m + 1 vertices per side, see getMorphEdge().
+    float morphFactor;
+    uint reserved;
+};
+
+StructuredBuffer<FruitInstanceData> instances : register(t0);
+
+// FruitTileBoundsRecord of gimslib, computed by computeFruitTileBounds() for each grid in use, one after the other.
+struct FruitTileBounds
+{
+    float3 center;
+    float radius;
+    float3 coneAxis;
+    float coneCutoff;
+};
+
+StructuredBuffer<FruitTileBounds> tileBounds : register(t1);
+
+// The tiles of one instance that AS_main found visible; mesh shader group i draws tile tiles[i].
+struct Payload
+{
+    uint instance;
+    uint tiles[AS_GROUP_SIZE];
+};
 
 struct MeshShaderOutput
 {
     float4 position : SV_POSITION;
     float3 viewSpacePosition : POSITION;
-    float3 decodedCoordinates : TEXCOORD0;
-    float positionOffset : TEXCOORD1;
+    float3 viewSpaceNormal : NORMAL;
+    nointerpolation uint instance : INSTANCE;
 };
 
 int calculateIntraLOD(int n)
@@ -61,20 +104,24 @@ float3 octDecode(float2 coordinates)
     return normalize(octahedronCoordinates);
 }
 
-float3 evaluateCubicBezierCurve(float t)
+float3 evaluateCubicBezierCurve(FruitInstanceData instance, float t)
 {
+    const float3 p0 = instance.p0.xyz;
+    const float3 p1 = instance.p1.xyz;
+    const float3 p2 = instance.p2.xyz;
+    const float3 p3 = instance.p3.xyz;
     const float T_QUADRAT = t * t;
     const float T_CUBED = T_QUADRAT * t;
-    return p0.xyz +
-           t * (-3 * p0.xyz + 3 * p1.xyz) +
-           T_QUADRAT * (3 * p0.xyz - 6 * p1.xyz + 3 * p2.xyz) +
-           T_CUBED * (-p0.xyz + 3 * p1.xyz - 3 * p2.xyz + p3.xyz);
+    return p0 +
+           t * (-3 * p0 + 3 * p1) +
+           T_QUADRAT * (3 * p0 - 6 * p1 + 3 * p2) +
+           T_CUBED * (-p0 + 3 * p1 - 3 * p2 + p3);
 }
 
-float3 calculateFruitCoordinates(float3 coordinates)
+float3 calculateFruitCoordinates(FruitInstanceData instance, float3 coordinates)
 {
     const float T = (coordinates.z + 1.0f) / 2;
-    float3 result = evaluateCubicBezierCurve(T);
+    float3 result = evaluateCubicBezierCurve(instance, T);
     
     float2 sinusCosinus = float2(0.0f, 0.0f);
     sinusCosinus = normalize(coordinates.yx);
@@ -85,85 +132,426 @@ float3 calculateFruitCoordinates(float3 coordinates)
     return result;
 }
 
+float3 evaluateCubicBezierDerivative(FruitInstanceData instance, float t)
+{
+    const float3 p0 = instance.p0.xyz;
+    const float3 p1 = instance.p1.xyz;
+    const float3 p2 = instance.p2.xyz;
+    const float3 p3 = instance.p3.xyz;
+    const float S = 1.0f - t;
+    return 3.0f * S * S * (p1 - p0) + 6.0f * S * t * (p2 - p1) + 3.0f * t * t * (p3 - p2);
+}
+
+// Outward unit normal at calculateFruitCoordinates(instance, coordinates), as calculateFruitNormal() of gimslib. The
+// surface is R(phi) B(t), so its normal is R(phi) ((-B.y, B.x, 0) x B'(t)), negated for profiles that run from the top
+// to the bottom; at the poles, where it vanishes, it is -z at the bottom and +z at the top.
+float3 calculateFruitNormal(FruitInstanceData instance, float3 coordinates)
+{
+    const float T = (coordinates.z + 1.0f) / 2;
+    const float3 B = evaluateCubicBezierCurve(instance, T);
+    const float3 N = cross(float3(-B.y, B.x, 0.0f), evaluateCubicBezierDerivative(instance, T));
+    const float N_LENGTH = length(N);
+    const float ORIENTATION = instance.p3.z < instance.p0.z ? -1.0f : 1.0f;
+    if (N_LENGTH < 1e-12f)
+    {
+        return float3(0.0f, 0.0f, T < 0.5f ? -ORIENTATION : ORIENTATION);
+    }
+    const float RADIUS = length(coordinates.xy);
+    const float2 cosinusSinus = RADIUS > 0.0f ? coordinates.xy / RADIUS : float2(1.0f, 0.0f);
+    return float3(cosinusSinus.x * N.x - cosinusSinus.y * N.y, cosinusSinus.y * N.x + cosinusSinus.x * N.y, N.z) /
+           N_LENGTH * ORIENTATION;
+}
+
+// Rotates by the unit quaternion (x, y, z, w).
+float3 rotate(float4 quaternion, float3 v)
+{
+    return v + 2.0f * cross(quaternion.xyz, cross(quaternion.xyz, v) + quaternion.w * v);
+}
+
+// World space position of the fruit surface point of the octahedral direction.
+float3 calculateWorldCoordinates(FruitInstanceData instance, float3 coordinates)
+{
+    return rotate(instance.rotation, calculateFruitCoordinates(instance, coordinates)) + instance.position;
+}
+
+struct Tile
+{
+    uint firstX;
+    uint firstY;
+    uint numQuadsX;
+    uint numQuadsY;
+};
+
+// Same tiling as planFruitTiling() and getFruitTile() of gimslib.
+uint getTilesPerSide(uint gridSize)
+{
+    return (gridSize - 1 + MAX_TILE_QUADS - 1) / MAX_TILE_QUADS;
+}
+
+uint getTileStart(uint gridSize, uint tile)
+{
+    return tile * (gridSize - 1) / getTilesPerSide(gridSize);
+}
+
+Tile getTile(uint gridSize, uint tileIndex)
+{
+    const uint X = tileIndex % getTilesPerSide(gridSize);
+    const uint Y = tileIndex / getTilesPerSide(gridSize);
+    Tile tile;
+    tile.firstX = getTileStart(gridSize, X);
+    tile.firstY = getTileStart(gridSize, Y);
+    tile.numQuadsX = getTileStart(gridSize, X + 1) - tile.firstX;
+    tile.numQuadsY = getTileStart(gridSize, Y + 1) - tile.firstY;
+    return tile;
+}
+
+// The culling tests of FruitCuller in gimslib, with the same operations in the same order. They are precise, so the
+// compiler can neither fuse nor reorder them and the results match the CPU bit for bit.
+
+// v + 2 cross(q.xyz, cross(q.xyz, v) + q.w v), rotate() written out term by term.
+float3 rotateExactly(float4 q, float3 v)
+{
+    precise const float tx = q.y * v.z - q.z * v.y + q.w * v.x;
+    precise const float ty = q.z * v.x - q.x * v.z + q.w * v.y;
+    precise const float tz = q.x * v.y - q.y * v.x + q.w * v.z;
+    precise float3 result;
+    result.x = v.x + 2.0f * (q.y * tz - q.z * ty);
+    result.y = v.y + 2.0f * (q.z * tx - q.x * tz);
+    result.z = v.z + 2.0f * (q.x * ty - q.y * tx);
+    return result;
+}
+
+float3 transformPointExactly(float3 p)
+{
+    precise float3 result;
+    result.x = viewMatrix[0].x * p.x + viewMatrix[0].y * p.y + viewMatrix[0].z * p.z + viewMatrix[0].w;
+    result.y = viewMatrix[1].x * p.x + viewMatrix[1].y * p.y + viewMatrix[1].z * p.z + viewMatrix[1].w;
+    result.z = viewMatrix[2].x * p.x + viewMatrix[2].y * p.y + viewMatrix[2].z * p.z + viewMatrix[2].w;
+    return result;
+}
+
+float3 transformDirectionExactly(float3 d)
+{
+    precise float3 result;
+    result.x = viewMatrix[0].x * d.x + viewMatrix[0].y * d.y + viewMatrix[0].z * d.z;
+    result.y = viewMatrix[1].x * d.x + viewMatrix[1].y * d.y + viewMatrix[1].z * d.z;
+    result.z = viewMatrix[2].x * d.x + viewMatrix[2].y * d.y + viewMatrix[2].z * d.z;
+    return result;
+}
+
+// Frustum plane i (left, right, bottom, top, near, far) from the rows of the projection matrix, unnormalized.
+float4 getFrustumPlane(uint i)
+{
+    precise float4 plane;
+    switch (i)
+    {
+    case 0: plane = projectionMatrix[3] + projectionMatrix[0]; break;
+    case 1: plane = projectionMatrix[3] - projectionMatrix[0]; break;
+    case 2: plane = projectionMatrix[3] + projectionMatrix[1]; break;
+    case 3: plane = projectionMatrix[3] - projectionMatrix[1]; break;
+    case 4: plane = projectionMatrix[2]; break;
+    default: plane = projectionMatrix[3] - projectionMatrix[2]; break;
+    }
+    return plane;
+}
+
+// The view space sphere is not entirely outside the plane: d >= 0 or d^2 <= r^2 |n|^2.
+bool isInsidePlane(float4 plane, float3 center, float radius)
+{
+    precise const float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+    precise const float normalLength2 = plane.x * plane.x + plane.y * plane.y + plane.z * plane.z;
+    precise const float distance2 = distance * distance;
+    precise const float bound = radius * radius * normalLength2;
+    return distance >= 0.0f || distance2 <= bound;
+}
+
+// Every normal of the cone points away from every point of the view space sphere.
+bool isBackfacing(float3 center, float radius, float3 axis, float coneCutoff)
+{
+    precise const float s = center.x * axis.x + center.y * axis.y + center.z * axis.z - radius;
+    precise const float s2 = s * s;
+    precise const float bound =
+        coneCutoff * coneCutoff * (center.x * center.x + center.y * center.y + center.z * center.z);
+    return coneCutoff >= 0.0f && s >= 0.0f && s2 >= bound;
+}
+
+bool isTileVisible(FruitInstanceData instance, FruitTileBounds bounds)
+{
+    precise const float3 worldCenter = rotateExactly(instance.rotation, bounds.center) + instance.position;
+    const float3 center = transformPointExactly(worldCenter);
+    const float3 axis = transformDirectionExactly(rotateExactly(instance.rotation, bounds.coneAxis));
+
+    bool visible = !isBackfacing(center, bounds.radius, axis, bounds.coneCutoff);
+    for (uint i = 0; i < 6; i++)
+    {
+        visible = visible && isInsidePlane(getFrustumPlane(i), center, bounds.radius);
+    }
+    return visible;
+}
+
+groupshared Payload payload;
+groupshared uint numVisibleTiles;
+
+// One group per AS_GROUP_SIZE tiles of one instance: group i = firstGroup + SV_GroupID.x culls the tiles of chunk
+// i % groupsPerInstance of instance i / groupsPerInstance, one tile per thread, and launches a mesh shader group for
+// each visible one. Chunks past the tiles of the instance's grid launch nothing.
+[numthreads(AS_GROUP_SIZE, 1, 1)]
+void AS_main(in uint3 threadIdInsideItsGroup : SV_GroupThreadID, in uint3 groupId : SV_GroupID)
+{
+    const uint GROUP = firstGroup + groupId.x;
+    const uint INSTANCE = GROUP / groupsPerInstance;
+    const FruitInstanceData INSTANCE_DATA = instances[INSTANCE];
+    const uint TILES_PER_SIDE = getTilesPerSide(INSTANCE_DATA.gridSize);
+    const uint NUM_TILES = TILES_PER_SIDE * TILES_PER_SIDE;
+    const uint TILE = (GROUP % groupsPerInstance) * AS_GROUP_SIZE + threadIdInsideItsGroup.x;
+
+    if (threadIdInsideItsGroup.x == 0)
+    {
+        payload.instance = INSTANCE;
+        numVisibleTiles = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    bool visible = TILE < NUM_TILES;
+    if (visible && cullTiles != 0)
+    {
+        visible = isTileVisible(INSTANCE_DATA, tileBounds[INSTANCE_DATA.firstTileBounds + TILE]);
+    }
+    if (visible)
+    {
+        uint slot;
+        InterlockedAdd(numVisibleTiles, 1, slot);
+        payload.tiles[slot] = TILE;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    DispatchMesh(numVisibleTiles, 1, 1, payload);
+}
+
+#ifdef FRUIT_CULL_PRIMITIVES
+// Per-primitive culling in MS_main. emulateFruitPrimitiveCulling() of gimslib runs the same tests on the CPU.
+struct PrimitiveOutput
+{
+    bool cull : SV_CullPrimitive;
+};
+
+// Clip space positions of the group's vertices; mesh shader outputs cannot be read back.
+groupshared float4 clipPositions[NUM_VERTICES];
+
+float2 toPixels(float4 clip)
+{
+    return float2(0.5f + 0.5f * clip.x / clip.w, 0.5f - 0.5f * clip.y / clip.w) * viewportSize;
+}
+
+// Culls triangles with zero area, backfacing triangles and triangles whose pixel space bounding box contains no
+// pixel center. Triangles with a vertex on or behind the camera plane are kept.
+bool isPrimitiveCulled(uint3 triangle)
+{
+    const float4 a = clipPositions[triangle.x];
+    const float4 b = clipPositions[triangle.y];
+    const float4 c = clipPositions[triangle.z];
+    if (a.w <= 0.0f || b.w <= 0.0f || c.w <= 0.0f)
+    {
+        return false;
+    }
+    const float2 pa = toPixels(a);
+    const float2 pb = toPixels(b);
+    const float2 pc = toPixels(c);
+
+    // Pixel y points down, so front faces, which are clockwise on screen, have a positive area.
+    const float area = (pb.x - pa.x) * (pc.y - pa.y) - (pb.y - pa.y) * (pc.x - pa.x);
+    if (area <= 0.0f)
+    {
+        return true;
+    }
+
+    // Pixel centers are at integers + 0.5; a box between two centers in x or y covers none.
+    const float2 minimum = min(pa, min(pb, pc));
+    const float2 maximum = max(pa, max(pb, pc));
+    return any(ceil(minimum - 0.5f) > floor(maximum - 0.5f));
+}
+#endif
+
+// Same rounding as FRUIT_TOPOLOGY_PARAMETERS.
+float2 getGridParameters(uint gridSize, uint2 grid)
+{
+    return float2(float(2 * grid.x) / float(gridSize - 1) - 1.0f, float(2 * grid.y) / float(gridSize - 1) - 1.0f);
+}
+
+// The coarse edge the vertex moves onto when the grid morphs into the grid of half its resolution, as
+// getFruitMorphEdge() of gimslib. Both ends are the vertex itself for the vertices of the coarse grid.
+void getMorphEdge(uint gridSize, uint2 grid, out uint2 first, out uint2 second)
+{
+    first = grid;
+    second = grid;
+    const bool ODD_X = (grid.x & 1) == 1;
+    const bool ODD_Y = (grid.y & 1) == 1;
+    if (ODD_X && !ODD_Y)
+    {
+        first.x -= 1;
+        second.x += 1;
+    }
+    else if (!ODD_X && ODD_Y)
+    {
+        first.y -= 1;
+        second.y += 1;
+    }
+    else if (ODD_X && ODD_Y)
+    {
+        // The diagonal of the coarse quad, which has the flip rule of the fine quad (x, y).
+        const uint HALF = gridSize / 2;
+        const bool noFlipNeeded = (grid.x < HALF && grid.y < HALF) || (grid.x >= HALF && grid.y >= HALF);
+        first = noFlipNeeded ? uint2(grid.x + 1, grid.y - 1) : grid - 1;
+        second = noFlipNeeded ? uint2(grid.x - 1, grid.y + 1) : grid + 1;
+    }
+}
+
+// parameters are getGridParameters(instance.gridSize, grid), or the same values from the topology tables.
+MeshShaderOutput createVertex(FruitInstanceData instance, uint instanceIndex, float2 parameters, uint2 grid)
+{
+    const float3 SPHERICAL_COORDINATES = octDecode(parameters);
+    float3 position = calculateFruitCoordinates(instance, SPHERICAL_COORDINATES);
+    float3 normal = calculateFruitNormal(instance, SPHERICAL_COORDINATES);
+
+    // Geomorphing, as tessellateMorphedFruit() of gimslib: towards the midpoint of the morph edge.
+    uint2 first;
+    uint2 second;
+    getMorphEdge(instance.gridSize, grid, first, second);
+    if (instance.morphFactor > 0.0f && any(first != second))
+    {
+        const float3 FIRST = octDecode(getGridParameters(instance.gridSize, first));
+        const float3 SECOND = octDecode(getGridParameters(instance.gridSize, second));
+        const float3 MIDPOINT =
+            0.5f * (calculateFruitCoordinates(instance, FIRST) + calculateFruitCoordinates(instance, SECOND));
+        const float3 MIDPOINT_NORMAL =
+            0.5f * (calculateFruitNormal(instance, FIRST) + calculateFruitNormal(instance, SECOND));
+        position += instance.morphFactor * (MIDPOINT - position);
+        normal += instance.morphFactor * (MIDPOINT_NORMAL - normal);
+    }
+
+    const float3 coordinates = rotate(instance.rotation, position) + instance.position;
+    const float4 viewSpacePosition = mul(viewMatrix, float4(coordinates, 1.0f));
+
+    MeshShaderOutput result;
+    result.position = mul(projectionMatrix, viewSpacePosition);
+    result.viewSpacePosition = viewSpacePosition.xyz;
+    // The view matrix is rigid, so its upper 3x3 block transforms normals.
+    result.viewSpaceNormal = mul((float3x3)viewMatrix, rotate(instance.rotation, normal));
+    result.instance = instanceIndex;
+    return result;
+}
+
+// One group per visible tile of the payload's instance: group i draws tile tiles[i] of the instance's grid. Tiles sharing
+// an edge compute its vertices from the same grid coordinates, so the edge matches exactly.
+//
+// The grids of FruitTopology.hlsli are a single tile. They take a uniform branch that reads the parameters and
+// triangles from the tables instead of deriving them with integer divisions and the flip rule.
+//
+// Compiled with FRUIT_CULL_PRIMITIVES, each triangle is also tested in clip space and flagged with SV_CullPrimitive.
 [outputtopology("triangle")]
 [numthreads(NUM_THREADS_X, NUM_THREADS_Y, NUM_THREADS_Z)]
 void MS_main(
     in uint3 threadIdInsideItsGroup : SV_GroupThreadID,
+    in uint3 groupId : SV_GroupID,
+    in payload Payload meshPayload,
     out vertices MeshShaderOutput triangleVertices[NUM_VERTICES],
     out indices uint3 triangleIndices[NUM_TRIANGLES]
+#ifdef FRUIT_CULL_PRIMITIVES
+    , out primitives PrimitiveOutput trianglePrimitives[NUM_TRIANGLES]
+#endif
 )
 {
-    const uint INTRA_LOD = calculateIntraLOD(NUM_THREADS_X / interLOD);
-    const uint INTRA_LOD_QUADRAT = INTRA_LOD * INTRA_LOD;
-    const uint INTRA_LOD_DECREMENTED_QUADRAT = INTRA_LOD_QUADRAT - 2 * INTRA_LOD + 1;
-    
-    const uint X = threadIdInsideItsGroup.x % INTRA_LOD;
-    const uint Y = threadIdInsideItsGroup.x / INTRA_LOD;
-    
-    if (X >= INTRA_LOD)
-        return;
-    if (Y >= INTRA_LOD)
+    const uint FRUIT = meshPayload.instance;
+    const FruitInstanceData INSTANCE = instances[FRUIT];
+    const uint gridSize = INSTANCE.gridSize;
+
+    // The table grids 3, 5, ..., 11 are entry (gridSize - 3) / 2; smaller grids wrap around to large entries.
+    const uint LOD = (gridSize - 3) >> 1;
+    if ((gridSize & 1) == 1 && LOD < FRUIT_TOPOLOGY_NUM_LODS)
+    {
+        const uint FIRST_VERTEX = FRUIT_TOPOLOGY_VERTEX_OFFSETS[LOD];
+        const uint FIRST_TRIANGLE = FRUIT_TOPOLOGY_TRIANGLE_OFFSETS[LOD];
+        const uint TABLE_VERTICES = gridSize * gridSize;
+        const uint TABLE_TRIANGLES = 2 * (gridSize - 1) * (gridSize - 1);
+
+        SetMeshOutputCounts(TABLE_VERTICES, TABLE_TRIANGLES);
+
+        for (uint vertex = threadIdInsideItsGroup.x; vertex < TABLE_VERTICES; vertex += NUM_THREADS_X)
+        {
+            const MeshShaderOutput VERTEX =
+                createVertex(INSTANCE, FRUIT, FRUIT_TOPOLOGY_PARAMETERS[FIRST_VERTEX + vertex],
+                             uint2(vertex % gridSize, vertex / gridSize));
+            triangleVertices[vertex] = VERTEX;
+#ifdef FRUIT_CULL_PRIMITIVES
+            clipPositions[vertex] = VERTEX.position;
+#endif
+        }
+#ifdef FRUIT_CULL_PRIMITIVES
+        GroupMemoryBarrierWithGroupSync();
+#endif
+        for (uint triangle = threadIdInsideItsGroup.x; triangle < TABLE_TRIANGLES; triangle += NUM_THREADS_X)
+        {
+            triangleIndices[triangle] = FRUIT_TOPOLOGY_TRIANGLES[FIRST_TRIANGLE + triangle];
+#ifdef FRUIT_CULL_PRIMITIVES
+            trianglePrimitives[triangle].cull = isPrimitiveCulled(FRUIT_TOPOLOGY_TRIANGLES[FIRST_TRIANGLE + triangle]);
+#endif
+        }
         return;
-    
-    SetMeshOutputCounts(interLOD * INTRA_LOD * INTRA_LOD, 2 * interLOD * (INTRA_LOD - 1) * (INTRA_LOD - 1));
+    }
 
-    const float X_REMAPPED = map(X, 0.0f, INTRA_LOD - 1, -1.0f, 1.0f);
-    const float Y_REMAPPED = map(Y, 0.0f, INTRA_LOD - 1, -1.0f, 1.0f);
-    const float3 SPHERICAL_COORDINATES = octDecode(float2(X_REMAPPED, Y_REMAPPED));
+    const Tile TILE = getTile(gridSize, meshPayload.tiles[groupId.x]);
+    const uint TILE_WIDTH = TILE.numQuadsX + 1;
+    const uint NUM_QUADS = TILE.numQuadsX * TILE.numQuadsY;
 
-    float positionOffset = 0;
-    uint index = Y * INTRA_LOD + X;
-    float3 coordinates = calculateFruitCoordinates(SPHERICAL_COORDINATES);
-    float4 viewSpacePosition = float4(0.0f, 0.0f, 0.0f, 0.0f);
-    for (int i = 0; i < interLOD; i++)
-    {
-        viewSpacePosition = mul(viewMatrix, float4(coordinates, 1.0f));
-        triangleVertices[index].position = mul(projectionMatrix, viewSpacePosition);
-        triangleVertices[index].viewSpacePosition = viewSpacePosition;
-        triangleVertices[index].decodedCoordinates = SPHERICAL_COORDINATES;
-        triangleVertices[index].positionOffset = positionOffset;
-        index += INTRA_LOD_QUADRAT;
-        coordinates.x += INTER_DISTANCE;
-        positionOffset += INTER_DISTANCE;
+    SetMeshOutputCounts(TILE_WIDTH * (TILE.numQuadsY + 1), 2 * NUM_QUADS);
 
+    for (uint index = threadIdInsideItsGroup.x; index < TILE_WIDTH * (TILE.numQuadsY + 1); index += NUM_THREADS_X)
+    {
+        const uint2 GRID = uint2(TILE.firstX + index % TILE_WIDTH, TILE.firstY + index / TILE_WIDTH);
+        const MeshShaderOutput VERTEX = createVertex(INSTANCE, FRUIT, getGridParameters(gridSize, GRID), GRID);
+        triangleVertices[index] = VERTEX;
+#ifdef FRUIT_CULL_PRIMITIVES
+        clipPositions[index] = VERTEX.position;
+#endif
     }
+#ifdef FRUIT_CULL_PRIMITIVES
+    GroupMemoryBarrierWithGroupSync();
+#endif
 
-    if (X >= (INTRA_LOD - 1))
-        return;
-    
-    if (Y >= (INTRA_LOD - 1))
-        return;
-    
-    uint current = Y * INTRA_LOD + X;
-    uint right = current + 1;
-    uint bottom = current + INTRA_LOD;
-    uint bottomRight = bottom + 1;
-    index = 2 * (Y * (INTRA_LOD - 1) + X);
-    bool noFlipNeeded = true;
-    for (int i = 0; i < interLOD; i++)
+    for (uint quad = threadIdInsideItsGroup.x; quad < NUM_QUADS; quad += NUM_THREADS_X)
     {
-        noFlipNeeded = (X < (INTRA_LOD / 2) && Y < (INTRA_LOD / 2)) || (X >= (INTRA_LOD / 2) && Y >= (INTRA_LOD / 2));
-        triangleIndices[index] = noFlipNeeded ? uint3(current, right, bottom) : uint3(current, right, bottomRight);
-        triangleIndices[index + 1] = noFlipNeeded ? uint3(right, bottomRight, bottom) : uint3(bottomRight, bottom, current);
-        current += INTRA_LOD_QUADRAT;
-        right = current + 1;
-        bottom = current + INTRA_LOD;
-        bottomRight = bottom + 1;
-        index += 2 * INTRA_LOD_DECREMENTED_QUADRAT;
+        const uint X = quad % TILE.numQuadsX;
+        const uint Y = quad / TILE.numQuadsX;
+        const uint current = Y * TILE_WIDTH + X;
+        const uint right = current + 1;
+        const uint bottom = current + TILE_WIDTH;
+        const uint bottomRight = bottom + 1;
 
+        // The flip rule of the whole grid, evaluated at grid coordinates.
+        const uint HALF = gridSize / 2;
+        const uint GRID_X = TILE.firstX + X;
+        const uint GRID_Y = TILE.firstY + Y;
+        const bool noFlipNeeded = (GRID_X < HALF && GRID_Y < HALF) || (GRID_X >= HALF && GRID_Y >= HALF);
+        const uint3 FIRST = noFlipNeeded ? uint3(current, right, bottom) : uint3(current, right, bottomRight);
+        const uint3 SECOND = noFlipNeeded ? uint3(right, bottomRight, bottom) : uint3(bottomRight, bottom, current);
+        triangleIndices[2 * quad] = FIRST;
+        triangleIndices[2 * quad + 1] = SECOND;
+#ifdef FRUIT_CULL_PRIMITIVES
+        trianglePrimitives[2 * quad].cull = isPrimitiveCulled(FIRST);
+        trianglePrimitives[2 * quad + 1].cull = isPrimitiveCulled(SECOND);
+#endif
     }
-
 }
 
 float4 PS_main(MeshShaderOutput input)
     : SV_TARGET
 {
-    float3 evaluatedCoordinates = calculateFruitCoordinates(input.decodedCoordinates);
-    
-    evaluatedCoordinates = mul(viewMatrix, float4(evaluatedCoordinates, 1.0f));
-    evaluatedCoordinates.x += input.positionOffset;
+    // The interpolated analytic normal, or the facet normal from the screen space derivatives for flat shading.
+    const FruitInstanceData instance = instances[input.instance];
     float3 l = normalize(LIGHT_DIRECTION);
-    float3 n = p3.w ? normalize(cross(ddx(input.viewSpacePosition), ddy(input.viewSpacePosition))) : normalize(cross(ddx(evaluatedCoordinates), ddy(evaluatedCoordinates)));
+    float3 n = (instance.flags & FRUIT_INSTANCE_FLAT_SHADING)
+                   ? normalize(cross(ddx(input.viewSpacePosition), ddy(input.viewSpacePosition)))
+                   : normalize(input.viewSpaceNormal);
     
     float3 v = normalize(-input.viewSpacePosition);
     float3 h = normalize(l + v);
@@ -1,43 +1,146 @@
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <gimslib/d3d/DX12App.hpp>
 #include <gimslib/d3d/DX12Util.hpp>
+#include <gimslib/fruit/FruitCompactOutput.hpp>
+#include <gimslib/fruit/FruitCulling.hpp>
+#include <gimslib/fruit/FruitDisplacement.hpp>
+#include <gimslib/fruit/FruitDistanceField.hpp>
+#include <gimslib/fruit/FruitGeomorph.hpp>
+#include <gimslib/fruit/FruitInstanceBuffer.hpp>
+#include <gimslib/fruit/FruitMeshCache.hpp>
+#include <gimslib/fruit/FruitMorphAnimation.hpp>
+#include <gimslib/fruit/FruitLODSelector.hpp>
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/fruit/FruitProfileFitter.hpp>
+#include <gimslib/fruit/FruitSceneBVH.hpp>
+#include <gimslib/fruit/FruitTessellator.hpp>
+#include <gimslib/fruit/FruitTiling.hpp>
+#include <gimslib/fruit/ProfileCurve.hpp>
 #include <gimslib/types.hpp>
 #include <gimslib/ui/ExaminerController.hpp>
 #include <imgui.h>
 #include <iostream>
+#include <optional>
 
 using namespace gims;
 
 class SphereRenderer : public DX12App
 {
 private:
+  //! Fruits per row of createInstances().
+  static constexpr size_t FRUITS_PER_ROW = 32;
+  //! Maximum of the grid size slider and of the screen-space LOD, which bounds the tile count.
+  static constexpr ui32 MAX_GRID_SIZE = 257;
+  //! Tiles culled by one amplification shader group, AS_GROUP_SIZE of Fruits.hlsl.
+  static constexpr ui32 AS_GROUP_SIZE = 32;
+  //! Largest group count per dimension of DispatchMesh(); larger dispatches are split.
+  static constexpr ui32 MAX_DISPATCH_GROUPS = 65535;
+
   struct UiData
   {
     f32v3 m_backgroundColor     = {0.0f, 0.0f, 0.0f};
     i32   m_intraLevelOfDetails = 1;
+    i32   m_gridSize            = 0;
+    bool  m_screenSpaceLOD      = false;
+    f32   m_pixelError          = 1.0f;
+    bool  m_geomorph            = false;
+    f32   m_morphFactor         = 0.0f;
     bool   m_flatShading = false;
+    bool  m_cullTiles           = true;
+    bool  m_cullPrimitives      = false;
+    bool  m_growFruits          = false;
     f32v3 m_firstControlPoint   = f32v3(0.0f, 0.0f, -0.3f);
     f32v3 m_secondControlPoint  = f32v3(1.0f, 0.0f, -0.7f);
     f32v3 m_thirdControlPoint   = f32v3(1.0f, 0.0f, 0.3f);
     f32v3 m_fourthControlPoint  = f32v3(0.f, 0.0f, 1.0f);
     char   m_shaderName[100]     = "default";
+    //! Relative to the working directory. "Save Profile as Scan" creates it.
+    char   m_scanDirectory[260]  = "scans";
+    i32    m_selectedScan        = 0;
+    //! Preset whose displacement "Save Profile as Scan" applies, -1 for none.
+    i32    m_scanDisplacement    = -1;
   };
 
   UiData m_uiData;
 
+  //! Of the profile of the previous frame; measured again when the profile changes.
+  ForwardDifferencingError    m_forwardDifferencingError;
+  std::optional<FruitProfile> m_forwardDifferencingProfile;
+
+  std::vector<FruitScanFit> m_scanFits;
+  std::string               m_scanError;
+
+  //! Grid size of each fruit selected by the screen-space LOD in the previous frame, for the hysteresis.
+  std::vector<ui32>             m_selectedGridSizes;
+  //! Grid and morph factor of each fruit, selected by the screen-space LOD when geomorphing.
+  std::vector<FruitMorphLevel>  m_morphLevels;
+  //! The grid and morph factor of each fruit in this frame and where its tile bounds start, stored in its instance
+  //! record.
+  std::vector<FruitInstanceLOD> m_instanceLODs;
+
+  //! Bounding spheres of m_sphereInstances, recomputed only when the instances change.
+  FruitBoundingSphereArray m_spheres;
+  FruitInstanceArray       m_sphereInstances;
+
+  //! Grows the fruits one after the other into the profile m_growthProfile; m_grownProfiles holds the current frame.
+  FruitMorphAnimation         m_growthAnimation;
+  std::optional<FruitProfile> m_growthProfile;
+  FruitProfileArray           m_grownProfiles;
+  f64                         m_growthStartTime = 0.0;
+
+  //! Hierarchy for picking and the instances it was built for.
+  std::optional<FruitSceneBVH> m_sceneBVH;
+  FruitInstanceArray           m_sceneBVHInstances;
+
+  FruitSceneHit               m_pickedFruit;
+  FruitDistanceFieldBenchmark m_distanceFieldBenchmark;
+  //! Of the FRUIT_COMPACT_OUTPUT variant of the saved shaders.
+  FruitCompactOutputError     m_compactOutputError;
+  FruitPrimitiveCullingStats  m_primitiveCullingStats;
+  //! Set by the UI; the emulation needs the matrices of the next frame.
+  bool                        m_emulatePrimitiveCulling = false;
+
   ComPtr<ID3D12PipelineState> m_pipelineState;
+  //! Compiled with FRUIT_CULL_PRIMITIVES.
+  ComPtr<ID3D12PipelineState> m_primitiveCullingPipelineState;
   ComPtr<ID3D12PipelineState> m_wireFramePipelineState;
   ComPtr<ID3D12RootSignature> m_rootSignature;
 
+  FruitInstanceBufferBuilder m_instanceBufferBuilder;
+  //! FruitInstanceRecords of m_instanceCapacity fruits, read by the shaders as a structured buffer. Recreated with
+  //! twice the capacity when the fruits no longer fit.
+  ComPtr<ID3D12Resource>              m_instanceBuffer;
+  size_t                              m_instanceCapacity = 0;
+  //! One persistently mapped staging buffer per frame in flight for the changed records.
+  std::vector<ComPtr<ID3D12Resource>> m_instanceUploadBuffers;
+  std::vector<FruitInstanceRecord*>   m_instanceUploadData;
+
+  //! Tile bounds of this frame, one copy per distinct profile and grid in use.
+  FruitTileBoundsBuilder              m_tileBoundsBuilder;
+  //! One persistently mapped buffer per frame in flight, read by AS_main directly from the upload heap.
+  std::vector<ComPtr<ID3D12Resource>> m_tileBoundsBuffers;
+  std::vector<FruitTileBoundsRecord*> m_tileBoundsData;
+  //! Records each of m_tileBoundsBuffers holds.
+  std::vector<size_t>                 m_tileBoundsCapacities;
+
+  //! Visible fruits and tiles of the last frame as counted by FruitCuller, the CPU reference of AS_main.
+  size_t m_numVisibleFruits = 0;
+  size_t m_numVisibleTiles  = 0;
+  size_t m_numTiles         = 0;
+
   gims::ExaminerController m_examinerController;
 
   void createRootSignature()
   {
-    CD3DX12_ROOT_PARAMETER rootParameters[1] = {};
-    rootParameters[0].InitAsConstants(49, 0, 0, D3D12_SHADER_VISIBILITY_ALL);
+    CD3DX12_ROOT_PARAMETER rootParameters[3] = {};
+    rootParameters[0].InitAsConstants(37, 0, 0, D3D12_SHADER_VISIBILITY_ALL);
+    rootParameters[1].InitAsShaderResourceView(0, 0, D3D12_SHADER_VISIBILITY_ALL);
+    rootParameters[2].InitAsShaderResourceView(1, 0, D3D12_SHADER_VISIBILITY_ALL);
 
     CD3DX12_ROOT_SIGNATURE_DESC descRootSignature;
-    descRootSignature.Init(1, rootParameters, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_NONE);
+    descRootSignature.Init(3, rootParameters, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_NONE);
 
     ComPtr<ID3DBlob> rootBlob, errorBlob;
     D3D12SerializeRootSignature(&descRootSignature, D3D_ROOT_SIGNATURE_VERSION_1, &rootBlob, &errorBlob);
@@ -48,6 +151,145 @@ private:
     std::cout << "Root signature created successfully!" << std::endl;
   }
 
+  //! Creates the instance buffer and its staging buffers for capacity records. The GPU must not use the old ones.
+  void createInstanceBuffers(size_t capacity)
+  {
+    const UINT64 size                  = capacity * sizeof(FruitInstanceRecord);
+    const auto   defaultHeapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+    const auto   uploadHeapProperties  = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+    const auto   bufferDesc            = CD3DX12_RESOURCE_DESC::Buffer(size);
+    throwIfFailed(getDevice()->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                       D3D12_RESOURCE_STATE_COMMON, nullptr,
+                                                       IID_PPV_ARGS(&m_instanceBuffer)));
+
+    const ui32 frameCount = getDX12AppConfig().frameCount;
+    m_instanceUploadBuffers.resize(frameCount);
+    m_instanceUploadData.resize(frameCount);
+    for (ui32 i = 0; i < frameCount; i++)
+    {
+      throwIfFailed(getDevice()->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                         D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+                                                         IID_PPV_ARGS(&m_instanceUploadBuffers[i])));
+      const CD3DX12_RANGE noRead(0, 0);
+      throwIfFailed(
+          m_instanceUploadBuffers[i]->Map(0, &noRead, reinterpret_cast<void**>(&m_instanceUploadData[i])));
+    }
+    m_instanceCapacity = capacity;
+    m_instanceBufferBuilder.invalidate();
+  }
+
+  void createTileBoundsBuffers()
+  {
+    const ui32 frameCount = getDX12AppConfig().frameCount;
+    m_tileBoundsBuffers.resize(frameCount);
+    m_tileBoundsData.resize(frameCount);
+    m_tileBoundsCapacities.resize(frameCount);
+    for (ui32 i = 0; i < frameCount; i++)
+    {
+      createTileBoundsBuffer(i, planFruitTiling(MAX_GRID_SIZE).getNumTiles());
+    }
+  }
+
+  //! Replaces the tile bounds buffer of the frame by one of the given capacity. A frame's buffer is only replaced while
+  //! the GPU is not using it, i.e., when the frame is recorded again.
+  void createTileBoundsBuffer(ui32 frame, size_t capacity)
+  {
+    const auto uploadHeapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+    const auto bufferDesc           = CD3DX12_RESOURCE_DESC::Buffer(capacity * sizeof(FruitTileBoundsRecord));
+    throwIfFailed(getDevice()->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                       D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+                                                       IID_PPV_ARGS(&m_tileBoundsBuffers[frame])));
+    const CD3DX12_RANGE noRead(0, 0);
+    throwIfFailed(m_tileBoundsBuffers[frame]->Map(0, &noRead, reinterpret_cast<void**>(&m_tileBoundsData[frame])));
+    m_tileBoundsCapacities[frame] = capacity;
+  }
+
+  //! Sets the firstTileBounds of each fruit and writes the tile bounds of this frame to this frame's buffer, which
+  //! grows as needed. The bounds are computed once per profile and grid; the finest grid has 576 tiles, 18 KB of
+  //! bounds, so the bounds of this frame are simply copied every frame.
+  void uploadTileBounds(const FruitInstanceArray& instances)
+  {
+    m_tileBoundsBuilder.update(instances, m_uiData.m_geomorph, m_instanceLODs);
+    const std::vector<FruitTileBoundsRecord>& bounds = m_tileBoundsBuilder.getBounds();
+
+    const ui32 frame = getFrameIndex();
+    if (bounds.size() > m_tileBoundsCapacities[frame])
+    {
+      createTileBoundsBuffer(frame, std::max(bounds.size(), 2 * m_tileBoundsCapacities[frame]));
+    }
+    ::memcpy(m_tileBoundsData[frame], bounds.data(), bounds.size() * sizeof(FruitTileBoundsRecord));
+  }
+
+  //! Returns the bounding spheres of the instances, which are only recomputed when the instances change.
+  const FruitBoundingSphereArray& getBoundingSpheres(const FruitInstanceArray& instances)
+  {
+    if (m_spheres.getSize() != instances.getSize() || !(m_sphereInstances == instances))
+    {
+      FruitMeasureArray measures;
+      computeFruitMeasures(instances.profiles, measures);
+      m_spheres.resize(instances.getSize());
+      computeFruitBoundingSpheres(instances, measures, 0, instances.getSize(), m_spheres);
+      m_sphereInstances = instances;
+    }
+    return m_spheres;
+  }
+
+  //! Counts the fruits and tiles FruitCuller finds visible, for comparison with the GPU.
+  void countVisible(const f32m4& projectionMatrix, const f32m4& viewMatrix, const FruitInstanceArray& instances)
+  {
+    const FruitCuller culler(viewMatrix, projectionMatrix);
+    std::vector<ui8>  visible(std::max<size_t>(instances.getSize(), planFruitTiling(MAX_GRID_SIZE).getNumTiles()));
+    culler.cullSpheres(getBoundingSpheres(instances), 0, instances.getSize(), visible.data());
+    m_numVisibleFruits =
+        static_cast<size_t>(std::count(visible.begin(), visible.begin() + instances.getSize(), ui8(1)));
+
+    m_numVisibleTiles = 0;
+    m_numTiles        = 0;
+    for (const FruitInstanceRecord& record : m_instanceBufferBuilder.getRecords())
+    {
+      const ui32                   numTiles = planFruitTiling(record.gridSize).getNumTiles();
+      const FruitTileBoundsRecord* bounds = m_tileBoundsBuilder.getBounds().data() + record.firstTileBounds;
+      culler.cullTiles(record, bounds, 0, numTiles, visible.data());
+      m_numVisibleTiles += static_cast<size_t>(std::count(visible.begin(), visible.begin() + numTiles, ui8(1)));
+      m_numTiles += numTiles;
+    }
+  }
+
+  //! Copies the records that changed since the last frame through this frame's staging buffer. Frames reuse their
+  //! staging buffer only after the GPU has finished with it, and the copies execute in order on the queue, so the
+  //! instance buffer always holds the records of the current frame.
+  void uploadInstances(const FruitInstanceArray& instances)
+  {
+    if (instances.getSize() > m_instanceCapacity)
+    {
+      // All frames in flight read the instance buffer, so it is replaced only once the GPU is idle.
+      waitForGPU();
+      createInstanceBuffers(std::max(instances.getSize(), 2 * m_instanceCapacity));
+    }
+    const std::vector<FruitInstanceRange>& ranges = m_instanceBufferBuilder.update(instances, m_instanceLODs);
+    if (ranges.empty())
+    {
+      return;
+    }
+
+    // Buffers decay to COMMON after each frame; the first copy promotes the instance buffer to COPY_DEST.
+    const auto                 commandList = getCommandList();
+    const ui32                 frame       = getFrameIndex();
+    const FruitInstanceRecord* records     = m_instanceBufferBuilder.getRecords().data();
+    for (const FruitInstanceRange& range : ranges)
+    {
+      const UINT64 offset = range.first * sizeof(FruitInstanceRecord);
+      const UINT64 size   = range.count * sizeof(FruitInstanceRecord);
+      ::memcpy(m_instanceUploadData[frame] + range.first, records + range.first, size);
+      commandList->CopyBufferRegion(m_instanceBuffer.Get(), offset, m_instanceUploadBuffers[frame].Get(), offset,
+                                    size);
+    }
+    const auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(
+        m_instanceBuffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST,
+        D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    commandList->ResourceBarrier(1, &barrier);
+  }
+
 
   std::string FormatFloat3(const f32v3& controlPoint)
   {
@@ -63,8 +305,8 @@ static const uint NUM_THREADS_Y = 1;
 static const uint NUM_THREADS_Z = 1;
 static const uint NUM_VERTICES = 256;
 static const uint NUM_TRIANGLES = 256;
-
-static const float INTER_DISTANCE = 2.5f;
+)" + std::format("\nstatic const float INTER_DISTANCE = {:.9g}f;\n", FRUIT_INTER_DISTANCE) +
+                             R"(
 
 static const float3 LIGHT_DIRECTION = float3(0.0f, 0.0f, -1.0f);
 static const float3 AMBIENT_COLOR = float3(0.0f, 0.0f, 0.0f);
@@ -77,13 +319,23 @@ cbuffer PerMeshConstants : register(b0)
     float4x4 viewMatrix;
     float4x4 projectionMatrix;
     int interLOD;
+    float2 viewportSize;
+    float4x4 inverseProjectionMatrix;
 }
 
+// With FRUIT_COMPACT_OUTPUT, a vertex takes 28 instead of 44 bytes: the pixel shader decodes the octahedral
+// coordinates and reconstructs the view space position from SV_POSITION. The shading differs slightly, as decoding the
+// interpolated octahedral coordinates is not the same as interpolating the decoded ones: the directions differ by up to
+// 0.053 rad (3 degrees) on the 3 x 3 grid and less on finer grids (FruitCompactOutputError::maxInterpolationAngle).
 struct MeshShaderOutput
 {
     float4 position : SV_POSITION;
+#ifdef FRUIT_COMPACT_OUTPUT
+    float2 encodedCoordinates : TEXCOORD0;
+#else
     float3 viewSpacePosition : POSITION;
     float3 decodedCoordinates : TEXCOORD0;
+#endif
     float positionOffset : TEXCOORD1;
 };
 
@@ -117,20 +369,10 @@ float3 octDecode(float2 coordinates)
     return normalize(octahedronCoordinates);
 }
 
-float3 evaluateCubicBezierCurve(float t)
-{
-    const float T_QUADRAT = t * t;
-    const float T_CUBED = T_QUADRAT * t;
-    return P0 +
-           t * (-3 * P0 + 3 * P1) +
-           T_QUADRAT * (3 * P0 - 6 * P1 + 3 * P2) +
-           T_CUBED * (-P0 + 3 * P1 - 3 * P2 + P3);
-}
-
 float3 calculateFruitCoordinates(float3 coordinates)
 {
     const float T = (coordinates.z + 1.0f) / 2;
-    float3 result = evaluateCubicBezierCurve(T);
+    float3 result = evaluateProfileCurve(T);
     
     float2 sinusCosinus = float2(0.0f, 0.0f);
     sinusCosinus = normalize(coordinates.yx);
@@ -175,8 +417,13 @@ void MS_main(
     {
         viewSpacePosition = mul(viewMatrix, float4(coordinates, 1.0f));
         triangleVertices[index].position = mul(projectionMatrix, viewSpacePosition);
+#ifdef FRUIT_COMPACT_OUTPUT
+        // The grid parameters are the octahedral encoding of SPHERICAL_COORDINATES.
+        triangleVertices[index].encodedCoordinates = float2(X_REMAPPED, Y_REMAPPED);
+#else
         triangleVertices[index].viewSpacePosition = viewSpacePosition;
         triangleVertices[index].decodedCoordinates = SPHERICAL_COORDINATES;
+#endif
         triangleVertices[index].positionOffset = positionOffset;
         index += INTRA_LOD_QUADRAT;
         coordinates.x += INTER_DISTANCE;
@@ -211,17 +458,31 @@ void MS_main(
 
 }
 
+float3 reconstructViewSpacePosition(float4 position)
+{
+    const float2 ndc = float2(2.0f * position.x / viewportSize.x - 1.0f, 1.0f - 2.0f * position.y / viewportSize.y);
+    const float4 viewSpacePosition = mul(inverseProjectionMatrix, float4(ndc, position.z, 1.0f));
+    return viewSpacePosition.xyz / viewSpacePosition.w;
+}
+
 float4 PS_main(MeshShaderOutput input)
     : SV_TARGET
 {
-    float3 evaluatedCoordinates = calculateFruitCoordinates(input.decodedCoordinates);
+#ifdef FRUIT_COMPACT_OUTPUT
+    const float3 decodedCoordinates = octDecode(input.encodedCoordinates);
+    const float3 viewSpacePosition = reconstructViewSpacePosition(input.position);
+#else
+    const float3 decodedCoordinates = input.decodedCoordinates;
+    const float3 viewSpacePosition = input.viewSpacePosition;
+#endif
+    float3 evaluatedCoordinates = calculateFruitCoordinates(decodedCoordinates);
     
     evaluatedCoordinates = mul(viewMatrix, float4(evaluatedCoordinates, 1.0f));
     evaluatedCoordinates.x += input.positionOffset;
     float3 l = normalize(LIGHT_DIRECTION);
     float3 n = normalize(cross(ddx(evaluatedCoordinates), ddy(evaluatedCoordinates)));
     
-    float3 v = normalize(-input.viewSpacePosition);
+    float3 v = normalize(-viewSpacePosition);
     float3 h = normalize(l + v);
     float f_diffuse = max(0.0f, dot(n, l));
     float f_specular = pow(max(0.0f, dot(n, h)), SPECULAR_EXPONENT.w);
@@ -243,14 +504,9 @@ float4 PS_main(MeshShaderOutput input)
     const std::string searchString   = "static const float3 TEXTURE_COLOR = float3(1.0f, 0.0f, 0.0f);";
     size_t            insertPosition = shaderCode.find(searchString);
 
-    const std::string generatedContent = std::format("\nstatic const float3 P0 = float3({});\n"
-                                                     "static const float3 P1 = float3({});\n"
-                                                     "static const float3 P2 = float3({});\n"
-                                                     "static const float3 P3 = float3({});\n",
-                                                     FormatFloat3(m_uiData.m_firstControlPoint),
-                                                     FormatFloat3(m_uiData.m_secondControlPoint),
-                                                     FormatFloat3(m_uiData.m_thirdControlPoint),
-                                                     FormatFloat3(m_uiData.m_fourthControlPoint));
+    const ProfileCurve<Bezier, 3> profileCurve({m_uiData.m_firstControlPoint, m_uiData.m_secondControlPoint,
+                                                m_uiData.m_thirdControlPoint, m_uiData.m_fourthControlPoint});
+    const std::string             generatedContent = profileCurve.toHLSL("evaluateProfileCurve");
 
     shaderCode.insert(insertPosition + searchString.size(), "\n" + generatedContent);
 
@@ -258,15 +514,248 @@ float4 PS_main(MeshShaderOutput input)
     outfile.close();
   }
 
-  void createPipeline()
+  void fitScans()
+  {
+    m_scanError.clear();
+    try
+    {
+      m_scanFits = fitFruitProfiles(m_uiData.m_scanDirectory);
+    }
+    catch (const std::exception& e)
+    {
+      m_scanFits.clear();
+      m_scanError = e.what();
+    }
+    m_uiData.m_selectedScan = 0;
+  }
+
+  //! Writes the profile, tessellated into rings by forward differencing, to the scan directory, so that it can be
+  //! fitted like a scan. With a scan displacement, the profile is tessellated into a grid and displaced instead, to see
+  //! how the fit copes with the bumps and dimples of a real scan.
+  void saveProfileAsScan()
+  {
+    m_scanError.clear();
+    try
+    {
+      const std::filesystem::path directory = m_uiData.m_scanDirectory;
+      std::filesystem::create_directories(directory);
+      FruitMesh mesh;
+      if (m_uiData.m_scanDisplacement < 0)
+      {
+        mesh = tessellateFruitRings(getProfile(), 129, 128);
+      }
+      else
+      {
+        mesh = tessellateFruit(getProfile(), 129);
+        displaceFruitMesh(getProfile(),
+                          getFruitDisplacementPreset(static_cast<FruitType>(m_uiData.m_scanDisplacement)), 129, mesh);
+      }
+      toCograBinaryMeshFile(mesh).save((directory / (std::string(m_uiData.m_shaderName) + ".cbm")).string());
+    }
+    catch (const std::exception& e)
+    {
+      m_scanError = e.what();
+    }
+  }
+
+  void applyScanFit(const FruitProfileFit& fit)
+  {
+    m_uiData.m_firstControlPoint  = fit.profile.p0;
+    m_uiData.m_secondControlPoint = fit.profile.p1;
+    m_uiData.m_thirdControlPoint  = fit.profile.p2;
+    m_uiData.m_fourthControlPoint = fit.profile.p3;
+  }
+
+  FruitProfile getProfile() const
   {
+    return {m_uiData.m_firstControlPoint, m_uiData.m_secondControlPoint, m_uiData.m_thirdControlPoint,
+            m_uiData.m_fourthControlPoint};
+  }
+
+  size_t getNumFruits() const
+  {
+    return static_cast<size_t>(std::max(m_uiData.m_intraLevelOfDetails, 1));
+  }
+
+  //! Evaluates the growth of the fruits for this frame. The animation restarts when the profile or the number of
+  //! fruits changes, and repeats once the last fruit is ripe.
+  void animateGrowth()
+  {
+    constexpr f32 GROWTH_DELAY = 0.5f;
+    constexpr f32 RIPE_TIME    = 3.0f;
+
+    const FruitProfile profile   = getProfile();
+    const size_t       numFruits = getNumFruits();
+    if (m_growthProfile != profile || m_growthAnimation.getNumInstances() != numFruits)
+    {
+      // Bud, small fruit and ripe fruit, scaled about the origin.
+      std::vector<FruitKeyframe> keyframes;
+      for (const auto& [time, scale] : {std::pair(0.0f, 0.1f), std::pair(1.0f, 0.5f), std::pair(RIPE_TIME, 1.0f)})
+      {
+        keyframes.push_back({time, {scale * profile.p0, scale * profile.p1, scale * profile.p2, scale * profile.p3}});
+      }
+      m_growthAnimation = FruitMorphAnimation();
+      const ui32 track  = m_growthAnimation.addTrack(keyframes);
+      for (size_t i = 0; i < numFruits; i++)
+      {
+        m_growthAnimation.addInstance(track, GROWTH_DELAY * static_cast<f32>(i));
+      }
+      m_grownProfiles.resize(numFruits);
+      m_growthProfile   = profile;
+      m_growthStartTime = ImGui::GetTime();
+    }
+    const f64 period = GROWTH_DELAY * static_cast<f64>(numFruits) + RIPE_TIME + 1.0;
+    // A handful of fruits, so they are evaluated on this thread.
+    m_growthAnimation.evaluate(static_cast<f32>(std::fmod(ImGui::GetTime() - m_growthStartTime, period)), 0,
+                               numFruits, m_grownProfiles);
+  }
+
+  //! The fruits of this frame in rows of FRUITS_PER_ROW, FRUIT_INTER_DISTANCE apart along x and y. While they grow,
+  //! their profiles come from animateGrowth(). Built once per frame in onDraw() and passed on.
+  FruitInstanceArray createInstances() const
+  {
+    const FruitProfile profile   = getProfile();
+    const size_t       numFruits = getNumFruits();
+    const bool         grown     = m_uiData.m_growFruits && m_grownProfiles.getSize() == numFruits;
+    FruitInstanceArray instances;
+    instances.resize(numFruits);
+    for (size_t i = 0; i < numFruits; i++)
+    {
+      FruitInstance instance;
+      instance.profile  = grown ? m_grownProfiles.getProfile(i) : profile;
+      instance.position = FRUIT_INTER_DISTANCE *
+                          f32v3(static_cast<f32>(i % FRUITS_PER_ROW), static_cast<f32>(i / FRUITS_PER_ROW), 0.0f);
+      instance.flags    = m_uiData.m_flatShading ? FRUIT_INSTANCE_FLAT_SHADING : 0;
+      instances.setInstance(i, instance);
+    }
+    return instances;
+  }
+
+  //! Intersects the ray through the mouse cursor with the fruits. The hierarchy is only rebuilt when they change.
+  void pickFruit(const f32m4& projectionMatrix, const f32m4& viewMatrix, const FruitInstanceArray& instances)
+  {
+    // Unproject the cursor on the near and the far plane.
+    const f32m4 inverseViewProjection = glm::inverse(projectionMatrix * viewMatrix);
+    const f32v2 mouse                 = getNormalizedMouseCoordinates();
+    const f32v4 nearPoint             = inverseViewProjection * f32v4(mouse, 0.0f, 1.0f);
+    const f32v4 farPoint              = inverseViewProjection * f32v4(mouse, 1.0f, 1.0f);
+    const f32v3 origin                = f32v3(nearPoint) / nearPoint.w;
+    const f32v3 direction             = f32v3(farPoint) / farPoint.w - origin;
+
+    if (!m_sceneBVH || !(m_sceneBVHInstances == instances))
+    {
+      m_sceneBVHInstances = instances;
+      m_sceneBVH.emplace(m_sceneBVHInstances);
+    }
+    m_sceneBVH->intersect(m_sceneBVHInstances, origin, direction, 1.0f, m_pickedFruit);
+  }
+
+  //! Selects the grid size of each fruit from its projected error, or its morphable grid and morph factor when
+  //! geomorphing, with the relaxed pixel error. The bounding spheres are only recomputed when the fruits change.
+  void selectScreenSpaceLOD(const f32m4& projectionMatrix, const f32m4& viewMatrix, const FruitInstanceArray& instances)
+  {
+    const FruitBoundingSphereArray& spheres = getBoundingSpheres(instances);
+    const FruitLODSelector          selector(viewMatrix, projectionMatrix,
+                                             f32v2(static_cast<f32>(getWidth()), static_cast<f32>(getHeight())),
+                                             getPixelError(), 0.25f, MAX_GRID_SIZE);
+    if (m_uiData.m_geomorph)
+    {
+      selector.selectMorphLevels(spheres, instances.lodBiases.data(), m_morphLevels);
+    }
+    else
+    {
+      selector.select(spheres, instances.lodBiases.data(), m_selectedGridSizes);
+    }
+  }
+
+  //! Returns the pixel error target of the screen-space LOD, relaxed while geomorphing.
+  f32 getPixelError() const
+  {
+    return m_uiData.m_pixelError * (m_uiData.m_geomorph ? FRUIT_GEOMORPH_PIXEL_ERROR_SCALE : 1.0f);
+  }
+
+  //! Returns the grid size of the fruit. The screen-space LOD overrides the grid size slider. Grid sizes below 2 select
+  //! the intra LOD of calculateIntraLOD(), a single tile per fruit. With geomorphing, the screen-space LOD selects the
+  //! grids 3, 5, 9, 17, ... and morphs between them instead.
+  ui32 getGridSize(size_t fruit) const
+  {
+    if (m_uiData.m_screenSpaceLOD && m_uiData.m_geomorph && fruit < m_morphLevels.size())
+    {
+      return m_morphLevels[fruit].gridSize;
+    }
+    if (m_uiData.m_screenSpaceLOD && fruit < m_selectedGridSizes.size())
+    {
+      return m_selectedGridSizes[fruit];
+    }
+    const ui32 numFruits = static_cast<ui32>(std::min<size_t>(getNumFruits(), 128));
+    return m_uiData.m_gridSize >= 2 ? static_cast<ui32>(m_uiData.m_gridSize) : calculateIntraLOD(128 / numFruits);
+  }
+
+  //! Returns the morph factor of the fruit on the grid, 0 if the grid does not morph. Without the screen-space LOD,
+  //! the slider morphs all fruits.
+  f32 getMorphFactor(size_t fruit, ui32 gridSize) const
+  {
+    if (!m_uiData.m_geomorph || !isFruitGridMorphable(gridSize))
+    {
+      return 0.0f;
+    }
+    if (m_uiData.m_screenSpaceLOD)
+    {
+      return fruit < m_morphLevels.size() ? m_morphLevels[fruit].morphFactor : 0.0f;
+    }
+    return m_uiData.m_morphFactor;
+  }
+
+  //! Sets the grid and morph factor of each fruit for this frame; uploadTileBounds() adds where its tile bounds start.
+  void selectGridSizes(size_t numFruits)
+  {
+    m_instanceLODs.resize(numFruits);
+    for (size_t i = 0; i < numFruits; i++)
+    {
+      m_instanceLODs[i].gridSize    = getGridSize(i);
+      m_instanceLODs[i].morphFactor = getMorphFactor(i, m_instanceLODs[i].gridSize);
+    }
+  }
+
+  //! Returns the tiling of the finest grid of this frame.
+  FruitTiling getTiling() const
+  {
+    ui32 gridSize = m_instanceLODs.empty() ? getGridSize(0) : 2;
+    for (const FruitInstanceLOD& lod : m_instanceLODs)
+    {
+      gridSize = std::max(gridSize, lod.gridSize);
+    }
+    return planFruitTiling(gridSize);
+  }
+
+  //! Emulates the per-primitive culling of MS_main for all fruits, each with its own profile and grid.
+  void emulatePrimitiveCulling(const f32m4& projectionMatrix, const f32m4& viewMatrix,
+                               const FruitInstanceArray& instances)
+  {
+    const f32v2 viewportSize(static_cast<f32>(getWidth()), static_cast<f32>(getHeight()));
+    m_primitiveCullingStats = {};
+    emulateFruitPrimitiveCulling(instances, m_instanceLODs, projectionMatrix * viewMatrix, viewportSize,
+                                 m_primitiveCullingStats);
+  }
+
+  //! \param cullPrimitives Compiles the shaders with FRUIT_CULL_PRIMITIVES into m_primitiveCullingPipelineState.
+  void createPipeline(bool cullPrimitives)
+  {
+    std::vector<const wchar_t*> defines;
+    if (cullPrimitives)
+    {
+      defines = {L"-D", L"FRUIT_CULL_PRIMITIVES"};
+    }
+    const auto amplificationShader = compileShader(
+        L"../../../assignments/AXFruitsGenerator/shaders/Fruits.hlsl", L"AS_main", L"as_6_5", defines);
     const auto meshShader = compileShader(
-        L"../../../assignments/AXFruitsGenerator/shaders/Fruits.hlsl", L"MS_main", L"ms_6_5");
+        L"../../../assignments/AXFruitsGenerator/shaders/Fruits.hlsl", L"MS_main", L"ms_6_5", defines);
     const auto pixelShader = compileShader(
-        L"../../../assignments/AXFruitsGenerator/shaders/Fruits.hlsl", L"PS_main", L"ps_6_5");
+        L"../../../assignments/AXFruitsGenerator/shaders/Fruits.hlsl", L"PS_main", L"ps_6_5", defines);
 
     D3DX12_MESH_SHADER_PIPELINE_STATE_DESC psoDesc = {};
     psoDesc.pRootSignature                         = m_rootSignature.Get();
+    psoDesc.AS                                     = HLSLCompiler::convert(amplificationShader);
     psoDesc.MS                                     = HLSLCompiler::convert(meshShader);
     psoDesc.PS                                     = HLSLCompiler::convert(pixelShader);
     psoDesc.RasterizerState                        = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
@@ -291,7 +780,8 @@ float4 PS_main(MeshShaderOutput input)
     streamDesc.pPipelineStateSubobjectStream = &psoStream;
     streamDesc.SizeInBytes                   = sizeof(psoStream);
 
-    throwIfFailed(getDevice()->CreatePipelineState(&streamDesc, IID_PPV_ARGS(&m_pipelineState)));
+    throwIfFailed(getDevice()->CreatePipelineState(
+        &streamDesc, IID_PPV_ARGS(cullPrimitives ? &m_primitiveCullingPipelineState : &m_pipelineState)));
 
     std::cout << "Pipeline created successfully!" << std::endl;
   }
@@ -303,7 +793,10 @@ public:
   {
     m_examinerController.setTranslationVector(f32v3(0.0f, 0.0f, 3.0f));
     createRootSignature();
-    createPipeline();
+    createPipeline(false);
+    createPipeline(true);
+    createInstanceBuffers(FRUITS_PER_ROW);
+    createTileBoundsBuffers();
   }
 
   void checkForMeshShaderSupport()
@@ -351,42 +844,148 @@ public:
         glm::perspectiveFovLH_ZO<f32>(glm::radians(45.0f), (f32)getWidth(), (f32)getHeight(), 0.0001f, 10000.0f);
     const auto viewMatrix = m_examinerController.getTransformationMatrix();
 
-    commandList->SetPipelineState(m_pipelineState.Get());
+    if (m_uiData.m_growFruits)
+    {
+      animateGrowth();
+    }
+    const FruitInstanceArray instances = createInstances();
+    if (!ImGui::GetIO().WantCaptureMouse && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left))
+    {
+      pickFruit(projectionMatrix, viewMatrix, instances);
+    }
+    if (m_uiData.m_screenSpaceLOD)
+    {
+      selectScreenSpaceLOD(projectionMatrix, viewMatrix, instances);
+    }
+    selectGridSizes(instances.getSize());
+    if (m_emulatePrimitiveCulling)
+    {
+      emulatePrimitiveCulling(projectionMatrix, viewMatrix, instances);
+      m_emulatePrimitiveCulling = false;
+    }
+
+    uploadTileBounds(instances);
+    uploadInstances(instances);
+
+    commandList->SetPipelineState(m_uiData.m_cullPrimitives ? m_primitiveCullingPipelineState.Get()
+                                                            : m_pipelineState.Get());
     commandList->SetGraphicsRootSignature(m_rootSignature.Get());
 
     commandList->SetGraphicsRoot32BitConstants(0, 16, &viewMatrix, 0);
     commandList->SetGraphicsRoot32BitConstants(0, 16, &projectionMatrix, 16);
 
-    f32v4 p0 = f32v4(m_uiData.m_firstControlPoint, 0.0f);
-    f32v4 p1 = f32v4(m_uiData.m_secondControlPoint, 0.0f);
-    f32v4 p2 = f32v4(m_uiData.m_thirdControlPoint, 0.0f);
-    f32v4 p3 = f32v4(m_uiData.m_fourthControlPoint, m_uiData.m_flatShading);
-    commandList->SetGraphicsRoot32BitConstants(0, 4, &p0, 32);
-    commandList->SetGraphicsRoot32BitConstants(0, 4, &p1, 36);
-    commandList->SetGraphicsRoot32BitConstants(0, 4, &p2, 40);
-    commandList->SetGraphicsRoot32BitConstants(0, 4, &p3, 44);
-
-    commandList->SetGraphicsRoot32BitConstants(0, 1, &m_uiData.m_intraLevelOfDetails, 48);
-
-    commandList->DispatchMesh(1, 1, 1);
+    // One amplification shader group per AS_GROUP_SIZE tiles of the finest grid for each instance.
+    const FruitTiling tiling            = getTiling();
+    const ui32        groupsPerInstance = (tiling.getNumTiles() + AS_GROUP_SIZE - 1) / AS_GROUP_SIZE;
+    const ui32        cullTiles         = m_uiData.m_cullTiles ? 1 : 0;
+    countVisible(projectionMatrix, viewMatrix, instances);
+    commandList->SetGraphicsRoot32BitConstants(0, 1, &groupsPerInstance, 32);
+    commandList->SetGraphicsRoot32BitConstants(0, 1, &cullTiles, 33);
+    const f32v2 viewportSize(static_cast<f32>(getWidth()), static_cast<f32>(getHeight()));
+    commandList->SetGraphicsRoot32BitConstants(0, 2, &viewportSize, 34);
+    commandList->SetGraphicsRootShaderResourceView(1, m_instanceBuffer->GetGPUVirtualAddress());
+    commandList->SetGraphicsRootShaderResourceView(2, m_tileBoundsBuffers[getFrameIndex()]->GetGPUVirtualAddress());
+    const ui32 numGroups = static_cast<ui32>(instances.getSize()) * groupsPerInstance;
+    for (ui32 firstGroup = 0; firstGroup < numGroups; firstGroup += MAX_DISPATCH_GROUPS)
+    {
+      commandList->SetGraphicsRoot32BitConstants(0, 1, &firstGroup, 36);
+      commandList->DispatchMesh(std::min(numGroups - firstGroup, MAX_DISPATCH_GROUPS), 1, 1);
+    }
   }
 
   virtual void onDrawUI()
   {
     ImGui::Begin("Information");
     ImGui::Text("Frame time: %f", 1.0f / ImGui::GetIO().Framerate * 1000.0f);
+    const FruitProfile profile = getProfile();
+    if (m_forwardDifferencingProfile != profile)
+    {
+      m_forwardDifferencingError   = measureForwardDifferencingError(profile, 256);
+      m_forwardDifferencingProfile = profile;
+    }
+    const ForwardDifferencingError& error = m_forwardDifferencingError;
+    ImGui::Text("Forward differencing error (max/rms): %.2e / %.2e", error.forwardDifferencingMaxError,
+                error.forwardDifferencingRmsError);
+    ImGui::Text("Direct evaluation error (max/rms): %.2e / %.2e", error.directMaxError, error.directRmsError);
+    const FruitTiling tiling = getTiling();
+    ImGui::Text("Finest grid %u x %u, %u tiles, %u triangles per fruit", tiling.gridSize, tiling.gridSize,
+                tiling.getNumTiles(), tiling.getNumTriangles());
+    ImGui::Text("Instance records uploaded: %zu", m_instanceBufferBuilder.getNumChangedRecords());
+    ImGui::Text("Visible (CPU reference): %zu of %zu fruits, %zu of %zu tiles", m_numVisibleFruits,
+                m_instanceBufferBuilder.getRecords().size(), m_numVisibleTiles, m_numTiles);
+    if (m_pickedFruit.instance != FruitSceneHit::NO_INSTANCE)
+    {
+      ImGui::Text("Picked fruit %zu at %s (t = %.3f)", m_pickedFruit.instance,
+                  FormatFloat3(m_pickedFruit.position).c_str(), m_pickedFruit.t);
+    }
+    else
+    {
+      ImGui::Text("Double click a fruit to pick it.");
+    }
     ImGui::End();
     ImGui::Begin("Configuration");
     ImGui::ColorEdit3("Background Color", &m_uiData.m_backgroundColor[0]);
-    ImGui::SliderInt("Inter Level of Detail", &m_uiData.m_intraLevelOfDetails, 1, 28);
+    ImGui::InputInt("Fruits", &m_uiData.m_intraLevelOfDetails);
+    ImGui::SliderInt("Grid Size (0 = automatic)", &m_uiData.m_gridSize, 0, static_cast<i32>(MAX_GRID_SIZE));
+    ImGui::Checkbox("Screen-Space LOD", &m_uiData.m_screenSpaceLOD);
+    ImGui::SliderFloat("Pixel Error", &m_uiData.m_pixelError, 0.25f, 8.0f);
+    if (m_uiData.m_screenSpaceLOD && m_uiData.m_geomorph)
+      ImGui::Text("Relaxed to %.2f pixels while geomorphing", getPixelError());
+    ImGui::Checkbox("Geomorph (grids 4 m + 1)", &m_uiData.m_geomorph);
+    ImGui::SliderFloat("Morph Factor", &m_uiData.m_morphFactor, 0.0f, 1.0f);
     ImGui::Checkbox("Flat Shading", &m_uiData.m_flatShading);
+    ImGui::Checkbox("Grow Fruits", &m_uiData.m_growFruits);
+    ImGui::Checkbox("Cull Tiles", &m_uiData.m_cullTiles);
+    ImGui::Checkbox("Cull Primitives", &m_uiData.m_cullPrimitives);
+    if (ImGui::Button("Emulate Primitive Culling"))
+      m_emulatePrimitiveCulling = true;
+    ImGui::Text("Culled of %zu triangles: %zu zero area, %zu backfacing, %zu too small",
+                m_primitiveCullingStats.numTriangles, m_primitiveCullingStats.numZeroArea,
+                m_primitiveCullingStats.numBackfacing, m_primitiveCullingStats.numTooSmall);
+    const FruitMeshCache& meshCache = FruitMeshCache::getDefault();
+    ImGui::Text("Mesh cache: %zu meshes, %zu KB, %llu hits, %llu misses", meshCache.getNumEntries(),
+                meshCache.getSizeInBytes() / 1024, meshCache.getNumHits(), meshCache.getNumMisses());
     ImGui::SliderFloat3("First Control Point", &m_uiData.m_firstControlPoint.x, -5, 5);
     ImGui::SliderFloat3("Second Control Point", &m_uiData.m_secondControlPoint.x, -5, 5);
     ImGui::SliderFloat3("Third Control Point", &m_uiData.m_thirdControlPoint.x, -5, 5);
     ImGui::SliderFloat3("Foruth Control Point", &m_uiData.m_fourthControlPoint.x, -5, 5);
+    if (ImGui::Button("Benchmark Distance Field"))
+      m_distanceFieldBenchmark = benchmarkFruitDistanceField(profile, 1 << 20);
+    ImGui::Text("Distance field error (max/rms): %.2e / %.2e, %.1f M queries/s", m_distanceFieldBenchmark.maxError,
+                m_distanceFieldBenchmark.rmsError, m_distanceFieldBenchmark.queriesPerSecond * 1e-6);
     ImGui::InputText("Shader Name", m_uiData.m_shaderName, 100);
     if (ImGui::Button("Save Shader"))
       generateShaderFile();
+    if (ImGui::Button("Measure Compact Output Error"))
+      m_compactOutputError = measureFruitCompactOutputError(
+          glm::perspectiveFovLH_ZO<f32>(glm::radians(45.0f), (f32)getWidth(), (f32)getHeight(), 0.0001f, 10000.0f),
+          f32v2(static_cast<f32>(getWidth()), static_cast<f32>(getHeight())), 0.5f, 50.0f, 1 << 20);
+    ImGui::Text("Compact output error: direction %.1e, position %.1e, view direction %.1e, interpolation %.1e",
+                m_compactOutputError.maxDirectionError, m_compactOutputError.maxPositionError,
+                m_compactOutputError.maxViewDirectionError, m_compactOutputError.maxInterpolationAngle);
+    ImGui::End();
+    ImGui::Begin("Scans");
+    ImGui::InputText("Scan Directory", m_uiData.m_scanDirectory, 260);
+    if (ImGui::Button("Fit Scans"))
+      fitScans();
+    ImGui::RadioButton("Smooth", &m_uiData.m_scanDisplacement, -1);
+    for (i32 type = 0; type < static_cast<i32>(FruitType::Count); type++)
+    {
+      ImGui::SameLine();
+      ImGui::RadioButton(getFruitPreset(static_cast<FruitType>(type)).name, &m_uiData.m_scanDisplacement, type);
+    }
+    if (ImGui::Button("Save Profile as Scan"))
+      saveProfileAsScan();
+    if (!m_scanError.empty())
+      ImGui::TextWrapped("%s", m_scanError.c_str());
+    for (i32 i = 0; i < static_cast<i32>(m_scanFits.size()); i++)
+    {
+      const FruitScanFit& scanFit = m_scanFits[i];
+      const std::string   label   = std::format("{} (Hausdorff {:.4f}, RMS {:.4f})", scanFit.file.stem().string(),
+                                                  scanFit.fit.hausdorffError, scanFit.fit.rmsError);
+      if (ImGui::RadioButton(label.c_str(), &m_uiData.m_selectedScan, i))
+        applyScanFit(scanFit.fit);
+    }
     ImGui::End();
   }
 };
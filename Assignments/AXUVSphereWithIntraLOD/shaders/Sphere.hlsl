@@ -36,7 +36,7 @@ void MS_main(
     out indices uint3 triangleIndices[MAX_NUM_TRIANGLES]
 )
 {
-    SetMeshOutputCounts(121, 242);
+    SetMeshOutputCounts(NUM_THREADS_X * NUM_THREADS_Y, 2 * (NUM_THREADS_X - 1) * (NUM_THREADS_Y - 1));
     if ((threadIdInsideItsGroup.x < NUM_THREADS_X) && (threadIdInsideItsGroup.y < NUM_THREADS_Y))
     {
         uint xIndex = threadGoupId.x * (NUM_THREADS_X) + threadIdInsideItsGroup.x - threadGoupId.x;
@@ -55,8 +55,8 @@ void MS_main(
             uint secondVertexId = firstVertexId + 1;
             uint thirdVertexId = firstVertexId + NUM_THREADS_X;
             uint fourthVertexId = secondVertexId + NUM_THREADS_X;
-            triangleIndices[(threadIdInsideItsGroup.x + threadIdInsideItsGroup.y * NUM_THREADS_X) * 2] = uint3(firstVertexId, secondVertexId, fourthVertexId).xzy;
-            triangleIndices[(threadIdInsideItsGroup.x + threadIdInsideItsGroup.y * NUM_THREADS_X) * 2 + 1] = uint3(fourthVertexId, thirdVertexId, firstVertexId).xzy;
+            triangleIndices[(threadIdInsideItsGroup.x + threadIdInsideItsGroup.y * (NUM_THREADS_X - 1)) * 2] = uint3(firstVertexId, secondVertexId, fourthVertexId).xzy;
+            triangleIndices[(threadIdInsideItsGroup.x + threadIdInsideItsGroup.y * (NUM_THREADS_X - 1)) * 2 + 1] = uint3(fourthVertexId, thirdVertexId, firstVertexId).xzy;
 
         }
     }
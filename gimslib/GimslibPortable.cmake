@@ -0,0 +1,55 @@
+# The platform independent part of gimslib: no Direct3D, no Windows API. The tools and tests link it, so they also
+# build and run on Linux. Included by their CMakeLists.txt, it defines the static library gimslibPortable once.
+if(NOT TARGET gimslibPortable)
+  set(gimslibPortable_SOURCE
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/emu/MeshShaderEmulator.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/emu/MeshShaderKernels.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitCompactOutput.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitCulling.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitDisplacement.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitDistanceField.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitGeomorph.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitImpostor.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitInstance.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitInstanceBuffer.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitInstanceCatalog.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitLODSelector.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitMeasures.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitMeshCache.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitMorphAnimation.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitPresets.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitProfile.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitProfileArray.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitProfileFitter.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitRayIntersector.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitSceneBVH.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitSurfaceSampler.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitTessellator.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitTiling.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/fruit/FruitTopology.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/io/CograBinaryMeshFile.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/io/ShaderCache.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/io/Sha256.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/mesh/SphereTessellationBenchmark.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/mesh/SubdividedOctasphere.cpp"
+						"${CMAKE_CURRENT_LIST_DIR}/src/gimslib/sys/ThreadPool.cpp"
+     )
+
+  add_library(gimslibPortable STATIC ${gimslibPortable_SOURCE})
+  target_include_directories(gimslibPortable PUBLIC "${CMAKE_CURRENT_LIST_DIR}/include")
+  if(WIN32)
+    target_compile_definitions(gimslibPortable PRIVATE NOMINMAX WIN32_LEAN_AND_MEAN)
+  endif()
+  # No fused multiply-adds, as for gimslib; PUBLIC, so that the tests compare against the same arithmetic.
+  if(MSVC)
+    target_compile_options(gimslibPortable PUBLIC /fp:precise)
+  else()
+    target_compile_options(gimslibPortable PUBLIC -ffp-contract=off)
+  endif()
+
+  find_package(glm CONFIG REQUIRED)
+  find_package(Threads REQUIRED)
+  target_link_libraries(gimslibPortable PUBLIC glm::glm Threads::Threads)
+
+  set_target_properties (gimslibPortable PROPERTIES FOLDER gimslib)
+endif()
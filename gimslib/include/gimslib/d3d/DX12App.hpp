@@ -35,6 +35,8 @@ struct DX12AppConfig
   DXGI_FORMAT       renderTargetFormat = DXGI_FORMAT_R8G8B8A8_UNORM; //! Format for frames.
   DXGI_FORMAT       depthBufferFormat  = DXGI_FORMAT_D32_FLOAT;      //! Format for depth buffer.
   bool              useVSync           = true;                       //! True, to enable vertical synchronization.
+  std::wstring      shaderCache        = L"ShaderCache";             //! Shader cache directory, empty to disable.
+  ui64              shaderCacheBudget  = 256ull << 20;               //! Maximum size of the shader cache in bytes.
 };
 
 namespace impl
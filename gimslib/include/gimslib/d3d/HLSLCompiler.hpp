@@ -2,6 +2,8 @@
 #include <d3dx12/d3dx12.h>
 #include <dxcapi.h>
 #include <filesystem>
+#include <gimslib/io/ShaderCache.hpp>
+#include <optional>
 #include <wrl.h>
 using Microsoft::WRL::ComPtr;
 
@@ -10,7 +12,10 @@ namespace gims
 class HLSLCompiler
 {
 public:
-  HLSLCompiler();
+  //! \brief Constructor.
+  //! \param cacheDirectory Directory of the persistent cache of compiled shaders. Empty to disable the cache.
+  //! \param cacheByteBudget Maximum size of the cache.
+  HLSLCompiler(const std::filesystem::path& cacheDirectory = {}, ui64 cacheByteBudget = 0);
 
   ComPtr<IDxcBlob> compileShader(const std::filesystem::path& shaderFile, const wchar_t* targetProfile,
                                  const wchar_t*              entryPoint,
@@ -18,10 +23,16 @@ public:
 
   static D3D12_SHADER_BYTECODE convert(ComPtr<IDxcBlob> in);
 
+  //! \brief Returns the cache of compiled shaders, or nullptr if it is disabled.
+  //! DX12App::run() logs its counters to the debugger output when the app quits.
+  const ShaderCache* getShaderCache() const;
+
 
 private:
   ComPtr<IDxcUtils>          m_utils;
   ComPtr<IDxcCompiler3>      m_compiler;  
   ComPtr<IDxcIncludeHandler> m_includeHandler;
+  std::string                m_compilerVersion;
+  std::optional<ShaderCache> m_shaderCache;
 };
 } // namespace gims
\ No newline at end of file
@@ -0,0 +1,388 @@
+#pragma once
+#include <algorithm>
+#include <gimslib/sys/ParallelFor.hpp>
+#include <gimslib/types.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gims
+{
+//! \brief Limits of a mesh shader group and a dispatch in D3D12.
+struct MeshShaderLimits
+{
+  static constexpr ui32 MAX_THREADS           = 128;
+  static constexpr ui32 MAX_VERTICES          = 256;
+  static constexpr ui32 MAX_PRIMITIVES        = 256;
+  static constexpr ui32 MAX_GROUPS_PER_AXIS   = 65535;
+  static constexpr ui32 MAX_GROUPS            = 1 << 22;
+  static constexpr ui32 MAX_PAYLOAD_BYTES     = 16384;
+  static constexpr ui32 MAX_GROUPSHARED_BYTES = 28672;
+};
+
+//! \brief The attributes of a kernel that HLSL declares in its signature.
+struct MeshShaderLayout
+{
+  //! numthreads(x, y, z).
+  ui32v3 numThreads             = ui32v3(1, 1, 1);
+  //! Sizes of the vertices and indices output arrays.
+  ui32   maxVertices            = 0;
+  ui32   maxPrimitives          = 0;
+  //! True if the kernel declares a primitives output array.
+  bool   hasPrimitiveAttributes = false;
+  //! One more than the number of GroupMemoryBarrierWithGroupSync() calls.
+  ui32   numPhases              = 1;
+
+  ui32 getNumThreads() const;
+};
+
+//! \brief The system values of one thread.
+struct MeshShaderThread
+{
+  ui32v3 groupThreadId; //!< SV_GroupThreadID
+  ui32v3 groupId;       //!< SV_GroupID
+  ui32   groupIndex;    //!< SV_GroupIndex
+  //! The part of the kernel to run: barriers passed so far.
+  ui32   phase;
+};
+
+//! \brief Output, payload and groupshared types of kernels that have none.
+struct MeshShaderNoPrimitive
+{
+};
+struct MeshShaderNoPayload
+{
+};
+struct MeshShaderNoGroupShared
+{
+};
+
+//! \brief Outputs and errors of one or more groups.
+//!
+//! Errors are counted per output element, i.e., 3 unwritten vertices are 3 errors. firstError describes the first of
+//! them in group order.
+struct MeshShaderDispatchStats
+{
+  size_t numGroups             = 0;
+  //! Sums of the counts of SetMeshOutputCounts().
+  size_t numVertices           = 0;
+  size_t numPrimitives         = 0;
+  ui32   maxVerticesPerGroup   = 0;
+  ui32   maxPrimitivesPerGroup = 0;
+  //! Bytes of the C++ output structs and of the indices, 12 per primitive.
+  size_t numOutputBytes        = 0;
+
+  //! SetMeshOutputCounts() beyond the output arrays, or called again with different counts.
+  size_t numInvalidCounts       = 0;
+  //! Writes before SetMeshOutputCounts().
+  size_t numEarlyWrites         = 0;
+  //! Writes past the counts of SetMeshOutputCounts().
+  size_t numOutOfRangeWrites    = 0;
+  size_t numUnwrittenVertices   = 0;
+  //! Primitives whose indices or, if declared, attributes were not written.
+  size_t numUnwrittenPrimitives = 0;
+  //! Indices of a vertex past the vertex count.
+  size_t numOutOfRangeIndices   = 0;
+
+  std::string firstError;
+
+  //! Primitives that use a vertex twice. Valid output, but rarely intended.
+  size_t numDegeneratePrimitives = 0;
+
+  size_t getNumErrors() const;
+
+  //! \brief Adds the counts of other; keeps firstError if it is set.
+  void add(const MeshShaderDispatchStats& other);
+
+  //! \brief Counts one error and records its message if it is the first one.
+  void addError(size_t& counter, const ui32v3& groupId, const std::string& message);
+};
+
+//! \brief The output arrays of one group, filled through MeshShaderOutputs.
+template<class Vertex, class Primitive = MeshShaderNoPrimitive> struct MeshShaderGroupOutput
+{
+  ui32v3                 groupId = ui32v3(0);
+  std::vector<Vertex>    vertices;
+  std::vector<ui32v3>    indices;
+  //! Empty unless the kernel declares primitive attributes.
+  std::vector<Primitive> primitives;
+};
+
+//! \brief The outputs of one group as seen by its kernel: SetMeshOutputCounts() and the vertices, indices and
+//! primitives arrays. Each write is checked against the counts; the checks of the whole group run in finish().
+template<class Vertex, class Primitive = MeshShaderNoPrimitive> class MeshShaderOutputs
+{
+public:
+  MeshShaderOutputs(const MeshShaderLayout& layout, const ui32v3& groupId)
+      : m_layout(layout)
+  {
+    m_output.groupId = groupId;
+    m_stats.numGroups++;
+  }
+
+  //! \brief SetMeshOutputCounts(numVertices, numPrimitives). HLSL executes it once per group, so calls of several
+  //! threads must agree. Counts beyond the output arrays are clamped to them after counting the error once.
+  void setMeshOutputCounts(ui32 numVertices, ui32 numPrimitives)
+  {
+    if (m_countsSet)
+    {
+      if (numVertices != m_requestedCounts.x || numPrimitives != m_requestedCounts.y)
+      {
+        m_stats.addError(m_stats.numInvalidCounts, m_output.groupId, "SetMeshOutputCounts called with other counts");
+      }
+      return;
+    }
+    m_requestedCounts = ui32v2(numVertices, numPrimitives);
+    if (numVertices > m_layout.maxVertices || numPrimitives > m_layout.maxPrimitives)
+    {
+      m_stats.addError(m_stats.numInvalidCounts, m_output.groupId, "SetMeshOutputCounts exceeds the output arrays");
+      numVertices   = std::min(numVertices, m_layout.maxVertices);
+      numPrimitives = std::min(numPrimitives, m_layout.maxPrimitives);
+    }
+    m_countsSet = true;
+    m_output.vertices.resize(numVertices);
+    m_output.indices.resize(numPrimitives);
+    m_vertexWritten.assign(numVertices, false);
+    m_indicesWritten.assign(numPrimitives, false);
+    if (m_layout.hasPrimitiveAttributes)
+    {
+      m_output.primitives.resize(numPrimitives);
+      m_primitiveWritten.assign(numPrimitives, false);
+    }
+  }
+
+  void setVertex(ui32 i, const Vertex& vertex)
+  {
+    if (checkWrite(i, m_layout.maxVertices, m_output.vertices.size(), "vertex"))
+    {
+      m_output.vertices[i] = vertex;
+      m_vertexWritten[i]   = true;
+    }
+  }
+
+  void setIndices(ui32 i, const ui32v3& indices)
+  {
+    if (checkWrite(i, m_layout.maxPrimitives, m_output.indices.size(), "indices"))
+    {
+      m_output.indices[i] = indices;
+      m_indicesWritten[i] = true;
+    }
+  }
+
+  void setPrimitive(ui32 i, const Primitive& primitive)
+  {
+    if (!m_layout.hasPrimitiveAttributes)
+    {
+      throw std::logic_error("The kernel declares no primitive attributes.");
+    }
+    if (checkWrite(i, m_layout.maxPrimitives, m_output.primitives.size(), "primitive"))
+    {
+      m_output.primitives[i] = primitive;
+      m_primitiveWritten[i]  = true;
+    }
+  }
+
+  //! \brief Checks that every output up to the counts was written and every index refers to a vertex, and returns
+  //! the outputs. Unwritten outputs are value-initialized.
+  MeshShaderGroupOutput<Vertex, Primitive> finish(MeshShaderDispatchStats& stats)
+  {
+    const ui32 numVertices   = static_cast<ui32>(m_output.vertices.size());
+    const ui32 numPrimitives = static_cast<ui32>(m_output.indices.size());
+    for (ui32 i = 0; i < numVertices; i++)
+    {
+      if (!m_vertexWritten[i])
+      {
+        m_stats.addError(m_stats.numUnwrittenVertices, m_output.groupId, "vertex " + std::to_string(i) + " unwritten");
+      }
+    }
+    for (ui32 i = 0; i < numPrimitives; i++)
+    {
+      if (!m_indicesWritten[i] || (m_layout.hasPrimitiveAttributes && !m_primitiveWritten[i]))
+      {
+        m_stats.addError(m_stats.numUnwrittenPrimitives, m_output.groupId,
+                         "primitive " + std::to_string(i) + " unwritten");
+        continue;
+      }
+      const ui32v3& t = m_output.indices[i];
+      if (t.x >= numVertices || t.y >= numVertices || t.z >= numVertices)
+      {
+        m_stats.addError(m_stats.numOutOfRangeIndices, m_output.groupId,
+                         "primitive " + std::to_string(i) + " indexes a vertex past the count");
+      }
+      else if (t.x == t.y || t.y == t.z || t.z == t.x)
+      {
+        m_stats.numDegeneratePrimitives++;
+      }
+    }
+
+    m_stats.numVertices += numVertices;
+    m_stats.numPrimitives += numPrimitives;
+    m_stats.numOutputBytes += numVertices * sizeof(Vertex) + numPrimitives * sizeof(ui32v3);
+    if (m_layout.hasPrimitiveAttributes)
+    {
+      m_stats.numOutputBytes += numPrimitives * sizeof(Primitive);
+    }
+    m_stats.maxVerticesPerGroup   = numVertices;
+    m_stats.maxPrimitivesPerGroup = numPrimitives;
+    stats.add(m_stats);
+    return std::move(m_output);
+  }
+
+private:
+  bool checkWrite(ui32 i, ui32 arraySize, size_t count, const char* what)
+  {
+    if (i >= arraySize)
+    {
+      // Out of bounds of the HLSL array; the compiler rejects constant indices, the GPU drops the others.
+      m_stats.addError(m_stats.numOutOfRangeWrites, m_output.groupId,
+                       std::string(what) + " " + std::to_string(i) + " written past the output array");
+      return false;
+    }
+    if (!m_countsSet)
+    {
+      m_stats.addError(m_stats.numEarlyWrites, m_output.groupId,
+                       std::string(what) + " " + std::to_string(i) + " written before SetMeshOutputCounts");
+      return false;
+    }
+    if (i >= count)
+    {
+      m_stats.addError(m_stats.numOutOfRangeWrites, m_output.groupId,
+                       std::string(what) + " " + std::to_string(i) + " written past the count");
+      return false;
+    }
+    return true;
+  }
+
+  MeshShaderLayout                         m_layout;
+  MeshShaderGroupOutput<Vertex, Primitive> m_output;
+  MeshShaderDispatchStats                  m_stats;
+  bool                                     m_countsSet       = false;
+  ui32v2                                   m_requestedCounts = ui32v2(0);
+  std::vector<bool>                        m_vertexWritten;
+  std::vector<bool>                        m_indicesWritten;
+  std::vector<bool>                        m_primitiveWritten;
+};
+
+//! \brief Declares the types a kernel uses; kernels derive from it.
+template<class VertexType, class PrimitiveType = MeshShaderNoPrimitive, class PayloadType = MeshShaderNoPayload,
+         class GroupSharedType = MeshShaderNoGroupShared>
+struct MeshShaderKernelTypes
+{
+  using Vertex      = VertexType;
+  using Primitive   = PrimitiveType;
+  using Payload     = PayloadType;
+  using GroupShared = GroupSharedType;
+  using Outputs     = MeshShaderOutputs<VertexType, PrimitiveType>;
+};
+
+//! \brief The groups launched by one DispatchMesh(), from the API or from an amplification shader group.
+template<class Payload> struct MeshShaderLaunch
+{
+  Payload payload   = {};
+  ui32v3  numGroups = ui32v3(1, 1, 1);
+};
+
+template<class Vertex, class Primitive = MeshShaderNoPrimitive> struct MeshShaderDispatch
+{
+  //! In launch order, then in the order of the groups' flattened ids, x fastest.
+  std::vector<MeshShaderGroupOutput<Vertex, Primitive>> groups;
+  MeshShaderDispatchStats                               stats;
+};
+
+//! \brief Runs one group: all threads of phase 0 in SV_GroupIndex order, then all of phase 1, and so on, so the
+//! phases see each other's groupshared writes as after GroupMemoryBarrierWithGroupSync(). Within a phase, threads
+//! run one after the other; kernels whose threads communicate without a barrier are not emulated faithfully.
+//!
+//! A kernel is a MeshShaderKernelTypes with
+//!   MeshShaderLayout getLayout() const;
+//!   void operator()(const MeshShaderThread&, const Payload&, GroupShared&, Outputs&) const;
+template<class Kernel>
+MeshShaderGroupOutput<typename Kernel::Vertex, typename Kernel::Primitive>
+executeMeshShaderGroup(const Kernel& kernel, const MeshShaderLayout& layout, const typename Kernel::Payload& payload,
+                       const ui32v3& groupId, MeshShaderDispatchStats& stats)
+{
+  typename Kernel::GroupShared shared = {};
+  typename Kernel::Outputs     outputs(layout, groupId);
+  for (ui32 phase = 0; phase < layout.numPhases; phase++)
+  {
+    for (ui32 index = 0; index < layout.getNumThreads(); index++)
+    {
+      const ui32 x = index % layout.numThreads.x;
+      const ui32 y = index / layout.numThreads.x % layout.numThreads.y;
+      const ui32 z = index / (layout.numThreads.x * layout.numThreads.y);
+      kernel(MeshShaderThread {ui32v3(x, y, z), groupId, index, phase}, payload, shared, outputs);
+    }
+  }
+  return outputs.finish(stats);
+}
+
+//! \brief Emulates the launches on all hardware threads, GROUPS_PER_TASK groups per task.
+//! \throws std::invalid_argument if the layout or a launch exceeds the limits of D3D12.
+template<class Kernel>
+MeshShaderDispatch<typename Kernel::Vertex, typename Kernel::Primitive>
+dispatchMeshShader(const Kernel& kernel, const std::vector<MeshShaderLaunch<typename Kernel::Payload>>& launches)
+{
+  static_assert(sizeof(typename Kernel::Payload) <= MeshShaderLimits::MAX_PAYLOAD_BYTES);
+  static_assert(sizeof(typename Kernel::GroupShared) <= MeshShaderLimits::MAX_GROUPSHARED_BYTES);
+  constexpr size_t GROUPS_PER_TASK = 64;
+
+  const MeshShaderLayout layout = kernel.getLayout();
+  if (layout.getNumThreads() == 0 || layout.getNumThreads() > MeshShaderLimits::MAX_THREADS ||
+      layout.maxVertices > MeshShaderLimits::MAX_VERTICES || layout.maxPrimitives > MeshShaderLimits::MAX_PRIMITIVES ||
+      layout.numPhases == 0)
+  {
+    throw std::invalid_argument("The kernel layout exceeds the limits of a mesh shader group.");
+  }
+
+  // The launch and group id of every group.
+  std::vector<std::pair<size_t, ui32v3>> groups;
+  for (size_t launch = 0; launch < launches.size(); launch++)
+  {
+    const ui32v3& n = launches[launch].numGroups;
+    if (std::max({n.x, n.y, n.z}) > MeshShaderLimits::MAX_GROUPS_PER_AXIS ||
+        static_cast<ui64>(n.x) * n.y * n.z > MeshShaderLimits::MAX_GROUPS)
+    {
+      throw std::invalid_argument("The launch exceeds the number of groups of DispatchMesh().");
+    }
+    for (ui32 z = 0; z < n.z; z++)
+    {
+      for (ui32 y = 0; y < n.y; y++)
+      {
+        for (ui32 x = 0; x < n.x; x++)
+        {
+          groups.emplace_back(launch, ui32v3(x, y, z));
+        }
+      }
+    }
+  }
+
+  MeshShaderDispatch<typename Kernel::Vertex, typename Kernel::Primitive> result;
+  result.groups.resize(groups.size());
+  const size_t                         numTasks = (groups.size() + GROUPS_PER_TASK - 1) / GROUPS_PER_TASK;
+  std::vector<MeshShaderDispatchStats> taskStats(numTasks);
+  parallelFor(numTasks,
+              [&](size_t task)
+              {
+                const size_t last = std::min(groups.size(), (task + 1) * GROUPS_PER_TASK);
+                for (size_t i = task * GROUPS_PER_TASK; i < last; i++)
+                {
+                  result.groups[i] = executeMeshShaderGroup(kernel, layout, launches[groups[i].first].payload,
+                                                            groups[i].second, taskStats[task]);
+                }
+              });
+  for (const MeshShaderDispatchStats& stats : taskStats)
+  {
+    result.stats.add(stats);
+  }
+  return result;
+}
+
+//! \brief Emulates DispatchMesh(numGroups.x, numGroups.y, numGroups.z) from the API.
+template<class Kernel>
+MeshShaderDispatch<typename Kernel::Vertex, typename Kernel::Primitive> dispatchMeshShader(const Kernel& kernel,
+                                                                                           const ui32v3& numGroups)
+{
+  return dispatchMeshShader(kernel, std::vector<MeshShaderLaunch<typename Kernel::Payload>> {{{}, numGroups}});
+}
+} // namespace gims
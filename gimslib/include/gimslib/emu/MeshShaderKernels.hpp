@@ -0,0 +1,145 @@
+#pragma once
+#include <gimslib/emu/MeshShaderEmulator.hpp>
+#include <gimslib/fruit/FruitCulling.hpp>
+#include <gimslib/fruit/FruitInstanceBuffer.hpp>
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/fruit/FruitTiling.hpp>
+#include <gimslib/types.hpp>
+#include <vector>
+
+namespace gims
+{
+// C++ ports of the MS_main kernels of the assignments, for dispatchMeshShader(). Each struct holds the constants of
+// its shader's cbuffer and is transcribed statement by statement, including the indexing and the early returns. The
+// math uses the gimslib counterparts of the shader functions (octDecode(), calculateFruitCoordinates(), ...), so the
+// vertices match the GPU's up to its approximate transcendental functions, and at the poles of the fruits, where the
+// shaders produce NaNs.
+
+//! \brief MeshShaderOutput of the kernels that output only a position.
+struct MeshShaderPositionVertex
+{
+  f32v4 position;
+};
+
+//! \brief Octaspheres.hlsl of AXTwoOctaspheres and AXOctasphereWithInterLOD: numOctaspheres unit octaspheres on a
+//! gridSize x gridSize grid each, 2.5 apart along x, one vertex of each per thread.
+struct OctaspheresMeshShader : MeshShaderKernelTypes<MeshShaderPositionVertex>
+{
+  f32m4 transformationMatrix = f32m4(1.0f);
+  //! NUM_OCTASPHERES.
+  ui32  numOctaspheres       = 2;
+  //! NUM_THREADS_X = NUM_THREADS_Y: 9 in AXTwoOctaspheres, getInterLODGridSize() in AXOctasphereWithInterLOD.
+  ui32  gridSize             = 9;
+
+  //! \brief APPROX_SQRT(MAX_THREADS / numOctaspheres) of AXOctasphereWithInterLOD.
+  static ui32 getInterLODGridSize(ui32 numOctaspheres);
+
+  MeshShaderLayout getLayout() const;
+  void operator()(const MeshShaderThread& thread, const Payload& payload, GroupShared& shared, Outputs& outputs) const;
+};
+
+//! \brief Octasphere.hlsl of AXOctasphereWithIntraLOD: the unfolded octahedron, an intraLOD x intraLOD grid in the
+//! z = 0 plane.
+struct OctahedronMeshShader : MeshShaderKernelTypes<MeshShaderPositionVertex>
+{
+  f32m4 transformationMatrix = f32m4(1.0f);
+  //! 3, 5, ..., 11.
+  i32   intraLOD             = 11;
+
+  MeshShaderLayout getLayout() const;
+  void operator()(const MeshShaderThread& thread, const Payload& payload, GroupShared& shared, Outputs& outputs) const;
+};
+
+//! \brief Sphere.hlsl of AXUVSphereWithIntraLOD: a UV sphere of interSphereLOD x interSphereLOD patches of 11 x 11
+//! vertices, one group per patch. Dispatch (interSphereLOD, interSphereLOD, 1) groups.
+struct UVSphereMeshShader : MeshShaderKernelTypes<MeshShaderPositionVertex>
+{
+  f32m4 transformationMatrix = f32m4(1.0f);
+  f32   radius               = 1.0f;
+  i32   interSphereLOD       = 1;
+
+  MeshShaderLayout getLayout() const;
+  void operator()(const MeshShaderThread& thread, const Payload& payload, GroupShared& shared, Outputs& outputs) const;
+};
+
+//! \brief MeshShaderOutput of the fruit renderers.
+struct FruitRendererVertex
+{
+  f32v4 position;
+  f32v3 viewSpacePosition;
+  f32v3 decodedCoordinates;
+  f32   positionOffset;
+};
+
+//! \brief MS_main of Apples.hlsl, Lemons.hlsl, Pears.hlsl and Strawberries.hlsl, which differ only in the profile:
+//! interLOD fruits, 2.5 apart along x, on the grid of calculateIntraLOD(128 / interLOD).
+struct FruitRendererMeshShader : MeshShaderKernelTypes<FruitRendererVertex>
+{
+  f32m4        viewMatrix       = f32m4(1.0f);
+  f32m4        projectionMatrix = f32m4(1.0f);
+  //! 1 to 28.
+  i32          interLOD         = 1;
+  //! P0 to P3.
+  FruitProfile profile;
+
+  MeshShaderLayout getLayout() const;
+  void operator()(const MeshShaderThread& thread, const Payload& payload, GroupShared& shared, Outputs& outputs) const;
+};
+
+//! \brief MeshShaderOutput of Fruits.hlsl.
+struct FruitsVertex
+{
+  f32v4 position;
+  f32v3 viewSpacePosition;
+  f32v3 viewSpaceNormal;
+  ui32  instance;
+};
+
+//! \brief PrimitiveOutput of Fruits.hlsl, compiled with FRUIT_CULL_PRIMITIVES.
+struct FruitsPrimitive
+{
+  bool cull;
+};
+
+//! \brief Payload of Fruits.hlsl.
+struct FruitsPayload
+{
+  static constexpr ui32 AS_GROUP_SIZE = 32;
+
+  ui32 instance;
+  ui32 tiles[AS_GROUP_SIZE];
+};
+
+//! \brief groupshared memory of MS_main of Fruits.hlsl.
+struct FruitsGroupShared
+{
+  f32v4 clipPositions[MeshShaderLimits::MAX_VERTICES];
+};
+
+//! \brief MS_main of Fruits.hlsl of AXFruitsGenerator: group i draws tile tiles[i] of the payload's instance, on the
+//! grid and with the morph factor of the instance's record. With cullPrimitives, the kernel compiled with
+//! FRUIT_CULL_PRIMITIVES, which flags culled primitives and has a barrier between the vertices and the primitives.
+struct FruitsMeshShader : MeshShaderKernelTypes<FruitsVertex, FruitsPrimitive, FruitsPayload, FruitsGroupShared>
+{
+  f32m4                      viewMatrix       = f32m4(1.0f);
+  f32m4                      projectionMatrix = f32m4(1.0f);
+  f32v2                      viewportSize     = f32v2(1.0f);
+  //! The instances buffer.
+  const FruitInstanceRecord* instances        = nullptr;
+  bool                       cullPrimitives   = false;
+
+  MeshShaderLayout getLayout() const;
+  void operator()(const MeshShaderThread& thread, const Payload& payload, GroupShared& shared, Outputs& outputs) const;
+};
+
+//! \brief Emulates AS_main of Fruits.hlsl: returns the launch of each amplification shader group, groupsPerInstance
+//! per instance, with the tiles of its chunk of AS_GROUP_SIZE tiles that culler finds visible, or all of them if
+//! culler is null. Chunks past the tiles of the instance's grid launch nothing. The GPU may list the visible tiles of a
+//! group in any order; here they are ascending.
+//! \param groupsPerInstance At least the chunks of the instance with the most tiles, as the renderer dispatches them.
+//! \param bounds The tile bounds buffer, read at the instances' firstTileBounds, only with a culler.
+std::vector<MeshShaderLaunch<FruitsPayload>> emulateFruitsAmplification(const FruitInstanceRecord* instances,
+                                                                        size_t numInstances, ui32 groupsPerInstance,
+                                                                        const FruitTileBoundsRecord* bounds,
+                                                                        const FruitCuller*           culler);
+} // namespace gims
@@ -0,0 +1,38 @@
+#pragma once
+#include <gimslib/types.hpp>
+
+namespace gims
+{
+//! \brief Reconstructs the view space position of a fragment from SV_POSITION, i.e., its pixel coordinates and depth
+//! (reconstructViewSpacePosition of the fruit renderers compiled with FRUIT_COMPACT_OUTPUT).
+f32v3 reconstructViewSpacePosition(const f32v4& position, const f32m4& inverseProjectionMatrix,
+                                   const f32v2& viewportSize);
+
+//! \brief Errors of the FRUIT_COMPACT_OUTPUT variant of the fruit renderers, which outputs the octahedral grid
+//! parameters instead of the decoded coordinates and no view space position.
+struct FruitCompactOutputError
+{
+  //! Number of directions and of view space positions.
+  ui32 numSamples            = 0;
+  //! Largest angle in radians between a direction and octDecode(octEncode()) of it.
+  f32  maxDirectionError     = 0.0f;
+  //! Largest angle in radians between octDecode() of the interpolated grid parameters and the interpolated decoded
+  //! coordinates, at the triangle centroids of the grids of calculateIntraLOD(). Not an error of the encoding, but of
+  //! the variants' different interpolation domains; it shrinks with the grid spacing.
+  f32  maxInterpolationAngle = 0.0f;
+  //! Largest distance between the reconstructed and the actual view space position, relative to the latter's length.
+  f32  maxPositionError      = 0.0f;
+  //! Largest angle in radians between the reconstructed and the actual view direction, the v of the specular term.
+  f32  maxViewDirectionError = 0.0f;
+};
+
+//! \brief Measures the errors for numSamples directions on the sphere and numSamples view space positions with depths
+//! in [minDepth; maxDepth] within the view frustum.
+//!
+//! SV_POSITION is computed in single precision like the rasterizer's. For the renderers' projection (45 degrees, near
+//! 1e-4, far 1e4) at 1920 x 1080 and depths in [0.5; 50], maxDirectionError is 2.5e-7, maxPositionError 4e-2 and
+//! maxViewDirectionError 1.4e-7: the depth precision limits the distance but not the direction, which is all that the
+//! pixel shaders use. maxInterpolationAngle is 0.053 (3 degrees), on the 3 x 3 grid.
+FruitCompactOutputError measureFruitCompactOutputError(const f32m4& projectionMatrix, const f32v2& viewportSize,
+                                                       f32 minDepth, f32 maxDepth, ui32 numSamples);
+} // namespace gims
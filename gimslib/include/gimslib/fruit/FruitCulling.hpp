@@ -0,0 +1,159 @@
+#pragma once
+#include <gimslib/fruit/FruitInstanceBuffer.hpp>
+#include <gimslib/fruit/FruitLODSelector.hpp>
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/fruit/FruitTessellator.hpp>
+#include <gimslib/fruit/FruitTiling.hpp>
+#include <gimslib/types.hpp>
+#include <map>
+#include <vector>
+
+namespace gims
+{
+//! \brief Object space bounds of one tile, the layout of FruitTileBounds in Fruits.hlsl.
+struct FruitTileBoundsRecord
+{
+  //! coneCutoff of tiles whose normals span a half-space or more; they are never backfacing as a whole.
+  static constexpr f32 NO_CONE = -1.0f;
+
+  f32v3 center;
+  f32   radius;
+  //! Unit axis of a cone that contains the outward normals of all triangles of the tile.
+  f32v3 coneAxis;
+  //! Sine of the cone's half angle, or NO_CONE.
+  f32   coneCutoff;
+};
+static_assert(sizeof(FruitTileBoundsRecord) == 32);
+
+//! \brief Computes the bounding sphere and normal cone of each tile of the tiling, from the vertices and triangles
+//! MS_main emits. Tile i of the result belongs to tile i of the tiling. The spheres are slightly inflated, so they
+//! also contain the vertices the GPU evaluates with its approximate transcendental functions. Tiles are processed on
+//! all hardware threads.
+//!
+//! Bounds of geomorphed grids hold for every morph factor: the spheres also contain the morph edges (see
+//! getFruitMorphEdge()), and the tiles have no cone.
+//! \throws std::invalid_argument if geomorphed is set for a grid that is not morphable.
+std::vector<FruitTileBoundsRecord> computeFruitTileBounds(const FruitProfile& profile, const FruitTiling& tiling,
+                                                          bool geomorphed = false);
+
+//! \brief Tile bounds of all instances for AS_main, one copy per distinct profile, grid and geomorphing.
+//!
+//! Instances with the same profile and grid share their bounds, so buildings of a single fruit type need only one copy
+//! per grid. Bounds that were in use in the previous update are reused, all others are dropped.
+class FruitTileBoundsBuilder
+{
+public:
+  //! \brief Concatenates the bounds the instances need and sets the firstTileBounds of each level of detail. Grids
+  //! that are not morphable are never geomorphed.
+  //! \throws std::invalid_argument if there is not one level of detail per instance.
+  void update(const FruitInstanceArray& instances, bool geomorph, std::vector<FruitInstanceLOD>& lods);
+
+  //! \brief Returns the bounds of the last update, indexed by firstTileBounds plus the tile.
+  const std::vector<FruitTileBoundsRecord>& getBounds() const;
+
+  //! \brief Returns the number of distinct bounds of the last update.
+  size_t getNumEntries() const;
+
+private:
+  //! Byte-wise comparable, free of padding.
+  struct Key
+  {
+    FruitProfile profile;
+    ui32         gridSize   = 0;
+    ui32         geomorphed = 0;
+
+    bool operator<(const Key& other) const;
+    bool operator==(const Key& other) const;
+  };
+  static_assert(sizeof(Key) == 56);
+
+  struct Entry
+  {
+    std::vector<FruitTileBoundsRecord> bounds;
+    ui32                               first = 0;
+  };
+
+  std::map<Key, Entry>               m_entries;
+  std::vector<FruitTileBoundsRecord> m_bounds;
+};
+
+//! \brief View frustum and backface culling of fruits and their tiles, bit for bit as AS_main of Fruits.hlsl.
+//!
+//! All tests run in view space, where the camera is at the origin. The frustum planes are the unnormalized rows of
+//! the projection matrix: a sphere is outside plane (n, w) if d = n . c + w < 0 and d^2 > r^2 |n|^2. A tile is
+//! backfacing if its cone has a cutoff and s = c . a - r >= 0 with s^2 >= cutoff^2 |c|^2, i.e., every normal of the
+//! tile points away from every point of its sphere as seen from the camera. The tests use only additions,
+//! multiplications and comparisons in a fixed order, which are correctly rounded on CPUs and GPUs alike; the shader
+//! marks them precise, so the compiler cannot fuse them into multiply-adds. The C++ build must not contract them
+//! either: gimslib and gimslibPortable compile with /fp:precise on MSVC and -ffp-contract=off elsewhere.
+//!
+//! The view matrix must be rigid.
+class FruitCuller
+{
+public:
+  //! \brief Constructor.
+  //! \param viewMatrix The view matrix, left handed, looking along +z.
+  //! \param projectionMatrix A perspective projection as built by glm::perspectiveFovLH_ZO.
+  FruitCuller(const f32m4& viewMatrix, const f32m4& projectionMatrix);
+
+  //! \brief Returns true if the world space sphere intersects the frustum.
+  bool isSphereVisible(const f32v3& center, f32 radius) const;
+
+  //! \brief Returns true if the tile of the instance intersects the frustum and is not backfacing.
+  bool isTileVisible(const FruitInstanceRecord& instance, const FruitTileBoundsRecord& bounds) const;
+
+  //! \brief Writes 1 to visible[i] for the spheres [first;last) that intersect the frustum, else 0.
+  //!
+  //! The spheres are processed in LaneBlocks. Disjoint ranges may be processed concurrently.
+  void cullSpheres(const FruitBoundingSphereArray& spheres, size_t first, size_t last, ui8* visible) const;
+
+  //! \brief Writes 1 to visible[i] for the tiles bounds[first;last) of the instance that are visible, else 0. Same
+  //! blocking as cullSpheres().
+  void cullTiles(const FruitInstanceRecord& instance, const FruitTileBoundsRecord* bounds, size_t first, size_t last,
+                 ui8* visible) const;
+
+  //! \brief Returns the frustum plane i: left, right, bottom, top, near, far.
+  const f32v4& getPlane(ui32 i) const;
+
+private:
+  //! Rows 0 to 2 of the view matrix.
+  f32v4 m_viewRows[3];
+  f32v4 m_planes[6];
+};
+
+//! \brief Triangles removed by the per-primitive culling of MS_main, compiled with FRUIT_CULL_PRIMITIVES.
+//!
+//! Each triangle counts towards the first test that removes it: zero area, backfacing, then too small, i.e., its pixel
+//! space bounding box contains no pixel center. Triangles with a vertex on or behind the camera plane are kept.
+struct FruitPrimitiveCullingStats
+{
+  size_t numTriangles  = 0;
+  size_t numZeroArea   = 0;
+  size_t numBackfacing = 0;
+  size_t numTooSmall   = 0;
+
+  size_t getNumCulled() const;
+};
+
+//! \brief Runs the per-primitive tests of MS_main over a CPU tessellated fruit and adds the counts to stats.
+//!
+//! The vertices are transformed to clip space like MS_main does it, so the counts are what the GPU would remove up to
+//! the rounding of its faster transcendental functions. Vertices and triangles are processed on all hardware threads.
+//! \param worldViewProjection Projection times view times the world transformation of the fruit.
+//! \param viewportSize Width and height of the viewport in pixels, one sample per pixel.
+void emulateFruitPrimitiveCulling(const FruitMesh& mesh, const f32m4& worldViewProjection, const f32v2& viewportSize,
+                                  FruitPrimitiveCullingStats& stats);
+
+//! \brief Runs the per-primitive tests of MS_main over all instances and adds the counts to stats.
+//!
+//! Each instance is tessellated with its own profile and grid, placed with its rotation and position like MS_main
+//! does it, and morphed by its morph factor if its grid is morphable. Unmorphed meshes come from
+//! FruitMeshCache::getDefault(), and neighboring instances with the same profile, grid and morph factor share their
+//! mesh.
+//! \param lods The grid and morph factor of each instance, as passed to FruitInstanceBufferBuilder::update().
+//! \param viewProjection Projection times view matrix.
+//! \throws std::invalid_argument if there is not one level of detail per instance or a morph factor is not in [0;1].
+void emulateFruitPrimitiveCulling(const FruitInstanceArray& instances, const std::vector<FruitInstanceLOD>& lods,
+                                  const f32m4& viewProjection, const f32v2& viewportSize,
+                                  FruitPrimitiveCullingStats& stats);
+} // namespace gims
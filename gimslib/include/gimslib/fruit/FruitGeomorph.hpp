@@ -0,0 +1,59 @@
+#pragma once
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/fruit/FruitTessellator.hpp>
+#include <gimslib/types.hpp>
+
+namespace gims
+{
+//! \brief The coarse edge a vertex of a morphable grid moves onto. Both ends are the vertex itself for the vertices
+//! the coarse grid shares.
+struct FruitMorphEdge
+{
+  ui32v2 first;
+  ui32v2 second;
+};
+
+//! \brief A grid size with its morph factor, 0 for the grid itself and 1 for the shape of its half resolution grid.
+struct FruitMorphLevel
+{
+  ui32 gridSize    = 3;
+  f32  morphFactor = 0.0f;
+};
+
+//! \brief Factor by which the renderers relax the pixel error target of the screen-space LOD while geomorphing.
+//!
+//! The target is tight because switching grids pops; morphed grids change continuously, so a twice as large geometric
+//! error goes unnoticed and costs about 30 % fewer vertices per side.
+constexpr f32 FRUIT_GEOMORPH_PIXEL_ERROR_SCALE = 2.0f;
+
+//! \brief Returns true if the grid morphs continuously into the grid of half its resolution, i.e., gridSize = 4 m + 1
+//! with m >= 1.
+//!
+//! The grid of 2 m + 1 vertices per side then consists of the even vertices of the fine grid, and the flip rule of
+//! tessellateFruit() cuts each coarse quad along the same diagonal as the four fine quads inside it. Every fine
+//! triangle thus lies in a coarse triangle once the odd vertices have moved onto the coarse edges, and the morphed
+//! grid at factor 1 has exactly the shape of the coarse grid.
+bool isFruitGridMorphable(ui32 gridSize);
+
+//! \brief Returns the coarse edge that the grid vertex (x, y) splits.
+//!
+//! Vertices with odd x and even y split a horizontal coarse edge, vertices with even x and odd y a vertical one.
+//! Vertices with odd x and odd y are the centers of coarse quads and split the quad's diagonal, from (x + 1, y - 1) to
+//! (x - 1, y + 1) where the flip rule keeps the diagonal, from (x - 1, y - 1) to (x + 1, y + 1) otherwise. MS_main of
+//! Fruits.hlsl uses the same edges.
+//! \throws std::invalid_argument if the grid is not morphable or the vertex does not exist.
+FruitMorphEdge getFruitMorphEdge(ui32 gridSize, ui32 x, ui32 y);
+
+//! \brief Selects the morphable grid for a fractional level (n - 1) / 2 of continuous detail, e.g., the level at which
+//! the projected error equals the target.
+//!
+//! Levels in (m;2 m] for m a power of two map to the grid 4 m + 1 with the factor (2 m - level) / m, so the factor
+//! reaches 1, i.e., the shape of the grid 2 m + 1, exactly where the next coarser grid takes over with factor 0. The
+//! grids are 3, 5, 9, 17, ..., and levels are clamped to the finest of them up to maxGridSize.
+FruitMorphLevel selectFruitMorphLevel(f32 level, ui32 maxGridSize);
+
+//! \brief Tessellates the fruit like tessellateFruit() and moves each vertex by morphFactor towards the midpoint of its
+//! morph edge, as MS_main does it. The CPU reference of the geomorphing.
+//! \throws std::invalid_argument if the grid is not morphable or the factor is not in [0;1].
+FruitMesh tessellateMorphedFruit(const FruitProfile& profile, ui32 gridSize, f32 morphFactor);
+} // namespace gims
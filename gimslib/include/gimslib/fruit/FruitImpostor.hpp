@@ -0,0 +1,91 @@
+#pragma once
+#include <filesystem>
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/types.hpp>
+#include <vector>
+
+namespace gims
+{
+//! \brief How the views of an impostor are distributed.
+enum class FruitImpostorLayout : ui32
+{
+  //! Views over the full sphere, octahedral mapping (octEncode()).
+  Sphere,
+  //! Views over the upper hemisphere (z >= 0), hemi-octahedral mapping. Twice the view density for the same atlas.
+  Hemisphere
+};
+
+//! \brief Header of an impostor atlas file. It is followed by the color and the normal/depth texels.
+struct FruitImpostorHeader
+{
+  //! "FRIM" in little endian.
+  static constexpr ui32 MAGIC   = 0x4d495246;
+  static constexpr ui32 VERSION = 1;
+
+  ui32                magic          = MAGIC;
+  ui32                version        = VERSION;
+  FruitImpostorLayout layout         = FruitImpostorLayout::Sphere;
+  //! The views form a viewsPerSide x viewsPerSide grid over the octahedral domain, including its border.
+  ui32                viewsPerSide   = 0;
+  //! Each view is a viewResolution x viewResolution tile of the atlas.
+  ui32                viewResolution = 0;
+  //! Bounding sphere of the fruit. Each view is an orthographic projection of the sphere along the view direction.
+  f32v3               center         = f32v3(0.0f);
+  f32                 radius         = 0.0f;
+};
+
+//! \brief Color, normal and depth of a fruit seen from many directions, for rendering distant fruits as billboards.
+//!
+//! The atlas is square with getSize() texels per side; tile (i, j) holds the view with grid coordinates (i, j), rows
+//! run from top to bottom. Per texel there are 8 bytes:
+//! - colors: RGBA8, the albedo of the fruit in RGB and the coverage in A.
+//! - normalDepths: the object space normal, octEncode()d to 2 x 8 bits (bits 0..15), and the depth in bits 16..31. The
+//!   depth is measured along the view direction from the tangent plane of the bounding sphere that faces the camera,
+//!   0 on that plane and 65534 on the opposite one. Uncovered texels have depth 65535.
+struct FruitImpostorAtlas
+{
+  FruitImpostorHeader header;
+  std::vector<ui32>   colors;
+  std::vector<ui32>   normalDepths;
+
+  //! \brief Returns the side length of the atlas in texels.
+  ui32 getSize() const;
+
+  //! \brief Writes the header and the texels.
+  //! \throws std::runtime_error if the file cannot be written.
+  void save(const std::filesystem::path& fileName) const;
+
+  //! \brief Reads an atlas file.
+  //! \throws std::runtime_error if the file cannot be read or is not a valid atlas: an unknown layout, fewer than 2
+  //! views per side or more than 16384 texels per side.
+  static FruitImpostorAtlas load(const std::filesystem::path& fileName);
+};
+
+//! \brief Returns the direction (from the center towards the camera) of view (x, y). viewsPerSide must be at least 2.
+f32v3 getFruitImpostorViewDirection(FruitImpostorLayout layout, ui32 viewsPerSide, ui32 x, ui32 y);
+
+//! \brief Returns the right and up vectors of the image plane of a view direction. Up is the projection of the z axis,
+//! or of the x axis for views along z.
+void getFruitImpostorViewBasis(const f32v3& direction, f32v3& right, f32v3& up);
+
+//! \brief Renders the fruit from all views of the atlas with a CPU ray caster, one view per task on all hardware
+//! threads. No GPU is needed.
+//! \throws std::invalid_argument if the layout is unknown, there are fewer than 2 views per side, the resolution is 0
+//! or the atlas has more than 16384 texels per side.
+FruitImpostorAtlas bakeFruitImpostor(const FruitProfile& profile, const f32v3& color, FruitImpostorLayout layout,
+                                     ui32 viewsPerSide, ui32 viewResolution);
+
+//! \brief The views to blend for a billboard.
+struct FruitImpostorViews
+{
+  //! Index y * viewsPerSide + x of each view.
+  ui32 views[3]   = {};
+  //! Barycentric weights, summing to 1.
+  f32  weights[3] = {};
+};
+
+//! \brief Returns the three views that surround a direction in the octahedral domain, with barycentric weights.
+//! \param direction Direction from the fruit to the camera in the fruit's object space.
+//! \throws std::invalid_argument if the header is not valid for bakeFruitImpostor().
+FruitImpostorViews selectFruitImpostorViews(const FruitImpostorHeader& header, const f32v3& direction);
+} // namespace gims
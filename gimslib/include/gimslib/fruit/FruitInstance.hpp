@@ -0,0 +1,96 @@
+#pragma once
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <gimslib/fruit/FruitProfileArray.hpp>
+#include <gimslib/types.hpp>
+#include <vector>
+
+namespace gims
+{
+//! Flag of FruitInstance::flags: shade the fruit flat with facet normals instead of the interpolated analytic normals.
+constexpr ui8 FRUIT_INSTANCE_FLAT_SHADING = 1;
+
+//! \brief A placed fruit: its shape, pose and appearance.
+struct FruitInstance
+{
+  //! The preset the profile is quantized against.
+  FruitType    preset = FruitType::Apple;
+  FruitProfile profile;
+  f32v3        position = f32v3(0.0f);
+  //! Unit quaternion (x, y, z, w).
+  f32v4        rotation   = f32v4(0.0f, 0.0f, 0.0f, 1.0f);
+  ui8          colorIndex = 0;
+  //! Added to the level of detail the renderer selects.
+  i8           lodBias = 0;
+  ui8          flags   = 0;
+};
+
+//! \brief Structure of arrays of FruitInstance.
+struct FruitInstanceArray
+{
+  FruitProfileArray profiles;
+  std::vector<f32>  positionX;
+  std::vector<f32>  positionY;
+  std::vector<f32>  positionZ;
+  std::vector<f32>  rotationX;
+  std::vector<f32>  rotationY;
+  std::vector<f32>  rotationZ;
+  std::vector<f32>  rotationW;
+  std::vector<ui8>  presets;
+  std::vector<ui8>  colorIndices;
+  std::vector<i8>   lodBiases;
+  std::vector<ui8>  flags;
+
+  size_t getSize() const;
+
+  void resize(size_t numInstances);
+
+  void setInstance(size_t index, const FruitInstance& instance);
+
+  FruitInstance getInstance(size_t index) const;
+
+  bool operator==(const FruitInstanceArray& other) const = default;
+};
+
+//! \brief A FruitInstance quantized to 32 bytes.
+//!
+//! - position: x, y and z in 21 bits each, relative to the bounds of the catalog. The quantization error per axis is
+//!   at most half the extent of the bounds divided by 2^21 - 1, i.e., 0.24 mm for a 1 km orchard, and f32 rounding
+//!   adds up to 0.08 mm. Over a 1 km x 1 km orchard, the distance error stays below 0.45 mm.
+//! - rotation: smallest three encoding. The two most significant bits hold the index of the largest component, which
+//!   is dropped and made positive. The others are stored in 10 bits each within [-1/sqrt(2);1/sqrt(2)], i.e., with an
+//!   error of at most 7e-4 per component. The rotation angle is off by less than 0.25 degrees.
+//! - profileOffsets: p0.z, p1.x, p1.z, p2.x, p2.z and p3.z as offsets to the preset in steps of
+//!   PROFILE_OFFSET_STEP. The remaining components are zero: the profile lies in the x-z half-plane and starts and
+//!   ends on the axis, as for all presets and fitted scans.
+struct PackedFruitInstance
+{
+  //! Number of stored profile components.
+  static constexpr ui32 NUM_PROFILE_OFFSETS = 6;
+
+  //! Quantization step of the profile offsets. Offsets up to +-2 are representable.
+  static constexpr f32 PROFILE_OFFSET_STEP = 2.0f / 32767.0f;
+
+  ui64 position;
+  ui32 rotation;
+  i16  profileOffsets[NUM_PROFILE_OFFSETS];
+  ui8  preset;
+  ui8  colorIndex;
+  i8   lodBias;
+  ui8  flags;
+  //! Zero. Room for future fields without changing the record size.
+  ui32 reserved;
+};
+static_assert(sizeof(PackedFruitInstance) == 32);
+
+//! \brief Packs the instances [first;last) into records[first;last).
+//!
+//! Positions are clamped to [positionMin;positionMax], profile offsets to their representable range. Disjoint ranges
+//! may be processed concurrently.
+void packFruitInstances(const FruitInstanceArray& instances, const f32v3& positionMin, const f32v3& positionMax,
+                        size_t first, size_t last, PackedFruitInstance* records);
+
+//! \brief Unpacks records[first;last) into the instances [first;last). The instance array must be large enough.
+//! Disjoint ranges may be processed concurrently.
+void unpackFruitInstances(const PackedFruitInstance* records, const f32v3& positionMin, const f32v3& positionMax,
+                          size_t first, size_t last, FruitInstanceArray& instances);
+} // namespace gims
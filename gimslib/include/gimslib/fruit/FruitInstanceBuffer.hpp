@@ -0,0 +1,93 @@
+#pragma once
+#include <gimslib/fruit/FruitInstance.hpp>
+#include <gimslib/types.hpp>
+#include <vector>
+
+namespace gims
+{
+//! \brief One fruit instance as the shaders read it, the layout of FruitInstanceData in Fruits.hlsl.
+//!
+//! 112 bytes without implicit padding, so records can be compared and copied bytewise.
+struct FruitInstanceRecord
+{
+  //! Unit quaternion (x, y, z, w).
+  f32v4 rotation;
+  f32v3 position;
+  //! Bits 0-7: FruitInstance::flags, bits 8-15: colorIndex, bits 16-23: lodBias as an 8 bit two's complement.
+  ui32  flags;
+  //! Control points p0 to p3 of the profile, w = 0.
+  f32v4 controlPoints[4];
+  //! FruitInstanceLOD::gridSize.
+  ui32  gridSize;
+  //! FruitInstanceLOD::firstTileBounds.
+  ui32  firstTileBounds;
+  //! FruitInstanceLOD::morphFactor.
+  f32   morphFactor;
+  ui32  reserved;
+};
+static_assert(sizeof(FruitInstanceRecord) == 112);
+
+//! \brief The level of detail of one instance, selected on the CPU each frame and stored in its record.
+struct FruitInstanceLOD
+{
+  //! Vertices per side of the instance's grid, 2 to FruitTiling::MAX_GRID_SIZE.
+  ui32 gridSize        = 3;
+  //! Index of the bounds of tile 0 of the instance's grid in the tile bounds buffer; the tiles follow in order.
+  ui32 firstTileBounds = 0;
+  //! How far the grid has morphed into its half resolution grid, 0 to 1 (see tessellateMorphedFruit()). Grids that are
+  //! not morphable ignore it.
+  f32  morphFactor     = 0.0f;
+};
+
+//! \brief A run of consecutive records, [first;first + count).
+struct FruitInstanceRange
+{
+  size_t first = 0;
+  size_t count = 0;
+
+  bool operator==(const FruitInstanceRange& other) const = default;
+};
+
+//! \brief Converts the instances [first;last) with their levels of detail lods[first;last) into records[first;last).
+//! Disjoint ranges may be processed concurrently.
+void buildFruitInstanceRecords(const FruitInstanceArray& instances, const FruitInstanceLOD* lods, size_t first,
+                               size_t last, FruitInstanceRecord* records);
+
+//! \brief Keeps the records of the last upload and finds the ones that changed since.
+//!
+//! Each update converts all instances with their levels of detail on all hardware threads and compares them bytewise
+//! with the previous records. Changed records separated by at most MAX_MERGED_GAP unchanged ones are merged into one
+//! range, trading a few redundant bytes for fewer copy commands. The renderer copies the changed ranges of
+//! getRecords() into the GPU buffer at the same offsets.
+class FruitInstanceBufferBuilder
+{
+public:
+  //! Unchanged records bridged between two changed ones, about 0.9 KB.
+  static constexpr size_t MAX_MERGED_GAP = 8;
+
+  //! \brief Converts the instances and returns the ranges of records that differ from the previous update, sorted and
+  //! disjoint. Everything is changed in the first update and after invalidate(), as are the records past the previous
+  //! size after growth. Records past the new size are dropped. An instance whose grid changes is changed as well.
+  //! \throws std::invalid_argument if there is not one level of detail per instance.
+  const std::vector<FruitInstanceRange>& update(const FruitInstanceArray& instances,
+                                                const std::vector<FruitInstanceLOD>& lods);
+
+  //! \brief Marks all records as changed in the next update, e.g., after the GPU buffer was recreated.
+  void invalidate();
+
+  const std::vector<FruitInstanceRecord>& getRecords() const;
+
+  //! \brief Returns the ranges of the last update.
+  const std::vector<FruitInstanceRange>& getChangedRanges() const;
+
+  //! \brief Returns the number of records in the changed ranges, including the bridged ones.
+  size_t getNumChangedRecords() const;
+
+private:
+  std::vector<FruitInstanceRecord> m_records;
+  //! The records being built, swapped with m_records after the comparison.
+  std::vector<FruitInstanceRecord> m_nextRecords;
+  std::vector<FruitInstanceRange>  m_changedRanges;
+  bool                             m_valid = false;
+};
+} // namespace gims
@@ -0,0 +1,68 @@
+#pragma once
+#include <filesystem>
+#include <gimslib/fruit/FruitInstance.hpp>
+#include <gimslib/types.hpp>
+#include <vector>
+
+namespace gims
+{
+//! \brief Header of a fruit instance catalog file. It is followed by numInstances PackedFruitInstance records.
+struct FruitInstanceCatalogHeader
+{
+  //! "FRIC" in little endian.
+  static constexpr ui32 MAGIC      = 0x43495246;
+  static constexpr ui32 VERSION    = 1;
+  static constexpr ui32 NUM_COLORS = 256;
+
+  ui32  magic        = MAGIC;
+  ui32  version      = VERSION;
+  ui64  numInstances = 0;
+  //! Bounds the positions are quantized against.
+  f32v3 positionMin = f32v3(0.0f);
+  f32v3 positionMax = f32v3(0.0f);
+  //! Palette indexed by PackedFruitInstance::colorIndex.
+  f32v3 colors[NUM_COLORS] = {};
+};
+static_assert(sizeof(FruitInstanceCatalogHeader) % alignof(PackedFruitInstance) == 0);
+
+//! \brief Read-only, memory-mapped fruit instance catalog.
+//!
+//! The records are used in place: opening a catalog only maps the file, and pages are loaded as they are touched.
+class FruitInstanceCatalog
+{
+public:
+  //! \brief Maps a catalog file.
+  //! \throws std::runtime_error if the file cannot be mapped or is not a valid catalog.
+  explicit FruitInstanceCatalog(const std::filesystem::path& fileName);
+
+  ~FruitInstanceCatalog();
+
+  FruitInstanceCatalog(const FruitInstanceCatalog&)            = delete;
+  FruitInstanceCatalog& operator=(const FruitInstanceCatalog&) = delete;
+
+  const FruitInstanceCatalogHeader& getHeader() const;
+
+  size_t getNumInstances() const;
+
+  const PackedFruitInstance* getInstances() const;
+
+  //! \brief Unpacks the instances [first;last) into instances[first;last). The instance array must be large enough.
+  void unpack(size_t first, size_t last, FruitInstanceArray& instances) const;
+
+  //! \brief Packs all instances in parallel and writes them as a catalog.
+  //!
+  //! The position bounds are the bounding box of the instance positions.
+  //! \param colors Palette of at most FruitInstanceCatalogHeader::NUM_COLORS colors.
+  //! \throws std::invalid_argument if the palette is too large, std::runtime_error if the file cannot be written.
+  static void save(const std::filesystem::path& fileName, const FruitInstanceArray& instances,
+                   const std::vector<f32v3>& colors);
+
+private:
+  void unmap();
+
+  const ui8* m_data        = nullptr;
+  size_t     m_sizeInBytes = 0;
+  void*      m_file        = nullptr;
+  void*      m_mapping     = nullptr;
+};
+} // namespace gims
@@ -0,0 +1,100 @@
+#pragma once
+#include <gimslib/fruit/FruitGeomorph.hpp>
+#include <gimslib/fruit/FruitInstance.hpp>
+#include <gimslib/fruit/FruitMeasures.hpp>
+#include <gimslib/types.hpp>
+#include <vector>
+
+namespace gims
+{
+//! \brief Structure of arrays of world space bounding spheres of fruit instances.
+struct FruitBoundingSphereArray
+{
+  std::vector<f32> centerX;
+  std::vector<f32> centerY;
+  std::vector<f32> centerZ;
+  std::vector<f32> radius;
+
+  size_t getSize() const;
+
+  void resize(size_t numSpheres);
+};
+
+//! \brief Computes the bounding spheres of the instances [first;last) from the bounding boxes of their measures (see
+//! computeFruitMeasures), rotated and translated with the instance. The sphere array must already have the size of
+//! the instance array. Disjoint ranges may be processed concurrently.
+void computeFruitBoundingSpheres(const FruitInstanceArray& instances, const FruitMeasureArray& measures, size_t first,
+                                 size_t last, FruitBoundingSphereArray& spheres);
+
+//! \brief Selects the grid size of each fruit from its projected geometric error.
+//!
+//! A fruit of bounding radius r tessellated on an n x n grid deviates from its surface by at most
+//! ERROR_CONSTANT * r / (n - 1)^2. Projected at the distance d of the sphere's closest point to the camera plane, this
+//! is ERROR_CONSTANT * r * s / (d * (n - 1)^2) pixels, with s the pixels per unit at distance 1, i.e., the
+//! projection's focal length times half the viewport size. The selected grid is the coarsest odd n >= 3 whose error
+//! is at most the pixel error target; fruits entirely behind the camera get n = 3, fruits that contain the camera the
+//! finest grid.
+//!
+//! With a previous selection, a grid is kept as long as its error is at most (1 + hysteresis) times the target and
+//! the next coarser grid would exceed the target divided by (1 + hysteresis). The lodBias of an instance is added to
+//! the level (n - 1) / 2 after the selection. The renderer stores the selection in the instance records (see
+//! FruitInstanceLOD), from which the shaders of Fruits.hlsl take each instance's grid.
+class FruitLODSelector
+{
+public:
+  //! Largest ratio of geometric error times (n - 1)^2 to bounding radius measured for the presets, 5.06 for the apple.
+  static constexpr f32 ERROR_CONSTANT = 5.1f;
+
+  //! \brief Constructor.
+  //! \param viewMatrix The view matrix, left handed, looking along +z.
+  //! \param projectionMatrix A perspective projection as built by glm::perspectiveFovLH_ZO.
+  //! \param viewportSize Width and height of the viewport in pixels.
+  //! \param pixelError Target error in pixels.
+  //! \param hysteresis Relative error band in which the previous grid is kept.
+  //! \param maxGridSize Finest grid, clamped to FruitTiling::MAX_GRID_SIZE.
+  //! \throws std::invalid_argument if the pixel error is not positive, the hysteresis is negative or maxGridSize < 3.
+  FruitLODSelector(const f32m4& viewMatrix, const f32m4& projectionMatrix, const f32v2& viewportSize, f32 pixelError,
+                   f32 hysteresis, ui32 maxGridSize);
+
+  //! \brief Returns the grid size of a sphere. previousGridSize is 0 if there is no previous selection.
+  ui32 select(const f32v3& center, f32 radius, i8 lodBias, ui32 previousGridSize) const;
+
+  //! \brief Selects the grid sizes of the spheres [first;last).
+  //!
+  //! gridSizes holds the previous selection (0 for none) and receives the new one. lodBiases may be nullptr. The
+  //! spheres are processed in LaneBlocks, a few nanoseconds per sphere and core. Disjoint ranges may be processed
+  //! concurrently.
+  void select(const FruitBoundingSphereArray& spheres, const i8* lodBiases, size_t first, size_t last,
+              ui32* gridSizes) const;
+
+  //! \brief Selects the grid sizes of all spheres on all hardware threads. gridSizes is resized to the number of
+  //! spheres, new entries have no previous selection.
+  void select(const FruitBoundingSphereArray& spheres, const i8* lodBiases, std::vector<ui32>& gridSizes) const;
+
+  //! \brief Returns the fractional level (n - 1) / 2 at which the projected error of the sphere equals the target,
+  //! without hysteresis, bias and clamping; 0 for spheres entirely behind the camera. For geomorphing, see
+  //! selectFruitMorphLevel().
+  f32 getContinuousLevel(const f32v3& center, f32 radius) const;
+
+  //! \brief Selects the morphable grid and morph factor of each sphere on all hardware threads: selectFruitMorphLevel()
+  //! of its continuous level plus its lodBias, up to the finest grid. The grids morph into each other, so there is no
+  //! hysteresis. levels is resized to the number of spheres; lodBiases may be nullptr.
+  void selectMorphLevels(const FruitBoundingSphereArray& spheres, const i8* lodBiases,
+                         std::vector<FruitMorphLevel>& levels) const;
+
+  //! \brief Returns the pixels per unit at distance 1.
+  f32 getProjectionScale() const;
+
+  //! \brief Returns the distance of the near plane.
+  f32 getNearPlane() const;
+
+private:
+  //! Row 2 of the view matrix, the view space z of a world space point.
+  f32v4 m_depthRow;
+  f32   m_projectionScale;
+  f32   m_nearPlane;
+  f32   m_pixelError;
+  f32   m_hysteresis;
+  ui32  m_maxLevel;
+};
+} // namespace gims
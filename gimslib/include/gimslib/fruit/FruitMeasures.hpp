@@ -0,0 +1,46 @@
+#pragma once
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/fruit/FruitProfileArray.hpp>
+#include <gimslib/types.hpp>
+#include <vector>
+
+namespace gims
+{
+//! \brief Surface area, volume and bounding box of a fruit, computed from its profile without tessellation.
+struct FruitMeasures
+{
+  f32   area   = 0.0f;
+  f32   volume = 0.0f;
+  f32v3 aabbMin;
+  f32v3 aabbMax;
+};
+
+//! \brief Structure of arrays of FruitMeasures.
+//!
+//! As the fruit is a surface of revolution around the z axis, its bounding box is [-radius;radius]^2 x [minZ;maxZ].
+struct FruitMeasureArray
+{
+  std::vector<f32> area;
+  std::vector<f32> volume;
+  std::vector<f32> radius;
+  std::vector<f32> minZ;
+  std::vector<f32> maxZ;
+
+  void resize(size_t numFruits);
+};
+
+//! \brief Computes the measures of a single fruit.
+FruitMeasures computeFruitMeasures(const FruitProfile& profile);
+
+//! \brief Computes the measures of all fruits. The measure arrays are resized to the number of profiles.
+//!
+//! Area and volume are integrated over t with 16 point Gauss-Legendre quadrature. The volume integrand is a polynomial
+//! of degree 8, hence the volume is exact up to rounding. The bounding box is exact if the y components of the control
+//! points are zero (as for all fruit presets) and conservative otherwise. It is found by evaluating the curve at the
+//! end points and at the roots of its derivative.
+void computeFruitMeasures(const FruitProfileArray& profiles, FruitMeasureArray& measures);
+
+//! \brief Computes the measures of the fruits [first;last). The measure arrays must already have the size of the
+//! profile array. Disjoint ranges may be processed concurrently.
+void computeFruitMeasures(const FruitProfileArray& profiles, size_t first, size_t last, FruitMeasureArray& measures);
+} // namespace gims
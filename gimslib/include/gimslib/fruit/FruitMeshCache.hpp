@@ -0,0 +1,91 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <gimslib/fruit/FruitTessellator.hpp>
+#include <gimslib/types.hpp>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace gims
+{
+//! \brief Identifies a tessellated fruit: the quantized control points and the intra LOD grid size.
+struct FruitMeshKey
+{
+  std::array<i32, 12> quantizedControlPoints = {};
+  ui32                intraLOD               = 0;
+
+  bool operator==(const FruitMeshKey& other) const = default;
+};
+
+struct FruitMeshKeyHash
+{
+  size_t operator()(const FruitMeshKey& key) const;
+};
+
+//! \brief Thread-safe LRU cache of CPU tessellated fruit meshes with a byte budget.
+//!
+//! The cached entries are published as an immutable snapshot. Hits load the current snapshot, store the time of the
+//! access in the entry and count the hit. They never wait for the mutex of the misses or for a tessellation, but they
+//! are not lock-free: loading the snapshot updates its reference count, std::atomic<std::shared_ptr> takes a short
+//! internal lock in libstdc++ and MSVC, and the hit counter is shared by all threads. Misses tessellate outside of any
+//! lock and then insert a new snapshot under a mutex, evicting the least recently used entries until the byte budget is
+//! met. Evicted meshes stay alive as long as a caller holds on to them.
+class FruitMeshCache
+{
+public:
+  //! Edge length of the grid the control points are snapped to before hashing and tessellation.
+  static constexpr f32 QUANTIZATION_STEP = 1.0f / 4096.0f;
+
+  //! \brief Constructor.
+  //! \param byteBudget Maximum number of bytes occupied by the positions and indices of all cached meshes.
+  explicit FruitMeshCache(size_t byteBudget);
+
+  //! \brief Returns the cached mesh, or tessellates and caches it.
+  //! \param profile The fruit profile. It is quantized with QUANTIZATION_STEP.
+  //! \param intraLOD Side length of the octahedral grid, see calculateIntraLOD().
+  std::shared_ptr<const FruitMesh> getOrTessellate(const FruitProfile& profile, ui32 intraLOD);
+
+  //! \brief Returns the cached mesh or nullptr. Never waits for a tessellation.
+  std::shared_ptr<const FruitMesh> find(const FruitMeshKey& key);
+
+  //! \brief Removes all entries.
+  void clear();
+
+  size_t getByteBudget() const;
+  size_t getSizeInBytes() const;
+  size_t getNumEntries() const;
+  ui64   getNumHits() const;
+  ui64   getNumMisses() const;
+
+  //! \brief Builds the key of a profile and grid size.
+  static FruitMeshKey makeKey(const FruitProfile& profile, ui32 intraLOD);
+
+  //! \brief Returns the profile a key stands for, i.e., the quantized profile.
+  static FruitProfile getProfile(const FruitMeshKey& key);
+
+  //! \brief Returns the number of bytes of the positions and indices of a mesh.
+  static size_t getSizeInBytes(const FruitMesh& mesh);
+
+  //! \brief Returns the cache shared by the entire process.
+  static FruitMeshCache& getDefault();
+
+private:
+  struct Entry
+  {
+    std::shared_ptr<const FruitMesh> mesh;
+    size_t                           sizeInBytes = 0;
+    //! steady_clock ticks of the last access.
+    std::atomic<i64>                 lastAccess  = 0;
+  };
+
+  typedef std::unordered_map<FruitMeshKey, std::shared_ptr<Entry>, FruitMeshKeyHash> EntryMap;
+
+  const size_t                                 m_byteBudget;
+  std::atomic<std::shared_ptr<const EntryMap>> m_entries;
+  std::mutex                                   m_writeMutex;
+  std::atomic<size_t>                          m_sizeInBytes;
+  std::atomic<ui64>                            m_numHits;
+  std::atomic<ui64>                            m_numMisses;
+};
+} // namespace gims
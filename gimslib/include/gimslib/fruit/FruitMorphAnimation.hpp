@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/fruit/FruitProfileArray.hpp>
+#include <gimslib/types.hpp>
+#include <vector>
+
+namespace gims
+{
+//! \brief Control points of a fruit at a point in time of its growth.
+struct FruitKeyframe
+{
+  f32          time = 0.0f;
+  FruitProfile profile;
+};
+
+//! \brief Keyframed growth and shape morphing of many fruit instances.
+//!
+//! Tracks are sequences of keyframes, e.g., flower, small green fruit and ripe apple. Each instance follows one track,
+//! starting at its own start time and running at its own rate. Between two keyframes the control points are linearly
+//! interpolated, before the first and after the last keyframe they are held.
+//!
+//! The keyframes and instances are stored as structure of arrays, and the instances are evaluated in LaneBlocks. An
+//! instance is marked as changed if any of its twelve control point components differs from the value in the profile
+//! array, so only growing fruits need to be re-tessellated or looked up in a FruitMeshCache again.
+class FruitMorphAnimation
+{
+public:
+  //! \brief Adds a track and returns its index.
+  //! \throws std::invalid_argument if there are no keyframes or their times are not ascending.
+  ui32 addTrack(const std::vector<FruitKeyframe>& keyframes);
+
+  ui32 getNumTracks() const;
+
+  //! \brief Adds an instance that reaches keyframe time k at startTime + k / rate and returns its index.
+  //! \throws std::out_of_range if the track does not exist.
+  size_t addInstance(ui32 track, f32 startTime, f32 rate = 1.0f);
+
+  //! \brief Changes the track and timing of an instance, e.g., to replant a harvested fruit.
+  //! \throws std::out_of_range if the track does not exist.
+  void setInstance(size_t index, ui32 track, f32 startTime, f32 rate = 1.0f);
+
+  size_t getNumInstances() const;
+
+  //! \brief Evaluates all instances at the given time on all hardware threads. The profile array is resized to the
+  //! number of instances; instances beyond its previous size are marked as changed.
+  void evaluate(f32 time, FruitProfileArray& profiles);
+
+  //! \brief Evaluates the instances [first;last) at the given time into profiles[first;last) and marks the instances
+  //! whose profile changed. The profile array must be large enough. Disjoint ranges may be processed concurrently.
+  void evaluate(f32 time, size_t first, size_t last, FruitProfileArray& profiles);
+
+  //! \brief Returns, per instance, 1 if the last evaluation changed its profile and 0 otherwise.
+  const std::vector<ui8>& getChangedFlags() const;
+
+  //! \brief Returns the indices of the instances the last evaluation changed, in ascending order.
+  void getChangedInstances(std::vector<size_t>& indices) const;
+
+private:
+  //! Keyframes of all tracks, one after the other.
+  std::vector<f32>                                                m_keyframeTimes;
+  std::array<std::vector<f32>, FruitProfileArray::NUM_COMPONENTS> m_keyframeComponents;
+  //! Index of the first keyframe and number of keyframes of each track.
+  std::vector<ui32>                                               m_trackOffsets;
+  std::vector<ui32>                                               m_trackSizes;
+
+  std::vector<ui32> m_instanceTracks;
+  std::vector<f32>  m_startTimes;
+  std::vector<f32>  m_rates;
+  std::vector<ui8>  m_changed;
+};
+} // namespace gims
@@ -0,0 +1,30 @@
+#pragma once
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/types.hpp>
+
+namespace gims
+{
+//! \brief The fruits of the Apples, Pears, Lemons and Strawberries renderers.
+enum class FruitType : ui32
+{
+  Apple,
+  Pear,
+  Lemon,
+  Strawberry,
+  Count
+};
+
+//! Distance along x between neighboring fruits of the renderers, INTER_DISTANCE in their shaders.
+constexpr f32 FRUIT_INTER_DISTANCE = 2.5f;
+
+//! \brief Shape and color of a fruit preset.
+struct FruitPreset
+{
+  const char*  name;
+  FruitProfile profile;
+  f32v3        color;
+};
+
+//! \brief Returns the preset with the control points and TEXTURE_COLOR of the corresponding renderer's shader.
+const FruitPreset& getFruitPreset(FruitType type);
+} // namespace gims
@@ -0,0 +1,99 @@
+#pragma once
+#include <gimslib/types.hpp>
+
+namespace gims
+{
+//! \brief Cubic Bezier profile of a fruit.
+//!
+//! The control points correspond to P0..P3 (resp. p0..p3) of the fruit shaders. The x component of the curve is the
+//! radius of the fruit, the z component its height. The fruit surface is obtained by revolving the curve around the
+//! z axis.
+struct FruitProfile
+{
+  f32v3 p0 = f32v3(0.0f, 0.0f, -0.3f);
+  f32v3 p1 = f32v3(1.0f, 0.0f, -0.7f);
+  f32v3 p2 = f32v3(1.0f, 0.0f, 0.3f);
+  f32v3 p3 = f32v3(0.0f, 0.0f, 1.0f);
+
+  bool operator==(const FruitProfile& other) const = default;
+};
+
+//! \brief Evaluates the profile at t in [0;1] using the same power basis as evaluateCubicBezierCurve in the shaders.
+f32v3 evaluateCubicBezierCurve(const FruitProfile& profile, f32 t);
+
+//! \brief Evaluates the profile at t in [0;1] in double precision. Used as reference.
+f64v3 evaluateCubicBezierCurve(const FruitProfile& profile, f64 t);
+
+//! \brief Evaluates the derivative of the profile with respect to t.
+f32v3 evaluateCubicBezierDerivative(const FruitProfile& profile, f32 t);
+
+//! \brief Maps a point of the [-1;1]^2 octahedral domain onto the unit sphere (octDecode in the shaders).
+f32v3 octDecode(const f32v2& coordinates);
+
+//! \brief Maps a direction onto the [-1;1]^2 octahedral domain. Inverse of octDecode().
+f32v2 octEncode(const f32v3& direction);
+
+//! \brief Revolves the profile to the position on the fruit surface that corresponds to a point on the unit sphere
+//! (calculateFruitCoordinates in the shaders).
+f32v3 calculateFruitCoordinates(const FruitProfile& profile, const f32v3& sphericalCoordinates);
+
+//! \brief Returns the outward unit surface normal at calculateFruitCoordinates(profile, sphericalCoordinates)
+//! (calculateFruitNormal in the shaders, which evaluate it per vertex).
+//!
+//! The surface is R(phi) B(t), so its normal is R(phi) ((-B.y, B.x, 0) x B'(t)) for profiles that run from the bottom
+//! to the top. It is negated for profiles that run from the top to the bottom (p3.z < p0.z), so it always points
+//! outwards. Where it vanishes, i.e., at the poles, the normal is -z at the bottom and +z at the top.
+f32v3 calculateFruitNormal(const FruitProfile& profile, const f32v3& sphericalCoordinates);
+
+//! \brief Returns the side length of the octahedral grid used when n threads are available for one fruit
+//! (calculateIntraLOD in the shaders).
+ui32 calculateIntraLOD(ui32 n);
+
+//! \brief Evaluates the profile at equidistant parameters t0, t0 + dt, t0 + 2 dt, ... by forward differencing.
+//!
+//! After setup, every step costs three vector additions instead of a full polynomial evaluation. The differences are
+//! set up in double precision and stepped in single precision, hence the error grows with the number of steps. Restart
+//! the differencer (e.g., once per row) if many steps are required. For the presets the maximum error is below 2.5e-6
+//! after 64 steps, 1e-5 after 256 steps and 4e-5 after 1024 steps, compared to 1e-6 for direct evaluation. See
+//! measureForwardDifferencingError().
+class BezierForwardDifferencer
+{
+public:
+  //! \brief Constructor.
+  //! \param profile The profile to evaluate.
+  //! \param t0 The first parameter.
+  //! \param dt The parameter step.
+  BezierForwardDifferencer(const FruitProfile& profile, f32 t0, f32 dt);
+
+  //! \brief Returns the curve point at the current parameter.
+  const f32v3& getValue() const;
+
+  //! \brief Advances to the next parameter.
+  void step();
+
+private:
+  f32v3 m_value;
+  f32v3 m_firstDifference;
+  f32v3 m_secondDifference;
+  f32v3 m_thirdDifference;
+};
+
+//! \brief Deviation of float32 profile evaluations from the exact (double precision) curve.
+struct ForwardDifferencingError
+{
+  //! Number of evaluated parameters.
+  ui32 numSamples = 0;
+  //! Maximum Euclidean error of the forward differenced evaluation.
+  f32 forwardDifferencingMaxError = 0.0f;
+  //! Root mean square error of the forward differenced evaluation.
+  f32 forwardDifferencingRmsError = 0.0f;
+  //! Maximum Euclidean error of the direct float32 evaluation.
+  f32 directMaxError = 0.0f;
+  //! Root mean square error of the direct float32 evaluation.
+  f32 directRmsError = 0.0f;
+};
+
+//! \brief Measures the error of forward differencing against direct evaluation over numSamples equidistant parameters
+//! in [0;1].
+ForwardDifferencingError measureForwardDifferencingError(const FruitProfile& profile, ui32 numSamples);
+} // namespace gims
@@ -0,0 +1,45 @@
+#pragma once
+#include <array>
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/types.hpp>
+#include <vector>
+
+namespace gims
+{
+//! \brief Structure of arrays of fruit profiles.
+//!
+//! Each of the twelve control point components (p0.x, p0.y, p0.z, p1.x, ..., p3.z) is stored in its own contiguous
+//! array, so batched kernels can process consecutive fruits in SIMD lanes.
+class FruitProfileArray
+{
+public:
+  //! Number of scalar components per profile.
+  static constexpr ui32 NUM_COMPONENTS = 12;
+
+  FruitProfileArray() = default;
+
+  //! \brief Creates an array of numProfiles default profiles.
+  explicit FruitProfileArray(size_t numProfiles);
+
+  size_t getSize() const;
+
+  void resize(size_t numProfiles);
+
+  void addProfile(const FruitProfile& profile);
+
+  void setProfile(size_t index, const FruitProfile& profile);
+
+  FruitProfile getProfile(size_t index) const;
+
+  //! \brief Returns the array of component c (0 = x, 1 = y, 2 = z) of control point i (0..3).
+  const f32* getComponent(ui32 i, ui32 c) const;
+
+  //! \brief Returns the array of component c (0 = x, 1 = y, 2 = z) of control point i (0..3).
+  f32* getComponent(ui32 i, ui32 c);
+
+  bool operator==(const FruitProfileArray& other) const = default;
+
+private:
+  std::array<std::vector<f32>, NUM_COMPONENTS> m_components;
+};
+} // namespace gims
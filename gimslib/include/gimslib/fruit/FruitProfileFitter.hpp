@@ -0,0 +1,49 @@
+#pragma once
+#include <filesystem>
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/io/CograBinaryMeshFile.hpp>
+#include <gimslib/types.hpp>
+#include <vector>
+
+namespace gims
+{
+//! \brief Result of fitting a fruit profile to a scanned mesh.
+struct FruitProfileFit
+{
+  //! The fitted profile in the coordinate frame of the axis: z runs along axisDirection, starting at axisOrigin.
+  FruitProfile profile;
+  //! Point on the axis of revolution, in mesh coordinates.
+  f32v3 axisOrigin;
+  //! Direction of the axis of revolution, in mesh coordinates.
+  f32v3 axisDirection;
+  //! Symmetric Hausdorff distance between the mesh vertices and the fitted surface, in mesh units.
+  f32 hausdorffError = 0.0f;
+  //! Root mean square distance of the mesh vertices to the fitted surface, in mesh units.
+  f32 rmsError = 0.0f;
+};
+
+//! \brief Fits a cubic Bezier profile to a mesh that is (approximately) a surface of revolution.
+//!
+//! The axis of revolution is the principal axis of the area weighted triangle distribution whose variance differs
+//! most from the other two. The vertices are then projected into the (radius, height) half-plane, averaged into a
+//! radial profile, and P1 and P2 are fitted by linear least squares with parameter correction until the parameters
+//! converge. P0 and P3 are constrained to the axis at the heights where the mesh meets the axis.
+//!
+//! The distance of a vertex to a surface of revolution equals the distance of its projection to the profile, hence
+//! the mesh-to-surface part of the Hausdorff error is exact. The surface-to-mesh part measures the distance of the
+//! profile to the projected mesh edges. For tessellated presets, rotated and translated arbitrarily, both errors stay
+//! below 0.3% of the fruit's size.
+//! Both parts look up the closest segments in uniform grids, so the errors cost about linear time in the mesh size.
+//! \throws std::invalid_argument if the mesh has no triangles or a triangle index is not below the vertex count.
+FruitProfileFit fitFruitProfile(const CograBinaryMeshFile& mesh);
+
+//! \brief Fit of one scan file.
+struct FruitScanFit
+{
+  std::filesystem::path file;
+  FruitProfileFit       fit;
+};
+
+//! \brief Fits all *.cbm files of a directory in parallel. The results are sorted by file name.
+std::vector<FruitScanFit> fitFruitProfiles(const std::filesystem::path& directory);
+} // namespace gims
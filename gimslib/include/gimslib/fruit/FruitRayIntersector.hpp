@@ -0,0 +1,92 @@
+#pragma once
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/types.hpp>
+#include <limits>
+#include <vector>
+
+namespace gims
+{
+//! \brief Intersection of a ray with a fruit.
+struct FruitRayHit
+{
+  //! Ray parameter of the hit: position = origin + distance * direction.
+  f32   distance = std::numeric_limits<f32>::infinity();
+  //! Profile parameter of the hit.
+  f32   t = 0.0f;
+  f32v3 position;
+  //! Outward unit surface normal.
+  f32v3 normal;
+};
+
+//! \brief Structure of arrays of rays.
+struct FruitRayArray
+{
+  std::vector<f32> originX;
+  std::vector<f32> originY;
+  std::vector<f32> originZ;
+  std::vector<f32> directionX;
+  std::vector<f32> directionY;
+  std::vector<f32> directionZ;
+  //! Only hits with a ray parameter in [0;maxDistance] count.
+  std::vector<f32> maxDistance;
+
+  size_t getSize() const;
+
+  void resize(size_t numRays);
+
+  void setRay(size_t index, const f32v3& origin, const f32v3& direction,
+              f32 maxDistance = std::numeric_limits<f32>::infinity());
+};
+
+//! \brief Structure of arrays of FruitRayHit. Misses have an infinite distance.
+struct FruitRayHitArray
+{
+  std::vector<f32> distance;
+  std::vector<f32> t;
+  std::vector<f32> normalX;
+  std::vector<f32> normalY;
+  std::vector<f32> normalZ;
+
+  void resize(size_t numRays);
+};
+
+//! \brief Intersects rays with the surface of revolution of a fruit profile, without tessellation.
+//!
+//! A point at height h and distance rho from the axis lies on the surface if h = z(t) and rho^2 = x(t)^2 + y(t)^2
+//! for some t. Along a ray with direction d, rho^2 is quadratic and h is linear in the ray parameter. Eliminating the
+//! ray parameter yields a polynomial of degree 6 in t. Its roots are bracketed on 32 intervals of [0;1], bisected and
+//! refined by Newton's method on the original two equations in t and the ray parameter, all in double precision: for
+//! flat rays the terms of the polynomial cancel, and in single precision slopes of a few thousandths missed the fruit.
+//! Below a slope of 1e-3 the elimination is ill conditioned even so, and the roots of z(t) = h are bracketed instead. A
+//! bracket without sign change may still hold two roots, e.g., where a flat ray enters and leaves the fruit at almost
+//! the same height. If the derivative changes its sign, the bracket is split at the extremum and both halves are
+//! searched.
+//!
+//! Rays that miss the bounding sphere of the control points are culled. Only rays that graze the silhouette so closely
+//! that both roots fall between two extrema of the polynomial within one bracket may be missed.
+class FruitRayIntersector
+{
+public:
+  explicit FruitRayIntersector(const FruitProfile& profile);
+
+  //! \brief Returns the closest hit with a ray parameter in [0;maxDistance], if any.
+  bool intersect(const f32v3& origin, const f32v3& direction, f32 maxDistance, FruitRayHit& hit) const;
+
+  //! \brief Intersects the rays [first;last). The hit array must be at least as large as the ray array.
+  //!
+  //! The rays are processed in LaneBlocks.
+  void intersect(const FruitRayArray& rays, size_t first, size_t last, FruitRayHitArray& hits) const;
+
+  const f32v3& getBoundingSphereCenter() const;
+
+  f32 getBoundingSphereRadius() const;
+
+private:
+  //! Power basis coefficients of x, y and z.
+  f64   m_coefficients[3][4];
+  //! Power basis coefficients of x(t)^2 + y(t)^2.
+  f64   m_radiusSquaredCoefficients[7];
+  f32v3 m_boundingSphereCenter;
+  f32   m_boundingSphereRadius;
+};
+} // namespace gims
@@ -0,0 +1,74 @@
+#pragma once
+#include <gimslib/fruit/FruitInstance.hpp>
+#include <gimslib/types.hpp>
+#include <limits>
+#include <vector>
+
+namespace gims
+{
+//! \brief Intersection of a ray with a fruit instance, in world space.
+struct FruitSceneHit
+{
+  static constexpr size_t NO_INSTANCE = ~size_t(0);
+
+  //! Index of the hit instance, NO_INSTANCE for a miss.
+  size_t instance = NO_INSTANCE;
+  //! Ray parameter of the hit: position = origin + distance * direction.
+  f32    distance = std::numeric_limits<f32>::infinity();
+  //! Profile parameter of the hit.
+  f32    t = 0.0f;
+  f32v3  position;
+  //! Outward unit surface normal.
+  f32v3  normal;
+};
+
+//! \brief Bounding volume hierarchy over the bounding spheres of fruit instances, e.g., for picking.
+//!
+//! The local bounding sphere of each fruit is derived from its exact bounding box (see computeFruitMeasures), rotated
+//! and translated with the instance. The hierarchy is built top down by splitting the instances at the median of their
+//! centers along the largest extent, down to four instances per leaf. Its nodes are stored depth first in 32 bytes
+//! each, the first child directly after its parent.
+//!
+//! A query visits the nearer child first and skips nodes behind the closest hit so far. The ray is transformed into
+//! the local frame of each candidate and intersected analytically with FruitRayIntersector, so no tessellation is
+//! needed and the hit is exact up to the precision of the intersector.
+class FruitSceneBVH
+{
+public:
+  //! \brief Builds the hierarchy. The bounds of the instances are computed in parallel.
+  explicit FruitSceneBVH(const FruitInstanceArray& instances);
+
+  //! \brief Returns the closest hit with a ray parameter in [0;maxDistance], if any.
+  //!
+  //! The instances must be the ones the hierarchy was built for. Concurrent queries are safe.
+  bool intersect(const FruitInstanceArray& instances, const f32v3& origin, const f32v3& direction, f32 maxDistance,
+                 FruitSceneHit& hit) const;
+
+  size_t getNumInstances() const;
+
+  size_t getNumNodes() const;
+
+  //! \brief Returns the bounding box of all instances.
+  void getBounds(f32v3& aabbMin, f32v3& aabbMax) const;
+
+private:
+  struct Node
+  {
+    f32v3 aabbMin;
+    //! Inner node: index of the second child. Leaf: index of the first entry of m_instanceIndices.
+    ui32  offset;
+    f32v3 aabbMax;
+    //! Number of instances of a leaf, 0 for inner nodes.
+    ui32  count;
+  };
+  static_assert(sizeof(Node) == 32);
+
+  //! Builds the subtree over m_instanceIndices[first;last) and appends its nodes.
+  void build(ui32 first, ui32 last);
+
+  std::vector<Node>  m_nodes;
+  std::vector<ui32>  m_instanceIndices;
+  //! World space bounding sphere (center, radius) of each instance.
+  std::vector<f32v4> m_spheres;
+};
+} // namespace gims
@@ -0,0 +1,38 @@
+#pragma once
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/types.hpp>
+#include <vector>
+
+namespace gims
+{
+//! \brief Points on a fruit surface, e.g., for instancing seeds, pores or spots.
+struct FruitSurfaceSamples
+{
+  //! Position of each sample in the [-1;1]^2 octahedral domain.
+  std::vector<f32v2> octahedralCoordinates;
+  //! Position on the fruit surface, calculateFruitCoordinates(octDecode(octahedralCoordinates)).
+  std::vector<f32v3> positions;
+  //! Outward unit surface normal.
+  std::vector<f32v3> normals;
+  //! No two samples are closer than this (Euclidean) distance.
+  f32                radius = 0.0f;
+};
+
+//! \brief Distributes blue noise samples on the surface of a fruit.
+//!
+//! Candidates are drawn in the octahedral domain with a density proportional to the area of the fruit surface they
+//! map to, so they are uniform on the surface despite the distortion of octDecode and the profile. The density is
+//! piecewise constant on a 128 x 128 grid and sampled with an alias table. A candidate is accepted if no accepted
+//! sample lies within the radius, measured in 3D on the surface. Hence the distribution is seamless across the folds
+//! of the octahedral domain. A spatial hash grid restricts the test to the 8 cells that overlap the ball around the
+//! candidate.
+//!
+//! The radius is chosen such that the requested number of samples fills 60% of the maximum density of random
+//! sequential packing. Fewer samples are returned only if the surface is degenerate. The result depends only on the
+//! profile, the number of samples and the seed, not on the number of threads.
+//!
+//! Candidates are generated in batches and tested against the samples of the previous batches in parallel. Only the
+//! survivors are tested and inserted serially, in order. 100k samples take about 0.12 s on a single core, of which
+//! about 30 ms for the roughly 103k survivors remain serial.
+FruitSurfaceSamples sampleFruitSurface(const FruitProfile& profile, ui32 numSamples, ui64 seed);
+} // namespace gims
@@ -0,0 +1,35 @@
+#pragma once
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/io/CograBinaryMeshFile.hpp>
+#include <gimslib/types.hpp>
+#include <vector>
+
+namespace gims
+{
+//! \brief Triangle mesh of a fruit tessellated on the CPU.
+struct FruitMesh
+{
+  std::vector<f32v3>  positions;
+  std::vector<ui32v3> indices;
+};
+
+//! \brief Tessellates the fruit on an intraLOD x intraLOD octahedral grid.
+//!
+//! Vertex order, triangle order and the diagonal flip pattern are identical to MS_main of the fruit shaders. The grids
+//! 3, 5, 7, 9 and 11 are copied from the compile-time tables of FRUIT_TOPOLOGY.
+//! \param profile The fruit profile.
+//! \param intraLOD Side length of the grid, see calculateIntraLOD().
+FruitMesh tessellateFruit(const FruitProfile& profile, ui32 intraLOD);
+
+//! \brief Tessellates the fruit into rings of constant curve parameter t.
+//!
+//! The rings are equidistant in t, so the profile is evaluated by forward differencing instead of evaluating the
+//! curve once per ring. Each ring consists of numSectors vertices.
+//! \param profile The fruit profile.
+//! \param numRings Number of rings, at least 2. The first ring is at t = 0, the last at t = 1.
+//! \param numSectors Number of vertices per ring, at least 3.
+FruitMesh tessellateFruitRings(const FruitProfile& profile, ui32 numRings, ui32 numSectors);
+
+//! \brief Returns the mesh as an indexed mesh file, e.g., to fit it like a scan with fitFruitProfile().
+CograBinaryMeshFile toCograBinaryMeshFile(const FruitMesh& mesh);
+} // namespace gims
@@ -0,0 +1,73 @@
+#pragma once
+#include <gimslib/types.hpp>
+#include <vector>
+
+namespace gims
+{
+//! \brief Splits the octahedral grid of a fruit into tiles that each fit into one mesh shader group.
+//!
+//! The grid has gridSize x gridSize vertices, like tessellateFruit(). Its gridSize - 1 quads per side are divided into
+//! tilesPerSide nearly equal ranges, tile t covering the quads [t * (gridSize - 1) / tilesPerSide; (t + 1) *
+//! (gridSize - 1) / tilesPerSide). Neighboring tiles both emit the vertices of their shared edge from the same grid
+//! coordinates, so the edge is evaluated bit-identically and the mesh has no cracks. MS_main of Fruits.hlsl uses the
+//! same formulas; tile i of fruit j is culled by thread i % 32 of amplification shader group j * ceil(getNumTiles() /
+//! 32) + i / 32, which launches one mesh shader group per visible tile.
+struct FruitTiling
+{
+  //! At most MAX_QUADS x MAX_QUADS quads per tile: (11 + 1)^2 = 144 vertices and 2 * 11^2 = 242 triangles fit the 256
+  //! vertices and 256 triangles of a mesh shader group.
+  static constexpr ui32 MAX_QUADS     = 11;
+  //! 1024 quads per side and about 2M triangles per fruit.
+  static constexpr ui32 MAX_GRID_SIZE = 1025;
+
+  ui32 gridSize     = 0;
+  ui32 tilesPerSide = 0;
+
+  //! \brief Returns tilesPerSide^2.
+  ui32 getNumTiles() const;
+  //! \brief Returns the number of triangles of all tiles, 2 * (gridSize - 1)^2.
+  ui32 getNumTriangles() const;
+};
+
+//! \brief A rectangle of quads of the grid.
+struct FruitTile
+{
+  //! Grid coordinates of the first vertex.
+  ui32 firstX    = 0;
+  ui32 firstY    = 0;
+  ui32 numQuadsX = 0;
+  ui32 numQuadsY = 0;
+
+  ui32 getNumVertices() const;
+  ui32 getNumTriangles() const;
+};
+
+//! \brief One tile tessellated like MS_main does it.
+struct FruitMeshlet
+{
+  //! Index y * gridSize + x of the grid vertex of each meshlet vertex.
+  std::vector<ui32>   vertices;
+  //! Triangles, indexing vertices.
+  std::vector<ui32v3> triangles;
+};
+
+//! \brief Plans the tiles of a grid with the fewest tiles per side.
+//! \throws std::invalid_argument if gridSize is not in [2;MAX_GRID_SIZE].
+FruitTiling planFruitTiling(ui32 gridSize);
+
+//! \brief Returns tile tileIndex = y * tilesPerSide + x.
+//! \throws std::out_of_range if the tile does not exist.
+FruitTile getFruitTile(const FruitTiling& tiling, ui32 tileIndex);
+
+//! \brief Returns the grid coordinates of vertex (vertex % (numQuadsX + 1), vertex / (numQuadsX + 1)) of the tile.
+ui32v2 getFruitTileVertex(const FruitTile& tile, ui32 vertex);
+
+//! \brief Returns the vertices of triangle 2 * (y * numQuadsX + x) + {0, 1} of quad (x, y) of the tile.
+//!
+//! The diagonals follow the flip rule of tessellateFruit() applied to the grid coordinates, so the union of all tiles
+//! has the same triangles as tessellateFruit(profile, gridSize).
+ui32v3 getFruitTileTriangle(const FruitTiling& tiling, const FruitTile& tile, ui32 triangle);
+
+//! \brief Tessellates all tiles.
+std::vector<FruitMeshlet> buildFruitMeshlets(const FruitTiling& tiling);
+} // namespace gims
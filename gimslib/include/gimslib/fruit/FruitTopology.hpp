@@ -0,0 +1,122 @@
+#pragma once
+#include <array>
+#include <filesystem>
+#include <gimslib/types.hpp>
+#include <string>
+
+namespace gims
+{
+//! \brief Vertex parameters and triangles of the intra LOD grids of calculateIntraLOD(), computed at compile time.
+//!
+//! The grids are concatenated: the vertices of grid i start at vertexOffsets[i], its triangles at triangleOffsets[i].
+//! Vertex y * n + x of an n x n grid has the octahedral parameters (2 x / (n - 1) - 1, 2 y / (n - 1) - 1); triangle
+//! indices are local to the grid. Triangle order and the diagonal flip rule are those of tessellateFruit(). The same
+//! tables are emitted as HLSL by fruitTopologyToHLSL(), so the CPU tessellator and MS_main share one topology.
+struct FruitTopologyTables
+{
+  static constexpr std::array<ui32, 5> INTRA_LODS    = {3, 5, 7, 9, 11};
+  static constexpr ui32                NUM_LODS      = static_cast<ui32>(INTRA_LODS.size());
+  //! Sum of n^2 over INTRA_LODS.
+  static constexpr ui32                NUM_VERTICES  = 9 + 25 + 49 + 81 + 121;
+  //! Sum of 2 (n - 1)^2 over INTRA_LODS.
+  static constexpr ui32                NUM_TRIANGLES = 2 * (4 + 16 + 36 + 64 + 100);
+
+  std::array<ui32, NUM_LODS>                      vertexOffsets   = {};
+  std::array<ui32, NUM_LODS>                      triangleOffsets = {};
+  std::array<std::array<f32, 2>, NUM_VERTICES>    parameters      = {};
+  std::array<std::array<ui32, 3>, NUM_TRIANGLES> triangles       = {};
+};
+
+//! \brief Builds the tables. Evaluated at compile time for FRUIT_TOPOLOGY.
+constexpr FruitTopologyTables makeFruitTopologyTables()
+{
+  FruitTopologyTables result;
+  ui32                vertex   = 0;
+  ui32                triangle = 0;
+  for (ui32 lod = 0; lod < FruitTopologyTables::NUM_LODS; lod++)
+  {
+    const ui32 n                = FruitTopologyTables::INTRA_LODS[lod];
+    result.vertexOffsets[lod]   = vertex;
+    result.triangleOffsets[lod] = triangle;
+    for (ui32 y = 0; y < n; y++)
+    {
+      for (ui32 x = 0; x < n; x++)
+      {
+        result.parameters[vertex++] = {static_cast<f32>(2 * x) / static_cast<f32>(n - 1) - 1.0f,
+                                       static_cast<f32>(2 * y) / static_cast<f32>(n - 1) - 1.0f};
+      }
+    }
+
+    const ui32 half = n / 2;
+    for (ui32 y = 0; y < n - 1; y++)
+    {
+      for (ui32 x = 0; x < n - 1; x++)
+      {
+        const ui32 current      = y * n + x;
+        const ui32 right        = current + 1;
+        const ui32 bottom       = current + n;
+        const ui32 bottomRight  = bottom + 1;
+        const bool noFlipNeeded = (x < half && y < half) || (x >= half && y >= half);
+        if (noFlipNeeded)
+        {
+          result.triangles[triangle++] = {current, right, bottom};
+          result.triangles[triangle++] = {right, bottomRight, bottom};
+        }
+        else
+        {
+          result.triangles[triangle++] = {current, right, bottomRight};
+          result.triangles[triangle++] = {bottomRight, bottom, current};
+        }
+      }
+    }
+  }
+  return result;
+}
+
+inline constexpr FruitTopologyTables FRUIT_TOPOLOGY = makeFruitTopologyTables();
+
+//! \brief Returns the index of an intra LOD grid in the tables, or -1 if there is no table for it.
+constexpr i32 getFruitTopologyIndex(ui32 intraLOD)
+{
+  for (ui32 lod = 0; lod < FruitTopologyTables::NUM_LODS; lod++)
+  {
+    if (FruitTopologyTables::INTRA_LODS[lod] == intraLOD)
+    {
+      return static_cast<i32>(lod);
+    }
+  }
+  return -1;
+}
+
+// MS_main of Fruits.hlsl finds the entry of grid n as (n - 3) / 2.
+static_assert([]
+              {
+                for (ui32 lod = 0; lod < FruitTopologyTables::NUM_LODS; lod++)
+                {
+                  if (FruitTopologyTables::INTRA_LODS[lod] != 2 * lod + 3)
+                  {
+                    return false;
+                  }
+                }
+                return true;
+              }());
+static_assert(FRUIT_TOPOLOGY.vertexOffsets[FruitTopologyTables::NUM_LODS - 1] + 11 * 11 ==
+              FruitTopologyTables::NUM_VERTICES);
+static_assert(FRUIT_TOPOLOGY.triangleOffsets[FruitTopologyTables::NUM_LODS - 1] + 2 * 10 * 10 ==
+              FruitTopologyTables::NUM_TRIANGLES);
+static_assert(FRUIT_TOPOLOGY.parameters[FruitTopologyTables::NUM_VERTICES - 1][0] == 1.0f &&
+              FRUIT_TOPOLOGY.parameters[FruitTopologyTables::NUM_VERTICES - 1][1] == 1.0f);
+
+//! \brief Returns the tables as HLSL static arrays FRUIT_TOPOLOGY_INTRA_LODS, FRUIT_TOPOLOGY_VERTEX_OFFSETS,
+//! FRUIT_TOPOLOGY_TRIANGLE_OFFSETS, FRUIT_TOPOLOGY_PARAMETERS (float2) and FRUIT_TOPOLOGY_TRIANGLES (uint3).
+//!
+//! Floats are printed with 9 significant digits, so the shader compiler reads back the very same values.
+std::string fruitTopologyToHLSL();
+
+//! \brief Writes fruitTopologyToHLSL() to a file, e.g., the FruitTopology.hlsli included by Fruits.hlsl.
+//!
+//! The shaders include a committed copy, which the tool FruitTopologyWriter regenerates and FruitTopologyTest compares
+//! with the tables.
+//! \throws std::runtime_error if the file cannot be written.
+void writeFruitTopologyHLSL(const std::filesystem::path& fileName);
+} // namespace gims
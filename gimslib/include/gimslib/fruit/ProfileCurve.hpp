@@ -0,0 +1,271 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <format>
+#include <gimslib/types.hpp>
+#include <string>
+#include <utility>
+
+namespace gims
+{
+//! Tag for Bezier curves. The second template argument of ProfileCurve is the degree.
+struct Bezier
+{
+};
+
+//! Tag for uniform cubic B-splines. The second template argument of ProfileCurve is the number of segments.
+struct UniformBSpline
+{
+};
+
+//! \brief Profile curve of a fruit, specialized at compile time for its type and degree or number of segments.
+//!
+//! The basis matrices are constexpr, and so is the conversion of the control points into power basis coefficients: a
+//! constexpr curve has its coefficients computed at compile time. The curve is evaluated by a fully unrolled Horner
+//! scheme. toHLSL() emits the very same power basis as shader code.
+template<class CurveType, ui32 N> class ProfileCurve;
+
+namespace ProfileCurveDetail
+{
+constexpr f32 binomial(ui32 n, ui32 k)
+{
+  f32 result = 1.0f;
+  for (ui32 i = 1; i <= k; i++)
+  {
+    result = result * static_cast<f32>(n - k + i) / static_cast<f32>(i);
+  }
+  return result;
+}
+
+//! Row k holds the weights of the control points for the coefficient of t^k.
+template<ui32 Degree> constexpr std::array<std::array<f32, Degree + 1>, Degree + 1> bezierPowerBasis()
+{
+  std::array<std::array<f32, Degree + 1>, Degree + 1> result = {};
+  for (ui32 k = 0; k <= Degree; k++)
+  {
+    for (ui32 i = 0; i <= k; i++)
+    {
+      const f32 sign = (k - i) % 2 == 0 ? 1.0f : -1.0f;
+      result[k][i]   = sign * binomial(Degree, k) * binomial(k, i);
+    }
+  }
+  return result;
+}
+
+//! Row k holds the weights of the four segment control points for the coefficient of t^k.
+constexpr std::array<std::array<f32, 4>, 4> uniformCubicBSplinePowerBasis()
+{
+  return {{{1.0f / 6.0f, 4.0f / 6.0f, 1.0f / 6.0f, 0.0f},
+           {-3.0f / 6.0f, 0.0f, 3.0f / 6.0f, 0.0f},
+           {3.0f / 6.0f, -6.0f / 6.0f, 3.0f / 6.0f, 0.0f},
+           {-1.0f / 6.0f, 3.0f / 6.0f, -3.0f / 6.0f, 1.0f / 6.0f}}};
+}
+
+//! Returns weights[0] controlPoints[first] + weights[1] controlPoints[first + 1] + ..., component by component, so that
+//! it is a constant expression whether or not the vector operators of glm are constexpr.
+template<size_t NumWeights, size_t NumControlPoints>
+constexpr f32v3 combine(const std::array<f32, NumWeights>&         weights,
+                        const std::array<f32v3, NumControlPoints>& controlPoints, size_t first)
+{
+  f32 x = 0.0f;
+  f32 y = 0.0f;
+  f32 z = 0.0f;
+  for (size_t i = 0; i < NumWeights && first + i < NumControlPoints; i++)
+  {
+    x += weights[i] * controlPoints[first + i].x;
+    y += weights[i] * controlPoints[first + i].y;
+    z += weights[i] * controlPoints[first + i].z;
+  }
+  return f32v3(x, y, z);
+}
+
+template<ui32 NumCoefficients, size_t... I>
+inline f32v3 evaluateHorner(const f32v3* coefficients, f32 t, std::index_sequence<I...>)
+{
+  f32v3 result = coefficients[NumCoefficients - 1];
+  ((result = result * t + coefficients[NumCoefficients - 2 - I]), ...);
+  return result;
+}
+
+//! Evaluates c[0] + t c[1] + ... + t^(NumCoefficients - 1) c[NumCoefficients - 1].
+template<ui32 NumCoefficients> inline f32v3 evaluateHorner(const f32v3* coefficients, f32 t)
+{
+  return evaluateHorner<NumCoefficients>(coefficients, t, std::make_index_sequence<NumCoefficients - 1>());
+}
+
+inline std::string formatFloat3(const f32v3& v)
+{
+  return std::format("float3({:.9g}, {:.9g}, {:.9g})", v.x, v.y, v.z);
+}
+
+//! Emits c[0] + t * (c[1] + t * (...)) in HLSL.
+inline std::string hornerToHLSL(const std::string* coefficients, ui32 numCoefficients, const std::string& t)
+{
+  std::string result = coefficients[numCoefficients - 1];
+  for (ui32 i = numCoefficients - 1; i > 0; i--)
+  {
+    result = coefficients[i - 1] + " + " + t + " * (" + result + ")";
+  }
+  return result;
+}
+} // namespace ProfileCurveDetail
+
+//! \brief Bezier curve of arbitrary degree.
+template<ui32 Degree> class ProfileCurve<Bezier, Degree>
+{
+  static_assert(Degree >= 1, "A Bezier curve needs a degree of at least one.");
+
+public:
+  static constexpr ui32 NUM_CONTROL_POINTS = Degree + 1;
+  static constexpr ui32 NUM_COEFFICIENTS   = Degree + 1;
+  static constexpr auto POWER_BASIS        = ProfileCurveDetail::bezierPowerBasis<Degree>();
+
+  //! \brief Constructor.
+  //! \param controlPoints The control points. Like P0..P3 of the cubic fruits, x is the radius and z the height.
+  constexpr explicit ProfileCurve(const std::array<f32v3, NUM_CONTROL_POINTS>& controlPoints)
+      : m_controlPoints(controlPoints)
+      , m_coefficients(computeCoefficients(controlPoints))
+  {
+  }
+
+  //! \brief Evaluates the curve at t in [0;1].
+  f32v3 evaluate(f32 t) const
+  {
+    return ProfileCurveDetail::evaluateHorner<NUM_COEFFICIENTS>(m_coefficients.data(), t);
+  }
+
+  constexpr const std::array<f32v3, NUM_CONTROL_POINTS>& getControlPoints() const
+  {
+    return m_controlPoints;
+  }
+
+  //! \brief Returns the power basis coefficients, lowest power first.
+  constexpr const std::array<f32v3, NUM_COEFFICIENTS>& getCoefficients() const
+  {
+    return m_coefficients;
+  }
+
+  //! \brief Returns an HLSL function "float3 functionName(float t)" that evaluates this curve.
+  std::string toHLSL(const std::string& functionName) const
+  {
+    std::array<std::string, NUM_COEFFICIENTS> coefficients;
+    for (ui32 k = 0; k < NUM_COEFFICIENTS; k++)
+    {
+      coefficients[k] = ProfileCurveDetail::formatFloat3(m_coefficients[k]);
+    }
+    return std::format("float3 {}(float t)\n{{\n    return {};\n}}\n", functionName,
+                       ProfileCurveDetail::hornerToHLSL(coefficients.data(), NUM_COEFFICIENTS, "t"));
+  }
+
+private:
+  static constexpr std::array<f32v3, NUM_COEFFICIENTS> computeCoefficients(
+      const std::array<f32v3, NUM_CONTROL_POINTS>& controlPoints)
+  {
+    std::array<f32v3, NUM_COEFFICIENTS> result = {};
+    for (ui32 k = 0; k < NUM_COEFFICIENTS; k++)
+    {
+      result[k] = ProfileCurveDetail::combine(POWER_BASIS[k], controlPoints, 0);
+    }
+    return result;
+  }
+
+  std::array<f32v3, NUM_CONTROL_POINTS> m_controlPoints;
+  std::array<f32v3, NUM_COEFFICIENTS>   m_coefficients;
+};
+
+//! \brief Uniform cubic B-spline with the given number of segments.
+//!
+//! The spline does not pass through its first and last control points. To close the fruit at the poles, place the
+//! first (resp. last) three control points on the axis, or repeat the end points three times.
+template<ui32 Segments> class ProfileCurve<UniformBSpline, Segments>
+{
+  static_assert(Segments >= 1, "A B-spline needs at least one segment.");
+
+public:
+  static constexpr ui32 NUM_CONTROL_POINTS = Segments + 3;
+  static constexpr ui32 NUM_COEFFICIENTS   = 4 * Segments;
+  static constexpr auto POWER_BASIS        = ProfileCurveDetail::uniformCubicBSplinePowerBasis();
+
+  //! \brief Constructor.
+  //! \param controlPoints The control points, x is the radius and z the height.
+  constexpr explicit ProfileCurve(const std::array<f32v3, NUM_CONTROL_POINTS>& controlPoints)
+      : m_controlPoints(controlPoints)
+      , m_coefficients(computeCoefficients(controlPoints))
+  {
+  }
+
+  //! \brief Evaluates the curve at t in [0;1]. Each segment covers 1 / Segments of the parameter range.
+  f32v3 evaluate(f32 t) const
+  {
+    const f32  u       = std::clamp(t, 0.0f, 1.0f) * static_cast<f32>(Segments);
+    const ui32 segment = std::min(static_cast<ui32>(u), Segments - 1);
+    return ProfileCurveDetail::evaluateHorner<4>(&m_coefficients[4 * segment], u - static_cast<f32>(segment));
+  }
+
+  constexpr const std::array<f32v3, NUM_CONTROL_POINTS>& getControlPoints() const
+  {
+    return m_controlPoints;
+  }
+
+  //! \brief Returns the power basis coefficients, four per segment, lowest power first.
+  constexpr const std::array<f32v3, NUM_COEFFICIENTS>& getCoefficients() const
+  {
+    return m_coefficients;
+  }
+
+  //! \brief Returns an HLSL function "float3 functionName(float t)" that evaluates this curve, preceded by the
+  //! coefficient table it reads from.
+  std::string toHLSL(const std::string& functionName) const
+  {
+    std::string table;
+    for (ui32 k = 0; k < NUM_COEFFICIENTS; k++)
+    {
+      table += std::format("        {}{}\n", ProfileCurveDetail::formatFloat3(m_coefficients[k]),
+                           k + 1 < NUM_COEFFICIENTS ? "," : "");
+    }
+    const std::array<std::string, 4> coefficients = {"coefficients[i]", "coefficients[i + 1]", "coefficients[i + 2]",
+                                                     "coefficients[i + 3]"};
+    return std::format("float3 {0}(float t)\n"
+                       "{{\n"
+                       "    static const float3 coefficients[{1}] =\n"
+                       "    {{\n"
+                       "{2}"
+                       "    }};\n"
+                       "    const float u = saturate(t) * {3};\n"
+                       "    const uint segment = min((uint)u, {4});\n"
+                       "    const float l = u - segment;\n"
+                       "    const uint i = 4 * segment;\n"
+                       "    return {5};\n"
+                       "}}\n",
+                       functionName, NUM_COEFFICIENTS, table, Segments, Segments - 1,
+                       ProfileCurveDetail::hornerToHLSL(coefficients.data(), 4, "l"));
+  }
+
+private:
+  static constexpr std::array<f32v3, NUM_COEFFICIENTS> computeCoefficients(
+      const std::array<f32v3, NUM_CONTROL_POINTS>& controlPoints)
+  {
+    std::array<f32v3, NUM_COEFFICIENTS> result = {};
+    for (ui32 s = 0; s < Segments; s++)
+    {
+      for (ui32 k = 0; k < 4; k++)
+      {
+        result[4 * s + k] = ProfileCurveDetail::combine(POWER_BASIS[k], controlPoints, s);
+      }
+    }
+    return result;
+  }
+
+  std::array<f32v3, NUM_CONTROL_POINTS> m_controlPoints;
+  std::array<f32v3, NUM_COEFFICIENTS>   m_coefficients;
+};
+
+static_assert(ProfileCurve<Bezier, 3>::POWER_BASIS[3][0] == -1.0f &&
+                  ProfileCurve<Bezier, 3>::POWER_BASIS[2][1] == -6.0f,
+              "Unexpected cubic Bezier power basis.");
+static_assert(ProfileCurve<Bezier, 3>({f32v3(0.0f, 0.0f, -0.5f), f32v3(1.0f, 0.0f, -0.5f), f32v3(1.0f, 0.0f, 0.5f),
+                                       f32v3(0.0f, 0.0f, 0.5f)})
+                      .getCoefficients()[2]
+                      .x == -3.0f,
+              "Unexpected coefficients of a constexpr cubic Bezier curve.");
+} // namespace gims
@@ -0,0 +1,33 @@
+#pragma once
+#include <array>
+#include <gimslib/types.hpp>
+#include <string>
+
+namespace gims
+{
+//! \brief Incremental SHA-256 after FIPS 180-4.
+class Sha256
+{
+public:
+  using Digest = std::array<ui8, 32>;
+
+  Sha256();
+
+  //! \brief Appends bytes to the message.
+  void update(const void* data, size_t size);
+
+  //! \brief Returns the digest of the message so far. The message can be continued afterwards.
+  Digest getDigest() const;
+
+  //! \brief Returns the digest as 64 lowercase hexadecimal digits.
+  static std::string toString(const Digest& digest);
+
+private:
+  void processBlock(const ui8* block);
+
+  std::array<ui32, 8> m_state;
+  //! The bytes of the incomplete block, m_numBytes % 64 of them.
+  std::array<ui8, 64> m_block;
+  ui64                m_numBytes;
+};
+} // namespace gims
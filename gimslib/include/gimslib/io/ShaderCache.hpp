@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <filesystem>
+#include <gimslib/io/Sha256.hpp>
+#include <gimslib/types.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace gims
+{
+//! \brief 128 bit content hash of everything that determines a compiled shader.
+struct ShaderCacheKey
+{
+  ui64 low  = 0;
+  ui64 high = 0;
+
+  bool operator==(const ShaderCacheKey& other) const = default;
+
+  //! \brief Returns the key as 32 hexadecimal digits, high first, the file name of its cache entry.
+  std::string toString() const;
+};
+
+//! \brief Builds a ShaderCacheKey incrementally.
+//!
+//! The key is the SHA-256 digest of the bytes truncated to 128 bits: high holds the digest bytes 0 to 7 and low the
+//! bytes 8 to 15, both big endian, so toString() returns the first 32 digits of the hexadecimal digest. Strings are
+//! added with their length, so the concatenation of the parts cannot collide with a different split of the same bytes.
+class ShaderCacheKeyBuilder
+{
+public:
+  void add(const void* data, size_t size);
+  void add(const std::string& string);
+  void add(const std::wstring& string);
+
+  //! \brief Adds the shader file and, recursively, every file it includes.
+  //!
+  //! This stands in for the preprocessed source, which only the compiler can produce: each #include "..." or <...>
+  //! line is followed, whether or not the preprocessor would take it, relative to the including file and then to the
+  //! include directories. Every file is added once, in the order of its first inclusion. Includes that cannot be found
+  //! are added by name. Hence, the key changes whenever the preprocessed source can.
+  //! \throws std::runtime_error if shaderFile cannot be read.
+  void addSourceFiles(const std::filesystem::path&              shaderFile,
+                      const std::vector<std::filesystem::path>& includeDirectories);
+
+  ShaderCacheKey getKey() const;
+
+private:
+  Sha256 m_hash;
+};
+
+//! \brief Persistent cache of compiled shaders, one file per key in a directory.
+//!
+//! Entries are written to a temporary file in the directory and renamed into place, so concurrent processes only ever
+//! see complete entries. Each entry carries its key, size and a checksum; an entry that does not match is a miss and
+//! is removed. The modification time of an entry is its last use: hits refresh it, and stores evict the least recently
+//! used entries until the directory fits the byte budget. The cache is an optimization, so failing I/O turns into
+//! misses and unstored entries, never into exceptions. All methods may be called concurrently.
+class ShaderCache
+{
+public:
+  //! \brief Constructor. Creates the directory if it does not exist.
+  //! \param byteBudget Maximum total size of the entries.
+  ShaderCache(const std::filesystem::path& directory, ui64 byteBudget);
+
+  //! \brief Returns the blob of the key, or nothing on a miss.
+  std::optional<std::vector<ui8>> load(const ShaderCacheKey& key);
+
+  //! \brief Stores the blob of the key and evicts entries over the byte budget. Returns false if it failed.
+  bool store(const ShaderCacheKey& key, const void* data, size_t size);
+
+  //! \brief Removes all entries.
+  void clear();
+
+  const std::filesystem::path& getDirectory() const;
+  ui64                         getByteBudget() const;
+  //! \brief Returns the total size of the entries in the directory.
+  ui64                         getSizeInBytes() const;
+  ui64                         getNumHits() const;
+  ui64                         getNumMisses() const;
+
+private:
+  std::filesystem::path getEntryPath(const ShaderCacheKey& key) const;
+  void                  evict(const std::filesystem::path& keep);
+
+  const std::filesystem::path m_directory;
+  const ui64                  m_byteBudget;
+  std::atomic<ui64>           m_numHits;
+  std::atomic<ui64>           m_numMisses;
+  std::atomic<ui64>           m_numTemporaryFiles;
+};
+} // namespace gims
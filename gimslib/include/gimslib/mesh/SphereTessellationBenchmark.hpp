@@ -0,0 +1,66 @@
+#pragma once
+#include <gimslib/types.hpp>
+
+namespace gims
+{
+//! \brief The unit sphere tessellations of the assignments.
+enum class SphereTessellation : ui32
+{
+  //! The latitude/longitude grid of Sphere.hlsl of AXUVSphereWithIntraLOD: L x L quads, in patches of 10 x 10.
+  UVSphere,
+  //! The octahedral grid of AXOctasphereWithIntraLOD and the fruits: n x n vertices mapped by octDecode(), with the
+  //! diagonal flip rule of FruitTopologyTables, in tiles of 10 x 10 quads.
+  Octasphere,
+  //! subdivideOctasphere().
+  SubdividedOctasphere,
+  Count
+};
+
+//! \brief Returns the name of the tessellation for the UI.
+const char* getSphereTessellationName(SphereTessellation tessellation);
+
+//! \brief Accuracy and cost of a sphere tessellation.
+struct SphereTessellationBenchmark
+{
+  SphereTessellation tessellation           = SphereTessellation::UVSphere;
+  //! L of the UV sphere, n of the octasphere, or the subdivision depth.
+  ui32               resolution             = 0;
+  size_t             numVertices            = 0;
+  size_t             numTriangles           = 0;
+  //! Triangles below 1e-6 of the mean area, i.e., the pole rows of the UV sphere. They count for the vertices per
+  //! triangle but not for the area and shape statistics.
+  size_t             numDegenerateTriangles = 0;
+
+  //! Maximum distance of the triangles from the unit sphere, exact.
+  f32 maxDeviation = 0.0f;
+  //! Root mean square distance from the unit sphere over the area of the triangles, 16 points per triangle.
+  f32 rmsDeviation = 0.0f;
+
+  //! Smallest over largest triangle area.
+  f32 minMaxAreaRatio  = 0.0f;
+  //! Standard deviation of the triangle areas over their mean.
+  f32 areaVariation    = 0.0f;
+  //! 4 sqrt(3) area / (a^2 + b^2 + c^2), i.e., 1 for equilateral triangles and 0 for slivers.
+  f32 minShapeQuality  = 0.0f;
+  f32 meanShapeQuality = 0.0f;
+
+  //! Indexed vertices per triangle.
+  f32 verticesPerTriangle        = 0.0f;
+  //! Vertices per triangle that mesh shader groups of up to 128 vertices and 256 triangles emit, with each group
+  //! taking as many consecutive triangles as fit. This is the vertex cost of the tessellation on the GPU.
+  f32 meshletVerticesPerTriangle = 0.0f;
+
+  //! Generated triangles per second, including the vertices. All tessellations generate on all hardware threads: the
+  //! grids a row of tiles per task, the subdivision blocks of edges and triangles per task.
+  f64 trianglesPerSecond = 0.0;
+};
+
+//! \brief Tessellates the unit sphere with the resolution whose triangle count is closest to numTriangles and measures
+//! the result.
+//!
+//! The octasphere matches the subdivided octasphere exactly for 8 * 4^d triangles, i.e., n = 2^(d + 1) + 1; the UV
+//! sphere comes within a few percent, as L is a multiple of the patch size 10. Compare the per-triangle figures. The
+//! generation is repeated for at least 50 ms. The SphereTessellationBenchmark tool prints the results for several
+//! budgets.
+SphereTessellationBenchmark benchmarkSphereTessellation(SphereTessellation tessellation, size_t numTriangles);
+} // namespace gims
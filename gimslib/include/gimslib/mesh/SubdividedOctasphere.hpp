@@ -0,0 +1,39 @@
+#pragma once
+#include <gimslib/io/CograBinaryMeshFile.hpp>
+#include <gimslib/types.hpp>
+#include <vector>
+
+namespace gims
+{
+//! \brief The unit octahedron subdivided by edge midpoints, with the midpoints projected onto the unit sphere.
+//!
+//! Each level splits every triangle (a, b, c) into (a, ab, ca), (ab, b, bc), (ca, bc, c) and (ab, bc, ca). Depth d has
+//! 8 * 4^d triangles and 4^(d + 1) + 2 vertices, every vertex shared by all of its triangles. Triangles are outward
+//! facing, i.e., cross(p[y] - p[x], p[z] - p[x]) points away from the origin.
+struct SubdividedOctasphere
+{
+  //! 67M vertices and 134M triangles, about 2.4 GB.
+  static constexpr ui32 MAX_DEPTH = 12;
+
+  //! Unit length.
+  std::vector<f32v3>  positions;
+  std::vector<ui32v3> indices;
+};
+
+//! \brief Subdivides the octahedron depth times.
+//!
+//! The mesh keeps an edge table from level to level, which serves as the midpoint cache: edge e of level k gets the
+//! midpoint vertex numVertices_k + e and splits into the edges 2 e and 2 e + 1 of level k + 1, and triangle t adds the
+//! three interior edges 2 numEdges_k + 3 t + {0, 1, 2}. Every midpoint is thus evaluated once, by its edge, without
+//! hashing or locks, and each level is processed in blocks of edges and triangles on all hardware threads.
+//!
+//! The four children of triangle t are 4 t + {0, 1, 2, 3}, so the final triangles follow the subdivision hierarchy and
+//! neighbors in the list are neighbors on the sphere. The vertices are renumbered in the order of their first use by
+//! the triangles, so consecutive triangles reference mostly recent vertices. Depth 8 (524288 triangles) takes about
+//! 25 ms on a single core.
+//! \throws std::invalid_argument if depth exceeds MAX_DEPTH.
+SubdividedOctasphere subdivideOctasphere(ui32 depth);
+
+//! \brief Returns the mesh as an indexed face set without attributes and with the integer constant "subdivisionDepth".
+CograBinaryMeshFile toCograBinaryMeshFile(const SubdividedOctasphere& octasphere, ui32 depth);
+} // namespace gims
@@ -0,0 +1,91 @@
+#pragma once
+#include <algorithm>
+#include <gimslib/types.hpp>
+
+namespace gims
+{
+//! \brief Number of elements the batch kernels of gimslib process side by side.
+//!
+//! The kernels walk their range in LaneBlocks and keep the state of each element in arrays with one entry per lane,
+//! e.g., f32 x[LANES]. Their inner loops run over all lanes of a block without branches or dependencies between lanes,
+//! so the compiler can map them to SIMD instructions: 8 f32 fill one AVX register or two SSE/NEON registers. The last
+//! block of a range may be partial. Its lanes past the end load the last element again (getElement()), so that the
+//! lane loops need no tail handling, and only the first count results are stored.
+constexpr ui32 LANES = 8;
+
+//! \brief Up to LANES consecutive elements of a range.
+struct LaneBlock
+{
+  //! Index of the element in lane 0.
+  size_t first;
+  //! Number of elements of the range in the block, 1 to LANES.
+  ui32   count;
+
+  //! \brief Returns the index of the element a lane loads. Lanes past the end repeat the last element.
+  size_t getElement(ui32 lane) const
+  {
+    return first + std::min(lane, count - 1);
+  }
+};
+
+//! \brief The LaneBlocks of [first;last), for use in a range-based for loop.
+class LaneBlockRange
+{
+public:
+  class Iterator
+  {
+  public:
+    Iterator(size_t first, size_t last)
+        : m_first(first)
+        , m_last(last)
+    {
+    }
+
+    LaneBlock operator*() const
+    {
+      return {m_first, static_cast<ui32>(std::min<size_t>(LANES, m_last - m_first))};
+    }
+
+    Iterator& operator++()
+    {
+      m_first = std::min(m_first + LANES, m_last);
+      return *this;
+    }
+
+    bool operator!=(const Iterator& other) const
+    {
+      return m_first != other.m_first;
+    }
+
+  private:
+    size_t m_first;
+    size_t m_last;
+  };
+
+  LaneBlockRange(size_t first, size_t last)
+      : m_first(first)
+      , m_last(std::max(first, last))
+  {
+  }
+
+  Iterator begin() const
+  {
+    return Iterator(m_first, m_last);
+  }
+
+  Iterator end() const
+  {
+    return Iterator(m_last, m_last);
+  }
+
+private:
+  size_t m_first;
+  size_t m_last;
+};
+
+//! \brief Returns the LaneBlocks that cover [first;last): for (const LaneBlock block : getLaneBlocks(first, last)).
+inline LaneBlockRange getLaneBlocks(size_t first, size_t last)
+{
+  return LaneBlockRange(first, last);
+}
+} // namespace gims
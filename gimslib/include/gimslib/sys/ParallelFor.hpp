@@ -0,0 +1,17 @@
+#pragma once
+#include <functional>
+#include <gimslib/sys/ThreadPool.hpp>
+
+namespace gims
+{
+//! \brief Calls function(i) for all i in [0;count) on all hardware threads.
+//!
+//! The calls run on the workers of ThreadPool::getDefault(), which are started once, so parallelFor() is cheap enough
+//! for per-frame kernels. Indices are handed out one at a time, so the function should still do a reasonable amount of
+//! work per call (e.g., one file, one view, or one block of a few thousand elements). The first exception thrown by
+//! function is rethrown after all threads have finished.
+template<class Function> void parallelFor(size_t count, Function&& function)
+{
+  ThreadPool::getDefault().run(count, std::function<void(size_t)>(std::ref(function)));
+}
+} // namespace gims
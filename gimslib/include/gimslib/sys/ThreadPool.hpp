@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <gimslib/types.hpp>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gims
+{
+//! \brief Worker threads that are started once and wait for work, so that per-frame kernels do not pay for thread
+//! creation.
+//!
+//! run() hands out the indices of a task to the workers and the calling thread and returns once all of them are done.
+//! Calls from several threads are serialized. A run() from within a task, on a worker or on the calling thread,
+//! executes serially on that thread instead of waiting for workers that are busy with the outer task.
+class ThreadPool
+{
+public:
+  //! \brief Returns the pool that parallelFor() uses, with one thread per hardware thread (including the caller).
+  static ThreadPool& getDefault();
+
+  //! \brief Starts numThreads - 1 workers. The thread that calls run() is the last one.
+  explicit ThreadPool(ui32 numThreads);
+
+  //! \brief Joins the workers.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&)            = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  //! \brief Returns the number of threads that execute a task, including the caller.
+  ui32 getNumThreads() const;
+
+  //! \brief Calls function(i) for all i in [0;count) and returns when all calls have finished.
+  //!
+  //! Indices are handed out one at a time. The first exception thrown by function is rethrown after all threads have
+  //! stopped working on the task; the remaining indices are skipped.
+  void run(size_t count, const std::function<void(size_t)>& function);
+
+private:
+  struct Task
+  {
+    const std::function<void(size_t)>* function = nullptr;
+    size_t                             count    = 0;
+    std::atomic<size_t>                next     = 0;
+    std::exception_ptr                 firstException;
+    std::mutex                         exceptionMutex;
+  };
+
+  static void work(Task& task);
+
+  void workerMain();
+
+  std::vector<std::thread> m_workers;
+  std::mutex               m_runMutex;
+  std::mutex               m_mutex;
+  std::condition_variable  m_wakeUp;
+  std::condition_variable  m_finished;
+  Task*                    m_task          = nullptr;
+  ui64                     m_generation    = 0;
+  ui32                     m_activeWorkers = 0;
+  bool                     m_stop          = false;
+};
+} // namespace gims
@@ -3,6 +3,7 @@
 #include <dxgi1_6.h>
 #include <dxgidebug.h>
 #include <d3dx12/d3dx12.h>
+#include <format>
 #include <gimslib/d3d/DX12App.hpp>
 #include <gimslib/d3d/DX12Util.hpp>
 #include <gimslib/dbg/HrException.hpp>
@@ -236,7 +237,7 @@ DX12App::DX12App(const DX12AppConfig config)
     , m_hwnd(createWindow(m_config.title, m_config.width, m_config.height, this))
     , m_factory(createDXGIFactory(m_config.debug))
     , m_device(createDevice(m_config.debug, m_config.d3d_featureLevel, m_factory))
-    , m_hlslCompiler()
+    , m_hlslCompiler(m_config.shaderCache, m_config.shaderCacheBudget)
     , m_commandQueue(createCommandQueue(m_device))
     , m_commandAllocators(createCommandAllocators(m_device, m_config.frameCount))
     , m_commandLists(createCommandLists(m_commandAllocators))
@@ -279,6 +280,14 @@ i32 DX12App::run()
     onDrawImpl();
   }
   waitForGPU();
+  // Once per app, after all shaders of the session are compiled.
+  if (const ShaderCache* shaderCache = m_hlslCompiler.getShaderCache())
+  {
+    OutputDebugStringA(std::format("Shader cache {}: {} hits, {} misses, {} bytes\n",
+                                   shaderCache->getDirectory().string(), shaderCache->getNumHits(),
+                                   shaderCache->getNumMisses(), shaderCache->getSizeInBytes())
+                           .c_str());
+  }
   return static_cast<char>(msg.wParam);
 }
 
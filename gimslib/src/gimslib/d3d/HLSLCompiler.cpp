@@ -21,7 +21,7 @@ std::string wstring_to_string(const std::wstring& wstr)
 
 namespace gims
 {
-HLSLCompiler::HLSLCompiler()
+HLSLCompiler::HLSLCompiler(const std::filesystem::path& cacheDirectory, ui64 cacheByteBudget)
 {
   HMODULE dxcompilerDLL = LoadLibraryW(L"dxcompiler.dll");
 
@@ -41,11 +41,72 @@ HLSLCompiler::HLSLCompiler()
   throwIfFailed(pfxDxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&m_utils)));
   throwIfFailed(pfxDxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&m_compiler)));
   throwIfFailed(m_utils->CreateDefaultIncludeHandler(&m_includeHandler));
+
+  // Part of the cache keys, so that a different dxcompiler.dll does not return stale shaders.
+  ComPtr<IDxcVersionInfo> versionInfo;
+  if (SUCCEEDED(m_compiler.As(&versionInfo)))
+  {
+    UINT32 major = 0;
+    UINT32 minor = 0;
+    versionInfo->GetVersion(&major, &minor);
+    m_compilerVersion = std::format("{}.{}", major, minor);
+  }
+  ComPtr<IDxcVersionInfo2> versionInfo2;
+  char*                    commitHash = nullptr;
+  UINT32                   numCommits = 0;
+  if (SUCCEEDED(m_compiler.As(&versionInfo2)) && SUCCEEDED(versionInfo2->GetCommitInfo(&numCommits, &commitHash)))
+  {
+    m_compilerVersion += std::format(".{}.{}", numCommits, commitHash);
+    CoTaskMemFree(commitHash);
+  }
+
+  if (!cacheDirectory.empty())
+  {
+    m_shaderCache.emplace(cacheDirectory, cacheByteBudget);
+  }
 }
 
 ComPtr<IDxcBlob> HLSLCompiler::compileShader(const std::filesystem::path& shaderFile, const wchar_t* targetProfile,
                                              const wchar_t* entryPoint, std::vector<const wchar_t*> userArguments)
 {
+  std::optional<ShaderCacheKey> cacheKey;
+  if (m_shaderCache)
+  {
+    ShaderCacheKeyBuilder keyBuilder;
+    keyBuilder.add(m_compilerVersion);
+    keyBuilder.add(std::wstring(targetProfile));
+    keyBuilder.add(std::wstring(entryPoint));
+    const ui64 numArguments = userArguments.size();
+    keyBuilder.add(&numArguments, sizeof(numArguments));
+
+    std::vector<std::filesystem::path> includeDirectories;
+    for (size_t i = 0; i < userArguments.size(); i++)
+    {
+      const std::wstring argument = userArguments[i];
+      keyBuilder.add(argument);
+      if ((argument == L"-I" || argument == L"/I") && i + 1 < userArguments.size())
+      {
+        includeDirectories.emplace_back(userArguments[i + 1]);
+      }
+      else if (argument.size() > 2 && (argument.starts_with(L"-I") || argument.starts_with(L"/I")))
+      {
+        includeDirectories.emplace_back(argument.substr(2));
+      }
+    }
+    // The default include handler falls back to the working directory.
+    includeDirectories.push_back(std::filesystem::current_path());
+    keyBuilder.addSourceFiles(shaderFile, includeDirectories);
+    cacheKey = keyBuilder.getKey();
+
+    if (const auto cachedShader = m_shaderCache->load(*cacheKey))
+    {
+      ComPtr<IDxcBlobEncoding> shaderBlob;
+      throwIfFailed(m_utils->CreateBlob(cachedShader->data(), static_cast<UINT32>(cachedShader->size()), DXC_CP_ACP,
+                                        &shaderBlob));
+      return shaderBlob;
+    }
+  }
+
   ComPtr<IDxcBlobEncoding> sourceCode;
   if (FAILED(m_utils->LoadFile(shaderFile.wstring().c_str(), nullptr, &sourceCode)))
   {
@@ -64,8 +125,8 @@ ComPtr<IDxcBlob> HLSLCompiler::compileShader(const std::filesystem::path& shader
   sourceCodeAsBuffer.Encoding = DXC_CP_UTF8;
 
   ComPtr<IDxcResult> result = nullptr;
-  throwIfFailed(m_compiler->Compile(&sourceCodeAsBuffer, arguments->GetArguments(), arguments->GetCount(), nullptr,
-                                    IID_PPV_ARGS(&result)));
+  throwIfFailed(m_compiler->Compile(&sourceCodeAsBuffer, arguments->GetArguments(), arguments->GetCount(),
+                                    m_includeHandler.Get(), IID_PPV_ARGS(&result)));
 
   HRESULT compileStatus;
   result->GetStatus(&compileStatus);
@@ -87,6 +148,10 @@ ComPtr<IDxcBlob> HLSLCompiler::compileShader(const std::filesystem::path& shader
 
   ComPtr<IDxcBlob> shaderBlob;
   result->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&shaderBlob), nullptr);
+  if (cacheKey && SUCCEEDED(compileStatus) && shaderBlob != nullptr)
+  {
+    m_shaderCache->store(*cacheKey, shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize());
+  }
 
    //ComPtr<IDxcResult>       disa_result = nullptr;
 
@@ -108,4 +173,9 @@ D3D12_SHADER_BYTECODE HLSLCompiler::convert(ComPtr<IDxcBlob> in)
   }
   return result;
 }
+
+const ShaderCache* HLSLCompiler::getShaderCache() const
+{
+  return m_shaderCache ? &*m_shaderCache : nullptr;
+}
 } // namespace gims
\ No newline at end of file
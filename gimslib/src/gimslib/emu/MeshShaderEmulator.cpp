@@ -0,0 +1,49 @@
+#include <algorithm>
+#include <format>
+#include <gimslib/emu/MeshShaderEmulator.hpp>
+
+namespace gims
+{
+ui32 MeshShaderLayout::getNumThreads() const
+{
+  return numThreads.x * numThreads.y * numThreads.z;
+}
+
+size_t MeshShaderDispatchStats::getNumErrors() const
+{
+  return numInvalidCounts + numEarlyWrites + numOutOfRangeWrites + numUnwrittenVertices + numUnwrittenPrimitives +
+         numOutOfRangeIndices;
+}
+
+void MeshShaderDispatchStats::add(const MeshShaderDispatchStats& other)
+{
+  numGroups += other.numGroups;
+  numVertices += other.numVertices;
+  numPrimitives += other.numPrimitives;
+  maxVerticesPerGroup   = std::max(maxVerticesPerGroup, other.maxVerticesPerGroup);
+  maxPrimitivesPerGroup = std::max(maxPrimitivesPerGroup, other.maxPrimitivesPerGroup);
+  numOutputBytes += other.numOutputBytes;
+
+  numInvalidCounts += other.numInvalidCounts;
+  numEarlyWrites += other.numEarlyWrites;
+  numOutOfRangeWrites += other.numOutOfRangeWrites;
+  numUnwrittenVertices += other.numUnwrittenVertices;
+  numUnwrittenPrimitives += other.numUnwrittenPrimitives;
+  numOutOfRangeIndices += other.numOutOfRangeIndices;
+  if (firstError.empty())
+  {
+    firstError = other.firstError;
+  }
+
+  numDegeneratePrimitives += other.numDegeneratePrimitives;
+}
+
+void MeshShaderDispatchStats::addError(size_t& counter, const ui32v3& groupId, const std::string& message)
+{
+  counter++;
+  if (firstError.empty())
+  {
+    firstError = std::format("Group ({}, {}, {}): {}", groupId.x, groupId.y, groupId.z, message);
+  }
+}
+} // namespace gims
@@ -0,0 +1,475 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <gimslib/emu/MeshShaderKernels.hpp>
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <gimslib/fruit/FruitTopology.hpp>
+
+namespace gims
+{
+namespace
+{
+f32 map(f32 value, f32 min1, f32 max1, f32 min2, f32 max2)
+{
+  return min2 + (value - min1) * (max2 - min2) / (max1 - min1);
+}
+
+//! rotate() of Fruits.hlsl.
+f32v3 rotate(const f32v4& quaternion, const f32v3& v)
+{
+  const f32v3 axis = f32v3(quaternion.x, quaternion.y, quaternion.z);
+  return v + 2.0f * glm::cross(axis, glm::cross(axis, v) + quaternion.w * v);
+}
+
+//! The flip rule of all grids: quads in the lower left and upper right quadrants keep the diagonal.
+bool isNoFlipNeeded(ui32 x, ui32 y, ui32 half)
+{
+  return (x < half && y < half) || (x >= half && y >= half);
+}
+
+FruitProfile getProfile(const FruitInstanceRecord& instance)
+{
+  FruitProfile result;
+  result.p0 = f32v3(instance.controlPoints[0]);
+  result.p1 = f32v3(instance.controlPoints[1]);
+  result.p2 = f32v3(instance.controlPoints[2]);
+  result.p3 = f32v3(instance.controlPoints[3]);
+  return result;
+}
+
+//! getGridParameters() of Fruits.hlsl.
+f32v2 getGridParameters(ui32 gridSize, const ui32v2& grid)
+{
+  return f32v2(static_cast<f32>(2 * grid.x) / static_cast<f32>(gridSize - 1) - 1.0f,
+               static_cast<f32>(2 * grid.y) / static_cast<f32>(gridSize - 1) - 1.0f);
+}
+
+//! getMorphEdge() of Fruits.hlsl.
+void getMorphEdge(ui32 gridSize, const ui32v2& grid, ui32v2& first, ui32v2& second)
+{
+  first           = grid;
+  second          = grid;
+  const bool oddX = (grid.x & 1) == 1;
+  const bool oddY = (grid.y & 1) == 1;
+  if (oddX && !oddY)
+  {
+    first.x -= 1;
+    second.x += 1;
+  }
+  else if (!oddX && oddY)
+  {
+    first.y -= 1;
+    second.y += 1;
+  }
+  else if (oddX && oddY)
+  {
+    const bool noFlipNeeded = isNoFlipNeeded(grid.x, grid.y, gridSize / 2);
+    first                   = noFlipNeeded ? ui32v2(grid.x + 1, grid.y - 1) : grid - 1u;
+    second                  = noFlipNeeded ? ui32v2(grid.x - 1, grid.y + 1) : grid + 1u;
+  }
+}
+
+//! createVertex() of Fruits.hlsl.
+FruitsVertex createFruitsVertex(const FruitsMeshShader& kernel, ui32 instanceIndex, const f32v2& parameters,
+                                const ui32v2& grid)
+{
+  const FruitInstanceRecord& instance             = kernel.instances[instanceIndex];
+  const FruitProfile         profile              = getProfile(instance);
+  const f32v3                sphericalCoordinates = octDecode(parameters);
+  f32v3                      position             = calculateFruitCoordinates(profile, sphericalCoordinates);
+  f32v3                      normal               = calculateFruitNormal(profile, sphericalCoordinates);
+
+  ui32v2 first;
+  ui32v2 second;
+  getMorphEdge(instance.gridSize, grid, first, second);
+  if (instance.morphFactor > 0.0f && first != second)
+  {
+    const f32v3 firstCoordinates  = octDecode(getGridParameters(instance.gridSize, first));
+    const f32v3 secondCoordinates = octDecode(getGridParameters(instance.gridSize, second));
+    const f32v3 midpoint          = 0.5f * (calculateFruitCoordinates(profile, firstCoordinates) +
+                                   calculateFruitCoordinates(profile, secondCoordinates));
+    const f32v3 midpointNormal    = 0.5f * (calculateFruitNormal(profile, firstCoordinates) +
+                                         calculateFruitNormal(profile, secondCoordinates));
+    position += instance.morphFactor * (midpoint - position);
+    normal += instance.morphFactor * (midpointNormal - normal);
+  }
+
+  const f32v3 coordinates       = rotate(instance.rotation, position) + instance.position;
+  const f32v4 viewSpacePosition = kernel.viewMatrix * f32v4(coordinates, 1.0f);
+
+  FruitsVertex result;
+  result.position          = kernel.projectionMatrix * viewSpacePosition;
+  result.viewSpacePosition = f32v3(viewSpacePosition);
+  result.viewSpaceNormal   = f32v3(kernel.viewMatrix * f32v4(rotate(instance.rotation, normal), 0.0f));
+  result.instance          = instanceIndex;
+  return result;
+}
+
+//! toPixels() of Fruits.hlsl.
+f32v2 toPixels(const f32v4& clip, const f32v2& viewportSize)
+{
+  return f32v2(0.5f + 0.5f * clip.x / clip.w, 0.5f - 0.5f * clip.y / clip.w) * viewportSize;
+}
+
+//! isPrimitiveCulled() of Fruits.hlsl.
+bool isFruitsPrimitiveCulled(const FruitsMeshShader& kernel, const FruitsGroupShared& shared, const ui32v3& triangle)
+{
+  const f32v4& a = shared.clipPositions[triangle.x];
+  const f32v4& b = shared.clipPositions[triangle.y];
+  const f32v4& c = shared.clipPositions[triangle.z];
+  if (a.w <= 0.0f || b.w <= 0.0f || c.w <= 0.0f)
+  {
+    return false;
+  }
+  const f32v2 pa = toPixels(a, kernel.viewportSize);
+  const f32v2 pb = toPixels(b, kernel.viewportSize);
+  const f32v2 pc = toPixels(c, kernel.viewportSize);
+
+  const f32 area = (pb.x - pa.x) * (pc.y - pa.y) - (pb.y - pa.y) * (pc.x - pa.x);
+  if (area <= 0.0f)
+  {
+    return true;
+  }
+
+  const f32v2 minimum = glm::min(pa, glm::min(pb, pc));
+  const f32v2 maximum = glm::max(pa, glm::max(pb, pc));
+  return std::ceil(minimum.x - 0.5f) > std::floor(maximum.x - 0.5f) ||
+         std::ceil(minimum.y - 0.5f) > std::floor(maximum.y - 0.5f);
+}
+} // namespace
+
+ui32 OctaspheresMeshShader::getInterLODGridSize(ui32 numOctaspheres)
+{
+  const ui32 n = MeshShaderLimits::MAX_THREADS / numOctaspheres;
+  return n >= 81 ? 9 : n >= 64 ? 8 : n >= 49 ? 7 : n >= 36 ? 6 : n >= 25 ? 5 : n >= 16 ? 4 : n >= 4 ? 3 : 1;
+}
+
+MeshShaderLayout OctaspheresMeshShader::getLayout() const
+{
+  MeshShaderLayout result;
+  result.numThreads    = ui32v3(gridSize, gridSize, 1);
+  result.maxVertices   = numOctaspheres * gridSize * gridSize;
+  result.maxPrimitives = 2 * numOctaspheres * ((gridSize - 1) * (gridSize - 1));
+  return result;
+}
+
+void OctaspheresMeshShader::operator()(const MeshShaderThread& thread, const Payload&, GroupShared&,
+                                       Outputs& outputs) const
+{
+  const ui32 maxNumVertices  = getLayout().maxVertices;
+  const ui32 maxNumTriangles = getLayout().maxPrimitives;
+  const ui32 x               = thread.groupThreadId.x;
+  const ui32 y               = thread.groupThreadId.y;
+  const f32  lastThread      = static_cast<f32>(gridSize - 1);
+  outputs.setMeshOutputCounts(maxNumVertices, maxNumTriangles);
+  const f32   xCoordinate    = map(static_cast<f32>(x), 0.0f, lastThread, -1.0f, 1.0f);
+  const f32   yCoordinate    = map(static_cast<f32>(y), 0.0f, lastThread, -1.0f, 1.0f);
+  const f32v3 decodedResults = octDecode(f32v2(xCoordinate, yCoordinate));
+  for (ui32 i = 0; i < numOctaspheres; i++)
+  {
+    const f32v4 position(decodedResults.x + static_cast<f32>(i) * 2.5f, decodedResults.y, decodedResults.z, 1.0f);
+    outputs.setVertex(y * gridSize + x + i * (maxNumVertices / numOctaspheres), {transformationMatrix * position});
+  }
+  if (x < gridSize - 1 && y < gridSize - 1)
+  {
+    for (ui32 i = 0; i < numOctaspheres; i++)
+    {
+      const ui32 currentVertexID             = y * gridSize + x + i * (maxNumVertices / numOctaspheres);
+      const ui32 nextMostRightVertexID       = currentVertexID + 1;
+      const ui32 nextMostBottomVertexID      = currentVertexID + gridSize;
+      const ui32 nextMostBottomRightVertexID = nextMostBottomVertexID + 1;
+      const ui32 index                       = 2 * (y * (gridSize - 1) + x) + i * (maxNumTriangles / numOctaspheres);
+      if (isNoFlipNeeded(x, y, gridSize / 2))
+      {
+        outputs.setIndices(index, ui32v3(currentVertexID, nextMostRightVertexID, nextMostBottomVertexID));
+        outputs.setIndices(index + 1,
+                           ui32v3(nextMostRightVertexID, nextMostBottomRightVertexID, nextMostBottomVertexID));
+      }
+      else
+      {
+        outputs.setIndices(index, ui32v3(currentVertexID, nextMostRightVertexID, nextMostBottomRightVertexID));
+        outputs.setIndices(index + 1, ui32v3(nextMostBottomRightVertexID, nextMostBottomVertexID, currentVertexID));
+      }
+    }
+  }
+}
+
+MeshShaderLayout OctahedronMeshShader::getLayout() const
+{
+  MeshShaderLayout result;
+  result.numThreads    = ui32v3(11, 11, 1);
+  result.maxVertices   = 11 * 11;
+  result.maxPrimitives = 2 * 10 * 10;
+  return result;
+}
+
+void OctahedronMeshShader::operator()(const MeshShaderThread& thread, const Payload&, GroupShared&,
+                                      Outputs& outputs) const
+{
+  const ui32 lod = static_cast<ui32>(intraLOD);
+  const ui32 x   = thread.groupThreadId.x;
+  const ui32 y   = thread.groupThreadId.y;
+  outputs.setMeshOutputCounts(lod * lod, 2 * (lod - 1) * (lod - 1));
+  if (x < lod && y < lod)
+  {
+    const f32 xCoordinate = map(static_cast<f32>(x), 0.0f, static_cast<f32>(lod - 1), -1.0f, 1.0f);
+    const f32 yCoordinate = map(static_cast<f32>(y), 0.0f, static_cast<f32>(lod - 1), -1.0f, 1.0f);
+    outputs.setVertex(y * lod + x, {transformationMatrix * f32v4(xCoordinate, yCoordinate, 0.0f, 1.0f)});
+    if (x < lod - 1 && y < lod - 1)
+    {
+      const ui32 currentVertexID             = y * lod + x;
+      const ui32 nextMostRightVertexID       = currentVertexID + 1;
+      const ui32 nextMostBottomVertexID      = currentVertexID + lod;
+      const ui32 nextMostBottomRightVertexID = nextMostBottomVertexID + 1;
+      const ui32 index                       = 2 * (y * (lod - 1) + x);
+      // The shader swizzles the triangles with .xzy.
+      if (isNoFlipNeeded(x, y, lod / 2))
+      {
+        outputs.setIndices(index, ui32v3(currentVertexID, nextMostBottomVertexID, nextMostRightVertexID));
+        outputs.setIndices(index + 1,
+                           ui32v3(nextMostRightVertexID, nextMostBottomVertexID, nextMostBottomRightVertexID));
+      }
+      else
+      {
+        outputs.setIndices(index, ui32v3(currentVertexID, nextMostBottomRightVertexID, nextMostRightVertexID));
+        outputs.setIndices(index + 1, ui32v3(nextMostBottomRightVertexID, currentVertexID, nextMostBottomVertexID));
+      }
+    }
+  }
+}
+
+MeshShaderLayout UVSphereMeshShader::getLayout() const
+{
+  MeshShaderLayout result;
+  result.numThreads    = ui32v3(11, 11, 1);
+  result.maxVertices   = 128;
+  result.maxPrimitives = 256;
+  return result;
+}
+
+void UVSphereMeshShader::operator()(const MeshShaderThread& thread, const Payload&, GroupShared&,
+                                    Outputs& outputs) const
+{
+  constexpr ui32 NUM_THREADS_X = 11;
+  constexpr ui32 NUM_THREADS_Y = 11;
+  const ui32     x             = thread.groupThreadId.x;
+  const ui32     y             = thread.groupThreadId.y;
+  const f32      lastIndex     = static_cast<f32>(static_cast<ui32>(interSphereLOD) * (NUM_THREADS_X - 1));
+  outputs.setMeshOutputCounts(NUM_THREADS_X * NUM_THREADS_Y, 2 * (NUM_THREADS_X - 1) * (NUM_THREADS_Y - 1));
+  if (x < NUM_THREADS_X && y < NUM_THREADS_Y)
+  {
+    const ui32 xIndex      = thread.groupId.x * NUM_THREADS_X + x - thread.groupId.x;
+    const ui32 yIndex      = thread.groupId.y * NUM_THREADS_Y + y - thread.groupId.y;
+    const f32  lat         = map(static_cast<f32>(xIndex), 0.0f, lastIndex, 0.0f, 2.0f * glm::pi<f32>());
+    const f32  lon         = map(static_cast<f32>(yIndex), 0.0f, lastIndex, 0.0f, glm::pi<f32>());
+    const f32  xCoordinate = radius * std::sin(lon) * std::cos(lat);
+    const f32  yCoordinate = radius * std::sin(lon) * std::sin(lat);
+    const f32  zCoordinate = radius * std::cos(lon);
+    outputs.setVertex(x + y * NUM_THREADS_X,
+                      {transformationMatrix * f32v4(xCoordinate, yCoordinate, zCoordinate, 1.0f)});
+    if (y < NUM_THREADS_Y - 1 && x < NUM_THREADS_X - 1)
+    {
+      const ui32 firstVertexId  = x + y * NUM_THREADS_X;
+      const ui32 secondVertexId = firstVertexId + 1;
+      const ui32 thirdVertexId  = firstVertexId + NUM_THREADS_X;
+      const ui32 fourthVertexId = secondVertexId + NUM_THREADS_X;
+      const ui32 index          = (x + y * (NUM_THREADS_X - 1)) * 2;
+      outputs.setIndices(index, ui32v3(firstVertexId, fourthVertexId, secondVertexId));
+      outputs.setIndices(index + 1, ui32v3(fourthVertexId, firstVertexId, thirdVertexId));
+    }
+  }
+}
+
+MeshShaderLayout FruitRendererMeshShader::getLayout() const
+{
+  MeshShaderLayout result;
+  result.numThreads    = ui32v3(128, 1, 1);
+  result.maxVertices   = 256;
+  result.maxPrimitives = 256;
+  return result;
+}
+
+void FruitRendererMeshShader::operator()(const MeshShaderThread& thread, const Payload&, GroupShared&,
+                                         Outputs& outputs) const
+{
+  const ui32 numInstances                  = static_cast<ui32>(interLOD);
+  const ui32 INTRA_LOD                     = calculateIntraLOD(getLayout().numThreads.x / numInstances);
+  const ui32 INTRA_LOD_QUADRAT             = INTRA_LOD * INTRA_LOD;
+  const ui32 INTRA_LOD_DECREMENTED_QUADRAT = INTRA_LOD_QUADRAT - 2 * INTRA_LOD + 1;
+
+  const ui32 X = thread.groupThreadId.x % INTRA_LOD;
+  const ui32 Y = thread.groupThreadId.x / INTRA_LOD;
+  if (Y >= INTRA_LOD)
+  {
+    return;
+  }
+
+  outputs.setMeshOutputCounts(numInstances * INTRA_LOD_QUADRAT, 2 * numInstances * INTRA_LOD_DECREMENTED_QUADRAT);
+
+  const f32   lastVertex            = static_cast<f32>(INTRA_LOD - 1);
+  const f32   X_REMAPPED            = map(static_cast<f32>(X), 0.0f, lastVertex, -1.0f, 1.0f);
+  const f32   Y_REMAPPED            = map(static_cast<f32>(Y), 0.0f, lastVertex, -1.0f, 1.0f);
+  const f32v3 SPHERICAL_COORDINATES = octDecode(f32v2(X_REMAPPED, Y_REMAPPED));
+
+  f32   positionOffset = 0.0f;
+  ui32  index          = Y * INTRA_LOD + X;
+  f32v3 coordinates    = calculateFruitCoordinates(profile, SPHERICAL_COORDINATES);
+  for (ui32 i = 0; i < numInstances; i++)
+  {
+    const f32v4 viewSpacePosition = viewMatrix * f32v4(coordinates, 1.0f);
+    outputs.setVertex(index, {projectionMatrix * viewSpacePosition, f32v3(viewSpacePosition), SPHERICAL_COORDINATES,
+                              positionOffset});
+    index += INTRA_LOD_QUADRAT;
+    coordinates.x += FRUIT_INTER_DISTANCE;
+    positionOffset += FRUIT_INTER_DISTANCE;
+  }
+
+  if (X >= INTRA_LOD - 1 || Y >= INTRA_LOD - 1)
+  {
+    return;
+  }
+
+  ui32 current     = Y * INTRA_LOD + X;
+  ui32 right       = current + 1;
+  ui32 bottom      = current + INTRA_LOD;
+  ui32 bottomRight = bottom + 1;
+  index            = 2 * (Y * (INTRA_LOD - 1) + X);
+  for (ui32 i = 0; i < numInstances; i++)
+  {
+    const bool noFlipNeeded = isNoFlipNeeded(X, Y, INTRA_LOD / 2);
+    outputs.setIndices(index, noFlipNeeded ? ui32v3(current, right, bottom) : ui32v3(current, right, bottomRight));
+    outputs.setIndices(index + 1,
+                       noFlipNeeded ? ui32v3(right, bottomRight, bottom) : ui32v3(bottomRight, bottom, current));
+    current += INTRA_LOD_QUADRAT;
+    right       = current + 1;
+    bottom      = current + INTRA_LOD;
+    bottomRight = bottom + 1;
+    index += 2 * INTRA_LOD_DECREMENTED_QUADRAT;
+  }
+}
+
+MeshShaderLayout FruitsMeshShader::getLayout() const
+{
+  MeshShaderLayout result;
+  result.numThreads             = ui32v3(128, 1, 1);
+  result.maxVertices            = 256;
+  result.maxPrimitives          = 256;
+  result.hasPrimitiveAttributes = cullPrimitives;
+  result.numPhases              = cullPrimitives ? 2 : 1;
+  return result;
+}
+
+void FruitsMeshShader::operator()(const MeshShaderThread& thread, const Payload& payload, GroupShared& shared,
+                                  Outputs& outputs) const
+{
+  constexpr ui32 NUM_THREADS_X = 128;
+  // Without FRUIT_CULL_PRIMITIVES, both loops run in the only phase.
+  const bool     writeVertices  = thread.phase == 0;
+  const bool     writeTriangles = thread.phase == getLayout().numPhases - 1;
+
+  const ui32 gridSize = instances[payload.instance].gridSize;
+  const ui32 LOD      = (gridSize - 3) >> 1;
+  if ((gridSize & 1) == 1 && LOD < FruitTopologyTables::NUM_LODS)
+  {
+    const ui32 FIRST_VERTEX    = FRUIT_TOPOLOGY.vertexOffsets[LOD];
+    const ui32 FIRST_TRIANGLE  = FRUIT_TOPOLOGY.triangleOffsets[LOD];
+    const ui32 TABLE_VERTICES  = gridSize * gridSize;
+    const ui32 TABLE_TRIANGLES = 2 * (gridSize - 1) * (gridSize - 1);
+
+    outputs.setMeshOutputCounts(TABLE_VERTICES, TABLE_TRIANGLES);
+    for (ui32 vertex = thread.groupThreadId.x; writeVertices && vertex < TABLE_VERTICES; vertex += NUM_THREADS_X)
+    {
+      const std::array<f32, 2>& parameters = FRUIT_TOPOLOGY.parameters[FIRST_VERTEX + vertex];
+      const ui32v2              grid(vertex % gridSize, vertex / gridSize);
+      const FruitsVertex        VERTEX =
+          createFruitsVertex(*this, payload.instance, f32v2(parameters[0], parameters[1]), grid);
+      outputs.setVertex(vertex, VERTEX);
+      shared.clipPositions[vertex] = VERTEX.position;
+    }
+    for (ui32 triangle = thread.groupThreadId.x; writeTriangles && triangle < TABLE_TRIANGLES;
+         triangle += NUM_THREADS_X)
+    {
+      const std::array<ui32, 3>& indices = FRUIT_TOPOLOGY.triangles[FIRST_TRIANGLE + triangle];
+      const ui32v3               TRIANGLE(indices[0], indices[1], indices[2]);
+      outputs.setIndices(triangle, TRIANGLE);
+      if (cullPrimitives)
+      {
+        outputs.setPrimitive(triangle, {isFruitsPrimitiveCulled(*this, shared, TRIANGLE)});
+      }
+    }
+    return;
+  }
+
+  // getTile() of Fruits.hlsl.
+  const ui32 tilesPerSide = (gridSize - 1 + FruitTiling::MAX_QUADS - 1) / FruitTiling::MAX_QUADS;
+  const auto getTileStart = [&](ui32 tile) { return tile * (gridSize - 1) / tilesPerSide; };
+  const ui32 tileIndex    = payload.tiles[thread.groupId.x];
+  const ui32 tileX        = tileIndex % tilesPerSide;
+  const ui32 tileY        = tileIndex / tilesPerSide;
+  const ui32 firstX       = getTileStart(tileX);
+  const ui32 firstY       = getTileStart(tileY);
+  const ui32 numQuadsX    = getTileStart(tileX + 1) - firstX;
+  const ui32 numQuadsY    = getTileStart(tileY + 1) - firstY;
+
+  const ui32 TILE_WIDTH = numQuadsX + 1;
+  const ui32 NUM_QUADS  = numQuadsX * numQuadsY;
+
+  outputs.setMeshOutputCounts(TILE_WIDTH * (numQuadsY + 1), 2 * NUM_QUADS);
+  for (ui32 index = thread.groupThreadId.x; writeVertices && index < TILE_WIDTH * (numQuadsY + 1);
+       index += NUM_THREADS_X)
+  {
+    const ui32v2       GRID   = ui32v2(firstX + index % TILE_WIDTH, firstY + index / TILE_WIDTH);
+    const FruitsVertex VERTEX = createFruitsVertex(*this, payload.instance, getGridParameters(gridSize, GRID), GRID);
+    outputs.setVertex(index, VERTEX);
+    shared.clipPositions[index] = VERTEX.position;
+  }
+
+  for (ui32 quad = thread.groupThreadId.x; writeTriangles && quad < NUM_QUADS; quad += NUM_THREADS_X)
+  {
+    const ui32 X           = quad % numQuadsX;
+    const ui32 Y           = quad / numQuadsX;
+    const ui32 current     = Y * TILE_WIDTH + X;
+    const ui32 right       = current + 1;
+    const ui32 bottom      = current + TILE_WIDTH;
+    const ui32 bottomRight = bottom + 1;
+
+    const bool   noFlipNeeded = isNoFlipNeeded(firstX + X, firstY + Y, gridSize / 2);
+    const ui32v3 FIRST  = noFlipNeeded ? ui32v3(current, right, bottom) : ui32v3(current, right, bottomRight);
+    const ui32v3 SECOND = noFlipNeeded ? ui32v3(right, bottomRight, bottom) : ui32v3(bottomRight, bottom, current);
+    outputs.setIndices(2 * quad, FIRST);
+    outputs.setIndices(2 * quad + 1, SECOND);
+    if (cullPrimitives)
+    {
+      outputs.setPrimitive(2 * quad, {isFruitsPrimitiveCulled(*this, shared, FIRST)});
+      outputs.setPrimitive(2 * quad + 1, {isFruitsPrimitiveCulled(*this, shared, SECOND)});
+    }
+  }
+}
+
+std::vector<MeshShaderLaunch<FruitsPayload>> emulateFruitsAmplification(const FruitInstanceRecord* instances,
+                                                                        size_t numInstances, ui32 groupsPerInstance,
+                                                                        const FruitTileBoundsRecord* bounds,
+                                                                        const FruitCuller*           culler)
+{
+  std::vector<MeshShaderLaunch<FruitsPayload>> result(numInstances * groupsPerInstance);
+  for (size_t i = 0; i < result.size(); i++)
+  {
+    MeshShaderLaunch<FruitsPayload>& launch = result[i];
+    launch.payload.instance                 = static_cast<ui32>(i / groupsPerInstance);
+    launch.numGroups                        = ui32v3(0, 1, 1);
+
+    const FruitInstanceRecord& instance  = instances[launch.payload.instance];
+    const ui32                 numTiles  = planFruitTiling(instance.gridSize).getNumTiles();
+    const ui32                 firstTile = static_cast<ui32>(i % groupsPerInstance) * FruitsPayload::AS_GROUP_SIZE;
+    const ui32                 lastTile  = std::min(firstTile + FruitsPayload::AS_GROUP_SIZE, numTiles);
+    for (ui32 tile = firstTile; tile < lastTile; tile++)
+    {
+      if (culler == nullptr || culler->isTileVisible(instance, bounds[instance.firstTileBounds + tile]))
+      {
+        launch.payload.tiles[launch.numGroups.x++] = tile;
+      }
+    }
+  }
+  return result;
+}
+} // namespace gims
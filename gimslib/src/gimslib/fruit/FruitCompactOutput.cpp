@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cmath>
+#include <gimslib/fruit/FruitCompactOutput.hpp>
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/fruit/FruitTopology.hpp>
+
+namespace gims
+{
+namespace
+{
+f64 getAngle(const f64v3& a, const f64v3& b)
+{
+  // atan2 stays accurate for tiny angles, unlike acos of the dot product.
+  return std::atan2(glm::length(glm::cross(a, b)), glm::dot(a, b));
+}
+
+//! Radical inverse of i in the base, i.e., the i-th element of a Halton sequence.
+f64 getHalton(ui32 i, ui32 base)
+{
+  f64 result   = 0.0;
+  f64 fraction = 1.0;
+  for (ui32 n = i + 1; n > 0; n /= base)
+  {
+    fraction /= static_cast<f64>(base);
+    result += fraction * static_cast<f64>(n % base);
+  }
+  return result;
+}
+} // namespace
+
+f32v3 reconstructViewSpacePosition(const f32v4& position, const f32m4& inverseProjectionMatrix,
+                                   const f32v2& viewportSize)
+{
+  const f32v2 ndc               =
+      f32v2(2.0f * position.x / viewportSize.x - 1.0f, 1.0f - 2.0f * position.y / viewportSize.y);
+  const f32v4 viewSpacePosition = inverseProjectionMatrix * f32v4(ndc, position.z, 1.0f);
+  return f32v3(viewSpacePosition) / viewSpacePosition.w;
+}
+
+FruitCompactOutputError measureFruitCompactOutputError(const f32m4& projectionMatrix, const f32v2& viewportSize,
+                                                       f32 minDepth, f32 maxDepth, ui32 numSamples)
+{
+  FruitCompactOutputError result;
+  result.numSamples = numSamples;
+
+  // Directions on a Fibonacci sphere.
+  const f64 goldenAngle = glm::pi<f64>() * (3.0 - std::sqrt(5.0));
+  for (ui32 i = 0; i < numSamples; i++)
+  {
+    const f64   z            = 1.0 - 2.0 * (static_cast<f64>(i) + 0.5) / static_cast<f64>(numSamples);
+    const f64   radius       = std::sqrt(std::max(0.0, 1.0 - z * z));
+    const f64   angle        = goldenAngle * static_cast<f64>(i);
+    const f32v3 direction    = f32v3(f64v3(radius * std::cos(angle), radius * std::sin(angle), z));
+    const f64   error        = getAngle(f64v3(direction), f64v3(octDecode(octEncode(direction))));
+    result.maxDirectionError = std::max(result.maxDirectionError, static_cast<f32>(error));
+  }
+
+  for (ui32 lod = 0; lod < FruitTopologyTables::NUM_LODS; lod++)
+  {
+    const ui32 n             = FruitTopologyTables::INTRA_LODS[lod];
+    const ui32 firstTriangle = FRUIT_TOPOLOGY.triangleOffsets[lod];
+    for (ui32 t = firstTriangle; t < firstTriangle + 2 * (n - 1) * (n - 1); t++)
+    {
+      f32v2 parameters = f32v2(0.0f);
+      f32v3 decoded    = f32v3(0.0f);
+      for (const ui32 vertex : FRUIT_TOPOLOGY.triangles[t])
+      {
+        const auto& parameter = FRUIT_TOPOLOGY.parameters[FRUIT_TOPOLOGY.vertexOffsets[lod] + vertex];
+        parameters += f32v2(parameter[0], parameter[1]) / 3.0f;
+        decoded += octDecode(f32v2(parameter[0], parameter[1])) / 3.0f;
+      }
+      const f64 angle              = getAngle(f64v3(octDecode(parameters)), f64v3(decoded));
+      result.maxInterpolationAngle = std::max(result.maxInterpolationAngle, static_cast<f32>(angle));
+    }
+  }
+
+  // View space positions through pixels and at depths of Halton sequences, the depth distributed logarithmically.
+  const f64m4 inverseProjection       = glm::inverse(f64m4(projectionMatrix));
+  const f32m4 inverseProjectionMatrix = glm::inverse(projectionMatrix);
+  for (ui32 i = 0; i < numSamples; i++)
+  {
+    const f64v2 ndc               = f64v2(2.0 * getHalton(i, 2) - 1.0, 2.0 * getHalton(i, 3) - 1.0);
+    const f64   depth             = minDepth * std::pow(static_cast<f64>(maxDepth) / minDepth, getHalton(i, 5));
+    const f64v4 ray               = inverseProjection * f64v4(ndc, 0.0, 1.0);
+    const f64v3 point             = f64v3(ray) / ray.w;
+    const f64v3 viewSpacePosition = point * (depth / point.z);
+
+    // What the mesh shader and the rasterizer compute.
+    const f32v4 clipPosition = projectionMatrix * f32v4(f32v3(viewSpacePosition), 1.0f);
+    const f32v3 ndcPosition  = f32v3(clipPosition) / clipPosition.w;
+    const f32v4 position     = f32v4((0.5f * ndcPosition.x + 0.5f) * viewportSize.x,
+                                     (0.5f - 0.5f * ndcPosition.y) * viewportSize.y, ndcPosition.z, clipPosition.w);
+
+    const f64v3 reconstructed      =
+        f64v3(reconstructViewSpacePosition(position, inverseProjectionMatrix, viewportSize));
+    const f64   positionError      = glm::length(reconstructed - viewSpacePosition) / glm::length(viewSpacePosition);
+    const f64   viewDirectionError = getAngle(reconstructed, viewSpacePosition);
+    result.maxPositionError        = std::max(result.maxPositionError, static_cast<f32>(positionError));
+    result.maxViewDirectionError   = std::max(result.maxViewDirectionError, static_cast<f32>(viewDirectionError));
+  }
+  return result;
+}
+} // namespace gims
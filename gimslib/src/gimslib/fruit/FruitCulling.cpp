@@ -0,0 +1,559 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <gimslib/fruit/FruitCulling.hpp>
+#include <gimslib/fruit/FruitGeomorph.hpp>
+#include <gimslib/fruit/FruitMeshCache.hpp>
+#include <gimslib/sys/LaneBlocks.hpp>
+#include <gimslib/sys/ParallelFor.hpp>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace
+{
+using namespace gims;
+
+constexpr ui32   TILES_PER_TASK    = 64;
+constexpr size_t ELEMENTS_PER_TASK = 16384;
+
+// Relative inflation of the tile spheres.
+constexpr f32 RADIUS_MARGIN = 1e-4f;
+
+// The expressions below are evaluated term by term from left to right, exactly as in AS_main of Fruits.hlsl.
+
+bool isInsidePlane(const f32v4& plane, f32 x, f32 y, f32 z, f32 radius)
+{
+  const f32 distance      = plane.x * x + plane.y * y + plane.z * z + plane.w;
+  const f32 normalLength2 = plane.x * plane.x + plane.y * plane.y + plane.z * plane.z;
+  return (distance >= 0.0f) | (distance * distance <= radius * radius * normalLength2);
+}
+
+bool isInsideFrustum(const f32v4* planes, f32 x, f32 y, f32 z, f32 radius)
+{
+  bool inside = true;
+  for (ui32 i = 0; i < 6; i++)
+  {
+    inside = inside & isInsidePlane(planes[i], x, y, z, radius);
+  }
+  return inside;
+}
+
+// The view space center (x, y, z) with the view space cone axis (ax, ay, az) is backfacing.
+bool isBackfacing(f32 x, f32 y, f32 z, f32 radius, f32 ax, f32 ay, f32 az, f32 coneCutoff)
+{
+  const f32 s = x * ax + y * ay + z * az - radius;
+  return (coneCutoff >= 0.0f) & (s >= 0.0f) & (s * s >= coneCutoff * coneCutoff * (x * x + y * y + z * z));
+}
+
+// v + 2 cross(q.xyz, cross(q.xyz, v) + q.w v), rotate() of Fruits.hlsl written out.
+inline void rotate(const f32v4& q, f32 vx, f32 vy, f32 vz, f32& rx, f32& ry, f32& rz)
+{
+  const f32 tx = q.y * vz - q.z * vy + q.w * vx;
+  const f32 ty = q.z * vx - q.x * vz + q.w * vy;
+  const f32 tz = q.x * vy - q.y * vx + q.w * vz;
+  rx           = vx + 2.0f * (q.y * tz - q.z * ty);
+  ry           = vy + 2.0f * (q.z * tx - q.x * tz);
+  rz           = vz + 2.0f * (q.x * ty - q.y * tx);
+}
+
+f32 transformPoint(const f32v4& row, f32 x, f32 y, f32 z)
+{
+  return row.x * x + row.y * y + row.z * z + row.w;
+}
+
+f32 transformDirection(const f32v4& row, f32 x, f32 y, f32 z)
+{
+  return row.x * x + row.y * y + row.z * z;
+}
+
+// Moves the tile's center and cone axis from object space into view space.
+void transformTile(const f32v4* viewRows, const f32v4& rotation, const f32v3& position, f32& cx, f32& cy, f32& cz,
+                   f32& ax, f32& ay, f32& az)
+{
+  f32 wx, wy, wz;
+  rotate(rotation, cx, cy, cz, wx, wy, wz);
+  wx = wx + position.x;
+  wy = wy + position.y;
+  wz = wz + position.z;
+  cx = transformPoint(viewRows[0], wx, wy, wz);
+  cy = transformPoint(viewRows[1], wx, wy, wz);
+  cz = transformPoint(viewRows[2], wx, wy, wz);
+
+  rotate(rotation, ax, ay, az, wx, wy, wz);
+  ax = transformDirection(viewRows[0], wx, wy, wz);
+  ay = transformDirection(viewRows[1], wx, wy, wz);
+  az = transformDirection(viewRows[2], wx, wy, wz);
+}
+
+// The tests of isPrimitiveCulled() in Fruits.hlsl, in the same order.
+enum class PrimitiveTest
+{
+  KEPT,
+  ZERO_AREA,
+  BACKFACING,
+  TOO_SMALL
+};
+
+f32v2 toPixels(const f32v4& clip, const f32v2& viewportSize)
+{
+  return f32v2(0.5f + 0.5f * clip.x / clip.w, 0.5f - 0.5f * clip.y / clip.w) * viewportSize;
+}
+
+PrimitiveTest testPrimitive(const f32v4& a, const f32v4& b, const f32v4& c, const f32v2& viewportSize)
+{
+  if (a.w <= 0.0f || b.w <= 0.0f || c.w <= 0.0f)
+  {
+    return PrimitiveTest::KEPT;
+  }
+  const f32v2 pa = toPixels(a, viewportSize);
+  const f32v2 pb = toPixels(b, viewportSize);
+  const f32v2 pc = toPixels(c, viewportSize);
+
+  // Pixel y points down, so front faces, which are clockwise on screen, have a positive area.
+  const f32 area = (pb.x - pa.x) * (pc.y - pa.y) - (pb.y - pa.y) * (pc.x - pa.x);
+  if (area == 0.0f)
+  {
+    return PrimitiveTest::ZERO_AREA;
+  }
+  if (area < 0.0f)
+  {
+    return PrimitiveTest::BACKFACING;
+  }
+
+  // Pixel centers are at integers + 0.5; a box between two centers in x or y covers none.
+  const f32v2 minimum   = glm::min(pa, glm::min(pb, pc));
+  const f32v2 maximum   = glm::max(pa, glm::max(pb, pc));
+  const bool  noSampleX = std::ceil(minimum.x - 0.5f) > std::floor(maximum.x - 0.5f);
+  const bool  noSampleY = std::ceil(minimum.y - 0.5f) > std::floor(maximum.y - 0.5f);
+  return noSampleX || noSampleY ? PrimitiveTest::TOO_SMALL : PrimitiveTest::KEPT;
+}
+
+// The position MS_main evaluates for the grid vertex.
+f32v3 evaluateGridVertex(const FruitProfile& profile, ui32 gridSize, const ui32v2& grid)
+{
+  const f32   denominator = static_cast<f32>(gridSize - 1);
+  const f32v2 parameters(static_cast<f32>(2 * grid.x) / denominator - 1.0f,
+                         static_cast<f32>(2 * grid.y) / denominator - 1.0f);
+  return calculateFruitCoordinates(profile, octDecode(parameters));
+}
+
+FruitTileBoundsRecord computeTileBounds(const FruitProfile& profile, const FruitTiling& tiling, bool geomorphed,
+                                        ui32 tileIndex)
+{
+  const FruitTile    tile = getFruitTile(tiling, tileIndex);
+  std::vector<f32v3> positions(tile.getNumVertices());
+  for (ui32 v = 0; v < tile.getNumVertices(); v++)
+  {
+    positions[v] = evaluateGridVertex(profile, tiling.gridSize, getFruitTileVertex(tile, v));
+  }
+
+  // Morphed vertices stay in the convex hull of their own and their morph edge's positions, which may belong to the
+  // neighboring tile.
+  std::vector<f32v3> hull = positions;
+  if (geomorphed)
+  {
+    for (ui32 v = 0; v < tile.getNumVertices(); v++)
+    {
+      const ui32v2         grid = getFruitTileVertex(tile, v);
+      const FruitMorphEdge edge = getFruitMorphEdge(tiling.gridSize, grid.x, grid.y);
+      hull.push_back(evaluateGridVertex(profile, tiling.gridSize, edge.first));
+      hull.push_back(evaluateGridVertex(profile, tiling.gridSize, edge.second));
+    }
+  }
+
+  f32v3 minimum(std::numeric_limits<f32>::max());
+  f32v3 maximum(-std::numeric_limits<f32>::max());
+  for (const f32v3& position : hull)
+  {
+    minimum = glm::min(minimum, position);
+    maximum = glm::max(maximum, position);
+  }
+  FruitTileBoundsRecord result;
+  result.center = 0.5f * (minimum + maximum);
+  result.radius = 0.0f;
+  for (const f32v3& position : hull)
+  {
+    result.radius = std::max(result.radius, glm::length(position - result.center));
+  }
+  result.radius *= 1.0f + RADIUS_MARGIN;
+
+  // The normals of morphed triangles are not bounded by the cone of the unmorphed ones.
+  result.coneAxis   = f32v3(0.0f, 0.0f, 1.0f);
+  result.coneCutoff = FruitTileBoundsRecord::NO_CONE;
+  if (geomorphed)
+  {
+    return result;
+  }
+
+  // Outward triangle normals; degenerate triangles at the poles have none.
+  std::vector<f32v3> normals;
+  normals.reserve(tile.getNumTriangles());
+  f32v3 normalSum(0.0f);
+  for (ui32 t = 0; t < tile.getNumTriangles(); t++)
+  {
+    const ui32v3 triangle = getFruitTileTriangle(tiling, tile, t);
+    const f32v3  normal   = glm::cross(positions[triangle.y] - positions[triangle.x],
+                                       positions[triangle.z] - positions[triangle.x]);
+    const f32    length   = glm::length(normal);
+    if (length > 0.0f)
+    {
+      normals.push_back(normal / length);
+      normalSum += normals.back();
+    }
+  }
+
+  const f32 sumLength = glm::length(normalSum);
+  if (normals.empty() || !(sumLength > 0.0f))
+  {
+    return result;
+  }
+  result.coneAxis = normalSum / sumLength;
+  f32 minimumDot  = 1.0f;
+  for (const f32v3& normal : normals)
+  {
+    minimumDot = std::min(minimumDot, glm::dot(normal, result.coneAxis));
+  }
+  // Cones of half a sphere or more never cull; the margin keeps the cone conservative despite rounding.
+  if (minimumDot > 1e-3f)
+  {
+    result.coneCutoff = std::min(std::sqrt(1.0f - minimumDot * minimumDot) + 1e-3f, 1.0f);
+  }
+  return result;
+}
+} // namespace
+
+namespace gims
+{
+std::vector<FruitTileBoundsRecord> computeFruitTileBounds(const FruitProfile& profile, const FruitTiling& tiling,
+                                                          bool geomorphed)
+{
+  if (geomorphed && !isFruitGridMorphable(tiling.gridSize))
+  {
+    throw std::invalid_argument("The grid is not morphable.");
+  }
+  const ui32                         numTiles = tiling.getNumTiles();
+  std::vector<FruitTileBoundsRecord> result(numTiles);
+  parallelFor((numTiles + TILES_PER_TASK - 1) / TILES_PER_TASK,
+              [&](size_t task)
+              {
+                const ui32 first = static_cast<ui32>(task) * TILES_PER_TASK;
+                for (ui32 i = first; i < std::min(first + TILES_PER_TASK, numTiles); i++)
+                {
+                  result[i] = computeTileBounds(profile, tiling, geomorphed, i);
+                }
+              });
+  return result;
+}
+
+bool FruitTileBoundsBuilder::Key::operator<(const Key& other) const
+{
+  return std::memcmp(this, &other, sizeof(Key)) < 0;
+}
+
+bool FruitTileBoundsBuilder::Key::operator==(const Key& other) const
+{
+  return std::memcmp(this, &other, sizeof(Key)) == 0;
+}
+
+void FruitTileBoundsBuilder::update(const FruitInstanceArray& instances, bool geomorph,
+                                    std::vector<FruitInstanceLOD>& lods)
+{
+  if (lods.size() != instances.getSize())
+  {
+    throw std::invalid_argument(
+        std::format("{} levels of detail for {} instances.", lods.size(), instances.getSize()));
+  }
+  std::map<Key, Entry> entries;
+  m_bounds.clear();
+  Key  previousKey;
+  ui32 previousFirst = 0;
+  for (size_t i = 0; i < instances.getSize(); i++)
+  {
+    Key key;
+    key.profile    = instances.profiles.getProfile(i);
+    key.gridSize   = lods[i].gridSize;
+    key.geomorphed = geomorph && isFruitGridMorphable(lods[i].gridSize) ? 1 : 0;
+    // Neighboring instances mostly share their profile and grid.
+    if (i == 0 || !(key == previousKey))
+    {
+      auto entry = entries.find(key);
+      if (entry == entries.end())
+      {
+        auto node = m_entries.extract(key);
+        if (node.empty())
+        {
+          Entry computed;
+          computed.bounds = computeFruitTileBounds(key.profile, planFruitTiling(key.gridSize), key.geomorphed != 0);
+          entry           = entries.emplace(key, std::move(computed)).first;
+        }
+        else
+        {
+          entry = entries.insert(std::move(node)).position;
+        }
+        entry->second.first = static_cast<ui32>(m_bounds.size());
+        m_bounds.insert(m_bounds.end(), entry->second.bounds.begin(), entry->second.bounds.end());
+      }
+      previousKey   = key;
+      previousFirst = entry->second.first;
+    }
+    lods[i].firstTileBounds = previousFirst;
+  }
+  m_entries = std::move(entries);
+}
+
+const std::vector<FruitTileBoundsRecord>& FruitTileBoundsBuilder::getBounds() const
+{
+  return m_bounds;
+}
+
+size_t FruitTileBoundsBuilder::getNumEntries() const
+{
+  return m_entries.size();
+}
+
+FruitCuller::FruitCuller(const f32m4& viewMatrix, const f32m4& projectionMatrix)
+{
+  // glm matrices are column major, m[column][row].
+  for (ui32 row = 0; row < 3; row++)
+  {
+    m_viewRows[row] = f32v4(viewMatrix[0][row], viewMatrix[1][row], viewMatrix[2][row], viewMatrix[3][row]);
+  }
+  f32v4 rows[4];
+  for (ui32 row = 0; row < 4; row++)
+  {
+    rows[row] =
+        f32v4(projectionMatrix[0][row], projectionMatrix[1][row], projectionMatrix[2][row], projectionMatrix[3][row]);
+  }
+  // Clip space -w <= x, y <= w and 0 <= z <= w.
+  m_planes[0] = rows[3] + rows[0];
+  m_planes[1] = rows[3] - rows[0];
+  m_planes[2] = rows[3] + rows[1];
+  m_planes[3] = rows[3] - rows[1];
+  m_planes[4] = rows[2];
+  m_planes[5] = rows[3] - rows[2];
+}
+
+bool FruitCuller::isSphereVisible(const f32v3& center, f32 radius) const
+{
+  const f32 x = transformPoint(m_viewRows[0], center.x, center.y, center.z);
+  const f32 y = transformPoint(m_viewRows[1], center.x, center.y, center.z);
+  const f32 z = transformPoint(m_viewRows[2], center.x, center.y, center.z);
+  return isInsideFrustum(m_planes, x, y, z, radius);
+}
+
+bool FruitCuller::isTileVisible(const FruitInstanceRecord& instance, const FruitTileBoundsRecord& bounds) const
+{
+  f32 cx = bounds.center.x, cy = bounds.center.y, cz = bounds.center.z;
+  f32 ax = bounds.coneAxis.x, ay = bounds.coneAxis.y, az = bounds.coneAxis.z;
+  transformTile(m_viewRows, instance.rotation, instance.position, cx, cy, cz, ax, ay, az);
+  return isInsideFrustum(m_planes, cx, cy, cz, bounds.radius) &
+         !isBackfacing(cx, cy, cz, bounds.radius, ax, ay, az, bounds.coneCutoff);
+}
+
+void FruitCuller::cullSpheres(const FruitBoundingSphereArray& spheres, size_t first, size_t last, ui8* visible) const
+{
+  for (const LaneBlock block : getLaneBlocks(first, last))
+  {
+    f32 x[LANES], y[LANES], z[LANES], radii[LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      const size_t i = block.getElement(lane);
+      x[lane]        = spheres.centerX[i];
+      y[lane]        = spheres.centerY[i];
+      z[lane]        = spheres.centerZ[i];
+      radii[lane]    = spheres.radius[i];
+    }
+
+    f32 vx[LANES], vy[LANES], vz[LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      vx[lane] = transformPoint(m_viewRows[0], x[lane], y[lane], z[lane]);
+      vy[lane] = transformPoint(m_viewRows[1], x[lane], y[lane], z[lane]);
+      vz[lane] = transformPoint(m_viewRows[2], x[lane], y[lane], z[lane]);
+    }
+
+    ui32 inside[LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      inside[lane] = 1;
+    }
+    for (ui32 i = 0; i < 6; i++)
+    {
+      for (ui32 lane = 0; lane < LANES; lane++)
+      {
+        inside[lane] =
+            inside[lane] & static_cast<ui32>(isInsidePlane(m_planes[i], vx[lane], vy[lane], vz[lane], radii[lane]));
+      }
+    }
+
+    for (ui32 lane = 0; lane < block.count; lane++)
+    {
+      visible[block.first + lane] = static_cast<ui8>(inside[lane]);
+    }
+  }
+}
+
+void FruitCuller::cullTiles(const FruitInstanceRecord& instance, const FruitTileBoundsRecord* bounds, size_t first,
+                            size_t last, ui8* visible) const
+{
+  for (const LaneBlock block : getLaneBlocks(first, last))
+  {
+    f32 cx[LANES], cy[LANES], cz[LANES], radii[LANES], ax[LANES], ay[LANES], az[LANES], cutoffs[LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      const FruitTileBoundsRecord& tile = bounds[block.getElement(lane)];
+      cx[lane]                          = tile.center.x;
+      cy[lane]                          = tile.center.y;
+      cz[lane]                          = tile.center.z;
+      radii[lane]                       = tile.radius;
+      ax[lane]                          = tile.coneAxis.x;
+      ay[lane]                          = tile.coneAxis.y;
+      az[lane]                          = tile.coneAxis.z;
+      cutoffs[lane]                     = tile.coneCutoff;
+    }
+
+    // transformTile(), spelled out so the lane loops stay free of calls.
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      f32 wx, wy, wz;
+      rotate(instance.rotation, cx[lane], cy[lane], cz[lane], wx, wy, wz);
+      wx       = wx + instance.position.x;
+      wy       = wy + instance.position.y;
+      wz       = wz + instance.position.z;
+      cx[lane] = transformPoint(m_viewRows[0], wx, wy, wz);
+      cy[lane] = transformPoint(m_viewRows[1], wx, wy, wz);
+      cz[lane] = transformPoint(m_viewRows[2], wx, wy, wz);
+    }
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      f32 wx, wy, wz;
+      rotate(instance.rotation, ax[lane], ay[lane], az[lane], wx, wy, wz);
+      ax[lane] = transformDirection(m_viewRows[0], wx, wy, wz);
+      ay[lane] = transformDirection(m_viewRows[1], wx, wy, wz);
+      az[lane] = transformDirection(m_viewRows[2], wx, wy, wz);
+    }
+
+    ui32 result[LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      result[lane] = static_cast<ui32>(
+          !isBackfacing(cx[lane], cy[lane], cz[lane], radii[lane], ax[lane], ay[lane], az[lane], cutoffs[lane]));
+    }
+    for (ui32 i = 0; i < 6; i++)
+    {
+      for (ui32 lane = 0; lane < LANES; lane++)
+      {
+        result[lane] =
+            result[lane] & static_cast<ui32>(isInsidePlane(m_planes[i], cx[lane], cy[lane], cz[lane], radii[lane]));
+      }
+    }
+
+    for (ui32 lane = 0; lane < block.count; lane++)
+    {
+      visible[block.first + lane] = static_cast<ui8>(result[lane]);
+    }
+  }
+}
+
+const f32v4& FruitCuller::getPlane(ui32 i) const
+{
+  return m_planes[i];
+}
+
+size_t FruitPrimitiveCullingStats::getNumCulled() const
+{
+  return numZeroArea + numBackfacing + numTooSmall;
+}
+
+void emulateFruitPrimitiveCulling(const FruitMesh& mesh, const f32m4& worldViewProjection, const f32v2& viewportSize,
+                                  FruitPrimitiveCullingStats& stats)
+{
+  // Like MS_main, which keeps the clip space positions of its vertices in group shared memory.
+  const size_t       numVertices = mesh.positions.size();
+  std::vector<f32v4> clipPositions(numVertices);
+  parallelFor((numVertices + ELEMENTS_PER_TASK - 1) / ELEMENTS_PER_TASK,
+              [&](size_t task)
+              {
+                const size_t first = task * ELEMENTS_PER_TASK;
+                for (size_t i = first; i < std::min(first + ELEMENTS_PER_TASK, numVertices); i++)
+                {
+                  clipPositions[i] = worldViewProjection * f32v4(mesh.positions[i], 1.0f);
+                }
+              });
+
+  const size_t                       numTriangles = mesh.indices.size();
+  const size_t                       numTasks     = (numTriangles + ELEMENTS_PER_TASK - 1) / ELEMENTS_PER_TASK;
+  std::vector<std::array<size_t, 4>> taskCounts(numTasks);
+  parallelFor(numTasks,
+              [&](size_t task)
+              {
+                const size_t first = task * ELEMENTS_PER_TASK;
+                for (size_t i = first; i < std::min(first + ELEMENTS_PER_TASK, numTriangles); i++)
+                {
+                  const ui32v3&       triangle = mesh.indices[i];
+                  const PrimitiveTest test     = testPrimitive(clipPositions[triangle.x], clipPositions[triangle.y],
+                                                               clipPositions[triangle.z], viewportSize);
+                  taskCounts[task][static_cast<size_t>(test)]++;
+                }
+              });
+
+  stats.numTriangles += numTriangles;
+  for (const std::array<size_t, 4>& counts : taskCounts)
+  {
+    stats.numZeroArea += counts[static_cast<size_t>(PrimitiveTest::ZERO_AREA)];
+    stats.numBackfacing += counts[static_cast<size_t>(PrimitiveTest::BACKFACING)];
+    stats.numTooSmall += counts[static_cast<size_t>(PrimitiveTest::TOO_SMALL)];
+  }
+}
+
+void emulateFruitPrimitiveCulling(const FruitInstanceArray& instances, const std::vector<FruitInstanceLOD>& lods,
+                                  const f32m4& viewProjection, const f32v2& viewportSize,
+                                  FruitPrimitiveCullingStats& stats)
+{
+  if (lods.size() != instances.getSize())
+  {
+    throw std::invalid_argument(
+        std::format("{} levels of detail for {} instances.", lods.size(), instances.getSize()));
+  }
+  std::shared_ptr<const FruitMesh> mesh;
+  FruitProfile                     meshProfile;
+  ui32                             meshGridSize    = 0;
+  f32                              meshMorphFactor = 0.0f;
+  for (size_t i = 0; i < instances.getSize(); i++)
+  {
+    const FruitInstance instance    = instances.getInstance(i);
+    const ui32          gridSize    = lods[i].gridSize;
+    const f32           morphFactor = isFruitGridMorphable(gridSize) ? lods[i].morphFactor : 0.0f;
+    if (!(morphFactor >= 0.0f && morphFactor <= 1.0f))
+    {
+      throw std::invalid_argument(std::format("Morph factor {} of instance {} is not in [0;1].", morphFactor, i));
+    }
+    if (gridSize != meshGridSize || morphFactor != meshMorphFactor || !(instance.profile == meshProfile))
+    {
+      // Morphed meshes depend on the continuous morph factor, so only the unmorphed ones are worth caching.
+      mesh = morphFactor > 0.0f
+                 ? std::make_shared<const FruitMesh>(tessellateMorphedFruit(instance.profile, gridSize, morphFactor))
+                 : FruitMeshCache::getDefault().getOrTessellate(instance.profile, gridSize);
+      meshProfile     = instance.profile;
+      meshGridSize    = gridSize;
+      meshMorphFactor = morphFactor;
+    }
+
+    // The columns of the world matrix are the rotated axes, rotated like rotate() of Fruits.hlsl.
+    f32m4 world(1.0f);
+    for (ui32 axis = 0; axis < 3; axis++)
+    {
+      f32v3 unit(0.0f);
+      unit[axis] = 1.0f;
+      f32v3 column;
+      rotate(instance.rotation, unit.x, unit.y, unit.z, column.x, column.y, column.z);
+      world[axis] = f32v4(column, 0.0f);
+    }
+    world[3] = f32v4(instance.position, 1.0f);
+    emulateFruitPrimitiveCulling(*mesh, viewProjection * world, viewportSize, stats);
+  }
+}
+} // namespace gims
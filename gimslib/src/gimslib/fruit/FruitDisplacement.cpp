@@ -0,0 +1,268 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <gimslib/fruit/FruitDisplacement.hpp>
+#include <gimslib/sys/LaneBlocks.hpp>
+#include <gimslib/sys/ParallelFor.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+using namespace gims;
+
+constexpr size_t VERTICES_PER_TASK = 8192;
+
+// Amplitude and frequency per preset: fine dimples for apples and pears, pores for lemons, seed bumps for strawberries.
+const std::array<FruitDisplacement, static_cast<size_t>(FruitType::Count)> PRESETS = {{
+    {0.004f, 6.0f, 3, 1},
+    {0.006f, 8.0f, 3, 2},
+    {0.008f, 24.0f, 2, 3},
+    {0.012f, 16.0f, 2, 4},
+}};
+
+ui32 hash(i32 x, i32 y, i32 z, ui32 seed)
+{
+  ui32 h = static_cast<ui32>(x) * 0x8da6b343u ^ static_cast<ui32>(y) * 0xd8163841u ^
+           static_cast<ui32>(z) * 0xcb1ab31fu ^ seed * 0x165667b1u;
+  h ^= h >> 15;
+  h *= 0x2c1b3c6du;
+  h ^= h >> 12;
+  h *= 0x297a2d39u;
+  return h ^ (h >> 15);
+}
+
+// Maps a point of the [-1;1]^2 octahedral domain onto the octahedron |x| + |y| + |z| = 1, like octDecode() without
+// the normalization.
+void unfoldOctahedron(f32 u, f32 v, f32& x, f32& y, f32& z)
+{
+  const f32  pz     = 1.0f - std::abs(u) - std::abs(v);
+  const bool folded = pz < 0.0f;
+  x                 = folded ? (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f) : u;
+  y                 = folded ? (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f) : v;
+  z                 = pz;
+}
+
+// Dot product of (x, y, z) with a pseudo-random gradient in [-1;1]^3 built from three bytes of the hash. Plain
+// arithmetic instead of a gradient table or selects keeps the lane loops vectorizable.
+f32 gradientDot(ui32 h, f32 x, f32 y, f32 z)
+{
+  constexpr f32 scale = 2.0f / 255.0f;
+  const f32     gx    = static_cast<f32>(static_cast<i32>(h & 0xff)) * scale - 1.0f;
+  const f32     gy    = static_cast<f32>(static_cast<i32>((h >> 8) & 0xff)) * scale - 1.0f;
+  const f32     gz    = static_cast<f32>(static_cast<i32>((h >> 16) & 0xff)) * scale - 1.0f;
+  return gx * x + gy * y + gz * z;
+}
+
+// Quintic fade curve with vanishing first and second derivative at 0 and 1.
+f32 fade(f32 t)
+{
+  return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+// Adds weight times 3D gradient noise at the points of a block to sum.
+void addGradientNoise(const f32 (&x)[LANES], const f32 (&y)[LANES], const f32 (&z)[LANES], ui32 seed, f32 weight,
+                      f32 (&sum)[LANES])
+{
+  i32 cell[3][LANES];
+  f32 fraction[3][LANES];
+  for (ui32 lane = 0; lane < LANES; lane++)
+  {
+    const f32 floorX  = std::floor(x[lane]);
+    const f32 floorY  = std::floor(y[lane]);
+    const f32 floorZ  = std::floor(z[lane]);
+    cell[0][lane]     = static_cast<i32>(floorX);
+    cell[1][lane]     = static_cast<i32>(floorY);
+    cell[2][lane]     = static_cast<i32>(floorZ);
+    fraction[0][lane] = x[lane] - floorX;
+    fraction[1][lane] = y[lane] - floorY;
+    fraction[2][lane] = z[lane] - floorZ;
+  }
+
+  f32 corners[8][LANES];
+  for (ui32 c = 0; c < 8; c++)
+  {
+    const i32 cx = static_cast<i32>(c & 1);
+    const i32 cy = static_cast<i32>((c >> 1) & 1);
+    const i32 cz = static_cast<i32>(c >> 2);
+    const f32 ox = static_cast<f32>(cx);
+    const f32 oy = static_cast<f32>(cy);
+    const f32 oz = static_cast<f32>(cz);
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      const ui32 h     = hash(cell[0][lane] + cx, cell[1][lane] + cy, cell[2][lane] + cz, seed);
+      corners[c][lane] = gradientDot(h, fraction[0][lane] - ox, fraction[1][lane] - oy, fraction[2][lane] - oz);
+    }
+  }
+
+  for (ui32 lane = 0; lane < LANES; lane++)
+  {
+    const f32 u  = fade(fraction[0][lane]);
+    const f32 v  = fade(fraction[1][lane]);
+    const f32 w  = fade(fraction[2][lane]);
+    const f32 x0 = corners[0][lane] + u * (corners[1][lane] - corners[0][lane]);
+    const f32 x1 = corners[2][lane] + u * (corners[3][lane] - corners[2][lane]);
+    const f32 x2 = corners[4][lane] + u * (corners[5][lane] - corners[4][lane]);
+    const f32 x3 = corners[6][lane] + u * (corners[7][lane] - corners[6][lane]);
+    const f32 y0 = x0 + v * (x1 - x0);
+    const f32 y1 = x2 + v * (x3 - x2);
+    sum[lane] += weight * (y0 + w * (y1 - y0));
+  }
+}
+
+// Maps the weighted sum of the octaves to [-amplitude;amplitude].
+f32 getHeightScale(const FruitDisplacement& displacement)
+{
+  f32 normalization = 0.0f;
+  for (ui32 octave = 0; octave < displacement.numOctaves; octave++)
+  {
+    normalization += std::ldexp(1.0f, -static_cast<i32>(octave));
+  }
+  return normalization > 0.0f ? displacement.amplitude / normalization : 0.0f;
+}
+
+// Heights of a block of points on the octahedron, see unfoldOctahedron().
+void evaluateHeights(const FruitDisplacement& displacement, f32 heightScale, const f32 (&x)[LANES],
+                     const f32 (&y)[LANES], const f32 (&z)[LANES], f32 (&heights)[LANES])
+{
+  f32 sum[LANES] = {};
+  for (ui32 octave = 0; octave < displacement.numOctaves; octave++)
+  {
+    const f32 frequency = std::ldexp(displacement.frequency, static_cast<i32>(octave));
+    f32       scaledX[LANES], scaledY[LANES], scaledZ[LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      scaledX[lane] = x[lane] * frequency;
+      scaledY[lane] = y[lane] * frequency;
+      scaledZ[lane] = z[lane] * frequency;
+    }
+    addGradientNoise(scaledX, scaledY, scaledZ, displacement.seed + octave * 0x9e3779b9u,
+                     std::ldexp(1.0f, -static_cast<i32>(octave)), sum);
+  }
+  for (ui32 lane = 0; lane < LANES; lane++)
+  {
+    heights[lane] = std::clamp(sum[lane] * heightScale, -displacement.amplitude, displacement.amplitude);
+  }
+}
+} // namespace
+
+namespace gims
+{
+const FruitDisplacement& getFruitDisplacementPreset(FruitType type)
+{
+  return PRESETS[static_cast<size_t>(type)];
+}
+
+void evaluateFruitDisplacement(const FruitDisplacement& displacement, const f32* u, const f32* v, size_t count,
+                               f32* heights)
+{
+  const f32 heightScale = getHeightScale(displacement);
+  for (const LaneBlock block : getLaneBlocks(0, count))
+  {
+    f32 x[LANES], y[LANES], z[LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      const size_t i = block.getElement(lane);
+      unfoldOctahedron(u[i], v[i], x[lane], y[lane], z[lane]);
+    }
+    f32 blockHeights[LANES];
+    evaluateHeights(displacement, heightScale, x, y, z, blockHeights);
+    std::copy(blockHeights, blockHeights + block.count, heights + block.first);
+  }
+}
+
+void displaceFruitVertices(const FruitProfile& profile, const FruitDisplacement& displacement, const f32* u,
+                           const f32* v, size_t first, size_t last, f32v3* positions)
+{
+  // Power basis c0 + c1 t + c2 t^2 + c3 t^3 of the profile curve.
+  const f32v3 c0 = profile.p0;
+  const f32v3 c1 = 3.0f * (profile.p1 - profile.p0);
+  const f32v3 c2 = 3.0f * (profile.p0 - 2.0f * profile.p1 + profile.p2);
+  const f32v3 c3 = profile.p3 - profile.p0 + 3.0f * (profile.p1 - profile.p2);
+
+  // calculateFruitCoordinates() + height * calculateFruitNormal(), unrolled into lane loops.
+  const f32 heightScale = getHeightScale(displacement);
+  const f32 orientation = profile.p3.z < profile.p0.z ? -1.0f : 1.0f;
+  for (const LaneBlock block : getLaneBlocks(first, last))
+  {
+    f32 x[LANES], y[LANES], z[LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      const size_t i = block.getElement(lane);
+      unfoldOctahedron(u[i], v[i], x[lane], y[lane], z[lane]);
+    }
+    f32 heights[LANES];
+    evaluateHeights(displacement, heightScale, x, y, z, heights);
+
+    f32 positionX[LANES], positionY[LANES], positionZ[LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      const f32 inverseLength = 1.0f / std::sqrt(x[lane] * x[lane] + y[lane] * y[lane] + z[lane] * z[lane]);
+      const f32 dx            = x[lane] * inverseLength;
+      const f32 dy            = y[lane] * inverseLength;
+      const f32 t             = 0.5f * (z[lane] * inverseLength + 1.0f);
+
+      const f32 pointX      = c0.x + t * (c1.x + t * (c2.x + t * c3.x));
+      const f32 pointY      = c0.y + t * (c1.y + t * (c2.y + t * c3.y));
+      const f32 pointZ      = c0.z + t * (c1.z + t * (c2.z + t * c3.z));
+      const f32 derivativeX = c1.x + t * (2.0f * c2.x + 3.0f * t * c3.x);
+      const f32 derivativeY = c1.y + t * (2.0f * c2.y + 3.0f * t * c3.y);
+      const f32 derivativeZ = c1.z + t * (2.0f * c2.z + 3.0f * t * c3.z);
+
+      // Angle of revolution, zero at the poles.
+      const f32  radius  = std::sqrt(dx * dx + dy * dy);
+      const bool isPole  = !(radius > 0.0f);
+      const f32  inverse = 1.0f / std::max(radius, 1e-30f);
+      const f32  c       = isPole ? 1.0f : dx * inverse;
+      const f32  s       = isPole ? 0.0f : dy * inverse;
+
+      // Normal of the unrotated profile, cross((-pointY, pointX, 0), derivative).
+      const f32  normalX      = pointX * derivativeZ;
+      const f32  normalY      = pointY * derivativeZ;
+      const f32  normalZ      = -pointY * derivativeY - pointX * derivativeX;
+      const f32  normalLength = std::sqrt(normalX * normalX + normalY * normalY + normalZ * normalZ);
+      const bool degenerate   = normalLength < 1e-12f;
+      const f32  height       = orientation * heights[lane];
+      const f32  scale        = height / std::max(normalLength, 1e-12f);
+      const f32  offsetX      = degenerate ? 0.0f : scale * normalX;
+      const f32  offsetY      = degenerate ? 0.0f : scale * normalY;
+      const f32  offsetZ      = degenerate ? (t < 0.5f ? -1.0f : 1.0f) * height : scale * normalZ;
+
+      positionX[lane] = c * (pointX + offsetX) - s * (pointY + offsetY);
+      positionY[lane] = s * (pointX + offsetX) + c * (pointY + offsetY);
+      positionZ[lane] = pointZ + offsetZ;
+    }
+
+    for (ui32 lane = 0; lane < block.count; lane++)
+    {
+      positions[block.first + lane] = f32v3(positionX[lane], positionY[lane], positionZ[lane]);
+    }
+  }
+}
+
+void displaceFruitMesh(const FruitProfile& profile, const FruitDisplacement& displacement, ui32 intraLOD,
+                       FruitMesh& mesh)
+{
+  const size_t numVertices = static_cast<size_t>(intraLOD) * intraLOD;
+  if (intraLOD < 2 || mesh.positions.size() != numVertices)
+  {
+    throw std::invalid_argument("The mesh is not an intraLOD x intraLOD fruit grid.");
+  }
+
+  // The same grid coordinates as tessellateFruit().
+  std::vector<f32> u(numVertices), v(numVertices);
+  const f32        step = 2.0f / static_cast<f32>(intraLOD - 1);
+  for (size_t i = 0; i < numVertices; i++)
+  {
+    u[i] = -1.0f + static_cast<f32>(i % intraLOD) * step;
+    v[i] = -1.0f + static_cast<f32>(i / intraLOD) * step;
+  }
+  parallelFor((numVertices + VERTICES_PER_TASK - 1) / VERTICES_PER_TASK,
+              [&](size_t task)
+              {
+                const size_t first = task * VERTICES_PER_TASK;
+                const size_t last  = std::min(first + VERTICES_PER_TASK, numVertices);
+                displaceFruitVertices(profile, displacement, u.data(), v.data(), first, last, mesh.positions.data());
+              });
+}
+} // namespace gims
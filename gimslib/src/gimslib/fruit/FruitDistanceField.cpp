@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <gimslib/fruit/FruitDistanceField.hpp>
+#include <gimslib/sys/LaneBlocks.hpp>
+#include <limits>
+
+namespace
+{
+using namespace gims;
+
+constexpr ui32 NUM_VERTICES          = FruitDistanceField::TABLE_SIZE + 1;
+constexpr ui32 NUM_NEWTON_STEPS      = 3;
+constexpr ui32 NUM_COARSE_SAMPLES    = 256;
+constexpr ui32 NUM_REFERENCE_SAMPLES = 4096;
+constexpr ui32 NUM_CHECKED_QUERIES   = 4096;
+constexpr f32  TABLE_MARGIN          = 0.5f;
+
+// Bounding box of the control points in the (r, z) half-plane, enlarged by TABLE_MARGIN of its larger side.
+void computeTableBounds(const FruitProfile& profile, f32v2& tableMin, f32v2& tableMax)
+{
+  const f32v3 p[4] = {profile.p0, profile.p1, profile.p2, profile.p3};
+  tableMin         = f32v2(0.0f, p[0].z);
+  tableMax         = f32v2(0.0f, p[0].z);
+  for (const f32v3& controlPoint : p)
+  {
+    tableMin = glm::min(tableMin, f32v2(controlPoint.x, controlPoint.z));
+    tableMax = glm::max(tableMax, f32v2(controlPoint.x, controlPoint.z));
+  }
+  const f32 margin = TABLE_MARGIN * std::max(std::max(tableMax.x - tableMin.x, tableMax.y - tableMin.y), 1e-3f);
+  tableMin         = f32v2(0.0f, tableMin.y - margin);
+  tableMax         = tableMax + margin;
+}
+
+// Newton's method on (B(t) - q) . B'(t) = 0 for the closest parameter of a cubic in power basis. Returns the squared
+// distance.
+f32 refineClosestParameter(const f32 (&r)[4], const f32 (&z)[4], f32 rho, f32 height, f32& t)
+{
+  for (ui32 step = 0; step < NUM_NEWTON_STEPS; step++)
+  {
+    const f32  dr         = ((r[3] * t + r[2]) * t + r[1]) * t + r[0] - rho;
+    const f32  dz         = ((z[3] * t + z[2]) * t + z[1]) * t + z[0] - height;
+    const f32  dr1        = (3.0f * r[3] * t + 2.0f * r[2]) * t + r[1];
+    const f32  dz1        = (3.0f * z[3] * t + 2.0f * z[2]) * t + z[1];
+    const f32  dr2        = 6.0f * r[3] * t + 2.0f * r[2];
+    const f32  dz2        = 6.0f * z[3] * t + 2.0f * z[2];
+    const f32  g          = dr * dr1 + dz * dz1;
+    const f32  derivative = dr1 * dr1 + dz1 * dz1 + dr * dr2 + dz * dz2;
+    const bool convex     = derivative > 1e-12f;
+    t                     = std::clamp(t - (convex ? g / derivative : 0.0f), 0.0f, 1.0f);
+  }
+  const f32 dr = ((r[3] * t + r[2]) * t + r[1]) * t + r[0] - rho;
+  const f32 dz = ((z[3] * t + z[2]) * t + z[1]) * t + z[0] - height;
+  return dr * dr + dz * dz;
+}
+
+// Signed distance in double precision: the closest of dense samples, refined by Newton's method.
+f64 referenceDistance(const FruitProfile& profile, f64 rho, f64 height)
+{
+  const auto distanceSquared = [&](f64 t)
+  {
+    const f64v3 p = evaluateCubicBezierCurve(profile, t);
+    return (p.x - rho) * (p.x - rho) + (p.z - height) * (p.z - height);
+  };
+  f64 bestT        = 0.0;
+  f64 bestDistance = distanceSquared(0.0);
+  for (ui32 i = 1; i <= NUM_REFERENCE_SAMPLES; i++)
+  {
+    const f64 t        = static_cast<f64>(i) / NUM_REFERENCE_SAMPLES;
+    const f64 distance = distanceSquared(t);
+    if (distance < bestDistance)
+    {
+      bestT        = t;
+      bestDistance = distance;
+    }
+  }
+  // Golden section search within the neighboring samples.
+  f64       lower = std::max(bestT - 1.0 / NUM_REFERENCE_SAMPLES, 0.0);
+  f64       upper = std::min(bestT + 1.0 / NUM_REFERENCE_SAMPLES, 1.0);
+  const f64 ratio = 0.5 * (std::sqrt(5.0) - 1.0);
+  for (ui32 i = 0; i < 64; i++)
+  {
+    const f64 a = upper - ratio * (upper - lower);
+    const f64 b = lower + ratio * (upper - lower);
+    if (distanceSquared(a) < distanceSquared(b))
+    {
+      upper = b;
+    }
+    else
+    {
+      lower = a;
+    }
+  }
+  const f64   t          = 0.5 * (lower + upper);
+  const f64v3 point      = evaluateCubicBezierCurve(profile, t);
+  const f64v3 derivative = evaluateCubicBezierCurve(profile, std::min(t + 1e-6, 1.0)) -
+                           evaluateCubicBezierCurve(profile, std::max(t - 1e-6, 0.0));
+  const f64   side       = (rho - point.x) * derivative.z - (height - point.z) * derivative.x;
+  const f64   distance   = std::sqrt(std::min(distanceSquared(t), bestDistance));
+  return side < 0.0 ? -distance : distance;
+}
+} // namespace
+
+namespace gims
+{
+FruitDistanceField::FruitDistanceField(const FruitProfile& profile)
+    : m_parameters(NUM_VERTICES * NUM_VERTICES)
+{
+  const f32v3 p0 = profile.p0;
+  const f32v3 p1 = profile.p1;
+  const f32v3 p2 = profile.p2;
+  const f32v3 p3 = profile.p3;
+  for (ui32 c = 0; c < 2; c++)
+  {
+    const ui32 component = c == 0 ? 0 : 2;
+    m_coefficients[c][0] = p0[component];
+    m_coefficients[c][1] = 3.0f * (p1[component] - p0[component]);
+    m_coefficients[c][2] = 3.0f * (p0[component] - 2.0f * p1[component] + p2[component]);
+    m_coefficients[c][3] = p3[component] - p0[component] + 3.0f * (p1[component] - p2[component]);
+  }
+
+  f32v2 tableMax;
+  computeTableBounds(profile, m_tableMin, tableMax);
+  const f32v2 cellSize = (tableMax - m_tableMin) / static_cast<f32>(TABLE_SIZE);
+  m_inverseCellSize    = 1.0f / cellSize;
+
+  f32v2 samples[NUM_COARSE_SAMPLES + 1];
+  for (ui32 i = 0; i <= NUM_COARSE_SAMPLES; i++)
+  {
+    const f32v3 point = evaluateCubicBezierCurve(profile, static_cast<f32>(i) / NUM_COARSE_SAMPLES);
+    samples[i]        = f32v2(point.x, point.z);
+  }
+  for (ui32 j = 0; j < NUM_VERTICES; j++)
+  {
+    for (ui32 i = 0; i < NUM_VERTICES; i++)
+    {
+      const f32v2 vertex       = m_tableMin + cellSize * f32v2(static_cast<f32>(i), static_cast<f32>(j));
+      ui32        best         = 0;
+      f32         bestDistance = std::numeric_limits<f32>::infinity();
+      for (ui32 k = 0; k <= NUM_COARSE_SAMPLES; k++)
+      {
+        const f32v2 d        = samples[k] - vertex;
+        const f32   distance = glm::dot(d, d);
+        best                 = distance < bestDistance ? k : best;
+        bestDistance         = std::min(distance, bestDistance);
+      }
+      f32 t = static_cast<f32>(best) / NUM_COARSE_SAMPLES;
+      refineClosestParameter(m_coefficients[0], m_coefficients[1], vertex.x, vertex.y, t);
+      m_parameters[j * NUM_VERTICES + i] = t;
+    }
+  }
+}
+
+f32 FruitDistanceField::evaluate(const f32v3& point) const
+{
+  f32 distance;
+  evaluate(&point.x, &point.y, &point.z, 1, &distance);
+  return distance;
+}
+
+void FruitDistanceField::evaluate(const f32* x, const f32* y, const f32* z, size_t count, f32* distances) const
+{
+  const f32(&r)[4]      = m_coefficients[0];
+  const f32(&height)[4] = m_coefficients[1];
+  const f32 lastCell    = static_cast<f32>(TABLE_SIZE - 1);
+
+  for (const LaneBlock block : getLaneBlocks(0, count))
+  {
+    f32 rho[LANES], qz[LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      const size_t i = block.getElement(lane);
+      rho[lane]      = std::sqrt(x[i] * x[i] + y[i] * y[i]);
+      qz[lane]       = z[i];
+    }
+
+    // The closest parameters at the four vertices of the cell are the starting points.
+    f32 candidates[4][LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      const f32  u        = std::clamp((rho[lane] - m_tableMin.x) * m_inverseCellSize.x, 0.0f, lastCell);
+      const f32  v        = std::clamp((qz[lane] - m_tableMin.y) * m_inverseCellSize.y, 0.0f, lastCell);
+      const ui32 vertex   = static_cast<ui32>(v) * NUM_VERTICES + static_cast<ui32>(u);
+      candidates[0][lane] = m_parameters[vertex];
+      candidates[1][lane] = m_parameters[vertex + 1];
+      candidates[2][lane] = m_parameters[vertex + NUM_VERTICES];
+      candidates[3][lane] = m_parameters[vertex + NUM_VERTICES + 1];
+    }
+
+    f32 bestDistance[LANES];
+    f32 bestT[LANES];
+    std::fill(bestDistance, bestDistance + LANES, std::numeric_limits<f32>::infinity());
+    std::fill(bestT, bestT + LANES, 0.0f);
+    for (ui32 candidate = 0; candidate < 4; candidate++)
+    {
+      for (ui32 lane = 0; lane < LANES; lane++)
+      {
+        f32        t        = candidates[candidate][lane];
+        const f32  distance = refineClosestParameter(r, height, rho[lane], qz[lane], t);
+        const bool closer   = distance < bestDistance[lane];
+        bestDistance[lane]  = closer ? distance : bestDistance[lane];
+        bestT[lane]         = closer ? t : bestT[lane];
+      }
+    }
+
+    // Inside if the point lies left of the profile, which runs from the bottom to the top.
+    for (ui32 lane = 0; lane < block.count; lane++)
+    {
+      const f32 t    = bestT[lane];
+      const f32 dr   = ((r[3] * t + r[2]) * t + r[1]) * t + r[0] - rho[lane];
+      const f32 dz   = ((height[3] * t + height[2]) * t + height[1]) * t + height[0] - qz[lane];
+      const f32 dr1  = (3.0f * r[3] * t + 2.0f * r[2]) * t + r[1];
+      const f32 dz1  = (3.0f * height[3] * t + 2.0f * height[2]) * t + height[1];
+      const f32 side = dr * dz1 - dz * dr1;
+      const f32 distance           = std::sqrt(bestDistance[lane]);
+      distances[block.first + lane] = side > 0.0f ? -distance : distance;
+    }
+  }
+}
+
+const FruitDistanceField& getFruitDistanceField(FruitType type)
+{
+  static const std::array<FruitDistanceField, static_cast<size_t>(FruitType::Count)> fields = {
+      FruitDistanceField(getFruitPreset(FruitType::Apple).profile),
+      FruitDistanceField(getFruitPreset(FruitType::Pear).profile),
+      FruitDistanceField(getFruitPreset(FruitType::Lemon).profile),
+      FruitDistanceField(getFruitPreset(FruitType::Strawberry).profile)};
+  return fields[static_cast<size_t>(type)];
+}
+
+FruitDistanceFieldBenchmark benchmarkFruitDistanceField(const FruitProfile& profile, ui32 numQueries)
+{
+  FruitDistanceFieldBenchmark benchmark;
+  if (numQueries == 0)
+  {
+    return benchmark;
+  }
+
+  const FruitDistanceField field(profile);
+  f32v2                    tableMin, tableMax;
+  computeTableBounds(profile, tableMin, tableMax);
+
+  // Points of a Halton sequence in the cylinder that the table covers.
+  std::vector<f32> x(numQueries), y(numQueries), z(numQueries), distances(numQueries);
+  for (ui32 i = 0; i < numQueries; i++)
+  {
+    f32 halton[3] = {};
+    for (ui32 dimension = 0; dimension < 3; dimension++)
+    {
+      const ui32 base     = dimension == 0 ? 2 : dimension == 1 ? 3 : 5;
+      f32        fraction = 1.0f;
+      for (ui32 n = i + 1; n > 0; n /= base)
+      {
+        fraction /= static_cast<f32>(base);
+        halton[dimension] += fraction * static_cast<f32>(n % base);
+      }
+    }
+    const f32 rho   = tableMax.x * std::sqrt(halton[0]);
+    const f32 angle = 2.0f * glm::pi<f32>() * halton[1];
+    x[i]            = rho * std::cos(angle);
+    y[i]            = rho * std::sin(angle);
+    z[i]            = tableMin.y + (tableMax.y - tableMin.y) * halton[2];
+  }
+
+  const auto start = std::chrono::high_resolution_clock::now();
+  field.evaluate(x.data(), y.data(), z.data(), numQueries, distances.data());
+  const std::chrono::duration<f64> duration = std::chrono::high_resolution_clock::now() - start;
+  benchmark.queriesPerSecond = static_cast<f64>(numQueries) / std::max(duration.count(), 1e-9);
+
+  const ui32 numChecked = std::min(numQueries, NUM_CHECKED_QUERIES);
+  f64        sumSquared = 0.0;
+  for (ui32 i = 0; i < numChecked; i++)
+  {
+    const size_t query = static_cast<size_t>(i) * numQueries / numChecked;
+    const f64    rho   = std::sqrt(static_cast<f64>(x[query]) * x[query] + static_cast<f64>(y[query]) * y[query]);
+    const f64    error = std::abs(referenceDistance(profile, rho, z[query]) - distances[query]);
+    benchmark.maxError = std::max(benchmark.maxError, static_cast<f32>(error));
+    sumSquared += error * error;
+  }
+  benchmark.rmsError = static_cast<f32>(std::sqrt(sumSquared / numChecked));
+  return benchmark;
+}
+} // namespace gims
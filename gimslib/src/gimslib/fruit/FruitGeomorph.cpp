@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <gimslib/fruit/FruitGeomorph.hpp>
+#include <gimslib/fruit/FruitTiling.hpp>
+#include <stdexcept>
+
+namespace gims
+{
+bool isFruitGridMorphable(ui32 gridSize)
+{
+  return gridSize >= 5 && gridSize <= FruitTiling::MAX_GRID_SIZE && (gridSize - 1) % 4 == 0;
+}
+
+FruitMorphEdge getFruitMorphEdge(ui32 gridSize, ui32 x, ui32 y)
+{
+  if (!isFruitGridMorphable(gridSize) || x >= gridSize || y >= gridSize)
+  {
+    throw std::invalid_argument("The grid is not morphable or the vertex does not exist.");
+  }
+
+  FruitMorphEdge result = {ui32v2(x, y), ui32v2(x, y)};
+  const bool     oddX   = (x & 1) == 1;
+  const bool     oddY   = (y & 1) == 1;
+  if (oddX && !oddY)
+  {
+    result.first.x--;
+    result.second.x++;
+  }
+  else if (!oddX && oddY)
+  {
+    result.first.y--;
+    result.second.y++;
+  }
+  else if (oddX && oddY)
+  {
+    // The fine quad (x, y) is in the same quadrant as the coarse quad, since the quadrants start at the even 2 m.
+    const ui32 half         = gridSize / 2;
+    const bool noFlipNeeded = (x < half && y < half) || (x >= half && y >= half);
+    result.first            = noFlipNeeded ? ui32v2(x + 1, y - 1) : ui32v2(x - 1, y - 1);
+    result.second           = noFlipNeeded ? ui32v2(x - 1, y + 1) : ui32v2(x + 1, y + 1);
+  }
+  return result;
+}
+
+FruitMorphLevel selectFruitMorphLevel(f32 level, ui32 maxGridSize)
+{
+  const ui32 finestGridSize = std::min(maxGridSize, FruitTiling::MAX_GRID_SIZE);
+  if (!(level > 1.0f) || finestGridSize < 5)
+  {
+    return {3, 0.0f};
+  }
+
+  // The smallest power of two m with level <= 2 m, unless the grid 4 m + 1 would be too fine.
+  ui32 m = 1;
+  while (2.0f * static_cast<f32>(m) < level && 8 * m + 1 <= finestGridSize)
+  {
+    m *= 2;
+  }
+  const f32 morphFactor = (2.0f * static_cast<f32>(m) - level) / static_cast<f32>(m);
+  return {4 * m + 1, std::clamp(morphFactor, 0.0f, 1.0f)};
+}
+
+FruitMesh tessellateMorphedFruit(const FruitProfile& profile, ui32 gridSize, f32 morphFactor)
+{
+  if (!isFruitGridMorphable(gridSize) || !(morphFactor >= 0.0f && morphFactor <= 1.0f))
+  {
+    throw std::invalid_argument("The grid is not morphable or the morph factor is not in [0;1].");
+  }
+
+  FruitMesh                result    = tessellateFruit(profile, gridSize);
+  const std::vector<f32v3> unmorphed = result.positions;
+  for (ui32 y = 0; y < gridSize; y++)
+  {
+    for (ui32 x = 0; x < gridSize; x++)
+    {
+      const FruitMorphEdge edge     = getFruitMorphEdge(gridSize, x, y);
+      const f32v3&         first    = unmorphed[edge.first.y * gridSize + edge.first.x];
+      const f32v3&         second   = unmorphed[edge.second.y * gridSize + edge.second.x];
+      f32v3&               position = result.positions[y * gridSize + x];
+      position += morphFactor * (0.5f * (first + second) - position);
+    }
+  }
+  return result;
+}
+} // namespace gims
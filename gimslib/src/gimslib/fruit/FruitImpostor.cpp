@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <gimslib/fruit/FruitImpostor.hpp>
+#include <gimslib/fruit/FruitMeasures.hpp>
+#include <gimslib/fruit/FruitRayIntersector.hpp>
+#include <gimslib/sys/ParallelFor.hpp>
+#include <stdexcept>
+
+namespace
+{
+using namespace gims;
+
+constexpr ui32 MAX_ATLAS_SIZE = 16384;
+constexpr ui32 EMPTY_DEPTH    = 0xffff;
+
+// The layout is one of the enumerators, and the atlas has at least 2 views per side and at most MAX_ATLAS_SIZE texels
+// per side. The size is computed in 64 bits, so large factors cannot wrap around below the limit.
+bool isValidAtlas(FruitImpostorLayout layout, ui32 viewsPerSide, ui32 viewResolution)
+{
+  return (layout == FruitImpostorLayout::Sphere || layout == FruitImpostorLayout::Hemisphere) && viewsPerSide >= 2 &&
+         viewResolution > 0 && static_cast<ui64>(viewsPerSide) * viewResolution <= MAX_ATLAS_SIZE;
+}
+
+ui32 toUnorm8(f32 value)
+{
+  return static_cast<ui32>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+f32v2 encodeDirection(FruitImpostorLayout layout, const f32v3& direction)
+{
+  if (layout == FruitImpostorLayout::Sphere)
+  {
+    return octEncode(direction);
+  }
+  // Directions below the horizon use the closest view on it.
+  const f32v3 d = f32v3(direction.x, direction.y, std::max(direction.z, 0.0f));
+  const f32v2 p = f32v2(d.x, d.y) / std::max(std::abs(d.x) + std::abs(d.y) + d.z, 1e-30f);
+  return f32v2(p.x + p.y, p.x - p.y);
+}
+
+f32v3 decodeDirection(FruitImpostorLayout layout, const f32v2& coordinates)
+{
+  if (layout == FruitImpostorLayout::Sphere)
+  {
+    return octDecode(coordinates);
+  }
+  const f32v2 p = 0.5f * f32v2(coordinates.x + coordinates.y, coordinates.x - coordinates.y);
+  return glm::normalize(f32v3(p, 1.0f - std::abs(p.x) - std::abs(p.y)));
+}
+} // namespace
+
+namespace gims
+{
+ui32 FruitImpostorAtlas::getSize() const
+{
+  return header.viewsPerSide * header.viewResolution;
+}
+
+void FruitImpostorAtlas::save(const std::filesystem::path& fileName) const
+{
+  std::ofstream outFile(fileName, std::ios::out | std::ios::binary);
+  if (!outFile.is_open())
+  {
+    throw std::runtime_error("Error opening file " + fileName.string() + ".");
+  }
+  outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  outFile.write(reinterpret_cast<const char*>(colors.data()),
+                static_cast<std::streamsize>(colors.size() * sizeof(ui32)));
+  outFile.write(reinterpret_cast<const char*>(normalDepths.data()),
+                static_cast<std::streamsize>(normalDepths.size() * sizeof(ui32)));
+  if (!outFile)
+  {
+    throw std::runtime_error("Error writing file " + fileName.string() + ".");
+  }
+}
+
+FruitImpostorAtlas FruitImpostorAtlas::load(const std::filesystem::path& fileName)
+{
+  std::ifstream inFile(fileName, std::ios::in | std::ios::binary);
+  if (!inFile.is_open())
+  {
+    throw std::runtime_error("Error opening file " + fileName.string() + ".");
+  }
+  FruitImpostorAtlas atlas;
+  inFile.read(reinterpret_cast<char*>(&atlas.header), sizeof(atlas.header));
+  if (!inFile || atlas.header.magic != FruitImpostorHeader::MAGIC ||
+      atlas.header.version != FruitImpostorHeader::VERSION ||
+      !isValidAtlas(atlas.header.layout, atlas.header.viewsPerSide, atlas.header.viewResolution))
+  {
+    throw std::runtime_error("Invalid fruit impostor atlas " + fileName.string() + ".");
+  }
+  const size_t numTexels = static_cast<size_t>(atlas.getSize()) * atlas.getSize();
+  atlas.colors.resize(numTexels);
+  atlas.normalDepths.resize(numTexels);
+  inFile.read(reinterpret_cast<char*>(atlas.colors.data()), static_cast<std::streamsize>(numTexels * sizeof(ui32)));
+  inFile.read(reinterpret_cast<char*>(atlas.normalDepths.data()),
+              static_cast<std::streamsize>(numTexels * sizeof(ui32)));
+  if (!inFile)
+  {
+    throw std::runtime_error("Error reading file " + fileName.string() + ".");
+  }
+  return atlas;
+}
+
+f32v3 getFruitImpostorViewDirection(FruitImpostorLayout layout, ui32 viewsPerSide, ui32 x, ui32 y)
+{
+  const f32 scale = 2.0f / static_cast<f32>(viewsPerSide - 1);
+  return decodeDirection(layout, f32v2(static_cast<f32>(x) * scale - 1.0f, static_cast<f32>(y) * scale - 1.0f));
+}
+
+void getFruitImpostorViewBasis(const f32v3& direction, f32v3& right, f32v3& up)
+{
+  const f32v3 axis = std::abs(direction.z) > 0.999f ? f32v3(1.0f, 0.0f, 0.0f) : f32v3(0.0f, 0.0f, 1.0f);
+  right            = glm::normalize(glm::cross(axis, direction));
+  up               = glm::cross(direction, right);
+}
+
+FruitImpostorAtlas bakeFruitImpostor(const FruitProfile& profile, const f32v3& color, FruitImpostorLayout layout,
+                                     ui32 viewsPerSide, ui32 viewResolution)
+{
+  if (!isValidAtlas(layout, viewsPerSide, viewResolution))
+  {
+    throw std::invalid_argument("An impostor atlas needs a valid layout, 2 or more views per side and at most 16384^2 "
+                                "texels.");
+  }
+
+  // The bounding sphere of the exact bounding box is tighter than the one of the control points.
+  const FruitMeasures measures   = computeFruitMeasures(profile);
+  const f32v3         halfExtent = 0.5f * (measures.aabbMax - measures.aabbMin);
+
+  FruitImpostorAtlas atlas;
+  atlas.header.layout         = layout;
+  atlas.header.viewsPerSide   = viewsPerSide;
+  atlas.header.viewResolution = viewResolution;
+  atlas.header.center         = 0.5f * (measures.aabbMin + measures.aabbMax);
+  atlas.header.radius         = std::max(std::sqrt(halfExtent.x * halfExtent.x + halfExtent.z * halfExtent.z), 1e-6f);
+
+  const size_t atlasSize = atlas.getSize();
+  atlas.colors.resize(atlasSize * atlasSize);
+  atlas.normalDepths.resize(atlasSize * atlasSize);
+
+  const FruitRayIntersector intersector(profile);
+  const f32                 radius    = atlas.header.radius;
+  const f32v3               center    = atlas.header.center;
+  const ui32                albedo    = toUnorm8(color.x) | toUnorm8(color.y) << 8 | toUnorm8(color.z) << 16;
+  const f32                 pixelSize = 2.0f * radius / static_cast<f32>(viewResolution);
+  const ui32                numTexels = viewResolution * viewResolution;
+  parallelFor(static_cast<size_t>(viewsPerSide) * viewsPerSide,
+              [&](size_t view)
+              {
+                const ui32  viewX     = static_cast<ui32>(view % viewsPerSide);
+                const ui32  viewY     = static_cast<ui32>(view / viewsPerSide);
+                const f32v3 direction = getFruitImpostorViewDirection(layout, viewsPerSide, viewX, viewY);
+                f32v3       right, up;
+                getFruitImpostorViewBasis(direction, right, up);
+
+                // One orthographic ray per texel center, starting on the tangent plane of the sphere.
+                FruitRayArray rays;
+                rays.resize(numTexels);
+                for (ui32 y = 0; y < viewResolution; y++)
+                {
+                  for (ui32 x = 0; x < viewResolution; x++)
+                  {
+                    const f32v3 origin = center + radius * direction +
+                                         ((static_cast<f32>(x) + 0.5f) * pixelSize - radius) * right +
+                                         (radius - (static_cast<f32>(y) + 0.5f) * pixelSize) * up;
+                    rays.setRay(y * viewResolution + x, origin, -direction, 2.0f * radius);
+                  }
+                }
+                FruitRayHitArray hits;
+                hits.resize(numTexels);
+                intersector.intersect(rays, 0, numTexels, hits);
+
+                for (ui32 y = 0; y < viewResolution; y++)
+                {
+                  const size_t row = (static_cast<size_t>(viewY) * viewResolution + y) * atlasSize +
+                                     static_cast<size_t>(viewX) * viewResolution;
+                  for (ui32 x = 0; x < viewResolution; x++)
+                  {
+                    const ui32 i = y * viewResolution + x;
+                    if (!std::isfinite(hits.distance[i]))
+                    {
+                      atlas.colors[row + x]       = 0;
+                      atlas.normalDepths[row + x] = EMPTY_DEPTH << 16;
+                      continue;
+                    }
+                    const f32v2 normal = octEncode(f32v3(hits.normalX[i], hits.normalY[i], hits.normalZ[i]));
+                    // The hit lies radius - distance in front of the plane through the center.
+                    const f32  depth = (radius - hits.distance[i]) / radius;
+                    const ui32 encodedDepth =
+                        static_cast<ui32>(std::clamp(0.5f - 0.5f * depth, 0.0f, 1.0f) * (EMPTY_DEPTH - 1) + 0.5f);
+                    atlas.colors[row + x]       = albedo | 0xffu << 24;
+                    atlas.normalDepths[row + x] = toUnorm8(0.5f * normal.x + 0.5f) |
+                                                  toUnorm8(0.5f * normal.y + 0.5f) << 8 | encodedDepth << 16;
+                  }
+                }
+              });
+  return atlas;
+}
+
+FruitImpostorViews selectFruitImpostorViews(const FruitImpostorHeader& header, const f32v3& direction)
+{
+  if (!isValidAtlas(header.layout, header.viewsPerSide, header.viewResolution))
+  {
+    throw std::invalid_argument("The header does not describe a valid impostor atlas.");
+  }
+  // Continuous grid coordinates of the direction, then the cell and the triangle of the cell that contain it.
+  const f32   lastView = static_cast<f32>(header.viewsPerSide - 1);
+  const f32v2 grid     = (0.5f * encodeDirection(header.layout, direction) + 0.5f) * lastView;
+  const f32v2 cell     = glm::clamp(glm::floor(grid), f32v2(0.0f), f32v2(lastView - 1.0f));
+  const f32v2 f        = glm::clamp(grid - cell, f32v2(0.0f), f32v2(1.0f));
+  const ui32  first    = static_cast<ui32>(cell.y) * header.viewsPerSide + static_cast<ui32>(cell.x);
+  const ui32  right    = first + 1;
+  const ui32  below    = first + header.viewsPerSide;
+
+  FruitImpostorViews views;
+  if (f.x + f.y <= 1.0f)
+  {
+    views = {{first, right, below}, {1.0f - f.x - f.y, f.x, f.y}};
+  }
+  else
+  {
+    views = {{below + 1, below, right}, {f.x + f.y - 1.0f, 1.0f - f.x, 1.0f - f.y}};
+  }
+  return views;
+}
+} // namespace gims
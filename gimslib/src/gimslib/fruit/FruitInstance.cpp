@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <cmath>
+#include <gimslib/fruit/FruitInstance.hpp>
+#include <gimslib/sys/LaneBlocks.hpp>
+
+namespace
+{
+using namespace gims;
+
+constexpr ui32 NUM_PRESETS = static_cast<ui32>(FruitType::Count);
+
+constexpr ui32 POSITION_BITS    = 21;
+constexpr ui64 POSITION_MASK    = (ui64(1) << POSITION_BITS) - 1;
+constexpr f32  POSITION_MAXIMUM = static_cast<f32>(POSITION_MASK);
+
+constexpr ui32 ROTATION_BITS    = 10;
+constexpr ui32 ROTATION_MASK    = (1u << ROTATION_BITS) - 1;
+constexpr f32  ROTATION_MAXIMUM = static_cast<f32>(ROTATION_MASK);
+constexpr f32  SQRT2            = 1.41421356f;
+
+// Components of the FruitProfileArray (3 * control point + coordinate) that are stored in PackedFruitInstance.
+constexpr ui32 PROFILE_COMPONENTS[PackedFruitInstance::NUM_PROFILE_OFFSETS][2] = {{0, 2}, {1, 0}, {1, 2},
+                                                                                  {2, 0}, {2, 2}, {3, 2}};
+
+// presetComponents[offset][preset]: the preset's value of the stored profile components.
+struct PresetComponents
+{
+  f32 values[PackedFruitInstance::NUM_PROFILE_OFFSETS][NUM_PRESETS];
+
+  PresetComponents()
+  {
+    for (ui32 preset = 0; preset < NUM_PRESETS; preset++)
+    {
+      const FruitProfile& profile          = getFruitPreset(static_cast<FruitType>(preset)).profile;
+      const f32v3* const  controlPoints[4] = {&profile.p0, &profile.p1, &profile.p2, &profile.p3};
+      for (ui32 offset = 0; offset < PackedFruitInstance::NUM_PROFILE_OFFSETS; offset++)
+      {
+        values[offset][preset] = (*controlPoints[PROFILE_COMPONENTS[offset][0]])[PROFILE_COMPONENTS[offset][1]];
+      }
+    }
+  }
+};
+
+const PresetComponents& getPresetComponents()
+{
+  static const PresetComponents presetComponents;
+  return presetComponents;
+}
+
+ui32 presetIndex(ui8 preset)
+{
+  return std::min<ui32>(preset, NUM_PRESETS - 1);
+}
+
+ui64 quantizePosition(f32 value, f32 minimum, f32 scale)
+{
+  return static_cast<ui64>(std::clamp((value - minimum) * scale, 0.0f, POSITION_MAXIMUM) + 0.5f);
+}
+
+ui32 quantizeRotation(f32 value)
+{
+  return static_cast<ui32>(std::clamp((value * SQRT2 * 0.5f + 0.5f) * ROTATION_MAXIMUM, 0.0f, ROTATION_MAXIMUM) +
+                           0.5f);
+}
+
+f32 dequantizeRotation(ui32 value)
+{
+  return (static_cast<f32>(value & ROTATION_MASK) / ROTATION_MAXIMUM * 2.0f - 1.0f) / SQRT2;
+}
+} // namespace
+
+namespace gims
+{
+size_t FruitInstanceArray::getSize() const
+{
+  return presets.size();
+}
+
+void FruitInstanceArray::resize(size_t numInstances)
+{
+  profiles.resize(numInstances);
+  positionX.resize(numInstances, 0.0f);
+  positionY.resize(numInstances, 0.0f);
+  positionZ.resize(numInstances, 0.0f);
+  rotationX.resize(numInstances, 0.0f);
+  rotationY.resize(numInstances, 0.0f);
+  rotationZ.resize(numInstances, 0.0f);
+  rotationW.resize(numInstances, 1.0f);
+  presets.resize(numInstances, 0);
+  colorIndices.resize(numInstances, 0);
+  lodBiases.resize(numInstances, 0);
+  flags.resize(numInstances, 0);
+}
+
+void FruitInstanceArray::setInstance(size_t index, const FruitInstance& instance)
+{
+  profiles.setProfile(index, instance.profile);
+  positionX[index]    = instance.position.x;
+  positionY[index]    = instance.position.y;
+  positionZ[index]    = instance.position.z;
+  rotationX[index]    = instance.rotation.x;
+  rotationY[index]    = instance.rotation.y;
+  rotationZ[index]    = instance.rotation.z;
+  rotationW[index]    = instance.rotation.w;
+  presets[index]      = static_cast<ui8>(instance.preset);
+  colorIndices[index] = instance.colorIndex;
+  lodBiases[index]    = instance.lodBias;
+  flags[index]        = instance.flags;
+}
+
+FruitInstance FruitInstanceArray::getInstance(size_t index) const
+{
+  FruitInstance instance;
+  instance.preset     = static_cast<FruitType>(presets[index]);
+  instance.profile    = profiles.getProfile(index);
+  instance.position   = f32v3(positionX[index], positionY[index], positionZ[index]);
+  instance.rotation   = f32v4(rotationX[index], rotationY[index], rotationZ[index], rotationW[index]);
+  instance.colorIndex = colorIndices[index];
+  instance.lodBias    = lodBiases[index];
+  instance.flags      = flags[index];
+  return instance;
+}
+
+void packFruitInstances(const FruitInstanceArray& instances, const f32v3& positionMin, const f32v3& positionMax,
+                        size_t first, size_t last, PackedFruitInstance* records)
+{
+  const PresetComponents& presetComponents = getPresetComponents();
+  const f32v3             positionScale    = POSITION_MAXIMUM / glm::max(positionMax - positionMin, f32v3(1e-30f));
+  const f32* const        position[3]      = {instances.positionX.data(), instances.positionY.data(),
+                                              instances.positionZ.data()};
+  const f32* const        rotation[4]      = {instances.rotationX.data(), instances.rotationY.data(),
+                                              instances.rotationZ.data(), instances.rotationW.data()};
+
+  for (const LaneBlock block : getLaneBlocks(first, last))
+  {
+    ui64 packedPosition[LANES] = {};
+    for (ui32 c = 0; c < 3; c++)
+    {
+      for (ui32 lane = 0; lane < block.count; lane++)
+      {
+        packedPosition[lane] |= quantizePosition(position[c][block.first + lane], positionMin[c], positionScale[c])
+                                << (c * POSITION_BITS);
+      }
+    }
+
+    // Smallest three: drop the largest component and flip the sign of the quaternion to make it positive.
+    ui32 packedRotation[LANES];
+    for (ui32 lane = 0; lane < block.count; lane++)
+    {
+      const size_t i       = block.first + lane;
+      const f32    q[4]    = {rotation[0][i], rotation[1][i], rotation[2][i], rotation[3][i]};
+      ui32         largest = 0;
+      for (ui32 c = 1; c < 4; c++)
+      {
+        largest = std::abs(q[c]) > std::abs(q[largest]) ? c : largest;
+      }
+      const f32 sign   = q[largest] < 0.0f ? -1.0f : 1.0f;
+      ui32      packed = largest << (3 * ROTATION_BITS);
+      ui32      slot   = 0;
+      for (ui32 c = 0; c < 4; c++)
+      {
+        if (c != largest)
+        {
+          packed |= quantizeRotation(sign * q[c]) << ((2 - slot) * ROTATION_BITS);
+          slot++;
+        }
+      }
+      packedRotation[lane] = packed;
+    }
+
+    i16 profileOffsets[PackedFruitInstance::NUM_PROFILE_OFFSETS][LANES];
+    for (ui32 offset = 0; offset < PackedFruitInstance::NUM_PROFILE_OFFSETS; offset++)
+    {
+      const f32* component =
+          instances.profiles.getComponent(PROFILE_COMPONENTS[offset][0], PROFILE_COMPONENTS[offset][1]) + block.first;
+      const ui8* preset = instances.presets.data() + block.first;
+      for (ui32 lane = 0; lane < block.count; lane++)
+      {
+        const f32 difference = (component[lane] - presetComponents.values[offset][presetIndex(preset[lane])]) /
+                               PackedFruitInstance::PROFILE_OFFSET_STEP;
+        profileOffsets[offset][lane] = static_cast<i16>(std::round(std::clamp(difference, -32767.0f, 32767.0f)));
+      }
+    }
+
+    for (ui32 lane = 0; lane < block.count; lane++)
+    {
+      const size_t         i      = block.first + lane;
+      PackedFruitInstance& record = records[i];
+      record.position             = packedPosition[lane];
+      record.rotation             = packedRotation[lane];
+      for (ui32 offset = 0; offset < PackedFruitInstance::NUM_PROFILE_OFFSETS; offset++)
+      {
+        record.profileOffsets[offset] = profileOffsets[offset][lane];
+      }
+      record.preset     = static_cast<ui8>(presetIndex(instances.presets[i]));
+      record.colorIndex = instances.colorIndices[i];
+      record.lodBias    = instances.lodBiases[i];
+      record.flags      = instances.flags[i];
+      record.reserved   = 0;
+    }
+  }
+}
+
+void unpackFruitInstances(const PackedFruitInstance* records, const f32v3& positionMin, const f32v3& positionMax,
+                          size_t first, size_t last, FruitInstanceArray& instances)
+{
+  const PresetComponents& presetComponents = getPresetComponents();
+  const f32v3             positionStep     = (positionMax - positionMin) / POSITION_MAXIMUM;
+  f32* const              position[3]      = {instances.positionX.data(), instances.positionY.data(),
+                                              instances.positionZ.data()};
+  f32* const              rotation[4]      = {instances.rotationX.data(), instances.rotationY.data(),
+                                              instances.rotationZ.data(), instances.rotationW.data()};
+
+  for (const LaneBlock block : getLaneBlocks(first, last))
+  {
+    for (ui32 c = 0; c < 3; c++)
+    {
+      for (ui32 lane = 0; lane < block.count; lane++)
+      {
+        const ui64 quantized = (records[block.first + lane].position >> (c * POSITION_BITS)) & POSITION_MASK;
+        position[c][block.first + lane] = positionMin[c] + static_cast<f32>(quantized) * positionStep[c];
+      }
+    }
+
+    // Decode the three stored components, then reconstruct the largest one and move it into place.
+    for (ui32 lane = 0; lane < block.count; lane++)
+    {
+      const size_t i       = block.first + lane;
+      const ui32   packed  = records[i].rotation;
+      const ui32   largest = packed >> (3 * ROTATION_BITS);
+      const f32    a       = dequantizeRotation(packed >> (2 * ROTATION_BITS));
+      const f32    b       = dequantizeRotation(packed >> ROTATION_BITS);
+      const f32    c       = dequantizeRotation(packed);
+      const f32    d       = std::sqrt(std::max(1.0f - a * a - b * b - c * c, 0.0f));
+      rotation[0][i]       = largest == 0 ? d : a;
+      rotation[1][i]       = largest == 0 ? a : largest == 1 ? d : b;
+      rotation[2][i]       = largest <= 1 ? b : largest == 2 ? d : c;
+      rotation[3][i]       = largest == 3 ? d : c;
+    }
+
+    for (ui32 offset = 0; offset < PackedFruitInstance::NUM_PROFILE_OFFSETS; offset++)
+    {
+      f32* component =
+          instances.profiles.getComponent(PROFILE_COMPONENTS[offset][0], PROFILE_COMPONENTS[offset][1]) + block.first;
+      for (ui32 lane = 0; lane < block.count; lane++)
+      {
+        const PackedFruitInstance& record = records[block.first + lane];
+        component[lane] = presetComponents.values[offset][presetIndex(record.preset)] +
+                          static_cast<f32>(record.profileOffsets[offset]) * PackedFruitInstance::PROFILE_OFFSET_STEP;
+      }
+    }
+    for (const ui32 zeroComponent : {0u, 1u, 4u, 7u, 9u, 10u})
+    {
+      f32* component = instances.profiles.getComponent(zeroComponent / 3, zeroComponent % 3) + block.first;
+      std::fill(component, component + block.count, 0.0f);
+    }
+
+    for (ui32 lane = 0; lane < block.count; lane++)
+    {
+      const size_t               i      = block.first + lane;
+      const PackedFruitInstance& record = records[i];
+      instances.presets[i]              = record.preset;
+      instances.colorIndices[i]         = record.colorIndex;
+      instances.lodBiases[i]            = record.lodBias;
+      instances.flags[i]                = record.flags;
+    }
+  }
+}
+} // namespace gims
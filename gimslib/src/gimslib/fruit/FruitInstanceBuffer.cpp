@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <gimslib/fruit/FruitInstanceBuffer.hpp>
+#include <gimslib/sys/ParallelFor.hpp>
+#include <stdexcept>
+
+namespace
+{
+using namespace gims;
+
+constexpr size_t RECORDS_PER_TASK = 16384;
+
+// Appends the record i to the ranges, extending the last range if it ends at most MAX_MERGED_GAP records before.
+void addChangedRecord(size_t i, std::vector<FruitInstanceRange>& ranges)
+{
+  if (!ranges.empty() && i - (ranges.back().first + ranges.back().count) <= FruitInstanceBufferBuilder::MAX_MERGED_GAP)
+  {
+    ranges.back().count = i + 1 - ranges.back().first;
+    return;
+  }
+  ranges.push_back({i, 1});
+}
+} // namespace
+
+namespace gims
+{
+void buildFruitInstanceRecords(const FruitInstanceArray& instances, const FruitInstanceLOD* lods, size_t first,
+                               size_t last, FruitInstanceRecord* records)
+{
+  const FruitProfileArray& profiles = instances.profiles;
+  for (size_t i = first; i < last; i++)
+  {
+    FruitInstanceRecord& record = records[i];
+    record.rotation =
+        f32v4(instances.rotationX[i], instances.rotationY[i], instances.rotationZ[i], instances.rotationW[i]);
+    record.position = f32v3(instances.positionX[i], instances.positionY[i], instances.positionZ[i]);
+    record.flags    = static_cast<ui32>(instances.flags[i]) | (static_cast<ui32>(instances.colorIndices[i]) << 8) |
+                   (static_cast<ui32>(static_cast<ui8>(instances.lodBiases[i])) << 16);
+    for (ui32 p = 0; p < 4; p++)
+    {
+      record.controlPoints[p] =
+          f32v4(profiles.getComponent(p, 0)[i], profiles.getComponent(p, 1)[i], profiles.getComponent(p, 2)[i], 0.0f);
+    }
+    record.gridSize        = lods[i].gridSize;
+    record.firstTileBounds = lods[i].firstTileBounds;
+    record.morphFactor     = lods[i].morphFactor;
+    record.reserved        = 0;
+  }
+}
+
+const std::vector<FruitInstanceRange>& FruitInstanceBufferBuilder::update(const FruitInstanceArray&           instances,
+                                                                         const std::vector<FruitInstanceLOD>& lods)
+{
+  const size_t numInstances = instances.getSize();
+  if (lods.size() != numInstances)
+  {
+    throw std::invalid_argument(
+        std::format("{} levels of detail were given for {} instances.", lods.size(), numInstances));
+  }
+  const size_t numCompared  = m_valid ? std::min(m_records.size(), numInstances) : 0;
+  m_nextRecords.resize(numInstances);
+
+  // Each task finds the changed ranges of its records; the ranges of consecutive tasks are joined afterwards.
+  const size_t                                 numTasks = (numInstances + RECORDS_PER_TASK - 1) / RECORDS_PER_TASK;
+  std::vector<std::vector<FruitInstanceRange>> taskRanges(numTasks);
+  parallelFor(numTasks,
+              [&](size_t task)
+              {
+                const size_t first = task * RECORDS_PER_TASK;
+                const size_t last  = std::min(first + RECORDS_PER_TASK, numInstances);
+                buildFruitInstanceRecords(instances, lods.data(), first, last, m_nextRecords.data());
+                for (size_t i = first; i < last; i++)
+                {
+                  if (i >= numCompared ||
+                      std::memcmp(&m_nextRecords[i], &m_records[i], sizeof(FruitInstanceRecord)) != 0)
+                  {
+                    addChangedRecord(i, taskRanges[task]);
+                  }
+                }
+              });
+
+  m_changedRanges.clear();
+  for (const std::vector<FruitInstanceRange>& ranges : taskRanges)
+  {
+    for (const FruitInstanceRange& range : ranges)
+    {
+      addChangedRecord(range.first, m_changedRanges);
+      m_changedRanges.back().count = range.first + range.count - m_changedRanges.back().first;
+    }
+  }
+
+  std::swap(m_records, m_nextRecords);
+  m_valid = true;
+  return m_changedRanges;
+}
+
+void FruitInstanceBufferBuilder::invalidate()
+{
+  m_valid = false;
+}
+
+const std::vector<FruitInstanceRecord>& FruitInstanceBufferBuilder::getRecords() const
+{
+  return m_records;
+}
+
+const std::vector<FruitInstanceRange>& FruitInstanceBufferBuilder::getChangedRanges() const
+{
+  return m_changedRanges;
+}
+
+size_t FruitInstanceBufferBuilder::getNumChangedRecords() const
+{
+  size_t result = 0;
+  for (const FruitInstanceRange& range : m_changedRanges)
+  {
+    result += range.count;
+  }
+  return result;
+}
+} // namespace gims
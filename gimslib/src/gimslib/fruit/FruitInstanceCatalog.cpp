@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <fstream>
+#include <gimslib/fruit/FruitInstanceCatalog.hpp>
+#include <gimslib/sys/ParallelFor.hpp>
+#include <stdexcept>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+using namespace gims;
+
+// Number of instances per parallel task.
+constexpr size_t INSTANCES_PER_TASK = 1 << 16;
+} // namespace
+
+namespace gims
+{
+FruitInstanceCatalog::FruitInstanceCatalog(const std::filesystem::path& fileName)
+{
+  const std::string errorMessage = "Error mapping fruit instance catalog " + fileName.string() + ".";
+#ifdef _WIN32
+  const HANDLE file = CreateFileW(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    throw std::runtime_error(errorMessage);
+  }
+  m_file = file;
+  LARGE_INTEGER fileSize;
+  if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+  {
+    m_sizeInBytes = static_cast<size_t>(fileSize.QuadPart);
+    m_mapping     = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    m_data        = m_mapping ? static_cast<const ui8*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+  }
+  if (!m_data)
+  {
+    unmap();
+    throw std::runtime_error(errorMessage);
+  }
+#else
+  const int file = open(fileName.c_str(), O_RDONLY);
+  if (file < 0)
+  {
+    throw std::runtime_error(errorMessage);
+  }
+  struct stat status;
+  void*       data = MAP_FAILED;
+  if (fstat(file, &status) == 0 && status.st_size > 0)
+  {
+    m_sizeInBytes = static_cast<size_t>(status.st_size);
+    data          = mmap(nullptr, m_sizeInBytes, PROT_READ, MAP_SHARED, file, 0);
+  }
+  close(file);
+  if (data == MAP_FAILED)
+  {
+    throw std::runtime_error(errorMessage);
+  }
+  m_data = static_cast<const ui8*>(data);
+#endif
+
+  const FruitInstanceCatalogHeader& header = getHeader();
+  if (m_sizeInBytes < sizeof(FruitInstanceCatalogHeader) || header.magic != FruitInstanceCatalogHeader::MAGIC ||
+      header.version != FruitInstanceCatalogHeader::VERSION ||
+      (m_sizeInBytes - sizeof(FruitInstanceCatalogHeader)) / sizeof(PackedFruitInstance) < header.numInstances)
+  {
+    unmap();
+    throw std::runtime_error("Invalid fruit instance catalog " + fileName.string() + ".");
+  }
+}
+
+FruitInstanceCatalog::~FruitInstanceCatalog()
+{
+  unmap();
+}
+
+void FruitInstanceCatalog::unmap()
+{
+#ifdef _WIN32
+  if (m_data)
+  {
+    UnmapViewOfFile(m_data);
+  }
+  if (m_mapping)
+  {
+    CloseHandle(m_mapping);
+  }
+  if (m_file)
+  {
+    CloseHandle(m_file);
+  }
+#else
+  if (m_data)
+  {
+    munmap(const_cast<ui8*>(m_data), m_sizeInBytes);
+  }
+#endif
+  m_data    = nullptr;
+  m_mapping = nullptr;
+  m_file    = nullptr;
+}
+
+const FruitInstanceCatalogHeader& FruitInstanceCatalog::getHeader() const
+{
+  return *reinterpret_cast<const FruitInstanceCatalogHeader*>(m_data);
+}
+
+size_t FruitInstanceCatalog::getNumInstances() const
+{
+  return static_cast<size_t>(getHeader().numInstances);
+}
+
+const PackedFruitInstance* FruitInstanceCatalog::getInstances() const
+{
+  return reinterpret_cast<const PackedFruitInstance*>(m_data + sizeof(FruitInstanceCatalogHeader));
+}
+
+void FruitInstanceCatalog::unpack(size_t first, size_t last, FruitInstanceArray& instances) const
+{
+  const FruitInstanceCatalogHeader& header = getHeader();
+  unpackFruitInstances(getInstances(), header.positionMin, header.positionMax, first, last, instances);
+}
+
+void FruitInstanceCatalog::save(const std::filesystem::path& fileName, const FruitInstanceArray& instances,
+                                const std::vector<f32v3>& colors)
+{
+  if (colors.size() > FruitInstanceCatalogHeader::NUM_COLORS)
+  {
+    throw std::invalid_argument("A fruit instance catalog holds at most 256 colors.");
+  }
+
+  FruitInstanceCatalogHeader header;
+  header.numInstances = instances.getSize();
+  std::copy(colors.begin(), colors.end(), header.colors);
+  if (!instances.positionX.empty())
+  {
+    const auto [minX, maxX] = std::minmax_element(instances.positionX.begin(), instances.positionX.end());
+    const auto [minY, maxY] = std::minmax_element(instances.positionY.begin(), instances.positionY.end());
+    const auto [minZ, maxZ] = std::minmax_element(instances.positionZ.begin(), instances.positionZ.end());
+    header.positionMin      = f32v3(*minX, *minY, *minZ);
+    header.positionMax      = f32v3(*maxX, *maxY, *maxZ);
+  }
+
+  std::vector<PackedFruitInstance> records(instances.getSize());
+  parallelFor((records.size() + INSTANCES_PER_TASK - 1) / INSTANCES_PER_TASK,
+              [&](size_t task)
+              {
+                const size_t first = task * INSTANCES_PER_TASK;
+                const size_t last  = std::min(first + INSTANCES_PER_TASK, records.size());
+                packFruitInstances(instances, header.positionMin, header.positionMax, first, last, records.data());
+              });
+
+  std::ofstream outFile(fileName, std::ios::out | std::ios::binary);
+  if (!outFile.is_open())
+  {
+    throw std::runtime_error("Error opening file " + fileName.string() + ".");
+  }
+  outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  outFile.write(reinterpret_cast<const char*>(records.data()),
+                static_cast<std::streamsize>(records.size() * sizeof(PackedFruitInstance)));
+  if (!outFile)
+  {
+    throw std::runtime_error("Error writing file " + fileName.string() + ".");
+  }
+}
+} // namespace gims
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cmath>
+#include <gimslib/fruit/FruitLODSelector.hpp>
+#include <gimslib/fruit/FruitTiling.hpp>
+#include <gimslib/sys/LaneBlocks.hpp>
+#include <gimslib/sys/ParallelFor.hpp>
+#include <stdexcept>
+
+namespace
+{
+using namespace gims;
+
+constexpr size_t SPHERES_PER_TASK = 16384;
+
+// Returns the level (n - 1) / 2 of a sphere at view space depth. All terms are evaluated and combined with & and
+// selects instead of && and branches, so the lane loop it is inlined into vectorizes.
+f32 selectLevel(f32 depth, f32 radius, f32 lodBias, f32 previousGridSize, f32 projectionScale, f32 nearPlane,
+                f32 pixelError, f32 hysteresis, f32 maxLevel)
+{
+  // (n - 1)^2 = 4 level^2 at which the projected error equals the target, 0 for spheres behind the camera.
+  const bool visible  = depth + radius >= 0.0f;
+  const f32  distance = std::max(depth - radius, nearPlane);
+  const f32  error    = FruitLODSelector::ERROR_CONSTANT * radius * projectionScale / (distance * pixelError);
+  const f32  required = visible ? error : 0.0f;
+  const f32  level    = std::max(std::ceil(0.5f * std::sqrt(required)), 1.0f);
+
+  const f32  previous  = 0.5f * (previousGridSize - 1.0f) - lodBias;
+  const f32  band      = 1.0f + hysteresis;
+  const bool tooCoarse = required > band * 4.0f * previous * previous;
+  const bool tooFine   = (previous > 1.0f) & (required * band <= 4.0f * (previous - 1.0f) * (previous - 1.0f));
+  const bool keep      = visible & (previousGridSize >= 3.0f) & (previous >= 1.0f) & !tooCoarse & !tooFine;
+
+  const f32 selected = keep ? previous : level;
+  return std::min(std::max(selected + lodBias, 1.0f), maxLevel);
+}
+} // namespace
+
+namespace gims
+{
+size_t FruitBoundingSphereArray::getSize() const
+{
+  return radius.size();
+}
+
+void FruitBoundingSphereArray::resize(size_t numSpheres)
+{
+  centerX.resize(numSpheres);
+  centerY.resize(numSpheres);
+  centerZ.resize(numSpheres);
+  radius.resize(numSpheres);
+}
+
+void computeFruitBoundingSpheres(const FruitInstanceArray& instances, const FruitMeasureArray& measures, size_t first,
+                                 size_t last, FruitBoundingSphereArray& spheres)
+{
+  for (size_t i = first; i < last; i++)
+  {
+    // The local center (0, 0, z) rotated by the quaternion (u, w) is z (2 (w uy + ux uz), 2 (uy uz - w ux),
+    // 1 - 2 (ux^2 + uy^2)).
+    const f32 halfHeight = 0.5f * (measures.maxZ[i] - measures.minZ[i]);
+    const f32 z          = 0.5f * (measures.minZ[i] + measures.maxZ[i]);
+    const f32 ux         = instances.rotationX[i];
+    const f32 uy         = instances.rotationY[i];
+    const f32 uz         = instances.rotationZ[i];
+    const f32 w          = instances.rotationW[i];
+    spheres.centerX[i]   = instances.positionX[i] + 2.0f * z * (w * uy + ux * uz);
+    spheres.centerY[i]   = instances.positionY[i] + 2.0f * z * (uy * uz - w * ux);
+    spheres.centerZ[i]   = instances.positionZ[i] + z * (1.0f - 2.0f * (ux * ux + uy * uy));
+    spheres.radius[i]    = std::sqrt(measures.radius[i] * measures.radius[i] + halfHeight * halfHeight);
+  }
+}
+
+FruitLODSelector::FruitLODSelector(const f32m4& viewMatrix, const f32m4& projectionMatrix, const f32v2& viewportSize,
+                                   f32 pixelError, f32 hysteresis, ui32 maxGridSize)
+{
+  if (!(pixelError > 0.0f) || !(hysteresis >= 0.0f) || maxGridSize < 3)
+  {
+    throw std::invalid_argument(
+        "The pixel error must be positive, the hysteresis must not be negative and the finest grid must be 3 or more.");
+  }
+  // glm matrices are column major, m[column][row].
+  m_depthRow        = f32v4(viewMatrix[0][2], viewMatrix[1][2], viewMatrix[2][2], viewMatrix[3][2]);
+  m_projectionScale = 0.5f * std::max(projectionMatrix[0][0] * viewportSize.x, projectionMatrix[1][1] * viewportSize.y);
+  // z_clip = m22 z + m32 is 0 at the near plane.
+  m_nearPlane  = std::max(-projectionMatrix[3][2] / projectionMatrix[2][2], 1e-6f);
+  m_pixelError = pixelError;
+  m_hysteresis = hysteresis;
+  m_maxLevel   = (std::min(maxGridSize, FruitTiling::MAX_GRID_SIZE) - 1) / 2;
+}
+
+ui32 FruitLODSelector::select(const f32v3& center, f32 radius, i8 lodBias, ui32 previousGridSize) const
+{
+  const f32 depth = m_depthRow.x * center.x + m_depthRow.y * center.y + m_depthRow.z * center.z + m_depthRow.w;
+  const f32 level =
+      selectLevel(depth, radius, static_cast<f32>(lodBias), static_cast<f32>(previousGridSize), m_projectionScale,
+                  m_nearPlane, m_pixelError, m_hysteresis, static_cast<f32>(m_maxLevel));
+  return static_cast<ui32>(2 * static_cast<i32>(level) + 1);
+}
+
+void FruitLODSelector::select(const FruitBoundingSphereArray& spheres, const i8* lodBiases, size_t first, size_t last,
+                              ui32* gridSizes) const
+{
+  const f32 maxLevel = static_cast<f32>(m_maxLevel);
+  for (const LaneBlock block : getLaneBlocks(first, last))
+  {
+    f32 depths[LANES], radii[LANES], biases[LANES], previous[LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      const size_t i = block.getElement(lane);
+      depths[lane]   = m_depthRow.x * spheres.centerX[i] + m_depthRow.y * spheres.centerY[i] +
+                     m_depthRow.z * spheres.centerZ[i] + m_depthRow.w;
+      radii[lane]    = spheres.radius[i];
+      biases[lane]   = lodBiases ? static_cast<f32>(lodBiases[i]) : 0.0f;
+      previous[lane] = static_cast<f32>(static_cast<i32>(gridSizes[i]));
+    }
+
+    ui32 selected[LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      const f32 level = selectLevel(depths[lane], radii[lane], biases[lane], previous[lane], m_projectionScale,
+                                    m_nearPlane, m_pixelError, m_hysteresis, maxLevel);
+      selected[lane]  = static_cast<ui32>(2 * static_cast<i32>(level) + 1);
+    }
+
+    for (ui32 lane = 0; lane < block.count; lane++)
+    {
+      gridSizes[block.first + lane] = selected[lane];
+    }
+  }
+}
+
+void FruitLODSelector::select(const FruitBoundingSphereArray& spheres, const i8* lodBiases,
+                              std::vector<ui32>& gridSizes) const
+{
+  const size_t numSpheres = spheres.getSize();
+  gridSizes.resize(numSpheres, 0);
+  parallelFor((numSpheres + SPHERES_PER_TASK - 1) / SPHERES_PER_TASK,
+              [&](size_t task)
+              {
+                const size_t first = task * SPHERES_PER_TASK;
+                select(spheres, lodBiases, first, std::min(first + SPHERES_PER_TASK, numSpheres), gridSizes.data());
+              });
+}
+
+f32 FruitLODSelector::getContinuousLevel(const f32v3& center, f32 radius) const
+{
+  const f32 depth = m_depthRow.x * center.x + m_depthRow.y * center.y + m_depthRow.z * center.z + m_depthRow.w;
+  if (depth + radius < 0.0f)
+  {
+    return 0.0f;
+  }
+  const f32 distance = std::max(depth - radius, m_nearPlane);
+  return 0.5f * std::sqrt(ERROR_CONSTANT * radius * m_projectionScale / (distance * m_pixelError));
+}
+
+void FruitLODSelector::selectMorphLevels(const FruitBoundingSphereArray& spheres, const i8* lodBiases,
+                                         std::vector<FruitMorphLevel>& levels) const
+{
+  const size_t numSpheres  = spheres.getSize();
+  const ui32   maxGridSize = 2 * m_maxLevel + 1;
+  levels.resize(numSpheres);
+  parallelFor((numSpheres + SPHERES_PER_TASK - 1) / SPHERES_PER_TASK,
+              [&](size_t task)
+              {
+                const size_t first = task * SPHERES_PER_TASK;
+                for (size_t i = first; i < std::min(first + SPHERES_PER_TASK, numSpheres); i++)
+                {
+                  const f32v3 center(spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i]);
+                  const f32   bias  = lodBiases ? static_cast<f32>(lodBiases[i]) : 0.0f;
+                  const f32   level = getContinuousLevel(center, spheres.radius[i]) + bias;
+                  levels[i]         = selectFruitMorphLevel(level, maxGridSize);
+                }
+              });
+}
+
+f32 FruitLODSelector::getProjectionScale() const
+{
+  return m_projectionScale;
+}
+
+f32 FruitLODSelector::getNearPlane() const
+{
+  return m_nearPlane;
+}
+} // namespace gims
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cmath>
+#include <gimslib/fruit/FruitMeasures.hpp>
+#include <gimslib/sys/LaneBlocks.hpp>
+
+namespace
+{
+using namespace gims;
+
+constexpr ui32 NUM_NODES = 16;
+
+// Gauss-Legendre nodes and weights, mapped to [0;1].
+constexpr f32 NODES[NUM_NODES] = {0.0052995325f, 0.0277124885f, 0.0671843988f, 0.122297796f,
+                                  0.191061878f,  0.270991611f,  0.359198225f,  0.452493745f,
+                                  0.547506255f,  0.640801775f,  0.729008389f,  0.808938122f,
+                                  0.877702204f,  0.932815601f,  0.972287512f,  0.994700467f};
+
+constexpr f32 WEIGHTS[NUM_NODES] = {0.0135762297f, 0.031126762f,  0.0475792558f, 0.0623144856f,
+                                    0.0747979944f, 0.0845782597f, 0.0913017075f, 0.0947253052f,
+                                    0.0947253052f, 0.0913017075f, 0.0845782597f, 0.0747979944f,
+                                    0.0623144856f, 0.0475792558f, 0.031126762f,  0.0135762297f};
+
+// Power basis coefficients c[component][power][lane] of a block of fruits.
+typedef f32 BlockCoefficients[3][4][LANES];
+
+void loadBlock(const FruitProfileArray& profiles, const LaneBlock& block, BlockCoefficients& c)
+{
+  for (ui32 component = 0; component < 3; component++)
+  {
+    const f32* p0 = profiles.getComponent(0, component);
+    const f32* p1 = profiles.getComponent(1, component);
+    const f32* p2 = profiles.getComponent(2, component);
+    const f32* p3 = profiles.getComponent(3, component);
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      const size_t i        = block.getElement(lane);
+      c[component][0][lane] = p0[i];
+      c[component][1][lane] = 3.0f * (p1[i] - p0[i]);
+      c[component][2][lane] = 3.0f * p0[i] - 6.0f * p1[i] + 3.0f * p2[i];
+      c[component][3][lane] = -p0[i] + 3.0f * p1[i] - 3.0f * p2[i] + p3[i];
+    }
+  }
+}
+
+f32 evaluate(const BlockCoefficients& c, ui32 component, ui32 lane, f32 t)
+{
+  return ((c[component][3][lane] * t + c[component][2][lane]) * t + c[component][1][lane]) * t +
+         c[component][0][lane];
+}
+
+f32 evaluateDerivative(const BlockCoefficients& c, ui32 component, ui32 lane, f32 t)
+{
+  return (3.0f * c[component][3][lane] * t + 2.0f * c[component][2][lane]) * t + c[component][1][lane];
+}
+
+// Returns two parameters in [0;1] that contain the roots of the derivative a t^2 + b t + c inside [0;1], if any.
+// Spurious parameters are harmless: they are points on the curve and cannot enlarge the bounding box.
+void derivativeRoots(f32 a, f32 b, f32 c, f32& r0, f32& r1)
+{
+  const f32 root = std::sqrt(std::max(b * b - 4.0f * a * c, 0.0f));
+  const f32 q    = -0.5f * (b + (b >= 0.0f ? root : -root));
+  r0             = std::clamp(q / (a != 0.0f ? a : 1.0f), 0.0f, 1.0f);
+  r1             = std::clamp(c / (q != 0.0f ? q : 1.0f), 0.0f, 1.0f);
+}
+} // namespace
+
+namespace gims
+{
+void FruitMeasureArray::resize(size_t numFruits)
+{
+  area.resize(numFruits);
+  volume.resize(numFruits);
+  radius.resize(numFruits);
+  minZ.resize(numFruits);
+  maxZ.resize(numFruits);
+}
+
+FruitMeasures computeFruitMeasures(const FruitProfile& profile)
+{
+  FruitProfileArray profiles;
+  profiles.addProfile(profile);
+  FruitMeasureArray measures;
+  computeFruitMeasures(profiles, measures);
+
+  FruitMeasures result;
+  result.area    = measures.area[0];
+  result.volume  = measures.volume[0];
+  result.aabbMin = f32v3(-measures.radius[0], -measures.radius[0], measures.minZ[0]);
+  result.aabbMax = f32v3(measures.radius[0], measures.radius[0], measures.maxZ[0]);
+  return result;
+}
+
+void computeFruitMeasures(const FruitProfileArray& profiles, FruitMeasureArray& measures)
+{
+  measures.resize(profiles.getSize());
+  computeFruitMeasures(profiles, 0, profiles.getSize(), measures);
+}
+
+void computeFruitMeasures(const FruitProfileArray& profiles, size_t first, size_t last, FruitMeasureArray& measures)
+{
+  for (const LaneBlock block : getLaneBlocks(first, last))
+  {
+    BlockCoefficients c;
+    loadBlock(profiles, block, c);
+
+    // Area: 2 pi int r sqrt(r'^2 + z'^2) dt with r = sqrt(x^2 + y^2), rewritten without divisions.
+    // Volume: pi int r^2 z' dt.
+    f32 area[LANES]   = {};
+    f32 volume[LANES] = {};
+    for (ui32 node = 0; node < NUM_NODES; node++)
+    {
+      const f32 t = NODES[node];
+      for (ui32 lane = 0; lane < LANES; lane++)
+      {
+        const f32 x  = evaluate(c, 0, lane, t);
+        const f32 y  = evaluate(c, 1, lane, t);
+        const f32 dx = evaluateDerivative(c, 0, lane, t);
+        const f32 dy = evaluateDerivative(c, 1, lane, t);
+        const f32 dz = evaluateDerivative(c, 2, lane, t);
+
+        const f32 radiusSquared         = x * x + y * y;
+        const f32 radiusTimesDerivative = x * dx + y * dy;
+        area[lane] += WEIGHTS[node] *
+                      std::sqrt(radiusTimesDerivative * radiusTimesDerivative + radiusSquared * dz * dz);
+        volume[lane] += WEIGHTS[node] * radiusSquared * dz;
+      }
+    }
+
+    f32 maxAbsolute[2][LANES];
+    f32 minZ[LANES];
+    f32 maxZ[LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      for (ui32 component = 0; component < 3; component++)
+      {
+        f32 r0, r1;
+        derivativeRoots(3.0f * c[component][3][lane], 2.0f * c[component][2][lane], c[component][1][lane], r0, r1);
+        const f32 v0       = c[component][0][lane];
+        const f32 v1       = evaluate(c, component, lane, 1.0f);
+        const f32 v2       = evaluate(c, component, lane, r0);
+        const f32 v3       = evaluate(c, component, lane, r1);
+        const f32 minValue = std::min(std::min(v0, v1), std::min(v2, v3));
+        const f32 maxValue = std::max(std::max(v0, v1), std::max(v2, v3));
+        if (component < 2)
+        {
+          maxAbsolute[component][lane] = std::max(-minValue, maxValue);
+        }
+        else
+        {
+          minZ[lane] = minValue;
+          maxZ[lane] = maxValue;
+        }
+      }
+    }
+
+    for (ui32 lane = 0; lane < block.count; lane++)
+    {
+      const size_t i     = block.first + lane;
+      measures.area[i]   = 2.0f * glm::pi<f32>() * area[lane];
+      measures.volume[i] = glm::pi<f32>() * std::abs(volume[lane]);
+      measures.radius[i] =
+          std::sqrt(maxAbsolute[0][lane] * maxAbsolute[0][lane] + maxAbsolute[1][lane] * maxAbsolute[1][lane]);
+      measures.minZ[i] = minZ[lane];
+      measures.maxZ[i] = maxZ[lane];
+    }
+  }
+}
+} // namespace gims
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <gimslib/fruit/FruitMeshCache.hpp>
+#include <vector>
+
+namespace gims
+{
+namespace
+{
+i64 getTimestamp()
+{
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+} // namespace
+
+size_t FruitMeshKeyHash::operator()(const FruitMeshKey& key) const
+{
+  // FNV-1a over the quantized control points and the grid size.
+  ui64       hash  = 14695981039346656037ull;
+  const auto mix32 = [&hash](ui32 value)
+  {
+    for (ui32 i = 0; i < 4; i++)
+    {
+      hash ^= (value >> (8 * i)) & 0xFF;
+      hash *= 1099511628211ull;
+    }
+  };
+  for (const i32 value : key.quantizedControlPoints)
+  {
+    mix32(static_cast<ui32>(value));
+  }
+  mix32(key.intraLOD);
+  return static_cast<size_t>(hash);
+}
+
+FruitMeshCache::FruitMeshCache(size_t byteBudget)
+    : m_byteBudget(byteBudget)
+    , m_entries(std::make_shared<const EntryMap>())
+    , m_sizeInBytes(0)
+    , m_numHits(0)
+    , m_numMisses(0)
+{
+}
+
+std::shared_ptr<const FruitMesh> FruitMeshCache::getOrTessellate(const FruitProfile& profile, ui32 intraLOD)
+{
+  const FruitMeshKey key = makeKey(profile, intraLOD);
+  if (auto mesh = find(key))
+  {
+    return mesh;
+  }
+
+  m_numMisses.fetch_add(1, std::memory_order_relaxed);
+  auto entry         = std::make_shared<Entry>();
+  entry->mesh        = std::make_shared<const FruitMesh>(tessellateFruit(getProfile(key), intraLOD));
+  entry->sizeInBytes = getSizeInBytes(*entry->mesh);
+  entry->lastAccess.store(getTimestamp(), std::memory_order_relaxed);
+  if (entry->sizeInBytes > m_byteBudget)
+  {
+    return entry->mesh;
+  }
+
+  std::lock_guard<std::mutex> lock(m_writeMutex);
+  const auto                  current = m_entries.load(std::memory_order_acquire);
+  // Another thread may have tessellated the same fruit in the meantime.
+  const auto existing = current->find(key);
+  if (existing != current->end())
+  {
+    return existing->second->mesh;
+  }
+
+  auto   next        = std::make_shared<EntryMap>(*current);
+  size_t sizeInBytes = m_sizeInBytes.load(std::memory_order_relaxed) + entry->sizeInBytes;
+  if (sizeInBytes > m_byteBudget)
+  {
+    std::vector<std::pair<i64, FruitMeshKey>> byAge;
+    byAge.reserve(next->size());
+    for (const auto& [cachedKey, cachedEntry] : *next)
+    {
+      byAge.emplace_back(cachedEntry->lastAccess.load(std::memory_order_relaxed), cachedKey);
+    }
+    std::sort(byAge.begin(), byAge.end(),
+              [](const auto& a, const auto& b)
+              {
+                return a.first < b.first;
+              });
+    for (const auto& aged : byAge)
+    {
+      if (sizeInBytes <= m_byteBudget)
+      {
+        break;
+      }
+      const auto evicted = next->find(aged.second);
+      sizeInBytes -= evicted->second->sizeInBytes;
+      next->erase(evicted);
+    }
+  }
+  next->emplace(key, entry);
+  m_sizeInBytes.store(sizeInBytes, std::memory_order_relaxed);
+  m_entries.store(std::move(next), std::memory_order_release);
+  return entry->mesh;
+}
+
+std::shared_ptr<const FruitMesh> FruitMeshCache::find(const FruitMeshKey& key)
+{
+  const auto entries = m_entries.load(std::memory_order_acquire);
+  const auto it      = entries->find(key);
+  if (it == entries->end())
+  {
+    return nullptr;
+  }
+  it->second->lastAccess.store(getTimestamp(), std::memory_order_relaxed);
+  m_numHits.fetch_add(1, std::memory_order_relaxed);
+  return it->second->mesh;
+}
+
+void FruitMeshCache::clear()
+{
+  std::lock_guard<std::mutex> lock(m_writeMutex);
+  m_entries.store(std::make_shared<const EntryMap>(), std::memory_order_release);
+  m_sizeInBytes.store(0, std::memory_order_relaxed);
+}
+
+size_t FruitMeshCache::getByteBudget() const
+{
+  return m_byteBudget;
+}
+
+size_t FruitMeshCache::getSizeInBytes() const
+{
+  return m_sizeInBytes.load(std::memory_order_relaxed);
+}
+
+size_t FruitMeshCache::getNumEntries() const
+{
+  return m_entries.load(std::memory_order_acquire)->size();
+}
+
+ui64 FruitMeshCache::getNumHits() const
+{
+  return m_numHits.load(std::memory_order_relaxed);
+}
+
+ui64 FruitMeshCache::getNumMisses() const
+{
+  return m_numMisses.load(std::memory_order_relaxed);
+}
+
+FruitMeshKey FruitMeshCache::makeKey(const FruitProfile& profile, ui32 intraLOD)
+{
+  FruitMeshKey       key;
+  const f32v3* const controlPoints[4] = {&profile.p0, &profile.p1, &profile.p2, &profile.p3};
+  for (ui32 i = 0; i < 4; i++)
+  {
+    for (ui32 c = 0; c < 3; c++)
+    {
+      key.quantizedControlPoints[3 * i + c] =
+          static_cast<i32>(std::lround((*controlPoints[i])[c] / QUANTIZATION_STEP));
+    }
+  }
+  key.intraLOD = intraLOD;
+  return key;
+}
+
+FruitProfile FruitMeshCache::getProfile(const FruitMeshKey& key)
+{
+  FruitProfile profile;
+  f32v3* const controlPoints[4] = {&profile.p0, &profile.p1, &profile.p2, &profile.p3};
+  for (ui32 i = 0; i < 4; i++)
+  {
+    for (ui32 c = 0; c < 3; c++)
+    {
+      (*controlPoints[i])[c] = static_cast<f32>(key.quantizedControlPoints[3 * i + c]) * QUANTIZATION_STEP;
+    }
+  }
+  return profile;
+}
+
+size_t FruitMeshCache::getSizeInBytes(const FruitMesh& mesh)
+{
+  return mesh.positions.size() * sizeof(f32v3) + mesh.indices.size() * sizeof(ui32v3);
+}
+
+FruitMeshCache& FruitMeshCache::getDefault()
+{
+  static FruitMeshCache cache(64 * 1024 * 1024);
+  return cache;
+}
+} // namespace gims
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <gimslib/fruit/FruitMorphAnimation.hpp>
+#include <gimslib/sys/LaneBlocks.hpp>
+#include <gimslib/sys/ParallelFor.hpp>
+#include <stdexcept>
+
+namespace
+{
+using namespace gims;
+
+constexpr size_t INSTANCES_PER_TASK = 16384;
+} // namespace
+
+namespace gims
+{
+ui32 FruitMorphAnimation::addTrack(const std::vector<FruitKeyframe>& keyframes)
+{
+  if (keyframes.empty())
+  {
+    throw std::invalid_argument("A fruit animation track needs at least one keyframe.");
+  }
+  for (size_t i = 1; i < keyframes.size(); i++)
+  {
+    if (!(keyframes[i - 1].time < keyframes[i].time))
+    {
+      throw std::invalid_argument("The keyframe times of a fruit animation track must be ascending.");
+    }
+  }
+
+  m_trackOffsets.push_back(static_cast<ui32>(m_keyframeTimes.size()));
+  m_trackSizes.push_back(static_cast<ui32>(keyframes.size()));
+  for (const FruitKeyframe& keyframe : keyframes)
+  {
+    m_keyframeTimes.push_back(keyframe.time);
+    const f32v3* const controlPoints[4] = {&keyframe.profile.p0, &keyframe.profile.p1, &keyframe.profile.p2,
+                                           &keyframe.profile.p3};
+    for (ui32 i = 0; i < 4; i++)
+    {
+      for (ui32 c = 0; c < 3; c++)
+      {
+        m_keyframeComponents[3 * i + c].push_back((*controlPoints[i])[c]);
+      }
+    }
+  }
+  return static_cast<ui32>(m_trackOffsets.size() - 1);
+}
+
+ui32 FruitMorphAnimation::getNumTracks() const
+{
+  return static_cast<ui32>(m_trackOffsets.size());
+}
+
+size_t FruitMorphAnimation::addInstance(ui32 track, f32 startTime, f32 rate)
+{
+  m_instanceTracks.push_back(0);
+  m_startTimes.push_back(0.0f);
+  m_rates.push_back(0.0f);
+  m_changed.push_back(0);
+  try
+  {
+    setInstance(m_instanceTracks.size() - 1, track, startTime, rate);
+  }
+  catch (...)
+  {
+    m_instanceTracks.pop_back();
+    m_startTimes.pop_back();
+    m_rates.pop_back();
+    m_changed.pop_back();
+    throw;
+  }
+  return m_instanceTracks.size() - 1;
+}
+
+void FruitMorphAnimation::setInstance(size_t index, ui32 track, f32 startTime, f32 rate)
+{
+  if (track >= getNumTracks())
+  {
+    throw std::out_of_range("The fruit animation track does not exist.");
+  }
+  m_instanceTracks.at(index) = track;
+  m_startTimes[index]        = startTime;
+  m_rates[index]             = rate;
+}
+
+size_t FruitMorphAnimation::getNumInstances() const
+{
+  return m_instanceTracks.size();
+}
+
+void FruitMorphAnimation::evaluate(f32 time, FruitProfileArray& profiles)
+{
+  const size_t numInstances = getNumInstances();
+  const size_t oldSize      = std::min(profiles.getSize(), numInstances);
+  profiles.resize(numInstances);
+  parallelFor((numInstances + INSTANCES_PER_TASK - 1) / INSTANCES_PER_TASK,
+              [&](size_t task)
+              {
+                const size_t first = task * INSTANCES_PER_TASK;
+                evaluate(time, first, std::min(first + INSTANCES_PER_TASK, numInstances), profiles);
+              });
+  std::fill(m_changed.begin() + static_cast<ptrdiff_t>(oldSize), m_changed.end(), ui8(1));
+}
+
+void FruitMorphAnimation::evaluate(f32 time, size_t first, size_t last, FruitProfileArray& profiles)
+{
+  f32* components[FruitProfileArray::NUM_COMPONENTS];
+  for (ui32 c = 0; c < FruitProfileArray::NUM_COMPONENTS; c++)
+  {
+    components[c] = profiles.getComponent(c / 3, c % 3);
+  }
+
+  for (const LaneBlock block : getLaneBlocks(first, last))
+  {
+    // Find the keyframes around the local time of each lane. Tracks are short, hence a linear search.
+    ui32 keyframes[LANES];
+    f32  weights[LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      const size_t i         = block.getElement(lane);
+      const ui32   offset    = m_trackOffsets[m_instanceTracks[i]];
+      const ui32   size      = m_trackSizes[m_instanceTracks[i]];
+      const f32    localTime = (time - m_startTimes[i]) * m_rates[i];
+      ui32         k         = offset;
+      while (k + 2 < offset + size && m_keyframeTimes[k + 1] <= localTime)
+      {
+        k++;
+      }
+      const ui32 next = std::min(k + 1, offset + size - 1);
+      const f32  span = m_keyframeTimes[next] - m_keyframeTimes[k];
+      keyframes[lane] = k;
+      weights[lane]   = span > 0.0f ? std::clamp((localTime - m_keyframeTimes[k]) / span, 0.0f, 1.0f) : 0.0f;
+    }
+
+    bool changed[LANES] = {};
+    for (ui32 c = 0; c < FruitProfileArray::NUM_COMPONENTS; c++)
+    {
+      const f32* keyframeComponents = m_keyframeComponents[c].data();
+      f32        values[LANES];
+      for (ui32 lane = 0; lane < LANES; lane++)
+      {
+        // The weight is 0 for tracks with a single keyframe, so the next keyframe is only read if it exists.
+        const f32 from = keyframeComponents[keyframes[lane]];
+        const f32 to   = weights[lane] > 0.0f ? keyframeComponents[keyframes[lane] + 1] : from;
+        values[lane]   = from + weights[lane] * (to - from);
+      }
+      f32* destination = components[c] + block.first;
+      for (ui32 lane = 0; lane < block.count; lane++)
+      {
+        changed[lane]     = changed[lane] || destination[lane] != values[lane];
+        destination[lane] = values[lane];
+      }
+    }
+
+    for (ui32 lane = 0; lane < block.count; lane++)
+    {
+      m_changed[block.first + lane] = changed[lane] ? 1 : 0;
+    }
+  }
+}
+
+const std::vector<ui8>& FruitMorphAnimation::getChangedFlags() const
+{
+  return m_changed;
+}
+
+void FruitMorphAnimation::getChangedInstances(std::vector<size_t>& indices) const
+{
+  indices.clear();
+  for (size_t i = 0; i < m_changed.size(); i++)
+  {
+    if (m_changed[i])
+    {
+      indices.push_back(i);
+    }
+  }
+}
+} // namespace gims
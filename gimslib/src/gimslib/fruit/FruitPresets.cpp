@@ -0,0 +1,35 @@
+#include <array>
+#include <gimslib/fruit/FruitPresets.hpp>
+
+namespace
+{
+using namespace gims;
+
+// Keep in sync with the P0..P3 and TEXTURE_COLOR constants of the renderers' shaders.
+const std::array<FruitPreset, static_cast<size_t>(FruitType::Count)> PRESETS = {{
+    {"Apple",
+     {f32v3(0.000f, 0.000f, -0.059f), f32v3(1.000f, 0.000f, -0.529f), f32v3(0.833f, 0.000f, 1.118f),
+      f32v3(0.000f, 0.000f, 1.000f)},
+     f32v3(0.545f, 0.008f, 0.008f)},
+    {"Pear",
+     {f32v3(0.000f, 0.000f, -0.882f), f32v3(0.833f, 0.000f, -0.176f), f32v3(0.595f, 0.000f, 0.647f),
+      f32v3(0.000f, 0.000f, 0.529f)},
+     f32v3(0.788f, 0.8f, 0.247f)},
+    {"Lemon",
+     {f32v3(0.000f, 0.000f, -0.765f), f32v3(0.230f, 0.000f, -0.765f), f32v3(1.071f, 0.000f, 0.176f),
+      f32v3(0.000f, 0.000f, 0.882f)},
+     f32v3(1.0f, 0.957f, 0.31f)},
+    {"Strawberry",
+     {f32v3(0.000f, 0.000f, -0.300f), f32v3(1.000f, 0.000f, -0.700f), f32v3(1.000f, 0.000f, 0.300f),
+      f32v3(0.000f, 0.000f, 1.000f)},
+     f32v3(0.898f, 0.224f, 0.224f)},
+}};
+} // namespace
+
+namespace gims
+{
+const FruitPreset& getFruitPreset(FruitType type)
+{
+  return PRESETS[static_cast<size_t>(type)];
+}
+} // namespace gims
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cmath>
+#include <gimslib/fruit/FruitProfile.hpp>
+
+namespace
+{
+using namespace gims;
+
+f32 signNotZero(f32 scalar)
+{
+  return scalar >= 0.0f ? 1.0f : -1.0f;
+}
+} // namespace
+
+namespace gims
+{
+f32v3 evaluateCubicBezierCurve(const FruitProfile& profile, f32 t)
+{
+  const f32 tQuadrat = t * t;
+  const f32 tCubed   = tQuadrat * t;
+  return profile.p0 + t * (-3.0f * profile.p0 + 3.0f * profile.p1) +
+         tQuadrat * (3.0f * profile.p0 - 6.0f * profile.p1 + 3.0f * profile.p2) +
+         tCubed * (-profile.p0 + 3.0f * profile.p1 - 3.0f * profile.p2 + profile.p3);
+}
+
+f64v3 evaluateCubicBezierCurve(const FruitProfile& profile, f64 t)
+{
+  const f64v3 p0 = f64v3(profile.p0);
+  const f64v3 p1 = f64v3(profile.p1);
+  const f64v3 p2 = f64v3(profile.p2);
+  const f64v3 p3 = f64v3(profile.p3);
+  const f64   s  = 1.0 - t;
+  return s * s * s * p0 + 3.0 * s * s * t * p1 + 3.0 * s * t * t * p2 + t * t * t * p3;
+}
+
+f32v3 evaluateCubicBezierDerivative(const FruitProfile& profile, f32 t)
+{
+  const f32 s = 1.0f - t;
+  return 3.0f * s * s * (profile.p1 - profile.p0) + 6.0f * s * t * (profile.p2 - profile.p1) +
+         3.0f * t * t * (profile.p3 - profile.p2);
+}
+
+f32v3 octDecode(const f32v2& coordinates)
+{
+  f32v3 octahedronCoordinates =
+      f32v3(coordinates.x, coordinates.y, 1.0f - std::abs(coordinates.x) - std::abs(coordinates.y));
+  if (octahedronCoordinates.z < 0.0f)
+  {
+    const f32v2 folded = f32v2(1.0f - std::abs(octahedronCoordinates.y), 1.0f - std::abs(octahedronCoordinates.x));
+    octahedronCoordinates.x = folded.x * signNotZero(octahedronCoordinates.x);
+    octahedronCoordinates.y = folded.y * signNotZero(octahedronCoordinates.y);
+  }
+  return glm::normalize(octahedronCoordinates);
+}
+
+f32v2 octEncode(const f32v3& direction)
+{
+  const f32v3 octahedronCoordinates =
+      direction / std::max(std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z), 1e-30f);
+  if (octahedronCoordinates.z < 0.0f)
+  {
+    return f32v2((1.0f - std::abs(octahedronCoordinates.y)) * signNotZero(octahedronCoordinates.x),
+                 (1.0f - std::abs(octahedronCoordinates.x)) * signNotZero(octahedronCoordinates.y));
+  }
+  return f32v2(octahedronCoordinates.x, octahedronCoordinates.y);
+}
+
+f32v3 calculateFruitCoordinates(const FruitProfile& profile, const f32v3& sphericalCoordinates)
+{
+  const f32 t      = (sphericalCoordinates.z + 1.0f) / 2.0f;
+  f32v3     result = evaluateCubicBezierCurve(profile, t);
+
+  // At the poles the angle of revolution is undefined. The shaders produce NaNs there, we pick angle zero.
+  f32v2     sinusCosinus = f32v2(0.0f, 1.0f);
+  const f32 radius       = glm::length(f32v2(sphericalCoordinates.y, sphericalCoordinates.x));
+  if (radius > 0.0f)
+  {
+    sinusCosinus.x = std::clamp(sphericalCoordinates.y / radius, -1.0f, 1.0f);
+    sinusCosinus.y = std::sqrt(1.0f - sinusCosinus.x * sinusCosinus.x) * signNotZero(sphericalCoordinates.x);
+  }
+  const f32v2 rotated = f32v2(sinusCosinus.y * result.x - sinusCosinus.x * result.y,
+                              sinusCosinus.x * result.x + sinusCosinus.y * result.y);
+  result.x            = rotated.x;
+  result.y            = rotated.y;
+  return result;
+}
+
+f32v3 calculateFruitNormal(const FruitProfile& profile, const f32v3& sphericalCoordinates)
+{
+  const f32   t          = (sphericalCoordinates.z + 1.0f) / 2.0f;
+  const f32v3 point      = evaluateCubicBezierCurve(profile, t);
+  const f32v3 derivative = evaluateCubicBezierDerivative(profile, t);
+  const f32v3 normal     = glm::cross(f32v3(-point.y, point.x, 0.0f), derivative);
+  const f32   length     = glm::length(normal);
+  // The cross product points inwards if the profile runs from the top to the bottom.
+  const f32 orientation = profile.p3.z < profile.p0.z ? -1.0f : 1.0f;
+  if (length < 1e-12f)
+  {
+    return f32v3(0.0f, 0.0f, t < 0.5f ? -orientation : orientation);
+  }
+  const f32 radius = glm::length(f32v2(sphericalCoordinates.x, sphericalCoordinates.y));
+  const f32 c      = radius > 0.0f ? sphericalCoordinates.x / radius : 1.0f;
+  const f32 s      = radius > 0.0f ? sphericalCoordinates.y / radius : 0.0f;
+  return f32v3(c * normal.x - s * normal.y, s * normal.x + c * normal.y, normal.z) / length * orientation;
+}
+
+ui32 calculateIntraLOD(ui32 n)
+{
+  return n >= 121 ? 11 : n >= 64 ? 9 : n >= 42 ? 7 : n >= 16 ? 5 : 3;
+}
+
+BezierForwardDifferencer::BezierForwardDifferencer(const FruitProfile& profile, f32 t0, f32 dt)
+{
+  const f64v3 p0 = f64v3(profile.p0);
+  const f64v3 p1 = f64v3(profile.p1);
+  const f64v3 p2 = f64v3(profile.p2);
+  const f64v3 p3 = f64v3(profile.p3);
+
+  // Power basis c0 + c1 t + c2 t^2 + c3 t^3.
+  const f64v3 c1 = -3.0 * p0 + 3.0 * p1;
+  const f64v3 c2 = 3.0 * p0 - 6.0 * p1 + 3.0 * p2;
+  const f64v3 c3 = -p0 + 3.0 * p1 - 3.0 * p2 + p3;
+
+  const f64 t  = t0;
+  const f64 h  = dt;
+  const f64 h2 = h * h;
+  const f64 h3 = h2 * h;
+
+  m_value            = f32v3(evaluateCubicBezierCurve(profile, t));
+  m_firstDifference  = f32v3(c1 * h + c2 * (2.0 * t * h + h2) + c3 * (3.0 * t * t * h + 3.0 * t * h2 + h3));
+  m_secondDifference = f32v3(c2 * (2.0 * h2) + c3 * (6.0 * t * h2 + 6.0 * h3));
+  m_thirdDifference  = f32v3(c3 * (6.0 * h3));
+}
+
+const f32v3& BezierForwardDifferencer::getValue() const
+{
+  return m_value;
+}
+
+void BezierForwardDifferencer::step()
+{
+  m_value += m_firstDifference;
+  m_firstDifference += m_secondDifference;
+  m_secondDifference += m_thirdDifference;
+}
+
+ForwardDifferencingError measureForwardDifferencingError(const FruitProfile& profile, ui32 numSamples)
+{
+  ForwardDifferencingError result;
+  if (numSamples < 2)
+  {
+    return result;
+  }
+  result.numSamples = numSamples;
+
+  const f32                dt = 1.0f / static_cast<f32>(numSamples - 1);
+  BezierForwardDifferencer differencer(profile, 0.0f, dt);
+
+  f64 forwardDifferencingSquaredSum = 0.0;
+  f64 directSquaredSum              = 0.0;
+  for (ui32 i = 0; i < numSamples; i++)
+  {
+    const f32   t         = static_cast<f32>(i) * dt;
+    const f64v3 reference = evaluateCubicBezierCurve(profile, static_cast<f64>(t));
+
+    const f64 forwardDifferencingError = glm::length(f64v3(differencer.getValue()) - reference);
+    const f64 directError              = glm::length(f64v3(evaluateCubicBezierCurve(profile, t)) - reference);
+
+    result.forwardDifferencingMaxError =
+        std::max(result.forwardDifferencingMaxError, static_cast<f32>(forwardDifferencingError));
+    result.directMaxError = std::max(result.directMaxError, static_cast<f32>(directError));
+    forwardDifferencingSquaredSum += forwardDifferencingError * forwardDifferencingError;
+    directSquaredSum += directError * directError;
+
+    differencer.step();
+  }
+  result.forwardDifferencingRmsError = static_cast<f32>(std::sqrt(forwardDifferencingSquaredSum / numSamples));
+  result.directRmsError              = static_cast<f32>(std::sqrt(directSquaredSum / numSamples));
+  return result;
+}
+} // namespace gims
@@ -0,0 +1,72 @@
+#include <gimslib/fruit/FruitProfileArray.hpp>
+
+namespace gims
+{
+FruitProfileArray::FruitProfileArray(size_t numProfiles)
+{
+  resize(numProfiles);
+}
+
+size_t FruitProfileArray::getSize() const
+{
+  return m_components[0].size();
+}
+
+void FruitProfileArray::resize(size_t numProfiles)
+{
+  const size_t oldSize = getSize();
+  for (auto& component : m_components)
+  {
+    component.resize(numProfiles);
+  }
+  for (size_t k = oldSize; k < numProfiles; k++)
+  {
+    setProfile(k, FruitProfile());
+  }
+}
+
+void FruitProfileArray::addProfile(const FruitProfile& profile)
+{
+  for (auto& component : m_components)
+  {
+    component.emplace_back(0.0f);
+  }
+  setProfile(getSize() - 1, profile);
+}
+
+void FruitProfileArray::setProfile(size_t index, const FruitProfile& profile)
+{
+  const f32v3* const controlPoints[4] = {&profile.p0, &profile.p1, &profile.p2, &profile.p3};
+  for (ui32 i = 0; i < 4; i++)
+  {
+    for (ui32 c = 0; c < 3; c++)
+    {
+      m_components[3 * i + c][index] = (*controlPoints[i])[c];
+    }
+  }
+}
+
+FruitProfile FruitProfileArray::getProfile(size_t index) const
+{
+  FruitProfile profile;
+  f32v3* const controlPoints[4] = {&profile.p0, &profile.p1, &profile.p2, &profile.p3};
+  for (ui32 i = 0; i < 4; i++)
+  {
+    for (ui32 c = 0; c < 3; c++)
+    {
+      (*controlPoints[i])[c] = m_components[3 * i + c][index];
+    }
+  }
+  return profile;
+}
+
+const f32* FruitProfileArray::getComponent(ui32 i, ui32 c) const
+{
+  return m_components[3 * i + c].data();
+}
+
+f32* FruitProfileArray::getComponent(ui32 i, ui32 c)
+{
+  return m_components[3 * i + c].data();
+}
+} // namespace gims
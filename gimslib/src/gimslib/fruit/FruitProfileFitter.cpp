@@ -0,0 +1,543 @@
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <gimslib/fruit/FruitProfileFitter.hpp>
+#include <gimslib/sys/ParallelFor.hpp>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+using namespace gims;
+
+constexpr ui32 NUM_PROFILE_BINS          = 64;
+constexpr ui32 MAX_PARAMETER_CORRECTIONS = 20000;
+constexpr ui32 NUM_ITERATIONS_PER_SEARCH = 1000;
+constexpr ui32 NUM_CLOSEST_POINT_SAMPLES = 64;
+constexpr ui32 NUM_CURVE_SEGMENTS        = 256;
+constexpr ui32 MAX_GRID_CELLS_PER_SIDE   = 1024;
+
+// The parameter correction has converged once no parameter moves by more than this.
+constexpr f64 PARAMETER_TOLERANCE = 1e-9;
+
+// Vertices closer to the axis than this fraction of the maximum radius count as pole vertices.
+constexpr f64 POLE_RADIUS = 0.02;
+
+// Eigen decomposition of a symmetric 3x3 matrix by cyclic Jacobi rotations. The columns of eigenvectors are the
+// eigenvectors.
+void symmetricEigenDecomposition(f64 a[3][3], f64 eigenvalues[3], f64 eigenvectors[3][3])
+{
+  for (ui32 i = 0; i < 3; i++)
+  {
+    for (ui32 j = 0; j < 3; j++)
+    {
+      eigenvectors[i][j] = i == j ? 1.0 : 0.0;
+    }
+  }
+
+  for (ui32 sweep = 0; sweep < 50; sweep++)
+  {
+    const f64 offDiagonal = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+    if (offDiagonal < 1e-30)
+    {
+      break;
+    }
+    for (ui32 p = 0; p < 2; p++)
+    {
+      for (ui32 q = p + 1; q < 3; q++)
+      {
+        if (a[p][q] == 0.0)
+        {
+          continue;
+        }
+        const f64 theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+        const f64 t     = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+        const f64 c     = 1.0 / std::sqrt(t * t + 1.0);
+        const f64 s     = t * c;
+        for (ui32 k = 0; k < 3; k++)
+        {
+          const f64 akp = a[k][p];
+          const f64 akq = a[k][q];
+          a[k][p]       = c * akp - s * akq;
+          a[k][q]       = s * akp + c * akq;
+        }
+        for (ui32 k = 0; k < 3; k++)
+        {
+          const f64 apk = a[p][k];
+          const f64 aqk = a[q][k];
+          a[p][k]       = c * apk - s * aqk;
+          a[q][k]       = s * apk + c * aqk;
+        }
+        for (ui32 k = 0; k < 3; k++)
+        {
+          const f64 vkp      = eigenvectors[k][p];
+          const f64 vkq      = eigenvectors[k][q];
+          eigenvectors[k][p] = c * vkp - s * vkq;
+          eigenvectors[k][q] = s * vkp + c * vkq;
+        }
+      }
+    }
+  }
+  for (ui32 i = 0; i < 3; i++)
+  {
+    eigenvalues[i] = a[i][i];
+  }
+}
+
+f64v2 evaluate(const f64v2 controlPoints[4], f64 t)
+{
+  const f64 s = 1.0 - t;
+  return s * s * s * controlPoints[0] + 3.0 * s * s * t * controlPoints[1] + 3.0 * s * t * t * controlPoints[2] +
+         t * t * t * controlPoints[3];
+}
+
+f64v2 evaluateDerivative(const f64v2 controlPoints[4], f64 t)
+{
+  const f64 s = 1.0 - t;
+  return 3.0 * s * s * (controlPoints[1] - controlPoints[0]) + 6.0 * s * t * (controlPoints[2] - controlPoints[1]) +
+         3.0 * t * t * (controlPoints[3] - controlPoints[2]);
+}
+
+f64v2 evaluateSecondDerivative(const f64v2 controlPoints[4], f64 t)
+{
+  return 6.0 * (1.0 - t) * (controlPoints[2] - 2.0 * controlPoints[1] + controlPoints[0]) +
+         6.0 * t * (controlPoints[3] - 2.0 * controlPoints[2] + controlPoints[1]);
+}
+
+// Solves for P1 and P2 minimizing sum |B(t_i) - s_i|^2 with fixed P0 and P3.
+void fitInnerControlPoints(const std::vector<f64v2>& samples, const std::vector<f64>& parameters,
+                           f64v2 controlPoints[4])
+{
+  f64   a11 = 0.0, a12 = 0.0, a22 = 0.0;
+  f64v2 rhs1(0.0), rhs2(0.0);
+  for (size_t i = 0; i < samples.size(); i++)
+  {
+    const f64   t  = parameters[i];
+    const f64   s  = 1.0 - t;
+    const f64   b0 = s * s * s;
+    const f64   b1 = 3.0 * s * s * t;
+    const f64   b2 = 3.0 * s * t * t;
+    const f64   b3 = t * t * t;
+    const f64v2 r  = samples[i] - b0 * controlPoints[0] - b3 * controlPoints[3];
+    a11 += b1 * b1;
+    a12 += b1 * b2;
+    a22 += b2 * b2;
+    rhs1 += b1 * r;
+    rhs2 += b2 * r;
+  }
+  const f64 determinant = a11 * a22 - a12 * a12;
+  if (std::abs(determinant) < 1e-12)
+  {
+    return;
+  }
+  controlPoints[1] = (a22 * rhs1 - a12 * rhs2) / determinant;
+  controlPoints[2] = (a11 * rhs2 - a12 * rhs1) / determinant;
+}
+
+// Refines the parameter of the curve point closest to p by Newton steps.
+f64 refineClosestParameter(const f64v2 controlPoints[4], const f64v2& p, f64 bestParameter)
+{
+  for (ui32 i = 0; i < 3; i++)
+  {
+    const f64v2 d           = evaluate(controlPoints, bestParameter) - p;
+    const f64v2 derivative  = evaluateDerivative(controlPoints, bestParameter);
+    const f64   denominator = glm::dot(derivative, derivative) +
+                            glm::dot(d, evaluateSecondDerivative(controlPoints, bestParameter));
+    if (denominator <= 0.0)
+    {
+      break;
+    }
+    bestParameter = std::clamp(bestParameter - glm::dot(d, derivative) / denominator, 0.0, 1.0);
+  }
+  return bestParameter;
+}
+
+// Returns the parameter of the curve point closest to p: a coarse search followed by Newton steps.
+f64 closestParameter(const f64v2 controlPoints[4], const f64v2& p)
+{
+  f64 bestParameter = 0.0;
+  f64 bestDistance  = std::numeric_limits<f64>::max();
+  for (ui32 i = 0; i <= NUM_CLOSEST_POINT_SAMPLES; i++)
+  {
+    const f64 t        = static_cast<f64>(i) / NUM_CLOSEST_POINT_SAMPLES;
+    const f64 distance = glm::length(evaluate(controlPoints, t) - p);
+    if (distance < bestDistance)
+    {
+      bestDistance  = distance;
+      bestParameter = t;
+    }
+  }
+  return refineClosestParameter(controlPoints, p, bestParameter);
+}
+
+f64 distanceToSegment(const f64v2& p, const f64v2& a, const f64v2& b)
+{
+  const f64v2 ab     = b - a;
+  const f64   length = glm::dot(ab, ab);
+  const f64   t      = length > 0.0 ? std::clamp(glm::dot(p - a, ab) / length, 0.0, 1.0) : 0.0;
+  return glm::length(p - (a + t * ab));
+}
+
+// Uniform grid of square cells over the bounding box of 2D segments. Each cell lists the segments whose bounding box
+// overlaps it. A query visits rings of cells around the query point until no closer segment can remain.
+class SegmentGrid
+{
+public:
+  explicit SegmentGrid(std::vector<std::pair<f64v2, f64v2>> segments)
+      : m_segments(std::move(segments))
+      , m_min(std::numeric_limits<f64>::max())
+  {
+    f64v2 max(std::numeric_limits<f64>::lowest());
+    for (const auto& [a, b] : m_segments)
+    {
+      m_min = glm::min(m_min, glm::min(a, b));
+      max   = glm::max(max, glm::max(a, b));
+    }
+    const f64v2 extent        = max - m_min;
+    const ui32  cellsPerSide  = std::clamp(static_cast<ui32>(std::sqrt(static_cast<f64>(m_segments.size()))), 1u,
+                                           MAX_GRID_CELLS_PER_SIDE);
+    m_cellSize                = std::max(std::max(extent.x, extent.y) / cellsPerSide, 1e-30);
+    m_numCells                = glm::clamp(ui32v2(extent / m_cellSize) + 1u, 1u, MAX_GRID_CELLS_PER_SIDE);
+
+    // Two passes: count the segments per cell, then fill them in.
+    m_cellBegins.assign(static_cast<size_t>(m_numCells.x) * m_numCells.y + 1, 0);
+    forEachOverlappedCell(
+        [this](size_t cell, ui32)
+        {
+          m_cellBegins[cell + 1]++;
+        });
+    for (size_t i = 1; i < m_cellBegins.size(); i++)
+    {
+      m_cellBegins[i] += m_cellBegins[i - 1];
+    }
+    m_cellSegments.resize(m_cellBegins.back());
+    std::vector<ui32> fill(m_cellBegins.begin(), m_cellBegins.end() - 1);
+    forEachOverlappedCell(
+        [this, &fill](size_t cell, ui32 segment)
+        {
+          m_cellSegments[fill[cell]++] = segment;
+        });
+  }
+
+  // Returns the distance of p to the closest segment.
+  f64 distance(const f64v2& p) const
+  {
+    const i32v2 center = getCell(p);
+    f64         result = std::numeric_limits<f64>::max();
+    for (i32 ring = 0; ring < static_cast<i32>(std::max(m_numCells.x, m_numCells.y)); ring++)
+    {
+      for (i32 y = center.y - ring; y <= center.y + ring; y++)
+      {
+        // Only the border of the ring, the inside has been visited before.
+        const i32 step = y == center.y - ring || y == center.y + ring ? 1 : std::max(2 * ring, 1);
+        for (i32 x = center.x - ring; x <= center.x + ring; x += step)
+        {
+          if (x < 0 || y < 0 || x >= static_cast<i32>(m_numCells.x) || y >= static_cast<i32>(m_numCells.y))
+          {
+            continue;
+          }
+          const size_t cell = static_cast<size_t>(y) * m_numCells.x + x;
+          for (ui32 i = m_cellBegins[cell]; i < m_cellBegins[cell + 1]; i++)
+          {
+            const auto& [a, b] = m_segments[m_cellSegments[i]];
+            result             = std::min(result, distanceToSegment(p, a, b));
+          }
+        }
+      }
+      // Cells outside the ring are at least ring cells away from p, or from its projection onto the grid.
+      if (result <= ring * m_cellSize)
+      {
+        break;
+      }
+    }
+    return result;
+  }
+
+private:
+  i32v2 getCell(const f64v2& p) const
+  {
+    const f64v2 cell = glm::floor((p - m_min) / m_cellSize);
+    return i32v2(glm::clamp(cell, f64v2(0.0), f64v2(m_numCells) - 1.0));
+  }
+
+  template<class Callback> void forEachOverlappedCell(const Callback& callback) const
+  {
+    for (ui32 segment = 0; segment < m_segments.size(); segment++)
+    {
+      const auto& [a, b] = m_segments[segment];
+      const i32v2 first  = getCell(glm::min(a, b));
+      const i32v2 last   = getCell(glm::max(a, b));
+      for (i32 y = first.y; y <= last.y; y++)
+      {
+        for (i32 x = first.x; x <= last.x; x++)
+        {
+          callback(static_cast<size_t>(y) * m_numCells.x + x, segment);
+        }
+      }
+    }
+  }
+
+  std::vector<std::pair<f64v2, f64v2>> m_segments;
+  f64v2                                m_min;
+  f64                                  m_cellSize;
+  ui32v2                               m_numCells;
+  std::vector<ui32>                    m_cellBegins;
+  std::vector<ui32>                    m_cellSegments;
+};
+} // namespace
+
+namespace gims
+{
+FruitProfileFit fitFruitProfile(const CograBinaryMeshFile& mesh)
+{
+  const ui32 numVertices  = mesh.getNumVertices();
+  const ui32 numTriangles = mesh.getNumTriangles();
+  if (numVertices == 0 || numTriangles == 0)
+  {
+    throw std::invalid_argument("Cannot fit a fruit profile to an empty mesh.");
+  }
+  const f32*  positions = mesh.getPositionsPtr();
+  const ui32* indices   = mesh.getTriangleIndices();
+  if (std::any_of(indices, indices + 3 * static_cast<size_t>(numTriangles),
+                  [numVertices](ui32 index)
+                  {
+                    return index >= numVertices;
+                  }))
+  {
+    throw std::invalid_argument(
+        std::format("Cannot fit a fruit profile to a mesh with triangle indices beyond its {} vertices.", numVertices));
+  }
+  const auto vertex = [positions](ui32 i)
+  {
+    return f64v3(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]);
+  };
+
+  // Area weighted centroid and covariance of the triangle centroids.
+  f64   totalArea = 0.0;
+  f64v3 centroid(0.0);
+  for (ui32 t = 0; t < numTriangles; t++)
+  {
+    const f64v3 a    = vertex(indices[3 * t]);
+    const f64v3 b    = vertex(indices[3 * t + 1]);
+    const f64v3 c    = vertex(indices[3 * t + 2]);
+    const f64   area = 0.5 * glm::length(glm::cross(b - a, c - a));
+    totalArea += area;
+    centroid += area * (a + b + c) / 3.0;
+  }
+  if (totalArea <= 0.0)
+  {
+    throw std::invalid_argument("Cannot fit a fruit profile to a mesh without area.");
+  }
+  centroid /= totalArea;
+
+  f64 covariance[3][3] = {};
+  for (ui32 t = 0; t < numTriangles; t++)
+  {
+    const f64v3 a    = vertex(indices[3 * t]);
+    const f64v3 b    = vertex(indices[3 * t + 1]);
+    const f64v3 c    = vertex(indices[3 * t + 2]);
+    const f64   area = 0.5 * glm::length(glm::cross(b - a, c - a));
+    const f64v3 d    = (a + b + c) / 3.0 - centroid;
+    for (ui32 i = 0; i < 3; i++)
+    {
+      for (ui32 j = 0; j < 3; j++)
+      {
+        covariance[i][j] += area * d[i] * d[j];
+      }
+    }
+  }
+
+  f64 eigenvalues[3];
+  f64 eigenvectors[3][3];
+  symmetricEigenDecomposition(covariance, eigenvalues, eigenvectors);
+
+  // Two variances of a surface of revolution are equal, the axis belongs to the remaining one.
+  ui32 order[3] = {0, 1, 2};
+  std::sort(order, order + 3,
+            [&eigenvalues](ui32 a, ui32 b)
+            {
+              return eigenvalues[a] > eigenvalues[b];
+            });
+  const ui32 axisIndex = eigenvalues[order[0]] - eigenvalues[order[1]] < eigenvalues[order[1]] - eigenvalues[order[2]]
+                             ? order[2]
+                             : order[0];
+  f64v3 axis = f64v3(eigenvectors[0][axisIndex], eigenvectors[1][axisIndex], eigenvectors[2][axisIndex]);
+  axis       = glm::normalize(axis);
+  const f64v3 absoluteAxis = glm::abs(axis);
+  const ui32  dominant     = absoluteAxis.x >= absoluteAxis.y && absoluteAxis.x >= absoluteAxis.z ? 0
+                             : absoluteAxis.y >= absoluteAxis.z                                 ? 1
+                                                                                                : 2;
+  if (axis[dominant] < 0.0)
+  {
+    axis = -axis;
+  }
+
+  // Project into the (radius, height) half-plane.
+  std::vector<f64v2> projected(numVertices);
+  f64                minHeight = std::numeric_limits<f64>::max();
+  f64                maxHeight = std::numeric_limits<f64>::lowest();
+  for (ui32 i = 0; i < numVertices; i++)
+  {
+    const f64v3 d      = vertex(i) - centroid;
+    const f64   height = glm::dot(d, axis);
+    projected[i]       = f64v2(glm::length(d - height * axis), height);
+    minHeight          = std::min(minHeight, height);
+    maxHeight          = std::max(maxHeight, height);
+  }
+
+  // The poles are where the surface meets the axis. They need not be the lowest and highest points, e.g., for the
+  // dimples of an apple. Average the heights of the vertices close to the axis below and above the center.
+  const f64 centerHeight = 0.5 * (minHeight + maxHeight);
+  f64       maxRadius    = 0.0;
+  for (const f64v2& p : projected)
+  {
+    maxRadius = std::max(maxRadius, p.x);
+  }
+  f64v2 poleSums(0.0);
+  f64v2 poleCounts(0.0);
+  for (const f64v2& p : projected)
+  {
+    if (p.x <= POLE_RADIUS * maxRadius)
+    {
+      const ui32 pole = p.y < centerHeight ? 0 : 1;
+      poleSums[pole] += p.y;
+      poleCounts[pole] += 1.0;
+    }
+  }
+  const f64 bottomPole = poleCounts[0] > 0.0 ? poleSums[0] / poleCounts[0] : minHeight;
+  const f64 topPole    = poleCounts[1] > 0.0 ? poleSums[1] / poleCounts[1] : maxHeight;
+
+  // Average the profile in bins of the polar angle around the center, from the bottom to the top pole.
+  f64v2     binSums[NUM_PROFILE_BINS];
+  ui32      binCounts[NUM_PROFILE_BINS] = {};
+  std::fill(binSums, binSums + NUM_PROFILE_BINS, f64v2(0.0));
+  for (const f64v2& p : projected)
+  {
+    const f64  angle = std::atan2(p.x, centerHeight - p.y);
+    const ui32 bin   = std::min(static_cast<ui32>(angle / glm::pi<f64>() * NUM_PROFILE_BINS), NUM_PROFILE_BINS - 1);
+    binSums[bin] += p;
+    binCounts[bin]++;
+  }
+
+  f64v2 controlPoints[4] = {f64v2(0.0, bottomPole), f64v2(0.0), f64v2(0.0), f64v2(0.0, topPole)};
+
+  std::vector<f64v2> samples;
+  samples.push_back(controlPoints[0]);
+  for (ui32 bin = 0; bin < NUM_PROFILE_BINS; bin++)
+  {
+    if (binCounts[bin] > 0)
+    {
+      samples.push_back(binSums[bin] / static_cast<f64>(binCounts[bin]));
+    }
+  }
+  samples.push_back(controlPoints[3]);
+
+  // Chord length parametrization, then alternate between fitting and projecting the samples onto the curve. This
+  // converges slowly but steadily, so most iterations only refine the previous parameters. A global search now and
+  // then lets samples jump to another branch of the curve. Once the parameters stop moving, a global search confirms
+  // that they have converged.
+  std::vector<f64> parameters(samples.size(), 0.0);
+  for (size_t i = 1; i < samples.size(); i++)
+  {
+    parameters[i] = parameters[i - 1] + glm::length(samples[i] - samples[i - 1]);
+  }
+  for (f64& t : parameters)
+  {
+    t /= parameters.back();
+  }
+  bool stalled = false;
+  for (ui32 iteration = 0; iteration < MAX_PARAMETER_CORRECTIONS; iteration++)
+  {
+    fitInnerControlPoints(samples, parameters, controlPoints);
+    const bool search    = stalled || iteration % NUM_ITERATIONS_PER_SEARCH == 0;
+    f64        maxChange = 0.0;
+    for (size_t i = 1; i + 1 < samples.size(); i++)
+    {
+      const f64 t   = search ? closestParameter(controlPoints, samples[i])
+                             : refineClosestParameter(controlPoints, samples[i], parameters[i]);
+      maxChange     = std::max(maxChange, std::abs(t - parameters[i]));
+      parameters[i] = t;
+    }
+    if (maxChange <= PARAMETER_TOLERANCE && search)
+    {
+      break;
+    }
+    stalled = maxChange <= PARAMETER_TOLERANCE;
+  }
+  fitInnerControlPoints(samples, parameters, controlPoints);
+
+  // Errors against a dense polyline of the profile, both ways through segment grids.
+  f64v2                                curve[NUM_CURVE_SEGMENTS + 1];
+  std::vector<std::pair<f64v2, f64v2>> curveSegments;
+  for (ui32 i = 0; i <= NUM_CURVE_SEGMENTS; i++)
+  {
+    curve[i] = evaluate(controlPoints, static_cast<f64>(i) / NUM_CURVE_SEGMENTS);
+    if (i > 0)
+    {
+      curveSegments.emplace_back(curve[i - 1], curve[i]);
+    }
+  }
+  const SegmentGrid curveGrid(std::move(curveSegments));
+  f64               meshToCurve        = 0.0;
+  f64               squaredDistanceSum = 0.0;
+  for (const f64v2& p : projected)
+  {
+    const f64 distance = curveGrid.distance(p);
+    meshToCurve        = std::max(meshToCurve, distance);
+    squaredDistanceSum += distance * distance;
+  }
+  // The edges of the mesh project to segments in the half-plane. Measuring against them instead of the vertices keeps
+  // the vertex spacing out of the error.
+  std::vector<std::pair<f64v2, f64v2>> meshSegments;
+  meshSegments.reserve(3 * static_cast<size_t>(numTriangles));
+  for (ui32 t = 0; t < numTriangles; t++)
+  {
+    for (ui32 e = 0; e < 3; e++)
+    {
+      meshSegments.emplace_back(projected[indices[3 * t + e]], projected[indices[3 * t + (e + 1) % 3]]);
+    }
+  }
+  const SegmentGrid meshGrid(std::move(meshSegments));
+  f64               curveToMesh = 0.0;
+  for (const f64v2& p : curve)
+  {
+    curveToMesh = std::max(curveToMesh, meshGrid.distance(p));
+  }
+
+  FruitProfileFit result;
+  result.profile.p0     = f32v3(static_cast<f32>(controlPoints[0].x), 0.0f, static_cast<f32>(controlPoints[0].y));
+  result.profile.p1     = f32v3(static_cast<f32>(controlPoints[1].x), 0.0f, static_cast<f32>(controlPoints[1].y));
+  result.profile.p2     = f32v3(static_cast<f32>(controlPoints[2].x), 0.0f, static_cast<f32>(controlPoints[2].y));
+  result.profile.p3     = f32v3(static_cast<f32>(controlPoints[3].x), 0.0f, static_cast<f32>(controlPoints[3].y));
+  result.axisOrigin     = f32v3(centroid);
+  result.axisDirection  = f32v3(axis);
+  result.hausdorffError = static_cast<f32>(std::max(meshToCurve, curveToMesh));
+  result.rmsError       = static_cast<f32>(std::sqrt(squaredDistanceSum / numVertices));
+  return result;
+}
+
+std::vector<FruitScanFit> fitFruitProfiles(const std::filesystem::path& directory)
+{
+  std::vector<FruitScanFit> results;
+  for (const auto& entry : std::filesystem::directory_iterator(directory))
+  {
+    if (entry.is_regular_file() && entry.path().extension() == ".cbm")
+    {
+      results.push_back({entry.path(), FruitProfileFit()});
+    }
+  }
+  std::sort(results.begin(), results.end(),
+            [](const FruitScanFit& a, const FruitScanFit& b)
+            {
+              return a.file < b.file;
+            });
+
+  parallelFor(results.size(),
+              [&results](size_t i)
+              {
+                const CograBinaryMeshFile mesh(results[i].file.string());
+                results[i].fit = fitFruitProfile(mesh);
+              });
+  return results;
+}
+} // namespace gims
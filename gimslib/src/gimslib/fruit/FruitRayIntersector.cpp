@@ -0,0 +1,416 @@
+#include <algorithm>
+#include <cmath>
+#include <gimslib/fruit/FruitRayIntersector.hpp>
+#include <gimslib/sys/LaneBlocks.hpp>
+
+namespace
+{
+using namespace gims;
+
+constexpr ui32 NUM_BRACKETS         = 32;
+constexpr ui32 NUM_BISECTION_STEPS  = 12;
+constexpr ui32 NUM_NEWTON_STEPS     = 3;
+constexpr f64  HORIZONTAL_THRESHOLD = 1e-3;
+constexpr f64  RESIDUAL_TOLERANCE   = 1e-4;
+constexpr f64  PARAMETER_TOLERANCE  = 1e-4;
+
+constexpr f32 INFINITE        = std::numeric_limits<f32>::infinity();
+constexpr f64 INFINITE_DOUBLE = std::numeric_limits<f64>::infinity();
+
+template<ui32 N> f64 evaluatePolynomial(const f64 (&c)[N], f64 t)
+{
+  f64 result = c[N - 1];
+  for (ui32 i = N - 1; i > 0; i--)
+  {
+    result = result * t + c[i - 1];
+  }
+  return result;
+}
+
+template<ui32 N> f64 evaluatePolynomialDerivative(const f64 (&c)[N], f64 t)
+{
+  f64 result = static_cast<f64>(N - 1) * c[N - 1];
+  for (ui32 i = N - 1; i > 1; i--)
+  {
+    result = result * t + static_cast<f64>(i - 1) * c[i - 1];
+  }
+  return result;
+}
+
+// Polynomial coefficients of one packet: c[power][lane].
+template<ui32 N> using PacketPolynomial = f64[N][LANES];
+
+template<ui32 N> f64 evaluatePacketPolynomial(const PacketPolynomial<N>& c, ui32 lane, f64 t)
+{
+  f64 result = c[N - 1][lane];
+  for (ui32 i = N - 1; i > 0; i--)
+  {
+    result = result * t + c[i - 1][lane];
+  }
+  return result;
+}
+
+// Solves a s^2 + b s + c = 0 and returns the smallest non-negative root, or infinity.
+f64 smallestNonNegativeRoot(f64 a, f64 b, f64 c)
+{
+  const f64 discriminant = b * b - 4.0 * a * c;
+  if (discriminant < 0.0 || a <= 0.0)
+  {
+    return INFINITE_DOUBLE;
+  }
+  const f64 root = std::sqrt(discriminant);
+  const f64 q    = -0.5 * (b + (b >= 0.0 ? root : -root));
+  const f64 s0   = std::min(q / a, q != 0.0 ? c / q : INFINITE_DOUBLE);
+  const f64 s1   = std::max(q / a, q != 0.0 ? c / q : -INFINITE_DOUBLE);
+  return s0 >= 0.0 ? s0 : s1 >= 0.0 ? s1 : INFINITE_DOUBLE;
+}
+} // namespace
+
+namespace gims
+{
+size_t FruitRayArray::getSize() const
+{
+  return originX.size();
+}
+
+void FruitRayArray::resize(size_t numRays)
+{
+  originX.resize(numRays);
+  originY.resize(numRays);
+  originZ.resize(numRays);
+  directionX.resize(numRays);
+  directionY.resize(numRays);
+  directionZ.resize(numRays);
+  maxDistance.resize(numRays, INFINITE);
+}
+
+void FruitRayArray::setRay(size_t index, const f32v3& origin, const f32v3& direction, f32 maxRayDistance)
+{
+  originX[index]     = origin.x;
+  originY[index]     = origin.y;
+  originZ[index]     = origin.z;
+  directionX[index]  = direction.x;
+  directionY[index]  = direction.y;
+  directionZ[index]  = direction.z;
+  maxDistance[index] = maxRayDistance;
+}
+
+void FruitRayHitArray::resize(size_t numRays)
+{
+  distance.resize(numRays, INFINITE);
+  t.resize(numRays);
+  normalX.resize(numRays);
+  normalY.resize(numRays);
+  normalZ.resize(numRays);
+}
+
+FruitRayIntersector::FruitRayIntersector(const FruitProfile& profile)
+{
+  const f32v3 p[4] = {profile.p0, profile.p1, profile.p2, profile.p3};
+  for (ui32 c = 0; c < 3; c++)
+  {
+    const f64 p0         = p[0][c];
+    const f64 p1         = p[1][c];
+    const f64 p2         = p[2][c];
+    const f64 p3         = p[3][c];
+    m_coefficients[c][0] = p0;
+    m_coefficients[c][1] = 3.0 * (p1 - p0);
+    m_coefficients[c][2] = 3.0 * p0 - 6.0 * p1 + 3.0 * p2;
+    m_coefficients[c][3] = -p0 + 3.0 * p1 - 3.0 * p2 + p3;
+  }
+  std::fill(m_radiusSquaredCoefficients, m_radiusSquaredCoefficients + 7, 0.0);
+  for (ui32 c = 0; c < 2; c++)
+  {
+    for (ui32 i = 0; i < 4; i++)
+    {
+      for (ui32 j = 0; j < 4; j++)
+      {
+        m_radiusSquaredCoefficients[i + j] += m_coefficients[c][i] * m_coefficients[c][j];
+      }
+    }
+  }
+
+  // The curve lies in the convex hull of its control points.
+  f32 maxRadius = 0.0f;
+  f32 minZ      = p[0].z;
+  f32 maxZ      = p[0].z;
+  for (const f32v3& controlPoint : p)
+  {
+    maxRadius = std::max(maxRadius, glm::length(f32v2(controlPoint.x, controlPoint.y)));
+    minZ      = std::min(minZ, controlPoint.z);
+    maxZ      = std::max(maxZ, controlPoint.z);
+  }
+  m_boundingSphereCenter = f32v3(0.0f, 0.0f, 0.5f * (minZ + maxZ));
+  m_boundingSphereRadius = std::sqrt(maxRadius * maxRadius + 0.25f * (maxZ - minZ) * (maxZ - minZ));
+}
+
+bool FruitRayIntersector::intersect(const f32v3& origin, const f32v3& direction, f32 maxDistance,
+                                    FruitRayHit& hit) const
+{
+  FruitRayArray rays;
+  rays.resize(1);
+  rays.setRay(0, origin, direction, maxDistance);
+  FruitRayHitArray hits;
+  hits.resize(1);
+  intersect(rays, 0, 1, hits);
+
+  if (!(hits.distance[0] < INFINITE))
+  {
+    return false;
+  }
+  hit.distance = hits.distance[0];
+  hit.t        = hits.t[0];
+  hit.position = origin + hit.distance * direction;
+  hit.normal   = f32v3(hits.normalX[0], hits.normalY[0], hits.normalZ[0]);
+  return true;
+}
+
+void FruitRayIntersector::intersect(const FruitRayArray& rays, size_t first, size_t last,
+                                    FruitRayHitArray& hits) const
+{
+  const f64 radiusScale = std::max(static_cast<f64>(m_boundingSphereRadius), 1e-6);
+
+  for (const LaneBlock block : getLaneBlocks(first, last))
+  {
+    f32 ox[LANES], oy[LANES], oz[LANES], dx[LANES], dy[LANES], dz[LANES], maxDistance[LANES];
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      const size_t i    = block.getElement(lane);
+      ox[lane]          = rays.originX[i];
+      oy[lane]          = rays.originY[i];
+      oz[lane]          = rays.originZ[i];
+      dx[lane]          = rays.directionX[i];
+      dy[lane]          = rays.directionY[i];
+      dz[lane]          = rays.directionZ[i];
+      maxDistance[lane] = rays.maxDistance[i];
+    }
+
+    // Bounding sphere culling. Along the ray, the squared distance to the axis is a s^2 + b s + c.
+    bool active[LANES];
+    bool horizontal[LANES];
+    f64  a[LANES], b[LANES], c[LANES];
+    bool anyActive = false;
+    for (ui32 lane = 0; lane < LANES; lane++)
+    {
+      const f32v3 d            = f32v3(dx[lane], dy[lane], dz[lane]);
+      const f32v3 oc           = f32v3(ox[lane], oy[lane], oz[lane]) - m_boundingSphereCenter;
+      const f32   dd           = glm::dot(d, d);
+      const f32   halfB        = glm::dot(oc, d);
+      const f32   discriminant =
+          halfB * halfB - dd * (glm::dot(oc, oc) - m_boundingSphereRadius * m_boundingSphereRadius);
+      const f32   root         = std::sqrt(std::max(discriminant, 0.0f));
+      active[lane]     = dd > 0.0f && discriminant >= 0.0f && -halfB + root >= 0.0f &&
+                     (-halfB - root) <= maxDistance[lane] * dd;
+      horizontal[lane] = std::abs(dz[lane]) < HORIZONTAL_THRESHOLD * std::sqrt(static_cast<f64>(dd));
+      a[lane]          = static_cast<f64>(dx[lane]) * dx[lane] + static_cast<f64>(dy[lane]) * dy[lane];
+      b[lane]          = 2.0 * (static_cast<f64>(ox[lane]) * dx[lane] + static_cast<f64>(oy[lane]) * dy[lane]);
+      c[lane]          = static_cast<f64>(ox[lane]) * ox[lane] + static_cast<f64>(oy[lane]) * oy[lane];
+      anyActive        = anyActive || (lane < block.count && active[lane]);
+    }
+
+    f64 bestDistance[LANES];
+    f64 bestT[LANES];
+    std::fill(bestDistance, bestDistance + LANES, INFINITE_DOUBLE);
+    std::fill(bestT, bestT + LANES, 0.0);
+
+    if (anyActive)
+    {
+      // With w(t) = z(t) - oz and s = w / dz, rho^2(s) = r^2(t) becomes
+      // F(t) = dz^2 r^2(t) - dz^2 c - dz b w(t) - a w(t)^2 = 0. Horizontal rays use F(t) = w(t) instead. Near the roots
+      // of F of a flat ray, its terms are about dz^2 times smaller than the coefficients, hence F is set up, bracketed
+      // and refined in double precision.
+      PacketPolynomial<7> f;
+      for (ui32 lane = 0; lane < LANES; lane++)
+      {
+        f64 w[4] = {m_coefficients[2][0] - oz[lane], m_coefficients[2][1], m_coefficients[2][2],
+                    m_coefficients[2][3]};
+        f64 wSquared[7] = {};
+        for (ui32 i = 0; i < 4; i++)
+        {
+          for (ui32 j = 0; j < 4; j++)
+          {
+            wSquared[i + j] += w[i] * w[j];
+          }
+        }
+        const f64 dzSquared = static_cast<f64>(dz[lane]) * dz[lane];
+        for (ui32 i = 0; i < 7; i++)
+        {
+          const f64 wi    = i < 4 ? w[i] : 0.0;
+          const f64 value =
+              dzSquared * m_radiusSquaredCoefficients[i] - dz[lane] * b[lane] * wi - a[lane] * wSquared[i];
+          f[i][lane]      = horizontal[lane] ? wi : value;
+        }
+        f[0][lane] -= horizontal[lane] ? 0.0 : dzSquared * c[lane];
+      }
+
+      PacketPolynomial<6> fDerivative;
+      for (ui32 i = 1; i < 7; i++)
+      {
+        for (ui32 lane = 0; lane < LANES; lane++)
+        {
+          fDerivative[i - 1][lane] = static_cast<f64>(i) * f[i][lane];
+        }
+      }
+
+      // Finds a root of the polynomial in [lower;upper] for the lanes with a sign change, by bisection.
+      const auto bisect = [](const auto& polynomial, f64(&lower)[LANES], f64(&upper)[LANES])
+      {
+        f64 lowerValue[LANES];
+        for (ui32 lane = 0; lane < LANES; lane++)
+        {
+          lowerValue[lane] = evaluatePacketPolynomial(polynomial, lane, lower[lane]);
+        }
+        for (ui32 step = 0; step < NUM_BISECTION_STEPS; step++)
+        {
+          for (ui32 lane = 0; lane < LANES; lane++)
+          {
+            const f64  middle      = 0.5 * (lower[lane] + upper[lane]);
+            const f64  middleValue = evaluatePacketPolynomial(polynomial, lane, middle);
+            const bool lowerHalf   = lowerValue[lane] * middleValue <= 0.0;
+            upper[lane]            = lowerHalf ? middle : upper[lane];
+            lower[lane]            = lowerHalf ? lower[lane] : middle;
+            lowerValue[lane]       = lowerHalf ? lowerValue[lane] : middleValue;
+          }
+        }
+      };
+
+      // Refines the roots of F in [lower;upper] and keeps the closest valid hit. First the ray parameter of the root,
+      // then Newton's method on r^2(t) = rho^2(s) and z(t) = oz + s dz.
+      const auto solve = [&](f64(&lower)[LANES], f64(&upper)[LANES], const bool(&mask)[LANES])
+      {
+        bisect(f, lower, upper);
+        for (ui32 lane = 0; lane < LANES; lane++)
+        {
+          f64 t = 0.5 * (lower[lane] + upper[lane]);
+          f64 s = horizontal[lane]
+                      ? smallestNonNegativeRoot(a[lane], b[lane],
+                                                c[lane] - evaluatePolynomial(m_radiusSquaredCoefficients, t))
+                      : (evaluatePolynomial(m_coefficients[2], t) - oz[lane]) / dz[lane];
+          for (ui32 step = 0; step < NUM_NEWTON_STEPS; step++)
+          {
+            const f64 g1 =
+                evaluatePolynomial(m_radiusSquaredCoefficients, t) - ((a[lane] * s + b[lane]) * s + c[lane]);
+            const f64  g2          = evaluatePolynomial(m_coefficients[2], t) - oz[lane] - s * dz[lane];
+            const f64  dg1dt       = evaluatePolynomialDerivative(m_radiusSquaredCoefficients, t);
+            const f64  dg1ds       = -(2.0 * a[lane] * s + b[lane]);
+            const f64  dg2dt       = evaluatePolynomialDerivative(m_coefficients[2], t);
+            const f64  determinant = dg1dt * -dz[lane] - dg1ds * dg2dt;
+            const bool solvable    = std::abs(determinant) > 1e-12 && s < INFINITE_DOUBLE;
+            const f64  inverse     = solvable ? 1.0 / determinant : 0.0;
+            t -= (g1 * -dz[lane] - dg1ds * g2) * inverse;
+            s -= (dg1dt * g2 - dg2dt * g1) * inverse;
+          }
+          const f64 g1 = evaluatePolynomial(m_radiusSquaredCoefficients, t) - ((a[lane] * s + b[lane]) * s + c[lane]);
+          const f64 g2 = evaluatePolynomial(m_coefficients[2], t) - oz[lane] - s * dz[lane];
+          const bool accepted = mask[lane] && t >= -PARAMETER_TOLERANCE && t <= 1.0 + PARAMETER_TOLERANCE &&
+                                s >= 0.0 && s <= maxDistance[lane] && s < bestDistance[lane] &&
+                                std::abs(g1) <= RESIDUAL_TOLERANCE * radiusScale * radiusScale &&
+                                std::abs(g2) <= RESIDUAL_TOLERANCE * radiusScale;
+          bestDistance[lane] = accepted ? s : bestDistance[lane];
+          bestT[lane]        = accepted ? std::clamp(t, 0.0, 1.0) : bestT[lane];
+        }
+      };
+
+      f64 previous[LANES];
+      f64 previousDerivative[LANES];
+      for (ui32 lane = 0; lane < LANES; lane++)
+      {
+        previous[lane]           = evaluatePacketPolynomial(f, lane, 0.0);
+        previousDerivative[lane] = evaluatePacketPolynomial(fDerivative, lane, 0.0);
+      }
+      for (ui32 bracket = 0; bracket < NUM_BRACKETS; bracket++)
+      {
+        const f64 t0 = static_cast<f64>(bracket) / NUM_BRACKETS;
+        const f64 t1 = static_cast<f64>(bracket + 1) / NUM_BRACKETS;
+
+        // A sign change brackets one root. Without sign change, an extremum of F may separate two roots, e.g., where a
+        // flat ray enters and leaves the fruit at almost the same height.
+        f64  values[LANES];
+        bool signChange[LANES];
+        bool extremum[LANES];
+        bool anySignChange = false;
+        bool anyExtremum   = false;
+        for (ui32 lane = 0; lane < LANES; lane++)
+        {
+          const f64 next           = evaluatePacketPolynomial(f, lane, t1);
+          const f64 nextDerivative = evaluatePacketPolynomial(fDerivative, lane, t1);
+          signChange[lane]         = active[lane] && previous[lane] * next <= 0.0;
+          extremum[lane] = active[lane] && !signChange[lane] && previousDerivative[lane] * nextDerivative < 0.0;
+          values[lane]   = previous[lane];
+          previous[lane] = next;
+          previousDerivative[lane] = nextDerivative;
+          anySignChange            = anySignChange || signChange[lane];
+          anyExtremum              = anyExtremum || extremum[lane];
+        }
+        if (!anySignChange && !anyExtremum)
+        {
+          continue;
+        }
+
+        f64 lower[LANES], upper[LANES];
+        std::fill(lower, lower + LANES, t0);
+        std::fill(upper, upper + LANES, t1);
+        if (anyExtremum)
+        {
+          bisect(fDerivative, lower, upper);
+        }
+        f64  middle[LANES];
+        bool lowerMask[LANES];
+        bool upperMask[LANES];
+        for (ui32 lane = 0; lane < LANES; lane++)
+        {
+          middle[lane]          = extremum[lane] ? 0.5 * (lower[lane] + upper[lane]) : t1;
+          const f64 middleValue = evaluatePacketPolynomial(f, lane, middle[lane]);
+          lowerMask[lane]       = signChange[lane] || (extremum[lane] && values[lane] * middleValue <= 0.0);
+          upperMask[lane]       = extremum[lane] && middleValue * previous[lane] <= 0.0;
+          lower[lane]           = t0;
+          upper[lane]           = middle[lane];
+        }
+        solve(lower, upper, lowerMask);
+        if (anyExtremum)
+        {
+          std::copy(middle, middle + LANES, lower);
+          std::fill(upper, upper + LANES, t1);
+          solve(lower, upper, upperMask);
+        }
+      }
+    }
+
+    // The normal of the surface is (e z'(t), -r'(t)), with e the unit vector from the axis to the hit.
+    for (ui32 lane = 0; lane < block.count; lane++)
+    {
+      const size_t i = block.first + lane;
+      hits.distance[i] = static_cast<f32>(bestDistance[lane]);
+      hits.t[i]        = static_cast<f32>(bestT[lane]);
+      f32v3 normal     = f32v3(0.0f, 0.0f, bestT[lane] < 0.5 ? -1.0f : 1.0f);
+      if (bestDistance[lane] < INFINITE_DOUBLE)
+      {
+        const f64   t        = bestT[lane];
+        const f64v2 radial   = f64v2(ox[lane], oy[lane]) + bestDistance[lane] * f64v2(dx[lane], dy[lane]);
+        const f64   rho      = glm::length(radial);
+        const f64   radius   = std::sqrt(std::max(evaluatePolynomial(m_radiusSquaredCoefficients, t), 0.0));
+        const f64   dRadius  = evaluatePolynomialDerivative(m_radiusSquaredCoefficients, t) / (2.0 * radius);
+        const f64   dHeight  = evaluatePolynomialDerivative(m_coefficients[2], t);
+        const f64v3 gradient = f64v3(radial / rho * dHeight, -dRadius);
+        if (rho > 0.0 && radius > 0.0 && glm::dot(gradient, gradient) > 0.0)
+        {
+          normal = f32v3(glm::normalize(gradient));
+        }
+      }
+      hits.normalX[i] = normal.x;
+      hits.normalY[i] = normal.y;
+      hits.normalZ[i] = normal.z;
+    }
+  }
+}
+
+const f32v3& FruitRayIntersector::getBoundingSphereCenter() const
+{
+  return m_boundingSphereCenter;
+}
+
+f32 FruitRayIntersector::getBoundingSphereRadius() const
+{
+  return m_boundingSphereRadius;
+}
+} // namespace gims
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cmath>
+#include <gimslib/fruit/FruitMeasures.hpp>
+#include <gimslib/fruit/FruitRayIntersector.hpp>
+#include <gimslib/fruit/FruitSceneBVH.hpp>
+#include <gimslib/sys/ParallelFor.hpp>
+#include <numeric>
+#include <stdexcept>
+
+namespace
+{
+using namespace gims;
+
+constexpr ui32   MAX_LEAF_SIZE      = 4;
+constexpr size_t INSTANCES_PER_TASK = 4096;
+// Median splits keep the depth at log2(n / MAX_LEAF_SIZE) + 1, i.e., below 32 for 2^32 instances.
+constexpr ui32   STACK_SIZE         = 64;
+
+// Rotates v by the unit quaternion (u, w): v + 2 w (u x v) + 2 u x (u x v).
+f32v3 rotate(const f32v3& u, f32 w, const f32v3& v)
+{
+  const f32v3 uv = glm::cross(u, v);
+  return v + 2.0f * (w * uv + glm::cross(u, uv));
+}
+
+// Ray parameter at which the ray enters the box, or infinity if it misses the box within [0;maxDistance].
+f32 intersectBox(const f32v3& aabbMin, const f32v3& aabbMax, const f32v3& origin, const f32v3& inverseDirection,
+                 f32 maxDistance)
+{
+  const f32v3 t0    = (aabbMin - origin) * inverseDirection;
+  const f32v3 t1    = (aabbMax - origin) * inverseDirection;
+  const f32v3 tNear = glm::min(t0, t1);
+  const f32v3 tFar  = glm::max(t0, t1);
+  const f32   enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+  const f32   exit  = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+  return enter <= exit ? enter : std::numeric_limits<f32>::infinity();
+}
+} // namespace
+
+namespace gims
+{
+FruitSceneBVH::FruitSceneBVH(const FruitInstanceArray& instances)
+{
+  const size_t numInstances = instances.getSize();
+  if (numInstances > std::numeric_limits<ui32>::max())
+  {
+    throw std::invalid_argument("A fruit scene BVH holds at most 2^32 - 1 instances.");
+  }
+
+  FruitMeasureArray measures;
+  measures.resize(numInstances);
+  m_spheres.resize(numInstances);
+  parallelFor((numInstances + INSTANCES_PER_TASK - 1) / INSTANCES_PER_TASK,
+              [&](size_t task)
+              {
+                const size_t first = task * INSTANCES_PER_TASK;
+                const size_t last  = std::min(first + INSTANCES_PER_TASK, numInstances);
+                computeFruitMeasures(instances.profiles, first, last, measures);
+                for (size_t i = first; i < last; i++)
+                {
+                  const f32   halfHeight = 0.5f * (measures.maxZ[i] - measures.minZ[i]);
+                  const f32v3 center     = f32v3(0.0f, 0.0f, 0.5f * (measures.minZ[i] + measures.maxZ[i]));
+                  const f32v3 u = f32v3(instances.rotationX[i], instances.rotationY[i], instances.rotationZ[i]);
+                  const f32v3 position =
+                      f32v3(instances.positionX[i], instances.positionY[i], instances.positionZ[i]);
+                  m_spheres[i] = f32v4(rotate(u, instances.rotationW[i], center) + position,
+                                       std::sqrt(measures.radius[i] * measures.radius[i] + halfHeight * halfHeight));
+                }
+              });
+
+  m_instanceIndices.resize(numInstances);
+  std::iota(m_instanceIndices.begin(), m_instanceIndices.end(), 0u);
+  if (numInstances > 0)
+  {
+    m_nodes.reserve(2 * (numInstances / MAX_LEAF_SIZE) + 1);
+    build(0, static_cast<ui32>(numInstances));
+  }
+}
+
+void FruitSceneBVH::build(ui32 first, ui32 last)
+{
+  f32v3 aabbMin   = f32v3(std::numeric_limits<f32>::infinity());
+  f32v3 aabbMax   = -aabbMin;
+  f32v3 centerMin = aabbMin;
+  f32v3 centerMax = aabbMax;
+  for (ui32 i = first; i < last; i++)
+  {
+    const f32v4& sphere = m_spheres[m_instanceIndices[i]];
+    const f32v3  center = f32v3(sphere);
+    aabbMin             = glm::min(aabbMin, center - sphere.w);
+    aabbMax             = glm::max(aabbMax, center + sphere.w);
+    centerMin           = glm::min(centerMin, center);
+    centerMax           = glm::max(centerMax, center);
+  }
+
+  const ui32 nodeIndex = static_cast<ui32>(m_nodes.size());
+  m_nodes.push_back({aabbMin, first, aabbMax, last - first});
+  if (last - first <= MAX_LEAF_SIZE)
+  {
+    return;
+  }
+
+  const f32v3 extent = centerMax - centerMin;
+  const ui32  axis   = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+  const ui32  middle = first + (last - first) / 2;
+  std::nth_element(m_instanceIndices.begin() + first, m_instanceIndices.begin() + middle,
+                   m_instanceIndices.begin() + last,
+                   [&](ui32 a, ui32 b) { return m_spheres[a][axis] < m_spheres[b][axis]; });
+
+  build(first, middle);
+  m_nodes[nodeIndex].offset = static_cast<ui32>(m_nodes.size());
+  m_nodes[nodeIndex].count  = 0;
+  build(middle, last);
+}
+
+bool FruitSceneBVH::intersect(const FruitInstanceArray& instances, const f32v3& origin, const f32v3& direction,
+                              f32 maxDistance, FruitSceneHit& hit) const
+{
+  hit = FruitSceneHit();
+  if (m_nodes.empty())
+  {
+    return false;
+  }
+
+  const f32v3 inverseDirection = 1.0f / direction;
+  const f32   directionLength  = glm::length(direction);
+  f32         closest          = maxDistance;
+
+  ui32 stack[STACK_SIZE];
+  ui32 stackSize = 0;
+  if (intersectBox(m_nodes[0].aabbMin, m_nodes[0].aabbMax, origin, inverseDirection, closest) <= closest)
+  {
+    stack[stackSize++] = 0;
+  }
+  while (stackSize > 0)
+  {
+    const Node& node = m_nodes[stack[--stackSize]];
+    if (node.count == 0)
+    {
+      // The first child directly follows its parent. Push the nearer child last, so it is visited first.
+      const ui32 children[2]  = {static_cast<ui32>(&node - m_nodes.data()) + 1, node.offset};
+      const f32  distances[2] = {
+          intersectBox(m_nodes[children[0]].aabbMin, m_nodes[children[0]].aabbMax, origin, inverseDirection, closest),
+          intersectBox(m_nodes[children[1]].aabbMin, m_nodes[children[1]].aabbMax, origin, inverseDirection, closest)};
+      const ui32 nearer = distances[0] <= distances[1] ? 0 : 1;
+      if (distances[1 - nearer] <= closest)
+      {
+        stack[stackSize++] = children[1 - nearer];
+      }
+      if (distances[nearer] <= closest)
+      {
+        stack[stackSize++] = children[nearer];
+      }
+      continue;
+    }
+
+    for (ui32 i = node.offset; i < node.offset + node.count; i++)
+    {
+      const ui32   instance = m_instanceIndices[i];
+      const f32v4& sphere   = m_spheres[instance];
+      const f32v3  oc       = origin - f32v3(sphere);
+      const f32    distance = glm::length(glm::cross(oc, direction));
+      if (distance > sphere.w * directionLength)
+      {
+        continue;
+      }
+
+      // Into the local frame of the fruit: rotate by the conjugate quaternion. The rotation keeps the ray parameter.
+      const f32v3 u =
+          f32v3(instances.rotationX[instance], instances.rotationY[instance], instances.rotationZ[instance]);
+      const f32   w        = instances.rotationW[instance];
+      const f32v3 position = f32v3(instances.positionX[instance], instances.positionY[instance],
+                                   instances.positionZ[instance]);
+      const FruitRayIntersector intersector(instances.profiles.getProfile(instance));
+      FruitRayHit               localHit;
+      if (intersector.intersect(rotate(-u, w, origin - position), rotate(-u, w, direction), closest, localHit) &&
+          localHit.distance < closest)
+      {
+        closest      = localHit.distance;
+        hit.instance = instance;
+        hit.distance = localHit.distance;
+        hit.t        = localHit.t;
+        hit.position = origin + localHit.distance * direction;
+        hit.normal   = rotate(u, w, localHit.normal);
+      }
+    }
+  }
+  return hit.instance != FruitSceneHit::NO_INSTANCE;
+}
+
+size_t FruitSceneBVH::getNumInstances() const
+{
+  return m_instanceIndices.size();
+}
+
+size_t FruitSceneBVH::getNumNodes() const
+{
+  return m_nodes.size();
+}
+
+void FruitSceneBVH::getBounds(f32v3& aabbMin, f32v3& aabbMax) const
+{
+  aabbMin = m_nodes.empty() ? f32v3(0.0f) : m_nodes[0].aabbMin;
+  aabbMax = m_nodes.empty() ? f32v3(0.0f) : m_nodes[0].aabbMax;
+}
+} // namespace gims
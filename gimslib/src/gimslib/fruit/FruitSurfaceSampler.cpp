@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <gimslib/fruit/FruitMeasures.hpp>
+#include <gimslib/fruit/FruitSurfaceSampler.hpp>
+#include <gimslib/sys/ParallelFor.hpp>
+#include <numeric>
+
+namespace
+{
+using namespace gims;
+
+constexpr ui32 DENSITY_GRID_SIZE = 128;
+
+// Random sequential packing of disks with diameter r covers at most 54.7% of a plane.
+constexpr f32 RANDOM_PACKING_COVERAGE = 0.547f;
+constexpr f32 TARGET_FILL             = 0.6f;
+
+constexpr ui32 CANDIDATES_PER_TASK       = 4096;
+constexpr ui32 MAX_CANDIDATES_PER_SAMPLE = 64;
+// Candidates are drawn in batches of this fraction of the requested samples. Smaller batches leave fewer candidates
+// for the serial acceptance, but call parallelFor more often.
+constexpr ui32 NUM_BATCHES_PER_SAMPLES = 16;
+
+constexpr ui32 EMPTY = ~0u;
+
+// SplitMix64. Unlike the std distributions, its output is the same on every platform.
+ui64 hash(ui64 x)
+{
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+f32 toUnitFloat(ui64 x)
+{
+  return static_cast<f32>(x >> 40) * (1.0f / 16777216.0f);
+}
+
+f32v3 surfacePoint(const FruitProfile& profile, const f32v2& coordinates)
+{
+  return calculateFruitCoordinates(profile, octDecode(coordinates));
+}
+
+// Walker's alias method: draws an index with probability proportional to its weight in constant time.
+class AliasTable
+{
+public:
+  explicit AliasTable(const std::vector<f32>& weights)
+      : m_thresholds(weights.size())
+      , m_aliases(weights.size())
+  {
+    const f32          total = std::accumulate(weights.begin(), weights.end(), 0.0f);
+    std::vector<ui32>  small;
+    std::vector<ui32>  large;
+    std::vector<f32>   scaled(weights.size());
+    for (ui32 i = 0; i < static_cast<ui32>(weights.size()); i++)
+    {
+      scaled[i] = weights[i] * static_cast<f32>(weights.size()) / total;
+      (scaled[i] < 1.0f ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty())
+    {
+      const ui32 s = small.back();
+      const ui32 l = large.back();
+      small.pop_back();
+      m_thresholds[s] = scaled[s];
+      m_aliases[s]    = l;
+      scaled[l] -= 1.0f - scaled[s];
+      if (scaled[l] < 1.0f)
+      {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+    // Left overs are 1 up to rounding.
+    for (const ui32 i : small)
+    {
+      m_thresholds[i] = 1.0f;
+      m_aliases[i]    = i;
+    }
+    for (const ui32 i : large)
+    {
+      m_thresholds[i] = 1.0f;
+      m_aliases[i]    = i;
+    }
+  }
+
+  //! The upper 32 bits of random select the entry, the lower 32 bits decide between the entry and its alias.
+  ui32 sample(ui64 random) const
+  {
+    const ui32 i = static_cast<ui32>(((random >> 32) * m_thresholds.size()) >> 32);
+    return toUnitFloat(random << 32) < m_thresholds[i] ? i : m_aliases[i];
+  }
+
+private:
+  std::vector<f32>  m_thresholds;
+  std::vector<ui32> m_aliases;
+};
+
+// Spatial hash grid over the accepted samples. Each bucket is a linked list of nodes. The nodes hold a copy of the
+// position, so a test touches one cache line per sample. The cells have twice the size of the radius, hence a ball
+// with the radius overlaps at most 2 x 2 x 2 cells.
+class HashGrid
+{
+public:
+  HashGrid(f32 radius, size_t numSamples)
+      : m_inverseCellSize(0.5f / radius)
+      , m_mask(std::bit_ceil(std::max<size_t>(2 * numSamples, 16)) - 1)
+      , m_buckets(m_mask + 1, EMPTY)
+  {
+    m_nodes.reserve(numSamples);
+  }
+
+  bool isFree(const f32v3& p, f32 radiusSquared) const
+  {
+    const i32v3 first = i32v3(glm::floor(p * m_inverseCellSize - 0.5f));
+    for (i32 z = first.z; z <= first.z + 1; z++)
+    {
+      for (i32 y = first.y; y <= first.y + 1; y++)
+      {
+        for (i32 x = first.x; x <= first.x + 1; x++)
+        {
+          for (ui32 i = m_buckets[getBucket(i32v3(x, y, z))]; i != EMPTY; i = m_nodes[i].next)
+          {
+            const f32v3 d = m_nodes[i].position - p;
+            if (glm::dot(d, d) < radiusSquared)
+            {
+              return false;
+            }
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  void insert(const f32v3& p)
+  {
+    const size_t bucket = getBucket(i32v3(glm::floor(p * m_inverseCellSize)));
+    m_nodes.push_back({p, m_buckets[bucket]});
+    m_buckets[bucket] = static_cast<ui32>(m_nodes.size() - 1);
+  }
+
+private:
+  struct Node
+  {
+    f32v3 position;
+    ui32  next;
+  };
+
+  size_t getBucket(const i32v3& cell) const
+  {
+    const ui32 h = static_cast<ui32>(cell.x) * 73856093u ^ static_cast<ui32>(cell.y) * 19349663u ^
+                   static_cast<ui32>(cell.z) * 83492791u;
+    return h & m_mask;
+  }
+
+  f32               m_inverseCellSize;
+  size_t            m_mask;
+  std::vector<ui32> m_buckets;
+  std::vector<Node> m_nodes;
+};
+} // namespace
+
+namespace gims
+{
+FruitSurfaceSamples sampleFruitSurface(const FruitProfile& profile, ui32 numSamples, ui64 seed)
+{
+  FruitSurfaceSamples samples;
+  if (numSamples == 0)
+  {
+    return samples;
+  }
+
+  // Area of the surface patch of each cell of the octahedral domain, by central differences at the cell center.
+  const f32        cellSize = 2.0f / DENSITY_GRID_SIZE;
+  const f32        h        = 0.5f * cellSize;
+  std::vector<f32> cellAreas(DENSITY_GRID_SIZE * DENSITY_GRID_SIZE);
+  f32              totalArea = 0.0f;
+  for (ui32 y = 0; y < DENSITY_GRID_SIZE; y++)
+  {
+    for (ui32 x = 0; x < DENSITY_GRID_SIZE; x++)
+    {
+      const f32v2 center = f32v2(-1.0f + (static_cast<f32>(x) + 0.5f) * cellSize,
+                                 -1.0f + (static_cast<f32>(y) + 0.5f) * cellSize);
+      const f32v3 du =
+          surfacePoint(profile, center + f32v2(h, 0.0f)) - surfacePoint(profile, center - f32v2(h, 0.0f));
+      const f32v3 dv =
+          surfacePoint(profile, center + f32v2(0.0f, h)) - surfacePoint(profile, center - f32v2(0.0f, h));
+      cellAreas[y * DENSITY_GRID_SIZE + x] = glm::length(glm::cross(du, dv));
+      totalArea += cellAreas[y * DENSITY_GRID_SIZE + x];
+    }
+  }
+  if (!(totalArea > 0.0f))
+  {
+    return samples;
+  }
+
+  // The exact area is more accurate than the sum over the cells.
+  const f32 area          = computeFruitMeasures(profile).area;
+  const f32 radius        = std::sqrt(4.0f * RANDOM_PACKING_COVERAGE * TARGET_FILL * area /
+                                      (glm::pi<f32>() * static_cast<f32>(numSamples)));
+  const f32 radiusSquared = radius * radius;
+  samples.radius          = radius;
+
+  const AliasTable cells(cellAreas);
+
+  HashGrid           grid(radius, numSamples);
+  std::vector<f32v2> candidateCoordinates;
+  std::vector<f32v3> candidatePositions;
+  std::vector<ui8>   candidateFree;
+  const size_t       batchSize = std::max<size_t>(numSamples / NUM_BATCHES_PER_SAMPLES, CANDIDATES_PER_TASK);
+  const size_t       maxCandidates = static_cast<size_t>(numSamples) * MAX_CANDIDATES_PER_SAMPLE;
+  for (size_t batchStart = 0; samples.positions.size() < numSamples && batchStart < maxCandidates;
+       batchStart += batchSize)
+  {
+    // Candidate i only depends on the seed and i, so candidates are generated in parallel. The grid does not change
+    // during the parallel part, so the candidates are also tested against the samples of the previous batches there.
+    candidateCoordinates.resize(batchSize);
+    candidatePositions.resize(batchSize);
+    candidateFree.resize(batchSize);
+    parallelFor((batchSize + CANDIDATES_PER_TASK - 1) / CANDIDATES_PER_TASK,
+                [&](size_t task)
+                {
+                  const size_t first = task * CANDIDATES_PER_TASK;
+                  const size_t last  = std::min(first + CANDIDATES_PER_TASK, batchSize);
+                  for (size_t i = first; i < last; i++)
+                  {
+                    const ui64 r0   = hash(seed ^ hash(batchStart + i));
+                    const ui64 r1   = hash(r0);
+                    const ui32 cell = cells.sample(r0);
+                    const f32 x = (static_cast<f32>(cell % DENSITY_GRID_SIZE) + toUnitFloat(r1)) * cellSize - 1.0f;
+                    const f32 y = (static_cast<f32>(cell / DENSITY_GRID_SIZE) + toUnitFloat(r1 << 24)) * cellSize -
+                                  1.0f;
+                    candidateCoordinates[i] = f32v2(x, y);
+                    candidatePositions[i]   = surfacePoint(profile, candidateCoordinates[i]);
+                    candidateFree[i]        = grid.isFree(candidatePositions[i], radiusSquared);
+                  }
+                });
+
+    // Only the survivors are tested serially, against the samples accepted before them in this batch. This accepts
+    // the same samples as testing each candidate in order.
+    for (size_t i = 0; i < batchSize && samples.positions.size() < numSamples; i++)
+    {
+      if (candidateFree[i] && grid.isFree(candidatePositions[i], radiusSquared))
+      {
+        grid.insert(candidatePositions[i]);
+        samples.positions.push_back(candidatePositions[i]);
+        samples.octahedralCoordinates.push_back(candidateCoordinates[i]);
+      }
+    }
+  }
+
+  samples.normals.resize(samples.positions.size());
+  for (size_t i = 0; i < samples.positions.size(); i++)
+  {
+    samples.normals[i] = calculateFruitNormal(profile, octDecode(samples.octahedralCoordinates[i]));
+  }
+  return samples;
+}
+} // namespace gims
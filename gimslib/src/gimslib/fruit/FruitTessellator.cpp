@@ -0,0 +1,126 @@
+#include <cmath>
+#include <gimslib/fruit/FruitTessellator.hpp>
+#include <gimslib/fruit/FruitTopology.hpp>
+#include <stdexcept>
+
+namespace gims
+{
+FruitMesh tessellateFruit(const FruitProfile& profile, ui32 intraLOD)
+{
+  if (intraLOD < 2)
+  {
+    throw std::invalid_argument("The intra LOD must be at least 2.");
+  }
+
+  FruitMesh result;
+  result.positions.resize(intraLOD * intraLOD);
+  result.indices.resize(2 * (intraLOD - 1) * (intraLOD - 1));
+
+  // The intra LODs of calculateIntraLOD() copy the compile-time tables, which MS_main reads as well.
+  const i32 lod = getFruitTopologyIndex(intraLOD);
+  if (lod >= 0)
+  {
+    const ui32 firstVertex   = FRUIT_TOPOLOGY.vertexOffsets[lod];
+    const ui32 firstTriangle = FRUIT_TOPOLOGY.triangleOffsets[lod];
+    for (ui32 i = 0; i < intraLOD * intraLOD; i++)
+    {
+      const std::array<f32, 2>& parameters = FRUIT_TOPOLOGY.parameters[firstVertex + i];
+      result.positions[i] = calculateFruitCoordinates(profile, octDecode(f32v2(parameters[0], parameters[1])));
+    }
+    for (ui32 i = 0; i < 2 * (intraLOD - 1) * (intraLOD - 1); i++)
+    {
+      const std::array<ui32, 3>& triangle = FRUIT_TOPOLOGY.triangles[firstTriangle + i];
+      result.indices[i]                   = ui32v3(triangle[0], triangle[1], triangle[2]);
+    }
+    return result;
+  }
+
+  // Same parameters as makeFruitTopologyTables(), so both paths agree bit for bit.
+  const f32 denominator = static_cast<f32>(intraLOD - 1);
+  for (ui32 y = 0; y < intraLOD; y++)
+  {
+    for (ui32 x = 0; x < intraLOD; x++)
+    {
+      const f32v2 remapped = f32v2(static_cast<f32>(2 * x) / denominator - 1.0f,
+                                   static_cast<f32>(2 * y) / denominator - 1.0f);
+      result.positions[y * intraLOD + x] = calculateFruitCoordinates(profile, octDecode(remapped));
+    }
+  }
+
+  const ui32 half = intraLOD / 2;
+  for (ui32 y = 0; y < intraLOD - 1; y++)
+  {
+    for (ui32 x = 0; x < intraLOD - 1; x++)
+    {
+      const ui32 current     = y * intraLOD + x;
+      const ui32 right       = current + 1;
+      const ui32 bottom      = current + intraLOD;
+      const ui32 bottomRight = bottom + 1;
+      const ui32 index       = 2 * (y * (intraLOD - 1) + x);
+
+      const bool noFlipNeeded = (x < half && y < half) || (x >= half && y >= half);
+      result.indices[index] = noFlipNeeded ? ui32v3(current, right, bottom) : ui32v3(current, right, bottomRight);
+      result.indices[index + 1] =
+          noFlipNeeded ? ui32v3(right, bottomRight, bottom) : ui32v3(bottomRight, bottom, current);
+    }
+  }
+  return result;
+}
+
+FruitMesh tessellateFruitRings(const FruitProfile& profile, ui32 numRings, ui32 numSectors)
+{
+  if (numRings < 2 || numSectors < 3)
+  {
+    throw std::invalid_argument("At least 2 rings and 3 sectors are required.");
+  }
+
+  std::vector<f32v2> sinusCosinus(numSectors);
+  for (ui32 s = 0; s < numSectors; s++)
+  {
+    const f32 angle = glm::two_pi<f32>() * static_cast<f32>(s) / static_cast<f32>(numSectors);
+    sinusCosinus[s] = f32v2(std::sin(angle), std::cos(angle));
+  }
+
+  FruitMesh result;
+  result.positions.resize(numRings * numSectors);
+  result.indices.reserve(2 * (numRings - 1) * numSectors);
+
+  BezierForwardDifferencer differencer(profile, 0.0f, 1.0f / static_cast<f32>(numRings - 1));
+  for (ui32 r = 0; r < numRings; r++)
+  {
+    const f32v3& curvePoint = differencer.getValue();
+    for (ui32 s = 0; s < numSectors; s++)
+    {
+      result.positions[r * numSectors + s] =
+          f32v3(sinusCosinus[s].y * curvePoint.x - sinusCosinus[s].x * curvePoint.y,
+                sinusCosinus[s].x * curvePoint.x + sinusCosinus[s].y * curvePoint.y, curvePoint.z);
+    }
+    differencer.step();
+  }
+
+  for (ui32 r = 0; r < numRings - 1; r++)
+  {
+    for (ui32 s = 0; s < numSectors; s++)
+    {
+      const ui32 current     = r * numSectors + s;
+      const ui32 right       = r * numSectors + (s + 1) % numSectors;
+      const ui32 bottom      = current + numSectors;
+      const ui32 bottomRight = right + numSectors;
+      result.indices.push_back(ui32v3(current, right, bottom));
+      result.indices.push_back(ui32v3(right, bottomRight, bottom));
+    }
+  }
+  return result;
+}
+
+CograBinaryMeshFile toCograBinaryMeshFile(const FruitMesh& mesh)
+{
+  static_assert(sizeof(f32v3) == 3 * sizeof(CograBinaryMeshFile::FloatType));
+  static_assert(sizeof(ui32v3) == 3 * sizeof(CograBinaryMeshFile::IndexType));
+
+  CograBinaryMeshFile result;
+  result.setPositions(&mesh.positions.data()->x, static_cast<CograBinaryMeshFile::SizeType>(mesh.positions.size()));
+  result.setTriangleIndices(&mesh.indices.data()->x, static_cast<CograBinaryMeshFile::SizeType>(mesh.indices.size()));
+  return result;
+}
+} // namespace gims
@@ -0,0 +1,111 @@
+#include <gimslib/fruit/FruitTiling.hpp>
+#include <stdexcept>
+
+namespace
+{
+using namespace gims;
+
+ui32 getTileStart(const FruitTiling& tiling, ui32 tile)
+{
+  return tile * (tiling.gridSize - 1) / tiling.tilesPerSide;
+}
+} // namespace
+
+namespace gims
+{
+ui32 FruitTiling::getNumTiles() const
+{
+  return tilesPerSide * tilesPerSide;
+}
+
+ui32 FruitTiling::getNumTriangles() const
+{
+  return 2 * (gridSize - 1) * (gridSize - 1);
+}
+
+ui32 FruitTile::getNumVertices() const
+{
+  return (numQuadsX + 1) * (numQuadsY + 1);
+}
+
+ui32 FruitTile::getNumTriangles() const
+{
+  return 2 * numQuadsX * numQuadsY;
+}
+
+FruitTiling planFruitTiling(ui32 gridSize)
+{
+  if (gridSize < 2 || gridSize > FruitTiling::MAX_GRID_SIZE)
+  {
+    throw std::invalid_argument("The grid size of a fruit must be in [2;1025].");
+  }
+  FruitTiling tiling;
+  tiling.gridSize     = gridSize;
+  tiling.tilesPerSide = (gridSize - 1 + FruitTiling::MAX_QUADS - 1) / FruitTiling::MAX_QUADS;
+  return tiling;
+}
+
+FruitTile getFruitTile(const FruitTiling& tiling, ui32 tileIndex)
+{
+  if (tileIndex >= tiling.getNumTiles())
+  {
+    throw std::out_of_range("The fruit tile does not exist.");
+  }
+  const ui32 x = tileIndex % tiling.tilesPerSide;
+  const ui32 y = tileIndex / tiling.tilesPerSide;
+
+  FruitTile tile;
+  tile.firstX    = getTileStart(tiling, x);
+  tile.firstY    = getTileStart(tiling, y);
+  tile.numQuadsX = getTileStart(tiling, x + 1) - tile.firstX;
+  tile.numQuadsY = getTileStart(tiling, y + 1) - tile.firstY;
+  return tile;
+}
+
+ui32v2 getFruitTileVertex(const FruitTile& tile, ui32 vertex)
+{
+  return ui32v2(tile.firstX + vertex % (tile.numQuadsX + 1), tile.firstY + vertex / (tile.numQuadsX + 1));
+}
+
+ui32v3 getFruitTileTriangle(const FruitTiling& tiling, const FruitTile& tile, ui32 triangle)
+{
+  const ui32 quad        = triangle / 2;
+  const ui32 x           = quad % tile.numQuadsX;
+  const ui32 y           = quad / tile.numQuadsX;
+  const ui32 current     = y * (tile.numQuadsX + 1) + x;
+  const ui32 right       = current + 1;
+  const ui32 bottom      = current + tile.numQuadsX + 1;
+  const ui32 bottomRight = bottom + 1;
+
+  const ui32 half         = tiling.gridSize / 2;
+  const ui32 gridX        = tile.firstX + x;
+  const ui32 gridY        = tile.firstY + y;
+  const bool noFlipNeeded = (gridX < half && gridY < half) || (gridX >= half && gridY >= half);
+  if (triangle % 2 == 0)
+  {
+    return noFlipNeeded ? ui32v3(current, right, bottom) : ui32v3(current, right, bottomRight);
+  }
+  return noFlipNeeded ? ui32v3(right, bottomRight, bottom) : ui32v3(bottomRight, bottom, current);
+}
+
+std::vector<FruitMeshlet> buildFruitMeshlets(const FruitTiling& tiling)
+{
+  std::vector<FruitMeshlet> meshlets(tiling.getNumTiles());
+  for (ui32 i = 0; i < tiling.getNumTiles(); i++)
+  {
+    const FruitTile tile = getFruitTile(tiling, i);
+    meshlets[i].vertices.resize(tile.getNumVertices());
+    for (ui32 v = 0; v < tile.getNumVertices(); v++)
+    {
+      const ui32v2 gridCoordinates = getFruitTileVertex(tile, v);
+      meshlets[i].vertices[v]      = gridCoordinates.y * tiling.gridSize + gridCoordinates.x;
+    }
+    meshlets[i].triangles.resize(tile.getNumTriangles());
+    for (ui32 t = 0; t < tile.getNumTriangles(); t++)
+    {
+      meshlets[i].triangles[t] = getFruitTileTriangle(tiling, tile, t);
+    }
+  }
+  return meshlets;
+}
+} // namespace gims
@@ -0,0 +1,71 @@
+#include <format>
+#include <fstream>
+#include <gimslib/fruit/FruitTopology.hpp>
+#include <stdexcept>
+
+namespace
+{
+using namespace gims;
+
+constexpr ui32 ENTRIES_PER_LINE = 8;
+
+template<size_t N> std::string formatUints(const std::array<ui32, N>& values)
+{
+  std::string result;
+  for (size_t i = 0; i < N; i++)
+  {
+    result += std::format("{}{}", i == 0 ? "" : ", ", values[i]);
+  }
+  return result;
+}
+} // namespace
+
+namespace gims
+{
+std::string fruitTopologyToHLSL()
+{
+  const FruitTopologyTables& tables = FRUIT_TOPOLOGY;
+
+  std::string result = "// Generated by writeFruitTopologyHLSL() of gimslib from FRUIT_TOPOLOGY. Do not edit.\n";
+  result += std::format("static const uint FRUIT_TOPOLOGY_NUM_LODS = {};\n", FruitTopologyTables::NUM_LODS);
+  result += std::format("static const uint FRUIT_TOPOLOGY_INTRA_LODS[{}] = {{{}}};\n", FruitTopologyTables::NUM_LODS,
+                        formatUints(FruitTopologyTables::INTRA_LODS));
+  result += std::format("static const uint FRUIT_TOPOLOGY_VERTEX_OFFSETS[{}] = {{{}}};\n",
+                        FruitTopologyTables::NUM_LODS, formatUints(tables.vertexOffsets));
+  result += std::format("static const uint FRUIT_TOPOLOGY_TRIANGLE_OFFSETS[{}] = {{{}}};\n",
+                        FruitTopologyTables::NUM_LODS, formatUints(tables.triangleOffsets));
+
+  result += std::format("\nstatic const float2 FRUIT_TOPOLOGY_PARAMETERS[{}] = {{", FruitTopologyTables::NUM_VERTICES);
+  for (ui32 i = 0; i < FruitTopologyTables::NUM_VERTICES; i++)
+  {
+    result += std::format("{}float2({:.9g}, {:.9g}){}", i % ENTRIES_PER_LINE == 0 ? "\n    " : " ",
+                          tables.parameters[i][0], tables.parameters[i][1],
+                          i + 1 < FruitTopologyTables::NUM_VERTICES ? "," : "");
+  }
+  result += "\n};\n";
+
+  result += std::format("\nstatic const uint3 FRUIT_TOPOLOGY_TRIANGLES[{}] = {{", FruitTopologyTables::NUM_TRIANGLES);
+  for (ui32 i = 0; i < FruitTopologyTables::NUM_TRIANGLES; i++)
+  {
+    result += std::format("{}uint3({}, {}, {}){}", i % ENTRIES_PER_LINE == 0 ? "\n    " : " ", tables.triangles[i][0],
+                          tables.triangles[i][1], tables.triangles[i][2],
+                          i + 1 < FruitTopologyTables::NUM_TRIANGLES ? "," : "");
+  }
+  result += "\n};\n";
+  return result;
+}
+
+void writeFruitTopologyHLSL(const std::filesystem::path& fileName)
+{
+  std::ofstream outFile(fileName, std::ios::out | std::ios::binary);
+  if (!outFile.is_open())
+  {
+    throw std::runtime_error("Error opening file " + fileName.string() + ".");
+  }
+  outFile << fruitTopologyToHLSL();
+  if (!outFile)
+  {
+    throw std::runtime_error("Error writing file " + fileName.string() + ".");
+  }
+}
+} // namespace gims
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <format>
+#include <gimslib/io/Sha256.hpp>
+
+namespace gims
+{
+namespace
+{
+constexpr std::array<ui32, 64> ROUND_CONSTANTS = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+constexpr std::array<ui32, 8> INITIAL_STATE = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                               0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+ui32 rotateRight(ui32 x, ui32 n)
+{
+  return (x >> n) | (x << (32 - n));
+}
+} // namespace
+
+Sha256::Sha256()
+    : m_state(INITIAL_STATE)
+    , m_block {}
+    , m_numBytes(0)
+{
+}
+
+void Sha256::update(const void* data, size_t size)
+{
+  const ui8* bytes = static_cast<const ui8*>(data);
+  while (size > 0)
+  {
+    const size_t offset = m_numBytes % 64;
+    const size_t count  = std::min(size, 64 - offset);
+    std::copy(bytes, bytes + count, m_block.begin() + offset);
+    m_numBytes += count;
+    bytes += count;
+    size -= count;
+    if (offset + count == 64)
+    {
+      processBlock(m_block.data());
+    }
+  }
+}
+
+Sha256::Digest Sha256::getDigest() const
+{
+  // Pads a copy with 0x80, zeros up to 56 mod 64 bytes and the message length in bits, big endian.
+  Sha256     padded    = *this;
+  const ui64 numBits   = m_numBytes * 8;
+  const ui8  one       = 0x80;
+  const ui8  zeros[64] = {};
+  padded.update(&one, 1);
+  padded.update(zeros, (120 - padded.m_numBytes % 64) % 64);
+  ui8 length[8];
+  for (ui32 i = 0; i < 8; i++)
+  {
+    length[i] = static_cast<ui8>(numBits >> (56 - 8 * i));
+  }
+  padded.update(length, sizeof(length));
+
+  Digest result;
+  for (ui32 i = 0; i < 32; i++)
+  {
+    result[i] = static_cast<ui8>(padded.m_state[i / 4] >> (24 - 8 * (i % 4)));
+  }
+  return result;
+}
+
+std::string Sha256::toString(const Digest& digest)
+{
+  std::string result;
+  for (const ui8 byte : digest)
+  {
+    result += std::format("{:02x}", byte);
+  }
+  return result;
+}
+
+void Sha256::processBlock(const ui8* block)
+{
+  std::array<ui32, 64> w;
+  for (ui32 i = 0; i < 16; i++)
+  {
+    w[i] = static_cast<ui32>(block[4 * i]) << 24 | static_cast<ui32>(block[4 * i + 1]) << 16 |
+           static_cast<ui32>(block[4 * i + 2]) << 8 | static_cast<ui32>(block[4 * i + 3]);
+  }
+  for (ui32 i = 16; i < 64; i++)
+  {
+    const ui32 s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    const ui32 s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i]          = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  std::array<ui32, 8> v = m_state;
+  for (ui32 i = 0; i < 64; i++)
+  {
+    const ui32 s1         = rotateRight(v[4], 6) ^ rotateRight(v[4], 11) ^ rotateRight(v[4], 25);
+    const ui32 choice     = (v[4] & v[5]) ^ (~v[4] & v[6]);
+    const ui32 temporary1 = v[7] + s1 + choice + ROUND_CONSTANTS[i] + w[i];
+    const ui32 s0         = rotateRight(v[0], 2) ^ rotateRight(v[0], 13) ^ rotateRight(v[0], 22);
+    const ui32 majority   = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+    const ui32 temporary2 = s0 + majority;
+    v                     = {temporary1 + temporary2, v[0], v[1], v[2], v[3] + temporary1, v[4], v[5], v[6]};
+  }
+  for (ui32 i = 0; i < 8; i++)
+  {
+    m_state[i] += v[i];
+  }
+}
+} // namespace gims
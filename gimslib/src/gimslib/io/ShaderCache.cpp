@@ -0,0 +1,390 @@
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <gimslib/io/ShaderCache.hpp>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_set>
+
+namespace gims
+{
+namespace
+{
+constexpr char ENTRY_EXTENSION[]     = ".shader";
+constexpr char TEMPORARY_EXTENSION[] = ".tmp";
+constexpr ui32 ENTRY_MAGIC           = 0x43534d47; // "GMSC"
+constexpr ui32 ENTRY_VERSION         = 2;          // 2 since the keys are SHA-256 digests.
+
+//! Precedes the blob in an entry file.
+struct EntryHeader
+{
+  ui32 magic;
+  ui32 version;
+  ui64 keyLow;
+  ui64 keyHigh;
+  ui64 size;
+  ui64 checksum;
+};
+
+ui64 fnv1a(ui64 hash, const void* data, size_t size)
+{
+  const ui8* bytes = static_cast<const ui8*>(data);
+  for (size_t i = 0; i < size; i++)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+ui64 getChecksum(const void* data, size_t size)
+{
+  return fnv1a(14695981039346656037ull, data, size);
+}
+
+std::optional<std::string> readFile(const std::filesystem::path& file)
+{
+  std::ifstream stream(file, std::ios::binary);
+  if (!stream)
+  {
+    return std::nullopt;
+  }
+  return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+//! Returns the names of the #include directives of the source, in order.
+std::vector<std::string> getIncludes(const std::string& source)
+{
+  std::vector<std::string> result;
+  size_t                   lineBegin = 0;
+  while (lineBegin < source.size())
+  {
+    size_t lineEnd = source.find('\n', lineBegin);
+    if (lineEnd == std::string::npos)
+    {
+      lineEnd = source.size();
+    }
+    size_t     i         = lineBegin;
+    const auto skipBlank = [&]()
+    {
+      while (i < lineEnd && (source[i] == ' ' || source[i] == '\t'))
+      {
+        i++;
+      }
+    };
+    skipBlank();
+    if (i < lineEnd && source[i] == '#')
+    {
+      i++;
+      skipBlank();
+      if (source.compare(i, 7, "include") == 0)
+      {
+        i += 7;
+        skipBlank();
+        if (i < lineEnd && (source[i] == '"' || source[i] == '<'))
+        {
+          const char   closing = source[i] == '"' ? '"' : '>';
+          const size_t end     = source.find(closing, i + 1);
+          if (end != std::string::npos && end < lineEnd)
+          {
+            result.push_back(source.substr(i + 1, end - i - 1));
+          }
+        }
+      }
+    }
+    lineBegin = lineEnd + 1;
+  }
+  return result;
+}
+
+std::optional<std::filesystem::path> resolveInclude(const std::string& name, const std::filesystem::path& directory,
+                                                    const std::vector<std::filesystem::path>& includeDirectories)
+{
+  std::error_code ec;
+  if (std::filesystem::is_regular_file(directory / name, ec))
+  {
+    return directory / name;
+  }
+  for (const auto& includeDirectory : includeDirectories)
+  {
+    if (std::filesystem::is_regular_file(includeDirectory / name, ec))
+    {
+      return includeDirectory / name;
+    }
+  }
+  return std::nullopt;
+}
+} // namespace
+
+std::string ShaderCacheKey::toString() const
+{
+  return std::format("{:016x}{:016x}", high, low);
+}
+
+void ShaderCacheKeyBuilder::add(const void* data, size_t size)
+{
+  m_hash.update(data, size);
+}
+
+void ShaderCacheKeyBuilder::add(const std::string& string)
+{
+  const ui64 size = string.size();
+  add(&size, sizeof(size));
+  add(string.data(), string.size());
+}
+
+void ShaderCacheKeyBuilder::add(const std::wstring& string)
+{
+  // wchar_t has 2 bytes on Windows and 4 bytes elsewhere, so the same string yields different keys, which is harmless.
+  const ui64 size = string.size();
+  add(&size, sizeof(size));
+  add(string.data(), string.size() * sizeof(wchar_t));
+}
+
+void ShaderCacheKeyBuilder::addSourceFiles(const std::filesystem::path&              shaderFile,
+                                           const std::vector<std::filesystem::path>& includeDirectories)
+{
+  const auto source = readFile(shaderFile);
+  if (!source)
+  {
+    throw std::runtime_error("Unable to load " + shaderFile.string());
+  }
+  add(shaderFile.generic_string());
+  add(*source);
+
+  std::error_code                 ec;
+  std::unordered_set<std::string> visited = {std::filesystem::weakly_canonical(shaderFile, ec).string()};
+  // Depth first, like the preprocessor.
+  std::vector<std::pair<std::filesystem::path, std::vector<std::string>>> stack;
+  stack.emplace_back(shaderFile.parent_path(), getIncludes(*source));
+  std::ranges::reverse(stack.back().second);
+  while (!stack.empty())
+  {
+    if (stack.back().second.empty())
+    {
+      stack.pop_back();
+      continue;
+    }
+    const std::string name = std::move(stack.back().second.back());
+    stack.back().second.pop_back();
+    add(name);
+
+    const auto file = resolveInclude(name, stack.back().first, includeDirectories);
+    if (!file || !visited.insert(std::filesystem::weakly_canonical(*file, ec).string()).second)
+    {
+      // Unresolved includes are added by name only: the compiler fails on them, or a file created later changes the
+      // key. Files already visited are guarded or recursive, so the name suffices as well.
+      add(file ? std::string("visited") : std::string("missing"));
+      continue;
+    }
+    const auto includedSource = readFile(*file);
+    add(includedSource.value_or(std::string()));
+    if (includedSource)
+    {
+      stack.emplace_back(file->parent_path(), getIncludes(*includedSource));
+      std::ranges::reverse(stack.back().second);
+    }
+  }
+}
+
+ShaderCacheKey ShaderCacheKeyBuilder::getKey() const
+{
+  const Sha256::Digest digest = m_hash.getDigest();
+  ShaderCacheKey       result;
+  for (ui32 i = 0; i < 8; i++)
+  {
+    result.high = result.high << 8 | digest[i];
+    result.low  = result.low << 8 | digest[8 + i];
+  }
+  return result;
+}
+
+ShaderCache::ShaderCache(const std::filesystem::path& directory, ui64 byteBudget)
+    : m_directory(directory)
+    , m_byteBudget(byteBudget)
+    , m_numHits(0)
+    , m_numMisses(0)
+    , m_numTemporaryFiles(0)
+{
+  std::error_code ec;
+  std::filesystem::create_directories(m_directory, ec);
+}
+
+std::optional<std::vector<ui8>> ShaderCache::load(const ShaderCacheKey& key)
+{
+  const auto path = getEntryPath(key);
+  {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+    {
+      m_numMisses.fetch_add(1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+
+    EntryHeader header = {};
+    if (stream.read(reinterpret_cast<char*>(&header), sizeof(header)) && header.magic == ENTRY_MAGIC &&
+        header.version == ENTRY_VERSION && header.keyLow == key.low && header.keyHigh == key.high &&
+        header.size <= m_byteBudget)
+    {
+      std::vector<ui8> result(header.size);
+      if (stream.read(reinterpret_cast<char*>(result.data()), result.size()) &&
+          stream.peek() == std::ifstream::traits_type::eof() &&
+          getChecksum(result.data(), result.size()) == header.checksum)
+      {
+        std::error_code ec;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+        m_numHits.fetch_add(1, std::memory_order_relaxed);
+        return result;
+      }
+    }
+  }
+
+  // Truncated or corrupted, e.g., by a full disk.
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  m_numMisses.fetch_add(1, std::memory_order_relaxed);
+  return std::nullopt;
+}
+
+bool ShaderCache::store(const ShaderCacheKey& key, const void* data, size_t size)
+{
+  if (sizeof(EntryHeader) + size > m_byteBudget)
+  {
+    return false;
+  }
+
+  // Unique among the threads of this process by the counter, and among processes by the random number.
+  static const ui64 processId =
+      (static_cast<ui64>(std::random_device()()) << 32) | static_cast<ui64>(std::random_device()());
+  const auto temporaryPath =
+      m_directory / std::format("{}.{:016x}.{}{}", key.toString(), processId,
+                                m_numTemporaryFiles.fetch_add(1, std::memory_order_relaxed), TEMPORARY_EXTENSION);
+
+  const EntryHeader header = {ENTRY_MAGIC, ENTRY_VERSION, key.low, key.high, size, getChecksum(data, size)};
+  std::ofstream     stream(temporaryPath, std::ios::binary | std::ios::trunc);
+  stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+  stream.close();
+
+  std::error_code ec;
+  const auto      path = getEntryPath(key);
+  if (!stream)
+  {
+    std::filesystem::remove(temporaryPath, ec);
+    return false;
+  }
+  // Replaces an entry of another thread or process for the same key, which is equal.
+  std::filesystem::rename(temporaryPath, path, ec);
+  if (ec)
+  {
+    std::filesystem::remove(temporaryPath, ec);
+    return false;
+  }
+  evict(path);
+  return true;
+}
+
+void ShaderCache::clear()
+{
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(m_directory, ec))
+  {
+    const auto extension = entry.path().extension();
+    if (extension == ENTRY_EXTENSION || extension == TEMPORARY_EXTENSION)
+    {
+      std::filesystem::remove(entry.path(), ec);
+    }
+  }
+}
+
+const std::filesystem::path& ShaderCache::getDirectory() const
+{
+  return m_directory;
+}
+
+ui64 ShaderCache::getByteBudget() const
+{
+  return m_byteBudget;
+}
+
+ui64 ShaderCache::getSizeInBytes() const
+{
+  ui64            result = 0;
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(m_directory, ec))
+  {
+    if (entry.path().extension() == ENTRY_EXTENSION)
+    {
+      const ui64 size = entry.file_size(ec);
+      result += ec ? 0 : size;
+    }
+  }
+  return result;
+}
+
+ui64 ShaderCache::getNumHits() const
+{
+  return m_numHits.load(std::memory_order_relaxed);
+}
+
+ui64 ShaderCache::getNumMisses() const
+{
+  return m_numMisses.load(std::memory_order_relaxed);
+}
+
+std::filesystem::path ShaderCache::getEntryPath(const ShaderCacheKey& key) const
+{
+  return m_directory / (key.toString() + ENTRY_EXTENSION);
+}
+
+void ShaderCache::evict(const std::filesystem::path& keep)
+{
+  struct Entry
+  {
+    std::filesystem::file_time_type lastUse;
+    ui64                            sizeInBytes;
+    std::filesystem::path           path;
+  };
+  std::vector<Entry> entries;
+  ui64               sizeInBytes = 0;
+  std::error_code    ec;
+  for (const auto& entry : std::filesystem::directory_iterator(m_directory, ec))
+  {
+    if (entry.path().extension() != ENTRY_EXTENSION)
+    {
+      continue;
+    }
+    const auto lastUse = entry.last_write_time(ec);
+    const ui64 size    = ec ? 0 : entry.file_size(ec);
+    if (!ec)
+    {
+      entries.push_back({lastUse, size, entry.path()});
+      sizeInBytes += size;
+    }
+  }
+  if (sizeInBytes <= m_byteBudget)
+  {
+    return;
+  }
+
+  std::ranges::sort(entries,
+                    [](const Entry& a, const Entry& b)
+                    {
+                      return a.lastUse < b.lastUse;
+                    });
+  for (const auto& entry : entries)
+  {
+    if (sizeInBytes <= m_byteBudget)
+    {
+      break;
+    }
+    // Another thread or process may have removed it already, which frees the space just as well.
+    if (entry.path != keep)
+    {
+      std::filesystem::remove(entry.path, ec);
+      sizeInBytes -= entry.sizeInBytes;
+    }
+  }
+}
+} // namespace gims
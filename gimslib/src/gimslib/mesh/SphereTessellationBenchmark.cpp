@@ -0,0 +1,368 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/mesh/SphereTessellationBenchmark.hpp>
+#include <gimslib/mesh/SubdividedOctasphere.hpp>
+#include <gimslib/sys/ParallelFor.hpp>
+#include <limits>
+#include <vector>
+
+namespace gims
+{
+namespace
+{
+//! Quads per side of the patches of the UV sphere and of the tiles of the octasphere.
+constexpr ui32 TILE_SIZE              = 10;
+constexpr ui32 MESHLET_MAX_VERTICES   = 128;
+constexpr ui32 MESHLET_MAX_TRIANGLES  = 256;
+//! Samples per triangle for the RMS deviation are the centroids of its subdivision into SAMPLE_LEVELS^2 triangles.
+constexpr ui32 SAMPLE_LEVELS          = 4;
+constexpr f64  DEGENERATE_AREA        = 1e-6;
+constexpr f64  MIN_GENERATION_SECONDS = 0.05;
+
+struct SphereMesh
+{
+  std::vector<f32v3>  positions;
+  std::vector<ui32v3> indices;
+};
+
+//! Calls function(x, y, quad) for the quads of an numQuads x numQuads grid, tile by tile, where quad counts the quads
+//! in this order. Each row of tiles is a task on all hardware threads.
+template<class Function> void forEachQuadByTiles(ui32 numQuads, Function&& function)
+{
+  parallelFor((numQuads + TILE_SIZE - 1) / TILE_SIZE,
+              [&](size_t task)
+              {
+                const ui32 tileY = static_cast<ui32>(task) * TILE_SIZE;
+                ui32       quad  = tileY * numQuads;
+                for (ui32 tileX = 0; tileX < numQuads; tileX += TILE_SIZE)
+                {
+                  for (ui32 y = tileY; y < std::min(tileY + TILE_SIZE, numQuads); y++)
+                  {
+                    for (ui32 x = tileX; x < std::min(tileX + TILE_SIZE, numQuads); x++)
+                    {
+                      function(x, y, quad++);
+                    }
+                  }
+                }
+              });
+}
+
+//! Calls function(x, y) for the vertices of an n x n grid, one row per task on all hardware threads.
+template<class Function> void forEachVertex(ui32 n, Function&& function)
+{
+  parallelFor(n,
+              [&](size_t y)
+              {
+                for (ui32 x = 0; x < n; x++)
+                {
+                  function(x, static_cast<ui32>(y));
+                }
+              });
+}
+
+//! Sphere.hlsl with radius 1 and interSphereLOD = numQuads / TILE_SIZE, with the patches merged.
+SphereMesh tessellateUVSphere(ui32 numQuads)
+{
+  SphereMesh result;
+  result.positions.resize((numQuads + 1) * (numQuads + 1));
+  result.indices.resize(2 * numQuads * numQuads);
+  const f32 lastIndex = static_cast<f32>(numQuads);
+  forEachVertex(numQuads + 1,
+                [&](ui32 x, ui32 y)
+                {
+                  const f32 lon = static_cast<f32>(y) / lastIndex * glm::pi<f32>();
+                  const f32 lat = static_cast<f32>(x) / lastIndex * 2.0f * glm::pi<f32>();
+                  result.positions[x + y * (numQuads + 1)] =
+                      f32v3(std::sin(lon) * std::cos(lat), std::sin(lon) * std::sin(lat), std::cos(lon));
+                });
+  forEachQuadByTiles(numQuads,
+                     [&](ui32 x, ui32 y, ui32 quad)
+                     {
+                       const ui32 first             = x + y * (numQuads + 1);
+                       const ui32 second            = first + 1;
+                       const ui32 third             = first + numQuads + 1;
+                       const ui32 fourth            = second + numQuads + 1;
+                       result.indices[2 * quad]     = ui32v3(first, fourth, second);
+                       result.indices[2 * quad + 1] = ui32v3(fourth, first, third);
+                     });
+  return result;
+}
+
+//! The n x n grid of FruitTopologyTables on the unit sphere.
+SphereMesh tessellateOctasphere(ui32 n)
+{
+  SphereMesh result;
+  result.positions.resize(n * n);
+  result.indices.resize(2 * (n - 1) * (n - 1));
+  const f32 lastIndex = static_cast<f32>(n - 1);
+  forEachVertex(n,
+                [&](ui32 x, ui32 y)
+                {
+                  result.positions[y * n + x] = octDecode(
+                      f32v2(static_cast<f32>(2 * x) / lastIndex - 1.0f, static_cast<f32>(2 * y) / lastIndex - 1.0f));
+                });
+  const ui32 half = n / 2;
+  forEachQuadByTiles(n - 1,
+                     [&](ui32 x, ui32 y, ui32 quad)
+                     {
+                       const ui32 current     = y * n + x;
+                       const ui32 right       = current + 1;
+                       const ui32 bottom      = current + n;
+                       const ui32 bottomRight = bottom + 1;
+                       if ((x < half && y < half) || (x >= half && y >= half))
+                       {
+                         result.indices[2 * quad]     = ui32v3(current, right, bottom);
+                         result.indices[2 * quad + 1] = ui32v3(right, bottomRight, bottom);
+                       }
+                       else
+                       {
+                         result.indices[2 * quad]     = ui32v3(current, right, bottomRight);
+                         result.indices[2 * quad + 1] = ui32v3(bottomRight, bottom, current);
+                       }
+                     });
+  return result;
+}
+
+SphereMesh tessellate(SphereTessellation tessellation, ui32 resolution)
+{
+  switch (tessellation)
+  {
+  case SphereTessellation::UVSphere:
+    return tessellateUVSphere(resolution);
+  case SphereTessellation::Octasphere:
+    return tessellateOctasphere(resolution);
+  default:
+  {
+    SubdividedOctasphere octasphere = subdivideOctasphere(resolution);
+    return {std::move(octasphere.positions), std::move(octasphere.indices)};
+  }
+  }
+}
+
+ui32 getResolution(SphereTessellation tessellation, size_t numTriangles)
+{
+  const f64 triangles = static_cast<f64>(std::max<size_t>(numTriangles, 1));
+  switch (tessellation)
+  {
+  case SphereTessellation::UVSphere:
+    // 2 L^2 triangles.
+    return TILE_SIZE *
+           std::max(1u, static_cast<ui32>(std::round(std::sqrt(triangles / (2.0 * TILE_SIZE * TILE_SIZE)))));
+  case SphereTessellation::Octasphere:
+    // 2 (n - 1)^2 triangles, n odd.
+    return 2 * std::max(1u, static_cast<ui32>(std::round(std::sqrt(triangles / 8.0)))) + 1;
+  default:
+    // 8 * 4^depth triangles.
+    return std::min(static_cast<ui32>(std::max(0.0, std::round(std::log2(triangles / 8.0) / 2.0))),
+                    SubdividedOctasphere::MAX_DEPTH);
+  }
+}
+
+//! The point of the triangle closest to the origin, after Ericson, Real-Time Collision Detection, 5.1.5.
+f64v3 getClosestPointToOrigin(const f64v3& a, const f64v3& b, const f64v3& c)
+{
+  const f64v3 ab = b - a;
+  const f64v3 ac = c - a;
+  const f64v3 ap = -a;
+  const f64   d1 = glm::dot(ab, ap);
+  const f64   d2 = glm::dot(ac, ap);
+  if (d1 <= 0.0 && d2 <= 0.0)
+  {
+    return a;
+  }
+  const f64v3 bp = -b;
+  const f64   d3 = glm::dot(ab, bp);
+  const f64   d4 = glm::dot(ac, bp);
+  if (d3 >= 0.0 && d4 <= d3)
+  {
+    return b;
+  }
+  const f64 vc = d1 * d4 - d3 * d2;
+  if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+  {
+    return a + d1 / (d1 - d3) * ab;
+  }
+  const f64v3 cp = -c;
+  const f64   d5 = glm::dot(ab, cp);
+  const f64   d6 = glm::dot(ac, cp);
+  if (d6 >= 0.0 && d5 <= d6)
+  {
+    return c;
+  }
+  const f64 vb = d5 * d2 - d1 * d6;
+  if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+  {
+    return a + d2 / (d2 - d6) * ac;
+  }
+  const f64 va = d4 * d5 - d3 * d6;
+  if (va <= 0.0 && d4 - d3 >= 0.0 && d5 - d6 >= 0.0)
+  {
+    return b + (d4 - d3) / ((d4 - d3) + (d5 - d6)) * (c - b);
+  }
+  const f64 denominator = 1.0 / (va + vb + vc);
+  return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+//! Mean of (1 - |p|)^2 over the triangle.
+f64 getMeanSquaredDeviation(const f64v3& a, const f64v3& b, const f64v3& c)
+{
+  constexpr f64 INVERSE_LEVELS = 1.0 / SAMPLE_LEVELS;
+  f64           sum            = 0.0;
+  const auto    addSample      = [&](f64 u, f64 v)
+  {
+    const f64 deviation = 1.0 - glm::length(a + u * INVERSE_LEVELS * (b - a) + v * INVERSE_LEVELS * (c - a));
+    sum += deviation * deviation;
+  };
+  for (ui32 i = 0; i < SAMPLE_LEVELS; i++)
+  {
+    for (ui32 j = 0; i + j < SAMPLE_LEVELS; j++)
+    {
+      addSample(i + 1.0 / 3.0, j + 1.0 / 3.0);
+      if (i + j + 1 < SAMPLE_LEVELS)
+      {
+        addSample(i + 2.0 / 3.0, j + 2.0 / 3.0);
+      }
+    }
+  }
+  return sum / (SAMPLE_LEVELS * SAMPLE_LEVELS);
+}
+
+//! Vertices emitted by meshlets of consecutive triangles.
+size_t countMeshletVertices(const SphereMesh& mesh)
+{
+  constexpr ui32    NONE = std::numeric_limits<ui32>::max();
+  // The last meshlet that emitted each vertex.
+  std::vector<ui32> meshlets(mesh.positions.size(), NONE);
+  ui32              meshlet          = 0;
+  ui32              meshletVertices  = 0;
+  ui32              meshletTriangles = 0;
+  size_t            result           = 0;
+  for (const ui32v3& triangle : mesh.indices)
+  {
+    ui32 newVertices = 0;
+    for (ui32 corner = 0; corner < 3; corner++)
+    {
+      newVertices += meshlets[triangle[corner]] != meshlet ? 1 : 0;
+    }
+    if (meshletVertices + newVertices > MESHLET_MAX_VERTICES || meshletTriangles == MESHLET_MAX_TRIANGLES)
+    {
+      meshlet++;
+      meshletVertices  = 0;
+      meshletTriangles = 0;
+      newVertices      = 3;
+    }
+    for (ui32 corner = 0; corner < 3; corner++)
+    {
+      meshlets[triangle[corner]] = meshlet;
+    }
+    meshletVertices += newVertices;
+    meshletTriangles++;
+    result += newVertices;
+  }
+  return result;
+}
+} // namespace
+
+const char* getSphereTessellationName(SphereTessellation tessellation)
+{
+  switch (tessellation)
+  {
+  case SphereTessellation::UVSphere:
+    return "UV sphere";
+  case SphereTessellation::Octasphere:
+    return "Octasphere";
+  default:
+    return "Subdivided octasphere";
+  }
+}
+
+SphereTessellationBenchmark benchmarkSphereTessellation(SphereTessellation tessellation, size_t numTriangles)
+{
+  SphereTessellationBenchmark benchmark;
+  benchmark.tessellation = tessellation;
+  benchmark.resolution   = getResolution(tessellation, numTriangles);
+
+  SphereMesh                 mesh;
+  size_t                     numRuns  = 0;
+  const auto                 start    = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<f64> duration = {};
+  do
+  {
+    mesh = tessellate(tessellation, benchmark.resolution);
+    numRuns++;
+    duration = std::chrono::high_resolution_clock::now() - start;
+  } while (duration.count() < MIN_GENERATION_SECONDS);
+  benchmark.numVertices        = mesh.positions.size();
+  benchmark.numTriangles       = mesh.indices.size();
+  benchmark.trianglesPerSecond = static_cast<f64>(numRuns * benchmark.numTriangles) / duration.count();
+
+  std::vector<f64> areas(mesh.indices.size());
+  std::vector<f64> shapeQualities(mesh.indices.size());
+  f64              maxDeviation = 0.0;
+  f64              sumSquared   = 0.0;
+  f64              totalArea    = 0.0;
+  for (size_t t = 0; t < mesh.indices.size(); t++)
+  {
+    const f64v3 a = f64v3(mesh.positions[mesh.indices[t].x]);
+    const f64v3 b = f64v3(mesh.positions[mesh.indices[t].y]);
+    const f64v3 c = f64v3(mesh.positions[mesh.indices[t].z]);
+
+    areas[t] = 0.5 * glm::length(glm::cross(b - a, c - a));
+    const f64 sumSquaredEdges = glm::dot(b - a, b - a) + glm::dot(c - b, c - b) + glm::dot(a - c, a - c);
+    shapeQualities[t]         = sumSquaredEdges > 0.0 ? 4.0 * std::sqrt(3.0) * areas[t] / sumSquaredEdges : 0.0;
+
+    maxDeviation = std::max(maxDeviation, 1.0 - glm::length(getClosestPointToOrigin(a, b, c)));
+    for (const f64v3& vertex : {a, b, c})
+    {
+      maxDeviation = std::max(maxDeviation, std::abs(glm::length(vertex) - 1.0));
+    }
+    sumSquared += areas[t] * getMeanSquaredDeviation(a, b, c);
+    totalArea += areas[t];
+  }
+  benchmark.maxDeviation = static_cast<f32>(maxDeviation);
+  benchmark.rmsDeviation = static_cast<f32>(std::sqrt(sumSquared / std::max(totalArea, 1e-300)));
+
+  const f64 meanArea       = totalArea / static_cast<f64>(std::max<size_t>(mesh.indices.size(), 1));
+  f64       minArea        = std::numeric_limits<f64>::max();
+  f64       maxArea        = 0.0;
+  f64       minShape       = std::numeric_limits<f64>::max();
+  f64       sumShape       = 0.0;
+  f64       sumArea        = 0.0;
+  f64       sumAreaSquared = 0.0;
+  for (size_t t = 0; t < mesh.indices.size(); t++)
+  {
+    if (areas[t] < DEGENERATE_AREA * meanArea)
+    {
+      benchmark.numDegenerateTriangles++;
+      continue;
+    }
+    minArea  = std::min(minArea, areas[t]);
+    maxArea  = std::max(maxArea, areas[t]);
+    minShape = std::min(minShape, shapeQualities[t]);
+    sumShape += shapeQualities[t];
+    sumArea += areas[t];
+    sumAreaSquared += areas[t] * areas[t];
+  }
+  const size_t numValid = benchmark.numTriangles - benchmark.numDegenerateTriangles;
+  if (numValid > 0)
+  {
+    const f64 validMeanArea    = sumArea / static_cast<f64>(numValid);
+    const f64 areaVariance     = sumAreaSquared / static_cast<f64>(numValid) - validMeanArea * validMeanArea;
+    benchmark.minMaxAreaRatio  = static_cast<f32>(minArea / maxArea);
+    benchmark.areaVariation    = static_cast<f32>(std::sqrt(std::max(areaVariance, 0.0)) / validMeanArea);
+    benchmark.minShapeQuality  = static_cast<f32>(minShape);
+    benchmark.meanShapeQuality = static_cast<f32>(sumShape / static_cast<f64>(numValid));
+  }
+
+  if (benchmark.numTriangles > 0)
+  {
+    benchmark.verticesPerTriangle =
+        static_cast<f32>(static_cast<f64>(benchmark.numVertices) / static_cast<f64>(benchmark.numTriangles));
+    benchmark.meshletVerticesPerTriangle =
+        static_cast<f32>(static_cast<f64>(countMeshletVertices(mesh)) / static_cast<f64>(benchmark.numTriangles));
+  }
+  return benchmark;
+}
+} // namespace gims
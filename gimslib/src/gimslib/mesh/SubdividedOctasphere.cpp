@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <gimslib/mesh/SubdividedOctasphere.hpp>
+#include <gimslib/sys/ParallelFor.hpp>
+#include <limits>
+#include <stdexcept>
+
+namespace gims
+{
+namespace
+{
+//! Large enough that parallelFor hands out a reasonable amount of work per call.
+constexpr size_t ELEMENTS_PER_TASK = 16384;
+
+//! Edges of a triangle (v0, v1, v2) are (v0, v1), (v1, v2) and (v2, v0).
+struct Triangle
+{
+  ui32v3 vertices;
+  ui32v3 edges;
+};
+
+template<class Function> void parallelForBlocks(size_t count, Function&& function)
+{
+  parallelFor((count + ELEMENTS_PER_TASK - 1) / ELEMENTS_PER_TASK,
+              [&](size_t task)
+              {
+                const size_t first = task * ELEMENTS_PER_TASK;
+                for (size_t i = first; i < std::min(first + ELEMENTS_PER_TASK, count); i++)
+                {
+                  function(i);
+                }
+              });
+}
+
+//! The half of the split edge e of the previous level that ends at the vertex.
+ui32 getHalfEdge(const std::vector<ui32v2>& edges, ui32 e, ui32 vertex)
+{
+  return edges[e].x == vertex ? 2 * e : 2 * e + 1;
+}
+} // namespace
+
+SubdividedOctasphere subdivideOctasphere(ui32 depth)
+{
+  if (depth > SubdividedOctasphere::MAX_DEPTH)
+  {
+    throw std::invalid_argument("The subdivision depth exceeds SubdividedOctasphere::MAX_DEPTH.");
+  }
+
+  std::vector<f32v3>    positions = {f32v3(1.0f, 0.0f, 0.0f),  f32v3(-1.0f, 0.0f, 0.0f), f32v3(0.0f, 1.0f, 0.0f),
+                                     f32v3(0.0f, -1.0f, 0.0f), f32v3(0.0f, 0.0f, 1.0f),  f32v3(0.0f, 0.0f, -1.0f)};
+  std::vector<ui32v2>   edges     = {{0, 2}, {2, 4}, {4, 0}, {2, 1}, {1, 4}, {1, 3}, {3, 4}, {3, 0},
+                                     {5, 2}, {0, 5}, {5, 1}, {5, 3}};
+  std::vector<Triangle> triangles = {
+      {{0, 2, 4}, {0, 1, 2}},   {{2, 1, 4}, {3, 4, 1}}, {{1, 3, 4}, {5, 6, 4}},   {{3, 0, 4}, {7, 2, 6}},
+      {{2, 0, 5}, {0, 9, 8}},   {{1, 2, 5}, {3, 8, 10}}, {{3, 1, 5}, {5, 10, 11}}, {{0, 3, 5}, {7, 11, 9}}};
+
+  for (ui32 level = 0; level < depth; level++)
+  {
+    const ui32 numVertices  = static_cast<ui32>(positions.size());
+    const ui32 numEdges     = static_cast<ui32>(edges.size());
+    const ui32 numTriangles = static_cast<ui32>(triangles.size());
+    // The last level needs no edges.
+    const bool splitEdges = level + 1 < depth;
+
+    std::vector<ui32v2>   nextEdges(splitEdges ? 2 * numEdges + 3 * numTriangles : 0);
+    std::vector<Triangle> nextTriangles(4 * numTriangles);
+    positions.resize(numVertices + numEdges);
+    parallelForBlocks(numEdges,
+                      [&](size_t i)
+                      {
+                        const ui32    e        = static_cast<ui32>(i);
+                        const ui32v2& edge     = edges[e];
+                        const ui32    midpoint = numVertices + e;
+                        positions[midpoint]    = glm::normalize(0.5f * (positions[edge.x] + positions[edge.y]));
+                        if (splitEdges)
+                        {
+                          nextEdges[2 * e]     = ui32v2(edge.x, midpoint);
+                          nextEdges[2 * e + 1] = ui32v2(midpoint, edge.y);
+                        }
+                      });
+    parallelForBlocks(numTriangles,
+                      [&](size_t i)
+                      {
+                        const ui32      t  = static_cast<ui32>(i);
+                        const Triangle& tr = triangles[t];
+                        const ui32      a  = tr.vertices.x;
+                        const ui32      b  = tr.vertices.y;
+                        const ui32      c  = tr.vertices.z;
+                        const ui32      ab = numVertices + tr.edges.x;
+                        const ui32      bc = numVertices + tr.edges.y;
+                        const ui32      ca = numVertices + tr.edges.z;
+                        nextTriangles[4 * t].vertices     = ui32v3(a, ab, ca);
+                        nextTriangles[4 * t + 1].vertices = ui32v3(ab, b, bc);
+                        nextTriangles[4 * t + 2].vertices = ui32v3(ca, bc, c);
+                        nextTriangles[4 * t + 3].vertices = ui32v3(ab, bc, ca);
+                        if (!splitEdges)
+                        {
+                          return;
+                        }
+
+                        // The interior edges (ab, bc), (bc, ca) and (ca, ab).
+                        const ui32 interior     = 2 * numEdges + 3 * t;
+                        nextEdges[interior]     = ui32v2(ab, bc);
+                        nextEdges[interior + 1] = ui32v2(bc, ca);
+                        nextEdges[interior + 2] = ui32v2(ca, ab);
+                        nextTriangles[4 * t].edges =
+                            ui32v3(getHalfEdge(edges, tr.edges.x, a), interior + 2, getHalfEdge(edges, tr.edges.z, a));
+                        nextTriangles[4 * t + 1].edges =
+                            ui32v3(getHalfEdge(edges, tr.edges.x, b), getHalfEdge(edges, tr.edges.y, b), interior);
+                        nextTriangles[4 * t + 2].edges =
+                            ui32v3(interior + 1, getHalfEdge(edges, tr.edges.y, c), getHalfEdge(edges, tr.edges.z, c));
+                        nextTriangles[4 * t + 3].edges = ui32v3(interior, interior + 1, interior + 2);
+                      });
+    edges.swap(nextEdges);
+    triangles.swap(nextTriangles);
+  }
+
+  // Renumber the vertices in the order of their first use.
+  constexpr ui32    UNUSED = std::numeric_limits<ui32>::max();
+  std::vector<ui32> newIndices(positions.size(), UNUSED);
+  ui32              numUsed = 0;
+  for (const Triangle& triangle : triangles)
+  {
+    for (ui32 corner = 0; corner < 3; corner++)
+    {
+      ui32& newIndex = newIndices[triangle.vertices[corner]];
+      if (newIndex == UNUSED)
+      {
+        newIndex = numUsed++;
+      }
+    }
+  }
+
+  SubdividedOctasphere result;
+  result.positions.resize(positions.size());
+  result.indices.resize(triangles.size());
+  parallelForBlocks(positions.size(), [&](size_t i) { result.positions[newIndices[i]] = positions[i]; });
+  parallelForBlocks(triangles.size(),
+                    [&](size_t i)
+                    {
+                      const ui32v3& vertices = triangles[i].vertices;
+                      result.indices[i] =
+                          ui32v3(newIndices[vertices.x], newIndices[vertices.y], newIndices[vertices.z]);
+                    });
+  return result;
+}
+
+CograBinaryMeshFile toCograBinaryMeshFile(const SubdividedOctasphere& octasphere, ui32 depth)
+{
+  static_assert(sizeof(f32v3) == 3 * sizeof(CograBinaryMeshFile::FloatType));
+  static_assert(sizeof(ui32v3) == 3 * sizeof(CograBinaryMeshFile::IndexType));
+
+  CograBinaryMeshFile result;
+  result.setPositions(&octasphere.positions.data()->x,
+                      static_cast<CograBinaryMeshFile::SizeType>(octasphere.positions.size()));
+  result.setTriangleIndices(&octasphere.indices.data()->x,
+                            static_cast<CograBinaryMeshFile::SizeType>(octasphere.indices.size()));
+  const int subdivisionDepth = static_cast<int>(depth);
+  result.addConstant(&subdivisionDepth, 1, sizeof(int), "subdivisionDepth");
+  return result;
+}
+} // namespace gims
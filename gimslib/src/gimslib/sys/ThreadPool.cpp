@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <gimslib/sys/ThreadPool.hpp>
+
+namespace
+{
+// Set while the thread works on a task, so that nested run()s execute serially.
+thread_local bool t_isInTask = false;
+} // namespace
+
+namespace gims
+{
+ThreadPool& ThreadPool::getDefault()
+{
+  static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+  return pool;
+}
+
+ThreadPool::ThreadPool(ui32 numThreads)
+{
+  m_workers.reserve(std::max(numThreads, 1u) - 1);
+  for (ui32 i = 1; i < numThreads; i++)
+  {
+    m_workers.emplace_back([this]() { workerMain(); });
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_wakeUp.notify_all();
+  for (auto& worker : m_workers)
+  {
+    worker.join();
+  }
+}
+
+ui32 ThreadPool::getNumThreads() const
+{
+  return static_cast<ui32>(m_workers.size()) + 1;
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t)>& function)
+{
+  if (count == 0)
+  {
+    return;
+  }
+  Task task;
+  task.function = &function;
+  task.count    = count;
+  if (t_isInTask || m_workers.empty() || count == 1)
+  {
+    work(task);
+  }
+  else
+  {
+    std::lock_guard<std::mutex> runLock(m_runMutex);
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_task = &task;
+      m_generation++;
+    }
+    m_wakeUp.notify_all();
+    work(task);
+
+    // Workers join the task only while m_task points to it, so none can start on it after this.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this]() { return m_activeWorkers == 0; });
+    m_task = nullptr;
+  }
+  if (task.firstException)
+  {
+    std::rethrow_exception(task.firstException);
+  }
+}
+
+void ThreadPool::work(Task& task)
+{
+  const bool wasInTask = t_isInTask;
+  t_isInTask           = true;
+  for (size_t i = task.next.fetch_add(1); i < task.count; i = task.next.fetch_add(1))
+  {
+    try
+    {
+      (*task.function)(i);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(task.exceptionMutex);
+      if (!task.firstException)
+      {
+        task.firstException = std::current_exception();
+      }
+      task.next.store(task.count);
+    }
+  }
+  t_isInTask = wasInTask;
+}
+
+void ThreadPool::workerMain()
+{
+  ui64                         generation = 0;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true)
+  {
+    m_wakeUp.wait(lock, [&]() { return m_stop || m_generation != generation; });
+    if (m_stop)
+    {
+      return;
+    }
+    generation = m_generation;
+    if (m_task == nullptr)
+    {
+      continue;
+    }
+    Task& task = *m_task;
+    m_activeWorkers++;
+    lock.unlock();
+    work(task);
+    lock.lock();
+    m_activeWorkers--;
+    if (m_activeWorkers == 0)
+    {
+      m_finished.notify_all();
+    }
+  }
+}
+} // namespace gims
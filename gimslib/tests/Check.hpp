@@ -0,0 +1,67 @@
+#pragma once
+#include <iostream>
+
+//! \file
+//! Minimal checks for the gimslib tests. Each test is an executable whose main() runs CHECKs and returns
+//! gims::finishChecks(), so CTest reports a test as failed if any of its checks failed.
+
+namespace gims
+{
+//! \brief Returns the number of failed checks so far.
+inline int& getNumFailedChecks()
+{
+  static int numFailedChecks = 0;
+  return numFailedChecks;
+}
+
+//! \brief Records and prints a failed check.
+inline void failCheck(const char* expression, const char* file, int line)
+{
+  getNumFailedChecks()++;
+  std::cerr << file << "(" << line << "): check failed: " << expression << std::endl;
+}
+
+//! \brief Prints a summary and returns the exit code of the test, 0 if all checks passed.
+inline int finishChecks()
+{
+  if (getNumFailedChecks() > 0)
+  {
+    std::cerr << getNumFailedChecks() << " check(s) failed." << std::endl;
+    return 1;
+  }
+  std::cout << "All checks passed." << std::endl;
+  return 0;
+}
+} // namespace gims
+
+//! Fails if condition is false. Execution continues, so one run reports all failures.
+#define CHECK(condition)                                                                                               \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    if (!(condition))                                                                                                  \
+    {                                                                                                                  \
+      gims::failCheck(#condition, __FILE__, __LINE__);                                                                 \
+    }                                                                                                                  \
+  } while (false)
+
+//! Fails unless expression throws an ExceptionType.
+#define CHECK_THROWS(expression, ExceptionType)                                                                        \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    bool thrown = false;                                                                                               \
+    try                                                                                                                \
+    {                                                                                                                  \
+      (void)(expression);                                                                                              \
+    }                                                                                                                  \
+    catch (const ExceptionType&)                                                                                       \
+    {                                                                                                                  \
+      thrown = true;                                                                                                   \
+    }                                                                                                                  \
+    catch (...)                                                                                                        \
+    {                                                                                                                  \
+    }                                                                                                                  \
+    if (!thrown)                                                                                                       \
+    {                                                                                                                  \
+      gims::failCheck(#expression " throws " #ExceptionType, __FILE__, __LINE__);                                      \
+    }                                                                                                                  \
+  } while (false)
@@ -0,0 +1,92 @@
+#include "Check.hpp"
+#include <cmath>
+#include <gimslib/fruit/FruitCompactOutput.hpp>
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <random>
+
+using namespace gims;
+
+namespace
+{
+// The projection of the fruit renderers at 1920 x 1080.
+const f32v2 VIEWPORT_SIZE(1920.0f, 1080.0f);
+const f32m4 PROJECTION =
+    glm::perspectiveFovLH_ZO<f32>(glm::radians(45.0f), VIEWPORT_SIZE.x, VIEWPORT_SIZE.y, 0.0001f, 10000.0f);
+
+f32 getAngle(const f32v3& a, const f32v3& b)
+{
+  return std::atan2(glm::length(glm::cross(a, b)), glm::dot(a, b));
+}
+
+// octDecode() returns unit directions, octEncode() parameters in [-1;1]^2, and both invert each other: directions
+// round trip everywhere, parameters except on the folds of the lower hemisphere, where both sides decode to the same
+// direction.
+void checkRoundTrip()
+{
+  std::mt19937                        random(5);
+  std::uniform_real_distribution<f32> uniform(-1.0f, 1.0f);
+  for (ui32 i = 0; i < 100000; i++)
+  {
+    const f32v3 direction = glm::normalize(f32v3(uniform(random), uniform(random), uniform(random)));
+    const f32v2 encoded   = octEncode(direction);
+    CHECK(std::abs(encoded.x) <= 1.0f && std::abs(encoded.y) <= 1.0f);
+    CHECK(getAngle(octDecode(encoded), direction) <= 1e-6f);
+
+    const f32v2 parameters(uniform(random), uniform(random));
+    const f32v3 decoded = octDecode(parameters);
+    CHECK(std::abs(glm::length(decoded) - 1.0f) <= 1e-6f);
+    if (std::abs(std::abs(parameters.x) + std::abs(parameters.y) - 1.0f) > 1e-3f &&
+        std::min(std::abs(parameters.x), std::abs(parameters.y)) > 1e-3f)
+    {
+      CHECK(glm::length(octEncode(decoded) - parameters) <= 1e-5f);
+    }
+  }
+
+  // The axes, including both poles.
+  for (const f32v3& axis : {f32v3(1.0f, 0.0f, 0.0f), f32v3(-1.0f, 0.0f, 0.0f), f32v3(0.0f, 1.0f, 0.0f),
+                            f32v3(0.0f, -1.0f, 0.0f), f32v3(0.0f, 0.0f, 1.0f), f32v3(0.0f, 0.0f, -1.0f)})
+  {
+    CHECK(glm::length(octDecode(octEncode(axis)) - axis) <= 1e-6f);
+  }
+}
+
+// SV_POSITION of a view space position, as the rasterizer computes it.
+f32v4 project(const f32v3& viewSpacePosition)
+{
+  const f32v4 clipPosition = PROJECTION * f32v4(viewSpacePosition, 1.0f);
+  const f32v3 ndcPosition  = f32v3(clipPosition) / clipPosition.w;
+  return f32v4((0.5f * ndcPosition.x + 0.5f) * VIEWPORT_SIZE.x, (0.5f - 0.5f * ndcPosition.y) * VIEWPORT_SIZE.y,
+               ndcPosition.z, clipPosition.w);
+}
+
+// The reconstruction is limited by the precision of the depth, which shrinks with the distance: the relative error of
+// the position grows with the depth, while the view direction, which is all that the pixel shaders use, stays exact.
+void checkReconstruction()
+{
+  const f32m4 inverseProjection = glm::inverse(PROJECTION);
+  const f32v3 near(0.1f, -0.05f, 0.5f);
+  CHECK(glm::length(reconstructViewSpacePosition(project(near), inverseProjection, VIEWPORT_SIZE) - near) <= 1e-3f);
+
+  const FruitCompactOutputError close = measureFruitCompactOutputError(PROJECTION, VIEWPORT_SIZE, 0.5f, 50.0f, 10000);
+  CHECK(close.numSamples == 10000);
+  CHECK(close.maxDirectionError <= 1e-6f);
+  CHECK(close.maxPositionError <= 5e-2f);
+  CHECK(close.maxViewDirectionError <= 1e-6f);
+
+  // Ten times farther, the position is off by far more, and the view direction is still exact.
+  const FruitCompactOutputError far = measureFruitCompactOutputError(PROJECTION, VIEWPORT_SIZE, 5.0f, 500.0f, 10000);
+  CHECK(far.maxPositionError > 2.0f * close.maxPositionError);
+  CHECK(far.maxViewDirectionError <= 1e-6f);
+
+  // The difference of the interpolation domains documented next to FRUIT_COMPACT_OUTPUT, on the 3 x 3 grid.
+  CHECK(std::abs(close.maxInterpolationAngle - 0.053f) <= 0.001f);
+  CHECK(far.maxInterpolationAngle == close.maxInterpolationAngle);
+}
+} // namespace
+
+int main()
+{
+  checkRoundTrip();
+  checkReconstruction();
+  return finishChecks();
+}
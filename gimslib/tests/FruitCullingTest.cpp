@@ -0,0 +1,314 @@
+#include "Check.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <gimslib/fruit/FruitCulling.hpp>
+#include <gimslib/fruit/FruitGeomorph.hpp>
+#include <gimslib/fruit/FruitMeshCache.hpp>
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace gims;
+
+namespace
+{
+const f32m4 PROJECTION = glm::perspectiveFovLH_ZO<f32>(glm::radians(45.0f), 1280.0f, 720.0f, 0.01f, 100.0f);
+
+// A camera at distance 1.5 to 5.5 from the origin looking at a random point near it.
+f32m4 createRandomView(std::mt19937& random)
+{
+  std::uniform_real_distribution<f32> uniform(-1.0f, 1.0f);
+  const f32v3 direction = f32v3(uniform(random), uniform(random), uniform(random)) + f32v3(0.0f, 0.0f, 1e-3f);
+  const f32v3 eye       = glm::normalize(direction) * (3.5f + 2.0f * uniform(random));
+  const f32v3 target    = 0.5f * f32v3(uniform(random), uniform(random), uniform(random));
+  return glm::lookAtLH(eye, target, f32v3(0.0f, 1.0f, 0.0f));
+}
+
+FruitInstanceRecord createRandomInstance(std::mt19937& random)
+{
+  std::uniform_real_distribution<f32> uniform(-1.0f, 1.0f);
+  FruitInstanceRecord                 instance = {};
+  instance.rotation = glm::normalize(f32v4(uniform(random), uniform(random), uniform(random), uniform(random)));
+  instance.position = 0.3f * f32v3(uniform(random), uniform(random), uniform(random));
+  return instance;
+}
+
+// View space position of an object space point of the instance, in double precision.
+glm::dvec3 toView(const f32m4& view, const FruitInstanceRecord& instance, const f32v3& position)
+{
+  const glm::dvec3 q(instance.rotation.x, instance.rotation.y, instance.rotation.z);
+  const glm::dvec3 p(position);
+  const f64        w     = instance.rotation.w;
+  const glm::dvec3 world = p + 2.0 * glm::cross(q, glm::cross(q, p) + w * p) + glm::dvec3(instance.position);
+  return glm::dvec3(glm::dmat4(view) * glm::dvec4(world, 1.0));
+}
+
+// The tile spheres contain the vertices of tessellateFruit(), also those of all morph edges of geomorphed grids.
+void checkTileSpheres(const FruitProfile& profile, ui32 gridSize, bool geomorphed)
+{
+  const FruitTiling                        tiling   = planFruitTiling(gridSize);
+  const std::vector<FruitTileBoundsRecord> bounds   = computeFruitTileBounds(profile, tiling, geomorphed);
+  const std::vector<FruitMeshlet>          meshlets = buildFruitMeshlets(tiling);
+  const FruitMesh                          mesh     = tessellateFruit(profile, gridSize);
+  CHECK(bounds.size() == tiling.getNumTiles());
+  for (size_t t = 0; t < bounds.size(); t++)
+  {
+    const FruitTileBoundsRecord& tile = bounds[t];
+    CHECK(geomorphed ? tile.coneCutoff == FruitTileBoundsRecord::NO_CONE : tile.coneCutoff <= 1.0f);
+    for (const ui32 v : meshlets[t].vertices)
+    {
+      std::vector<ui32> hull = {v};
+      if (geomorphed)
+      {
+        const FruitMorphEdge edge = getFruitMorphEdge(gridSize, v % gridSize, v / gridSize);
+        hull.push_back(edge.first.y * gridSize + edge.first.x);
+        hull.push_back(edge.second.y * gridSize + edge.second.x);
+      }
+      for (const ui32 h : hull)
+      {
+        CHECK(glm::length(mesh.positions[h] - tile.center) <= tile.radius);
+      }
+    }
+  }
+}
+
+// The batch tests agree with the scalar ones, also in partial LaneBlocks, and write only their range.
+void checkBatches()
+{
+  std::mt19937                        random(1);
+  std::uniform_real_distribution<f32> uniform(-1.0f, 1.0f);
+  const FruitCuller                   culler(createRandomView(random), PROJECTION);
+
+  FruitBoundingSphereArray spheres;
+  spheres.resize(61);
+  for (size_t i = 0; i < spheres.getSize(); i++)
+  {
+    spheres.centerX[i] = 3.0f * uniform(random);
+    spheres.centerY[i] = 3.0f * uniform(random);
+    spheres.centerZ[i] = 3.0f * uniform(random);
+    spheres.radius[i]  = 0.5f * (uniform(random) + 1.0f);
+  }
+  const FruitInstanceRecord                instance = createRandomInstance(random);
+  const std::vector<FruitTileBoundsRecord> bounds =
+      computeFruitTileBounds(getFruitPreset(FruitType::Pear).profile, planFruitTiling(61));
+
+  for (const size_t first : {0, 3, 8})
+  {
+    for (const size_t last : {first, first + 1, first + 7, size_t(40), size_t(61)})
+    {
+      std::vector<ui8> visible(61, 2);
+      culler.cullSpheres(spheres, first, last, visible.data());
+      for (size_t i = 0; i < visible.size(); i++)
+      {
+        const f32v3 center(spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i]);
+        CHECK(visible[i] == (i < first || i >= last ? 2 : culler.isSphereVisible(center, spheres.radius[i])));
+      }
+
+      std::fill(visible.begin(), visible.end(), ui8(2));
+      culler.cullTiles(instance, bounds.data(), first, last, visible.data());
+      for (size_t i = 0; i < visible.size(); i++)
+      {
+        CHECK(visible[i] == (i < first || i >= last ? 2 : culler.isTileVisible(instance, bounds[i])));
+      }
+    }
+  }
+}
+
+// Culled tiles have all vertices outside one frustum plane or all triangles facing away from the camera, for random
+// cameras and poses. Returns the number of culled tiles.
+size_t checkConservative(const FruitProfile& profile, ui32 gridSize)
+{
+  const FruitTiling                        tiling   = planFruitTiling(gridSize);
+  const std::vector<FruitTileBoundsRecord> bounds   = computeFruitTileBounds(profile, tiling);
+  const std::vector<FruitMeshlet>          meshlets = buildFruitMeshlets(tiling);
+  const FruitMesh                          mesh     = tessellateFruit(profile, gridSize);
+
+  std::mt19937 random(gridSize);
+  size_t       numCulled = 0;
+  for (ui32 trial = 0; trial < 100; trial++)
+  {
+    const f32m4               view     = createRandomView(random);
+    const FruitCuller         culler(view, PROJECTION);
+    const FruitInstanceRecord instance = createRandomInstance(random);
+    std::vector<ui8>          visible(bounds.size());
+    culler.cullTiles(instance, bounds.data(), 0, bounds.size(), visible.data());
+    for (size_t t = 0; t < bounds.size(); t++)
+    {
+      if (visible[t])
+      {
+        continue;
+      }
+      numCulled++;
+      const FruitMeshlet&     meshlet = meshlets[t];
+      std::vector<glm::dvec3> positions;
+      for (const ui32 v : meshlet.vertices)
+      {
+        positions.push_back(toView(view, instance, mesh.positions[v]));
+      }
+
+      bool outside = false;
+      for (ui32 i = 0; i < 6; i++)
+      {
+        const glm::dvec4 plane(culler.getPlane(i));
+        bool             allOutside = true;
+        for (const glm::dvec3& position : positions)
+        {
+          allOutside = allOutside && glm::dot(glm::dvec3(plane), position) + plane.w < 0.0;
+        }
+        outside = outside || allOutside;
+      }
+
+      // Outward normals point away from the camera at the origin, up to rounding for triangles seen edge-on.
+      bool backfacing = true;
+      for (const ui32v3& triangle : meshlet.triangles)
+      {
+        const glm::dvec3 a      = positions[triangle.x];
+        const glm::dvec3 normal = glm::cross(positions[triangle.y] - a, positions[triangle.z] - a);
+        backfacing              = backfacing && glm::dot(normal, a) >= -1e-9 * glm::length(normal) * glm::length(a);
+      }
+      CHECK(outside || backfacing);
+    }
+  }
+  return numCulled;
+}
+
+void checkTileBoundsBuilder()
+{
+  const FruitProfile apple = getFruitPreset(FruitType::Apple).profile;
+  const FruitProfile pear  = getFruitPreset(FruitType::Pear).profile;
+
+  FruitInstanceArray instances;
+  instances.resize(6);
+  const FruitProfile profiles[6] = {apple, apple, pear, apple, apple, pear};
+  for (size_t i = 0; i < 6; i++)
+  {
+    FruitInstance instance;
+    instance.profile = profiles[i];
+    instances.setInstance(i, instance);
+  }
+  std::vector<FruitInstanceLOD> lods = {{5, 99}, {5, 99}, {5, 99}, {9, 99}, {5, 99}, {6, 99}};
+
+  FruitTileBoundsBuilder        builder;
+  std::vector<FruitInstanceLOD> tooFew(5);
+  CHECK_THROWS(builder.update(instances, false, tooFew), std::invalid_argument);
+
+  // Grid 6 is not morphable and is never geomorphed.
+  builder.update(instances, true, lods);
+  CHECK(builder.getNumEntries() == 4);
+  const std::vector<FruitTileBoundsRecord> apple5 = computeFruitTileBounds(apple, planFruitTiling(5), true);
+  const std::vector<FruitTileBoundsRecord> pear5  = computeFruitTileBounds(pear, planFruitTiling(5), true);
+  const std::vector<FruitTileBoundsRecord> apple9 = computeFruitTileBounds(apple, planFruitTiling(9), true);
+  const std::vector<FruitTileBoundsRecord> pear6  = computeFruitTileBounds(pear, planFruitTiling(6), false);
+  const auto matches = [&](const FruitInstanceLOD& lod, const std::vector<FruitTileBoundsRecord>& expected)
+  {
+    const std::vector<FruitTileBoundsRecord>& bounds = builder.getBounds();
+    return lod.firstTileBounds + expected.size() <= bounds.size() &&
+           std::memcmp(bounds.data() + lod.firstTileBounds, expected.data(),
+                       expected.size() * sizeof(FruitTileBoundsRecord)) == 0;
+  };
+  CHECK(builder.getBounds().size() == apple5.size() + pear5.size() + apple9.size() + pear6.size());
+  CHECK(lods[0].firstTileBounds == 0 && lods[1].firstTileBounds == 0 && lods[4].firstTileBounds == 0);
+  CHECK(matches(lods[0], apple5) && matches(lods[2], pear5) && matches(lods[3], apple9) && matches(lods[5], pear6));
+
+  // Without geomorphing, the morphable grids get other bounds; unused ones are dropped.
+  lods = {{5, 99}, {5, 99}, {5, 99}, {5, 99}, {5, 99}, {5, 99}};
+  builder.update(instances, false, lods);
+  CHECK(builder.getNumEntries() == 2);
+  CHECK(matches(lods[0], computeFruitTileBounds(apple, planFruitTiling(5))));
+  CHECK(matches(lods[2], computeFruitTileBounds(pear, planFruitTiling(5))));
+  CHECK(lods[1].firstTileBounds == lods[0].firstTileBounds && lods[5].firstTileBounds == lods[2].firstTileBounds);
+
+  instances.resize(0);
+  lods.clear();
+  builder.update(instances, false, lods);
+  CHECK(builder.getBounds().empty() && builder.getNumEntries() == 0);
+}
+
+bool operator==(const FruitPrimitiveCullingStats& a, const FruitPrimitiveCullingStats& b)
+{
+  return a.numTriangles == b.numTriangles && a.numZeroArea == b.numZeroArea && a.numBackfacing == b.numBackfacing &&
+         a.numTooSmall == b.numTooSmall;
+}
+
+// Each instance counts with its own profile, grid, morph factor and position; only morphable grids are morphed.
+void checkPrimitiveCulling()
+{
+  const f32m4 view           = glm::lookAtLH(f32v3(0.0f, 0.0f, -4.0f), f32v3(0.0f), f32v3(0.0f, 1.0f, 0.0f));
+  const f32m4 viewProjection = PROJECTION * view;
+  const f32v2 viewportSize(1280.0f, 720.0f);
+
+  const FruitProfile profiles[4]  = {getFruitPreset(FruitType::Apple).profile, getFruitPreset(FruitType::Pear).profile,
+                                     getFruitPreset(FruitType::Pear).profile, getFruitPreset(FruitType::Lemon).profile};
+  const f32v3        positions[4] = {f32v3(-1.0f, 0.0f, 0.0f), f32v3(1.0f, 0.5f, 2.0f), f32v3(0.0f, 0.0f, 0.0f),
+                                     f32v3(0.0f, 0.0f, -8.0f)};
+  // Grid 6 is not morphable, so its morph factor is ignored.
+  std::vector<FruitInstanceLOD> lods = {{25, 0, 0.25f}, {9, 0, 0.5f}, {6, 0, 0.5f}, {17, 0, 0.0f}};
+
+  FruitInstanceArray instances;
+  instances.resize(4);
+  for (size_t i = 0; i < 4; i++)
+  {
+    FruitInstance instance;
+    instance.profile  = profiles[i];
+    instance.position = positions[i];
+    instances.setInstance(i, instance);
+  }
+
+  FruitPrimitiveCullingStats expected;
+  for (size_t i = 0; i < 4; i++)
+  {
+    const FruitMesh mesh = lods[i].morphFactor > 0.0f && isFruitGridMorphable(lods[i].gridSize)
+                               ? tessellateMorphedFruit(profiles[i], lods[i].gridSize, lods[i].morphFactor)
+                               : *FruitMeshCache::getDefault().getOrTessellate(profiles[i], lods[i].gridSize);
+    f32m4           world(1.0f);
+    world[3] = f32v4(positions[i], 1.0f);
+    emulateFruitPrimitiveCulling(mesh, viewProjection * world, viewportSize, expected);
+  }
+  FruitPrimitiveCullingStats stats;
+  emulateFruitPrimitiveCulling(instances, lods, viewProjection, viewportSize, stats);
+  CHECK(stats == expected);
+  CHECK(stats.numBackfacing > 0 && stats.getNumCulled() < stats.numTriangles);
+
+  // The lemon is behind the camera, where all triangles are kept.
+  FruitPrimitiveCullingStats inFront;
+  instances.resize(3);
+  emulateFruitPrimitiveCulling(instances, std::vector<FruitInstanceLOD>(lods.begin(), lods.begin() + 3),
+                               viewProjection, viewportSize, inFront);
+  CHECK(stats.numTriangles == inFront.numTriangles + 2 * 16 * 16);
+  CHECK(stats.getNumCulled() == inFront.getNumCulled());
+
+  CHECK_THROWS(emulateFruitPrimitiveCulling(instances, lods, viewProjection, viewportSize, stats),
+               std::invalid_argument);
+  lods.resize(3);
+  lods[1].morphFactor = 1.5f;
+  CHECK_THROWS(emulateFruitPrimitiveCulling(instances, lods, viewProjection, viewportSize, stats),
+               std::invalid_argument);
+}
+} // namespace
+
+int main()
+{
+  const FruitCuller culler(glm::lookAtLH(f32v3(0.0f, 0.0f, -5.0f), f32v3(0.0f), f32v3(0.0f, 1.0f, 0.0f)), PROJECTION);
+  CHECK(culler.isSphereVisible(f32v3(0.0f), 0.1f));
+  CHECK(!culler.isSphereVisible(f32v3(0.0f, 0.0f, -6.0f), 0.5f));
+  CHECK(culler.isSphereVisible(f32v3(0.0f, 0.0f, -6.0f), 1.5f));
+  CHECK(!culler.isSphereVisible(f32v3(100.0f, 0.0f, 0.0f), 1.0f));
+  CHECK(!culler.isSphereVisible(f32v3(0.0f, 0.0f, 200.0f), 1.0f));
+
+  for (const FruitType type : {FruitType::Apple, FruitType::Pear})
+  {
+    const FruitProfile& profile = getFruitPreset(type).profile;
+    checkTileSpheres(profile, 25, false);
+    checkTileSpheres(profile, 129, false);
+    checkTileSpheres(profile, 33, true);
+    CHECK(checkConservative(profile, 25) > 0);
+    CHECK(checkConservative(profile, 129) > 0);
+  }
+  checkBatches();
+  checkTileBoundsBuilder();
+  checkPrimitiveCulling();
+
+  return finishChecks();
+}
@@ -0,0 +1,154 @@
+#include "Check.hpp"
+#include <algorithm>
+#include <cmath>
+#include <gimslib/fruit/FruitDistanceField.hpp>
+#include <gimslib/fruit/FruitMeasures.hpp>
+#include <random>
+#include <vector>
+
+using namespace gims;
+
+namespace
+{
+constexpr ui32 NUM_REFERENCE_SEGMENTS = 4096;
+
+// The profile in the (r, z) half-plane, densely sampled in double precision.
+std::vector<f64v2> sampleProfile(const FruitProfile& profile)
+{
+  std::vector<f64v2> samples(NUM_REFERENCE_SEGMENTS + 1);
+  for (ui32 i = 0; i <= NUM_REFERENCE_SEGMENTS; i++)
+  {
+    const f64v3 point = evaluateCubicBezierCurve(profile, static_cast<f64>(i) / NUM_REFERENCE_SEGMENTS);
+    samples[i]        = f64v2(point.x, point.z);
+  }
+  return samples;
+}
+
+// Signed distance in double precision: the closest sample, refined by ternary search on the neighboring segments.
+// Inside if the horizontal ray from the point to the right crosses the closed outline an odd number of times.
+f64 referenceDistance(const FruitProfile& profile, const std::vector<f64v2>& samples, const f64v2& q)
+{
+  const auto distanceSquared = [&](f64 t)
+  {
+    const f64v3 p = evaluateCubicBezierCurve(profile, t);
+    return (p.x - q.x) * (p.x - q.x) + (p.z - q.y) * (p.z - q.y);
+  };
+  size_t best   = 0;
+  bool   inside = false;
+  for (size_t i = 0; i < samples.size(); i++)
+  {
+    const f64v2 d     = samples[i] - q;
+    const f64v2 dBest = samples[best] - q;
+    best              = glm::dot(d, d) < glm::dot(dBest, dBest) ? i : best;
+    if (i > 0 && (samples[i - 1].y > q.y) != (samples[i].y > q.y))
+    {
+      const f64 r = samples[i - 1].x + (q.y - samples[i - 1].y) / (samples[i].y - samples[i - 1].y) *
+                                           (samples[i].x - samples[i - 1].x);
+      inside = r > q.x ? !inside : inside;
+    }
+  }
+  f64 lower = static_cast<f64>(best == 0 ? 0 : best - 1) / NUM_REFERENCE_SEGMENTS;
+  f64 upper = static_cast<f64>(std::min<size_t>(best + 1, NUM_REFERENCE_SEGMENTS)) / NUM_REFERENCE_SEGMENTS;
+  for (ui32 i = 0; i < 100; i++)
+  {
+    const f64 a = (2.0 * lower + upper) / 3.0;
+    const f64 b = (lower + 2.0 * upper) / 3.0;
+    if (distanceSquared(a) < distanceSquared(b))
+    {
+      upper = b;
+    }
+    else
+    {
+      lower = a;
+    }
+  }
+  const f64 distance = std::sqrt(distanceSquared(0.5 * (lower + upper)));
+  return inside ? -distance : distance;
+}
+
+// Maximum error of the field against the reference for random points in the cylinder of radius maxRho between
+// minZ and maxZ.
+f64 measureError(FruitType type, f32 maxRho, f32 minZ, f32 maxZ)
+{
+  const FruitProfile&       profile = getFruitPreset(type).profile;
+  const FruitDistanceField& field   = getFruitDistanceField(type);
+  const std::vector<f64v2>  samples = sampleProfile(profile);
+
+  std::mt19937                        random(static_cast<ui32>(type));
+  std::uniform_real_distribution<f32> uniform(0.0f, 1.0f);
+  constexpr ui32                      NUM_POINTS = 4000;
+  std::vector<f32>                    x(NUM_POINTS), y(NUM_POINTS), z(NUM_POINTS), distances(NUM_POINTS);
+  for (ui32 i = 0; i < NUM_POINTS; i++)
+  {
+    const f32 rho   = maxRho * std::sqrt(uniform(random));
+    const f32 angle = 2.0f * glm::pi<f32>() * uniform(random);
+    x[i]            = rho * std::cos(angle);
+    y[i]            = rho * std::sin(angle);
+    z[i]            = minZ + (maxZ - minZ) * uniform(random);
+  }
+  field.evaluate(x.data(), y.data(), z.data(), NUM_POINTS, distances.data());
+  f64 maxError = 0.0;
+  for (ui32 i = 0; i < NUM_POINTS; i++)
+  {
+    const f64 rho   = std::sqrt(static_cast<f64>(x[i]) * x[i] + static_cast<f64>(y[i]) * y[i]);
+    const f64 error = std::abs(referenceDistance(profile, samples, f64v2(rho, z[i])) - distances[i]);
+    maxError        = std::max(maxError, error);
+  }
+  return maxError;
+}
+
+// Within the table, the error is a few float ulps of the distance. Beyond, the refinement still converges, and the
+// error grows with the distance.
+void checkPreset(FruitType type)
+{
+  const FruitProfile& profile  = getFruitPreset(type).profile;
+  f32v2               tableMin = f32v2(0.0f, profile.p0.z);
+  f32v2               tableMax = tableMin;
+  for (const f32v3& p : {profile.p0, profile.p1, profile.p2, profile.p3})
+  {
+    tableMin = glm::min(tableMin, f32v2(p.x, p.z));
+    tableMax = glm::max(tableMax, f32v2(p.x, p.z));
+  }
+  const f32 size   = std::max(tableMax.x - tableMin.x, tableMax.y - tableMin.y);
+  const f32 margin = 0.5f * size;
+  CHECK(measureError(type, tableMax.x + margin, tableMin.y - margin, tableMax.y + margin) <= 7e-7);
+  CHECK(measureError(type, tableMax.x + 4.0f * size, tableMin.y - 4.0f * size, tableMax.y + 4.0f * size) <= 1.5e-6);
+
+  const FruitDistanceFieldBenchmark benchmark = benchmarkFruitDistanceField(profile, 10000);
+  CHECK(benchmark.maxError <= 7e-7f && benchmark.rmsError <= benchmark.maxError && benchmark.queriesPerSecond > 0.0);
+}
+
+// Single points, batches of any size and the field of a copied profile give the same distances.
+void checkConsistency()
+{
+  const FruitProfile&       profile = getFruitPreset(FruitType::Pear).profile;
+  const FruitDistanceField  field(profile);
+  const FruitDistanceField& preset = getFruitDistanceField(FruitType::Pear);
+  std::vector<f32>          x, y, z;
+  for (ui32 i = 0; i < 37; i++)
+  {
+    x.push_back(0.05f * static_cast<f32>(i) - 0.6f);
+    y.push_back(0.3f * std::sin(static_cast<f32>(i)));
+    z.push_back(0.04f * static_cast<f32>(i) - 0.7f);
+  }
+  std::vector<f32> distances(x.size());
+  field.evaluate(x.data(), y.data(), z.data(), x.size(), distances.data());
+  for (size_t i = 0; i < x.size(); i++)
+  {
+    const f32v3 point(x[i], y[i], z[i]);
+    CHECK(field.evaluate(point) == distances[i] && preset.evaluate(point) == distances[i]);
+  }
+  CHECK(field.evaluate(f32v3(0.0f, 0.0f, 0.5f * (profile.p0.z + profile.p3.z))) < 0.0f);
+  CHECK(field.evaluate(f32v3(2.0f, 0.0f, 0.0f)) > 0.0f);
+}
+} // namespace
+
+int main()
+{
+  for (ui32 type = 0; type < static_cast<ui32>(FruitType::Count); type++)
+  {
+    checkPreset(static_cast<FruitType>(type));
+  }
+  checkConsistency();
+  return finishChecks();
+}
@@ -0,0 +1,181 @@
+#include "Check.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <gimslib/fruit/FruitImpostor.hpp>
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <random>
+#include <stdexcept>
+
+using namespace gims;
+
+namespace
+{
+const std::filesystem::path DIRECTORY = "FruitImpostorTest";
+
+FruitImpostorHeader createHeader(FruitImpostorLayout layout, ui32 viewsPerSide, ui32 viewResolution)
+{
+  FruitImpostorHeader header;
+  header.layout         = layout;
+  header.viewsPerSide   = viewsPerSide;
+  header.viewResolution = viewResolution;
+  return header;
+}
+
+f32v3 getViewDirection(const FruitImpostorHeader& header, ui32 view)
+{
+  return getFruitImpostorViewDirection(header.layout, header.viewsPerSide, view % header.viewsPerSide,
+                                       view / header.viewsPerSide);
+}
+
+// Decoding the grid coordinates of each view and encoding the direction again selects that view alone. On the border
+// of the octahedral domain of the sphere, the view may be the one on the opposite border with the same direction. The
+// hemisphere maps its whole domain one to one.
+void checkViewRoundTrip(FruitImpostorLayout layout)
+{
+  const FruitImpostorHeader header = createHeader(layout, 9, 16);
+  for (ui32 view = 0; view < header.viewsPerSide * header.viewsPerSide; view++)
+  {
+    const f32v3              direction = getViewDirection(header, view);
+    const FruitImpostorViews views     = selectFruitImpostorViews(header, direction);
+    ui32                     best      = 0;
+    for (ui32 i = 1; i < 3; i++)
+    {
+      best = views.weights[i] > views.weights[best] ? i : best;
+    }
+    CHECK(std::abs(glm::length(direction) - 1.0f) <= 1e-6f);
+    CHECK(views.weights[best] >= 1.0f - 1e-5f);
+    CHECK(glm::length(getViewDirection(header, views.views[best]) - direction) <= 1e-5f);
+    if (layout == FruitImpostorLayout::Hemisphere)
+    {
+      CHECK(direction.z >= 0.0f && views.views[best] == view);
+    }
+  }
+}
+
+// Any direction lies within the triangle of the three views that are blended, with weights that sum to one. Below the
+// horizon, the hemisphere uses the views on the horizon.
+void checkSelection(FruitImpostorLayout layout)
+{
+  const FruitImpostorHeader           header = createHeader(layout, 12, 16);
+  std::mt19937                        random(static_cast<ui32>(layout));
+  std::normal_distribution<f32>       normal;
+  std::uniform_real_distribution<f32> uniform(0.0f, 1.0f);
+  // The blended views lie within 2 pi / (n - 1) of the direction on the hemisphere, and within twice that angle on the
+  // sphere, which spreads as many views over twice the area.
+  const f32 maxAngle = (layout == FruitImpostorLayout::Sphere ? 4.0f : 2.0f) * glm::pi<f32>() /
+                       static_cast<f32>(header.viewsPerSide - 1);
+  for (ui32 i = 0; i < 1000; i++)
+  {
+    f32v3 direction = glm::normalize(f32v3(normal(random), normal(random), normal(random)));
+    if (layout == FruitImpostorLayout::Hemisphere)
+    {
+      direction.z = std::abs(direction.z);
+    }
+    const FruitImpostorViews views = selectFruitImpostorViews(header, direction);
+    CHECK(std::abs(views.weights[0] + views.weights[1] + views.weights[2] - 1.0f) <= 1e-5f);
+    for (ui32 k = 0; k < 3; k++)
+    {
+      CHECK(views.views[k] < header.viewsPerSide * header.viewsPerSide && views.weights[k] >= 0.0f);
+      CHECK(glm::dot(getViewDirection(header, views.views[k]), direction) >= std::cos(maxAngle));
+    }
+    if (layout == FruitImpostorLayout::Hemisphere)
+    {
+      const f32v3              mirrored = f32v3(direction.x, direction.y, -direction.z);
+      const FruitImpostorViews below    = selectFruitImpostorViews(header, mirrored);
+      const FruitImpostorViews horizon  = selectFruitImpostorViews(header, f32v3(direction.x, direction.y, 0.0f));
+      CHECK(below.views[0] == horizon.views[0] && below.weights[0] == horizon.weights[0]);
+    }
+  }
+}
+
+// Unknown layouts, fewer than 2 views per side, no texels and more than 16384 texels per side are rejected, also if
+// the texel count wraps around in 32 bits.
+void checkValidation()
+{
+  const FruitProfile& apple = getFruitPreset(FruitType::Apple).profile;
+  const f32v3         color(1.0f, 0.0f, 0.0f);
+  const auto          layout = static_cast<FruitImpostorLayout>(2);
+  CHECK_THROWS(bakeFruitImpostor(apple, color, layout, 4, 4), std::invalid_argument);
+  CHECK_THROWS(bakeFruitImpostor(apple, color, FruitImpostorLayout::Sphere, 1, 4), std::invalid_argument);
+  CHECK_THROWS(bakeFruitImpostor(apple, color, FruitImpostorLayout::Sphere, 4, 0), std::invalid_argument);
+  CHECK_THROWS(bakeFruitImpostor(apple, color, FruitImpostorLayout::Sphere, 2, 8193), std::invalid_argument);
+  CHECK_THROWS(bakeFruitImpostor(apple, color, FruitImpostorLayout::Sphere, 65536, 65536), std::invalid_argument);
+
+  const f32v3 up(0.0f, 0.0f, 1.0f);
+  CHECK_THROWS(selectFruitImpostorViews(createHeader(layout, 4, 4), up), std::invalid_argument);
+  CHECK_THROWS(selectFruitImpostorViews(createHeader(FruitImpostorLayout::Hemisphere, 1, 4), up),
+               std::invalid_argument);
+  CHECK_THROWS(selectFruitImpostorViews(createHeader(FruitImpostorLayout::Hemisphere, 4, 0), up),
+               std::invalid_argument);
+  CHECK_THROWS(selectFruitImpostorViews(createHeader(FruitImpostorLayout::Hemisphere, 16385, 1), up),
+               std::invalid_argument);
+  CHECK_THROWS(selectFruitImpostorViews(createHeader(FruitImpostorLayout::Hemisphere, 131072, 32768), up),
+               std::invalid_argument);
+  CHECK(selectFruitImpostorViews(createHeader(FruitImpostorLayout::Hemisphere, 2, 8192), up).weights[0] >= 0.0f);
+}
+
+// The baked atlas covers the fruit in the center of each view and not the corners, and survives saving and loading.
+// Corrupt and truncated files are rejected.
+void checkAtlasFile()
+{
+  const FruitImpostorAtlas atlas =
+      bakeFruitImpostor(getFruitPreset(FruitType::Pear).profile, f32v3(0.5f, 1.0f, 0.0f),
+                        FruitImpostorLayout::Hemisphere, 5, 16);
+  CHECK(atlas.getSize() == 80 && atlas.colors.size() == 80 * 80 && atlas.normalDepths.size() == 80 * 80);
+  for (ui32 y = 0; y < 5; y++)
+  {
+    for (ui32 x = 0; x < 5; x++)
+    {
+      const size_t corner = static_cast<size_t>(y) * 16 * 80 + x * 16;
+      const size_t center = corner + 8 * 80 + 8;
+      CHECK(atlas.colors[corner] == 0 && atlas.normalDepths[corner] >> 16 == 0xffff);
+      CHECK(atlas.colors[center] == (0xffu << 24 | 0xffu << 8 | 0x80u) && atlas.normalDepths[center] >> 16 < 0x8000);
+    }
+  }
+
+  const std::filesystem::path fileName = DIRECTORY / "pear.frim";
+  atlas.save(fileName);
+  const FruitImpostorAtlas loaded = FruitImpostorAtlas::load(fileName);
+  CHECK(loaded.header.layout == atlas.header.layout && loaded.header.viewsPerSide == 5);
+  CHECK(loaded.header.center == atlas.header.center && loaded.header.radius == atlas.header.radius);
+  CHECK(loaded.colors == atlas.colors && loaded.normalDepths == atlas.normalDepths);
+
+  std::vector<char> content(std::filesystem::file_size(fileName));
+  std::ifstream(fileName, std::ios::binary).read(content.data(), static_cast<std::streamsize>(content.size()));
+  const auto writeAndLoad = [&](const std::vector<char>& file)
+  {
+    const std::filesystem::path invalid = DIRECTORY / "invalid.frim";
+    std::ofstream(invalid, std::ios::binary).write(file.data(), static_cast<std::streamsize>(file.size()));
+    return FruitImpostorAtlas::load(invalid);
+  };
+  CHECK_THROWS(FruitImpostorAtlas::load(DIRECTORY / "missing.frim"), std::runtime_error);
+  CHECK_THROWS(writeAndLoad(std::vector<char>(content.begin(), content.end() - 1)), std::runtime_error);
+  CHECK_THROWS(writeAndLoad(std::vector<char>(content.begin(), content.begin() + 8)), std::runtime_error);
+  for (const size_t offset : {offsetof(FruitImpostorHeader, magic), offsetof(FruitImpostorHeader, version),
+                              offsetof(FruitImpostorHeader, layout)})
+  {
+    std::vector<char> corrupt = content;
+    corrupt[offset] += 2;
+    CHECK_THROWS(writeAndLoad(corrupt), std::runtime_error);
+  }
+  std::vector<char> tooLarge = content;
+  tooLarge[offsetof(FruitImpostorHeader, viewResolution) + 3] = 1;
+  CHECK_THROWS(writeAndLoad(tooLarge), std::runtime_error);
+}
+} // namespace
+
+int main()
+{
+  std::filesystem::remove_all(DIRECTORY);
+  std::filesystem::create_directories(DIRECTORY);
+  for (const FruitImpostorLayout layout : {FruitImpostorLayout::Sphere, FruitImpostorLayout::Hemisphere})
+  {
+    checkViewRoundTrip(layout);
+    checkSelection(layout);
+  }
+  checkValidation();
+  checkAtlasFile();
+  std::filesystem::remove_all(DIRECTORY);
+  return finishChecks();
+}
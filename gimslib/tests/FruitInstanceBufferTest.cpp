@@ -0,0 +1,176 @@
+#include "Check.hpp"
+#include <cstring>
+#include <gimslib/fruit/FruitInstanceBuffer.hpp>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace gims;
+
+namespace
+{
+FruitInstanceArray createInstances(size_t numInstances)
+{
+  const FruitProfile& profile = getFruitPreset(FruitType::Apple).profile;
+  FruitInstanceArray  instances;
+  instances.resize(numInstances);
+  for (size_t i = 0; i < numInstances; i++)
+  {
+    FruitInstance instance;
+    instance.profile  = profile;
+    instance.position = f32v3(static_cast<f32>(i), 0.0f, 0.0f);
+    instances.setInstance(i, instance);
+  }
+  return instances;
+}
+
+// Moves the instance, which changes its record.
+void change(FruitInstanceArray& instances, size_t i)
+{
+  instances.positionY[i] += 1.0f;
+}
+
+// The ranges of a serial scan over the changed flags, merged across at most MAX_MERGED_GAP unchanged records.
+std::vector<FruitInstanceRange> getExpectedRanges(const std::vector<bool>& changed)
+{
+  std::vector<FruitInstanceRange> result;
+  for (size_t i = 0; i < changed.size(); i++)
+  {
+    if (!changed[i])
+    {
+      continue;
+    }
+    if (!result.empty() &&
+        i - (result.back().first + result.back().count) <= FruitInstanceBufferBuilder::MAX_MERGED_GAP)
+    {
+      result.back().count = i + 1 - result.back().first;
+    }
+    else
+    {
+      result.push_back({i, 1});
+    }
+  }
+  return result;
+}
+
+// Changes the instances at the indices and returns the ranges of the next update.
+std::vector<FruitInstanceRange> update(FruitInstanceBufferBuilder& builder, FruitInstanceArray& instances,
+                                       const std::vector<size_t>& indices)
+{
+  for (const size_t i : indices)
+  {
+    change(instances, i);
+  }
+  return builder.update(instances, std::vector<FruitInstanceLOD>(instances.getSize()));
+}
+
+void checkRecords()
+{
+  FruitInstanceArray instances = createInstances(2);
+  instances.colorIndices[1]    = 7;
+  instances.lodBiases[1]       = -2;
+  instances.flags[1]           = FRUIT_INSTANCE_FLAT_SHADING;
+
+  const FruitInstanceLOD lods[2] = {{5, 0, 0.0f}, {129, 12, 0.75f}};
+
+  FruitInstanceRecord records[2];
+  buildFruitInstanceRecords(instances, lods, 0, 2, records);
+  CHECK(records[1].flags == (1u | (7u << 8) | (0xFEu << 16)));
+  CHECK(records[1].position == f32v3(1.0f, 0.0f, 0.0f));
+  CHECK(records[1].rotation == f32v4(0.0f, 0.0f, 0.0f, 1.0f));
+  CHECK(records[1].controlPoints[3] == f32v4(instances.profiles.getProfile(1).p3, 0.0f));
+  CHECK(records[0].gridSize == 5 && records[0].firstTileBounds == 0 && records[0].morphFactor == 0.0f);
+  CHECK(records[1].gridSize == 129 && records[1].firstTileBounds == 12 && records[1].morphFactor == 0.75f);
+  CHECK(records[1].reserved == 0);
+}
+
+void checkRanges()
+{
+  constexpr size_t           GAP       = FruitInstanceBufferBuilder::MAX_MERGED_GAP;
+  FruitInstanceArray         instances = createInstances(100);
+  FruitInstanceBufferBuilder builder;
+
+  // Everything changes in the first update, nothing in the next.
+  CHECK((update(builder, instances, {}) == std::vector<FruitInstanceRange>{{0, 100}}));
+  CHECK(update(builder, instances, {}).empty());
+  CHECK(builder.getNumChangedRecords() == 0);
+  CHECK(builder.getRecords().size() == 100);
+
+  // Gaps of up to MAX_MERGED_GAP unchanged records are bridged.
+  CHECK((update(builder, instances, {5, 5 + GAP + 1}) == std::vector<FruitInstanceRange>{{5, GAP + 2}}));
+  CHECK(builder.getNumChangedRecords() == GAP + 2);
+  CHECK((update(builder, instances, {5, 5 + GAP + 2}) ==
+         std::vector<FruitInstanceRange>{{5, 1}, {5 + GAP + 2, 1}}));
+  CHECK((update(builder, instances, {0, 99}) == std::vector<FruitInstanceRange>{{0, 1}, {99, 1}}));
+  CHECK(builder.getRecords()[99].position == f32v3(99.0f, 1.0f, 0.0f));
+
+  // A new level of detail or morph factor changes the record.
+  std::vector<FruitInstanceLOD> lods(100);
+  lods[42].gridSize = 9;
+  CHECK((builder.update(instances, lods) == std::vector<FruitInstanceRange>{{42, 1}}));
+  CHECK(builder.getRecords()[42].gridSize == 9);
+  lods[42].morphFactor = 0.5f;
+  CHECK((builder.update(instances, lods) == std::vector<FruitInstanceRange>{{42, 1}}));
+  CHECK(builder.getRecords()[42].morphFactor == 0.5f);
+  CHECK_THROWS(builder.update(instances, std::vector<FruitInstanceLOD>(99)), std::invalid_argument);
+
+  // Growth adds the new records, shrinking drops records and invalidate() changes everything.
+  const FruitInstanceArray grown = createInstances(103);
+  instances.resize(103);
+  for (size_t i = 100; i < 103; i++)
+  {
+    instances.setInstance(i, grown.getInstance(i));
+  }
+  CHECK((update(builder, instances, {}) == std::vector<FruitInstanceRange>{{42, 1}, {100, 3}}));
+  instances.resize(50);
+  CHECK(update(builder, instances, {}).empty());
+  CHECK(builder.getRecords().size() == 50);
+  builder.invalidate();
+  CHECK((update(builder, instances, {}) == std::vector<FruitInstanceRange>{{0, 50}}));
+}
+
+// Random changes over several tasks of the parallel update, compared with a serial scan.
+void checkRandomRanges()
+{
+  constexpr size_t           NUM_INSTANCES = 100000;
+  FruitInstanceArray         instances     = createInstances(NUM_INSTANCES);
+  FruitInstanceBufferBuilder builder;
+  update(builder, instances, {});
+
+  std::mt19937                          random(3);
+  std::uniform_int_distribution<size_t> index(0, NUM_INSTANCES - 1);
+  for (const size_t numChanges : {1, 10, 1000, 20000})
+  {
+    std::vector<bool>   changed(NUM_INSTANCES, false);
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < numChanges; i++)
+    {
+      indices.push_back(index(random));
+      changed[indices.back()] = true;
+    }
+    // Runs that straddle the task boundaries at multiples of 16384 records.
+    for (const size_t i : {16383, 16384, 16390, 32760, 32775})
+    {
+      if (!changed[i])
+      {
+        indices.push_back(i);
+        changed[i] = true;
+      }
+    }
+    CHECK(update(builder, instances, indices) == getExpectedRanges(changed));
+
+    const std::vector<FruitInstanceLOD> lods(NUM_INSTANCES);
+    std::vector<FruitInstanceRecord>    expected(NUM_INSTANCES);
+    buildFruitInstanceRecords(instances, lods.data(), 0, NUM_INSTANCES, expected.data());
+    CHECK(std::memcmp(expected.data(), builder.getRecords().data(), NUM_INSTANCES * sizeof(FruitInstanceRecord)) == 0);
+  }
+}
+} // namespace
+
+int main()
+{
+  checkRecords();
+  checkRanges();
+  checkRandomRanges();
+  return finishChecks();
+}
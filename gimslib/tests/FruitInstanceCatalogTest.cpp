@@ -0,0 +1,194 @@
+#include "Check.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <gimslib/fruit/FruitInstanceCatalog.hpp>
+#include <random>
+#include <stdexcept>
+
+using namespace gims;
+
+namespace
+{
+const std::filesystem::path DIRECTORY = "FruitInstanceCatalogTest";
+
+// Fruits scattered over a 1 km x 1 km orchard, up to 10 m high, with random rotations and profiles around their
+// presets. The count spans several parallel tasks and ends in a partial lane block.
+FruitInstanceArray createOrchard(size_t numInstances)
+{
+  std::mt19937                        random(11);
+  std::uniform_real_distribution<f32> uniform(0.0f, 1.0f);
+  std::normal_distribution<f32>       normal;
+  FruitInstanceArray                  instances;
+  instances.resize(numInstances);
+  for (size_t i = 0; i < numInstances; i++)
+  {
+    FruitInstance instance;
+    instance.preset   = static_cast<FruitType>(i % static_cast<size_t>(FruitType::Count));
+    instance.profile  = getFruitPreset(instance.preset).profile;
+    instance.position = f32v3(1000.0f * uniform(random) - 500.0f, 1000.0f * uniform(random), 10.0f * uniform(random));
+    instance.rotation = glm::normalize(f32v4(normal(random), normal(random), normal(random), normal(random)));
+    instance.profile.p0.z += 0.2f * uniform(random) - 0.1f;
+    instance.profile.p1 += f32v3(0.5f * uniform(random) - 0.25f, 0.0f, 0.5f * uniform(random) - 0.25f);
+    instance.profile.p2 += f32v3(0.5f * uniform(random) - 0.25f, 0.0f, 0.5f * uniform(random) - 0.25f);
+    instance.profile.p3.z += 0.2f * uniform(random) - 0.1f;
+    instance.colorIndex = static_cast<ui8>(i % 7);
+    instance.lodBias    = static_cast<i8>(static_cast<i32>(i % 5) - 2);
+    instance.flags      = static_cast<ui8>(i % 2 == 0 ? FRUIT_INSTANCE_FLAT_SHADING : 0);
+    instances.setInstance(i, instance);
+  }
+  return instances;
+}
+
+// Angle between two rotations given as unit quaternions, q and -q being the same rotation.
+f32 getRotationAngle(const f32v4& a, const f32v4& b)
+{
+  return 2.0f * std::acos(std::min(std::abs(glm::dot(a, b)), 1.0f));
+}
+
+// Saving, mapping and unpacking a catalog keeps everything but the quantization errors the header documents.
+void checkRoundTrip()
+{
+  const FruitInstanceArray    instances = createOrchard(150001);
+  const std::vector<f32v3>    colors    = {f32v3(1.0f, 0.0f, 0.0f), f32v3(0.0f, 1.0f, 0.0f), f32v3(0.9f, 0.8f, 0.1f)};
+  const std::filesystem::path fileName  = DIRECTORY / "orchard.fic";
+  FruitInstanceCatalog::save(fileName, instances, colors);
+  CHECK(std::filesystem::file_size(fileName) ==
+        sizeof(FruitInstanceCatalogHeader) + instances.getSize() * sizeof(PackedFruitInstance));
+
+  const FruitInstanceCatalog        catalog(fileName);
+  const FruitInstanceCatalogHeader& header = catalog.getHeader();
+  CHECK(catalog.getNumInstances() == instances.getSize());
+  CHECK(header.colors[2] == colors[2] && header.colors[3] == f32v3(0.0f));
+  CHECK(header.positionMin.x >= -500.0f && header.positionMax.x <= 500.0f && header.positionMax.x > 499.0f);
+
+  std::vector<PackedFruitInstance> records(instances.getSize());
+  packFruitInstances(instances, header.positionMin, header.positionMax, 0, instances.getSize(), records.data());
+  CHECK(std::memcmp(records.data(), catalog.getInstances(), records.size() * sizeof(PackedFruitInstance)) == 0);
+
+  FruitInstanceArray unpacked;
+  unpacked.resize(instances.getSize());
+  catalog.unpack(0, instances.getSize(), unpacked);
+
+  // Half a quantization step per axis plus f32 rounding of coordinates up to 1000 m.
+  const f32v3 maxAxisError = 0.5f * (header.positionMax - header.positionMin) / 2097151.0f + f32v3(8e-5f);
+  f32         maxDistance  = 0.0f;
+  f32         maxAngle     = 0.0f;
+  f32         maxProfile   = 0.0f;
+  for (size_t i = 0; i < instances.getSize(); i++)
+  {
+    const FruitInstance expected      = instances.getInstance(i);
+    const FruitInstance actual        = unpacked.getInstance(i);
+    const f32v3         positionError = glm::abs(actual.position - expected.position);
+    CHECK(positionError.x <= maxAxisError.x && positionError.y <= maxAxisError.y && positionError.z <= maxAxisError.z);
+    maxDistance = std::max(maxDistance, glm::length(actual.position - expected.position));
+
+    // The three stored components are off by at most half a step of 10 bits over [-1/sqrt(2);1/sqrt(2)].
+    const f32v4 rotation = glm::dot(actual.rotation, expected.rotation) < 0.0f ? -actual.rotation : actual.rotation;
+    ui32        largest  = 0;
+    for (ui32 c = 1; c < 4; c++)
+    {
+      largest = std::abs(expected.rotation[c]) > std::abs(expected.rotation[largest]) ? c : largest;
+    }
+    for (ui32 c = 0; c < 4; c++)
+    {
+      CHECK(c == largest || std::abs(rotation[c] - expected.rotation[c]) <= 7e-4f);
+    }
+    CHECK(std::abs(glm::length(actual.rotation) - 1.0f) <= 2e-3f);
+    maxAngle = std::max(maxAngle, getRotationAngle(actual.rotation, expected.rotation));
+
+    const f32v3 expectedPoints[4] = {expected.profile.p0, expected.profile.p1, expected.profile.p2,
+                                     expected.profile.p3};
+    const f32v3 actualPoints[4]   = {actual.profile.p0, actual.profile.p1, actual.profile.p2, actual.profile.p3};
+    for (ui32 p = 0; p < 4; p++)
+    {
+      maxProfile = std::max(maxProfile, glm::length(actualPoints[p] - expectedPoints[p]));
+    }
+    CHECK(actual.profile.p0.x == 0.0f && actual.profile.p3.x == 0.0f && actual.profile.p1.y == 0.0f);
+    CHECK(actual.preset == expected.preset && actual.colorIndex == expected.colorIndex);
+    CHECK(actual.lodBias == expected.lodBias && actual.flags == expected.flags);
+  }
+  // The errors PackedFruitInstance documents: 0.45 mm, 0.25 degrees, and half a step in x and z of a control point.
+  CHECK(maxDistance <= 4.5e-4f);
+  CHECK(maxAngle <= glm::radians(0.25f));
+  CHECK(maxProfile <= 0.5f * std::sqrt(2.0f) * PackedFruitInstance::PROFILE_OFFSET_STEP + 1e-6f);
+
+  // Unpacking a range touches only that range.
+  FruitInstanceArray part;
+  part.resize(instances.getSize());
+  catalog.unpack(70001, 70013, part);
+  CHECK(part.getInstance(70000).position == f32v3(0.0f) && part.getInstance(70013).position == f32v3(0.0f));
+  for (size_t i = 70001; i < 70013; i++)
+  {
+    CHECK(part.getInstance(i).position == unpacked.getInstance(i).position);
+    CHECK(part.getInstance(i).profile == unpacked.getInstance(i).profile);
+  }
+}
+
+void writeFile(const std::filesystem::path& fileName, const std::vector<char>& content)
+{
+  std::ofstream(fileName, std::ios::binary).write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+// Missing, empty, truncated and corrupt catalogs are rejected, and so are palettes beyond 256 colors.
+void checkInvalidCatalogs()
+{
+  const std::filesystem::path fileName = DIRECTORY / "small.fic";
+  FruitInstanceCatalog::save(fileName, createOrchard(10), {});
+  std::vector<char> content(std::filesystem::file_size(fileName));
+  std::ifstream(fileName, std::ios::binary).read(content.data(), static_cast<std::streamsize>(content.size()));
+  CHECK(FruitInstanceCatalog(fileName).getNumInstances() == 10);
+
+  const std::filesystem::path invalid = DIRECTORY / "invalid.fic";
+  CHECK_THROWS(FruitInstanceCatalog(DIRECTORY / "missing.fic"), std::runtime_error);
+  writeFile(invalid, {});
+  CHECK_THROWS(FruitInstanceCatalog(invalid), std::runtime_error);
+  writeFile(invalid, std::vector<char>(content.begin(), content.begin() + sizeof(FruitInstanceCatalogHeader) - 1));
+  CHECK_THROWS(FruitInstanceCatalog(invalid), std::runtime_error);
+  writeFile(invalid, std::vector<char>(content.begin(), content.end() - 1));
+  CHECK_THROWS(FruitInstanceCatalog(invalid), std::runtime_error);
+
+  std::vector<char> corrupt = content;
+  corrupt[0]                = 'X';
+  writeFile(invalid, corrupt);
+  CHECK_THROWS(FruitInstanceCatalog(invalid), std::runtime_error);
+  corrupt = content;
+  corrupt[offsetof(FruitInstanceCatalogHeader, version)]++;
+  writeFile(invalid, corrupt);
+  CHECK_THROWS(FruitInstanceCatalog(invalid), std::runtime_error);
+  corrupt = content;
+  corrupt[offsetof(FruitInstanceCatalogHeader, numInstances) + 7] = 1;
+  writeFile(invalid, corrupt);
+  CHECK_THROWS(FruitInstanceCatalog(invalid), std::runtime_error);
+
+  CHECK_THROWS(FruitInstanceCatalog::save(invalid, createOrchard(1), std::vector<f32v3>(257)), std::invalid_argument);
+  CHECK_THROWS(FruitInstanceCatalog::save(DIRECTORY / "missing" / "a.fic", createOrchard(1), {}), std::runtime_error);
+}
+
+// Positions outside of the bounds are clamped to them.
+void checkClamping()
+{
+  FruitInstanceArray instances = createOrchard(3);
+  instances.positionX[0]       = -1.0f;
+  instances.positionX[1]       = 2.0f;
+  PackedFruitInstance records[3];
+  packFruitInstances(instances, f32v3(0.0f), f32v3(1.0f), 0, 3, records);
+  FruitInstanceArray unpacked;
+  unpacked.resize(3);
+  unpackFruitInstances(records, f32v3(0.0f), f32v3(1.0f), 0, 3, unpacked);
+  CHECK(unpacked.positionX[0] == 0.0f && unpacked.positionX[1] == 1.0f);
+}
+} // namespace
+
+int main()
+{
+  std::filesystem::remove_all(DIRECTORY);
+  std::filesystem::create_directories(DIRECTORY);
+  checkRoundTrip();
+  checkInvalidCatalogs();
+  checkClamping();
+  std::filesystem::remove_all(DIRECTORY);
+  return finishChecks();
+}
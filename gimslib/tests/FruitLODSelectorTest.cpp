@@ -0,0 +1,79 @@
+#include "Check.hpp"
+#include <gimslib/fruit/FruitGeomorph.hpp>
+#include <gimslib/fruit/FruitLODSelector.hpp>
+#include <random>
+
+using namespace gims;
+
+namespace
+{
+const f32m4 VIEW       = glm::lookAtLH(f32v3(0.0f, 0.0f, -4.0f), f32v3(0.0f), f32v3(0.0f, 1.0f, 0.0f));
+const f32m4 PROJECTION = glm::perspectiveFovLH_ZO<f32>(glm::radians(45.0f), 1280.0f, 720.0f, 0.01f, 100.0f);
+const f32v2 VIEWPORT_SIZE(1280.0f, 720.0f);
+
+FruitBoundingSphereArray createSpheres(size_t numSpheres)
+{
+  std::mt19937                        random(3);
+  std::uniform_real_distribution<f32> position(-20.0f, 20.0f);
+  std::uniform_real_distribution<f32> radius(0.05f, 2.0f);
+  FruitBoundingSphereArray            spheres;
+  spheres.resize(numSpheres);
+  for (size_t i = 0; i < numSpheres; i++)
+  {
+    spheres.centerX[i] = position(random);
+    spheres.centerY[i] = position(random);
+    spheres.centerZ[i] = position(random) + 20.0f;
+    spheres.radius[i]  = radius(random);
+  }
+  return spheres;
+}
+
+// Each sphere gets the morph level of its own continuous level plus its bias, and the relaxed pixel error of the
+// geomorphing renderers never selects finer levels; a larger morph factor is coarser.
+void checkMorphLevels()
+{
+  const FruitBoundingSphereArray spheres = createSpheres(10000);
+  std::vector<i8>                lodBiases(spheres.getSize());
+  for (size_t i = 0; i < lodBiases.size(); i++)
+  {
+    lodBiases[i] = static_cast<i8>(static_cast<i32>(i % 5) - 2);
+  }
+
+  const FruitLODSelector       selector(VIEW, PROJECTION, VIEWPORT_SIZE, 1.0f, 0.25f, 129);
+  const FruitLODSelector       relaxed(VIEW, PROJECTION, VIEWPORT_SIZE, FRUIT_GEOMORPH_PIXEL_ERROR_SCALE, 0.25f, 129);
+  std::vector<FruitMorphLevel> levels;
+  std::vector<FruitMorphLevel> relaxedLevels;
+  selector.selectMorphLevels(spheres, lodBiases.data(), levels);
+  relaxed.selectMorphLevels(spheres, lodBiases.data(), relaxedLevels);
+  CHECK(levels.size() == spheres.getSize() && relaxedLevels.size() == spheres.getSize());
+
+  size_t numCoarser = 0;
+  for (size_t i = 0; i < spheres.getSize(); i++)
+  {
+    const f32v3           center(spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i]);
+    const f32             level    = selector.getContinuousLevel(center, spheres.radius[i]) + lodBiases[i];
+    const FruitMorphLevel expected = selectFruitMorphLevel(level, 129);
+    CHECK(levels[i].gridSize == expected.gridSize && levels[i].morphFactor == expected.morphFactor);
+    CHECK(levels[i].morphFactor >= 0.0f && levels[i].morphFactor <= 1.0f);
+    CHECK(relaxedLevels[i].gridSize <= levels[i].gridSize);
+    if (relaxedLevels[i].gridSize == levels[i].gridSize)
+    {
+      CHECK(relaxedLevels[i].morphFactor >= levels[i].morphFactor);
+    }
+    numCoarser += relaxedLevels[i].gridSize < levels[i].gridSize ? 1 : 0;
+  }
+  CHECK(numCoarser > 0);
+
+  // Without biases, all spheres use bias 0.
+  selector.selectMorphLevels(spheres, nullptr, levels);
+  const f32v3           center(spheres.centerX[0], spheres.centerY[0], spheres.centerZ[0]);
+  const FruitMorphLevel unbiased = selectFruitMorphLevel(selector.getContinuousLevel(center, spheres.radius[0]), 129);
+  CHECK(levels[0].gridSize == unbiased.gridSize && levels[0].morphFactor == unbiased.morphFactor);
+}
+} // namespace
+
+int main()
+{
+  checkMorphLevels();
+  return finishChecks();
+}
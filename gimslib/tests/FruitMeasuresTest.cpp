@@ -0,0 +1,153 @@
+#include "Check.hpp"
+#include <algorithm>
+#include <cmath>
+#include <gimslib/fruit/FruitMeasures.hpp>
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <limits>
+#include <random>
+
+using namespace gims;
+
+namespace
+{
+struct ReferenceMeasures
+{
+  f64   area   = 0.0;
+  f64   volume = 0.0;
+  f64   radius = 0.0;
+  f64v2 z      = f64v2(std::numeric_limits<f64>::max(), std::numeric_limits<f64>::lowest());
+};
+
+// Integrates the revolved profile as a chain of many frusta in double precision, independent of the quadrature.
+ReferenceMeasures measureReference(const FruitProfile& profile)
+{
+  constexpr ui32    NUM_SEGMENTS = 100000;
+  ReferenceMeasures result;
+  f64v2             previous;
+  for (ui32 i = 0; i <= NUM_SEGMENTS; i++)
+  {
+    const f64v3 point = evaluateCubicBezierCurve(profile, static_cast<f64>(i) / NUM_SEGMENTS);
+    const f64v2 current(glm::length(f64v2(point.x, point.y)), point.z);
+    if (i > 0)
+    {
+      result.area += glm::pi<f64>() * (previous.x + current.x) * glm::length(current - previous);
+      result.volume += glm::pi<f64>() / 3.0 *
+                       (previous.x * previous.x + previous.x * current.x + current.x * current.x) *
+                       (current.y - previous.y);
+    }
+    result.radius = std::max(result.radius, current.x);
+    result.z      = f64v2(std::min(result.z.x, current.y), std::max(result.z.y, current.y));
+    previous      = current;
+  }
+  result.volume = std::abs(result.volume);
+  return result;
+}
+
+bool isClose(f32 actual, f64 expected, f64 relativeError)
+{
+  return std::abs(actual - expected) <= relativeError * std::abs(expected);
+}
+
+// A straight profile, with the inner control points at thirds, is parametrized uniformly.
+FruitProfile makeLine(const f32v3& begin, const f32v3& end)
+{
+  return {begin, begin + (end - begin) / 3.0f, begin + 2.0f * (end - begin) / 3.0f, end};
+}
+
+// Cylinder and cone have closed forms, and so has the sphere-like profile whose inner control points are at 4/3: its
+// radius 4 t (1 - t) and height derivative 12 t (1 - t) give a volume of 192 pi B(4, 4) = 48 pi / 35 and the unit
+// cube as bounding box.
+void checkClosedForms()
+{
+  const FruitMeasures cylinder = computeFruitMeasures(makeLine(f32v3(0.5f, 0.0f, -1.0f), f32v3(0.5f, 0.0f, 1.0f)));
+  CHECK(isClose(cylinder.area, 2.0 * glm::pi<f64>() * 0.5 * 2.0, 1e-6));
+  CHECK(isClose(cylinder.volume, glm::pi<f64>() * 0.25 * 2.0, 1e-6));
+  CHECK(cylinder.aabbMin == f32v3(-0.5f, -0.5f, -1.0f) && cylinder.aabbMax == f32v3(0.5f, 0.5f, 1.0f));
+
+  const FruitMeasures cone = computeFruitMeasures(makeLine(f32v3(0.0f, 0.0f, 0.0f), f32v3(0.6f, 0.0f, 0.8f)));
+  CHECK(isClose(cone.area, glm::pi<f64>() * 0.6 * 1.0, 1e-6));
+  CHECK(isClose(cone.volume, glm::pi<f64>() * 0.36 * 0.8 / 3.0, 1e-6));
+
+  const FruitProfile  sphereLike = {f32v3(0.0f, 0.0f, -1.0f), f32v3(4.0f / 3.0f, 0.0f, -1.0f),
+                                    f32v3(4.0f / 3.0f, 0.0f, 1.0f), f32v3(0.0f, 0.0f, 1.0f)};
+  const FruitMeasures sphere     = computeFruitMeasures(sphereLike);
+  CHECK(isClose(sphere.volume, 48.0 * glm::pi<f64>() / 35.0, 1e-6));
+  CHECK(isClose(sphere.area, measureReference(sphereLike).area, 1e-5));
+  CHECK(glm::length(sphere.aabbMin - f32v3(-1.0f)) <= 1e-6f && glm::length(sphere.aabbMax - f32v3(1.0f)) <= 1e-6f);
+}
+
+// The presets, their reverses, and random profiles with non-zero y against the frusta. The bounding box is tight for
+// profiles in the xz plane and conservative otherwise.
+void checkAgainstReference()
+{
+  std::vector<FruitProfile> profiles;
+  for (ui32 type = 0; type < static_cast<ui32>(FruitType::Count); type++)
+  {
+    const FruitProfile& profile = getFruitPreset(static_cast<FruitType>(type)).profile;
+    profiles.push_back(profile);
+    profiles.push_back({profile.p3, profile.p2, profile.p1, profile.p0});
+  }
+  std::mt19937                        random(3);
+  std::uniform_real_distribution<f32> uniform(-1.0f, 1.0f);
+  for (ui32 i = 0; i < 8; i++)
+  {
+    profiles.push_back({f32v3(0.0f, 0.0f, -1.0f), f32v3(uniform(random), uniform(random), uniform(random)),
+                        f32v3(uniform(random), uniform(random), uniform(random)), f32v3(0.0f, 0.0f, 1.0f)});
+  }
+
+  for (const FruitProfile& profile : profiles)
+  {
+    const bool              planar    = profile.p1.y == 0.0f && profile.p2.y == 0.0f;
+    const FruitMeasures     measures  = computeFruitMeasures(profile);
+    const ReferenceMeasures reference = measureReference(profile);
+    CHECK(isClose(measures.area, reference.area, 2e-5));
+    CHECK(isClose(measures.volume, reference.volume, 2e-6));
+    CHECK(measures.aabbMax.x >= reference.radius - 1e-6 && measures.aabbMax.y == measures.aabbMax.x);
+    CHECK(measures.aabbMin == f32v3(-measures.aabbMax.x, -measures.aabbMax.y, measures.aabbMin.z));
+    CHECK(measures.aabbMin.z <= reference.z.x + 1e-6 && measures.aabbMax.z >= reference.z.y - 1e-6);
+    CHECK(measures.aabbMin.z >= reference.z.x - 1e-6 && measures.aabbMax.z <= reference.z.y + 1e-6);
+    if (planar)
+    {
+      CHECK(measures.aabbMax.x <= reference.radius + 1e-6);
+    }
+  }
+}
+
+// The batch computes the same measures as single fruits, for any count of fruits and for disjoint ranges.
+void checkBatch()
+{
+  FruitProfileArray profiles;
+  for (ui32 i = 0; i < 21; i++)
+  {
+    FruitProfile profile = getFruitPreset(static_cast<FruitType>(i % 4)).profile;
+    profile.p1.x *= 1.0f + 0.05f * static_cast<f32>(i);
+    profiles.addProfile(profile);
+  }
+  FruitMeasureArray measures;
+  computeFruitMeasures(profiles, measures);
+  CHECK(measures.area.size() == 21 && measures.maxZ.size() == 21);
+
+  FruitMeasureArray ranges;
+  ranges.resize(profiles.getSize());
+  computeFruitMeasures(profiles, 11, 21, ranges);
+  computeFruitMeasures(profiles, 0, 11, ranges);
+  for (size_t i = 0; i < profiles.getSize(); i++)
+  {
+    const FruitMeasures single = computeFruitMeasures(profiles.getProfile(i));
+    CHECK(measures.area[i] == single.area && measures.volume[i] == single.volume);
+    CHECK(measures.radius[i] == single.aabbMax.x);
+    CHECK(measures.minZ[i] == single.aabbMin.z && measures.maxZ[i] == single.aabbMax.z);
+    CHECK(ranges.area[i] == measures.area[i] && ranges.volume[i] == measures.volume[i]);
+    CHECK(ranges.radius[i] == measures.radius[i]);
+    CHECK(ranges.minZ[i] == measures.minZ[i] && ranges.maxZ[i] == measures.maxZ[i]);
+  }
+}
+} // namespace
+
+int main()
+{
+  checkClosedForms();
+  checkAgainstReference();
+  checkBatch();
+  return finishChecks();
+}
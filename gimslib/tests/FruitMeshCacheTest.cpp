@@ -0,0 +1,189 @@
+#include "Check.hpp"
+#include <chrono>
+#include <cmath>
+#include <gimslib/fruit/FruitMeshCache.hpp>
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <thread>
+#include <vector>
+
+using namespace gims;
+
+namespace
+{
+constexpr ui32 INTRA_LOD = 11;
+
+bool isEqual(const FruitMesh& a, const FruitMesh& b)
+{
+  return a.positions == b.positions && a.indices == b.indices;
+}
+
+const FruitProfile& getProfile(ui32 type)
+{
+  return getFruitPreset(static_cast<FruitType>(type)).profile;
+}
+
+FruitMeshKey getKey(ui32 type, ui32 intraLOD)
+{
+  return FruitMeshCache::makeKey(getProfile(type), intraLOD);
+}
+
+// The mesh that misses tessellate: the one of the quantized profile.
+FruitMesh tessellateQuantized(ui32 type, ui32 intraLOD)
+{
+  return tessellateFruit(FruitMeshCache::getProfile(getKey(type, intraLOD)), intraLOD);
+}
+
+// Distinct steady_clock timestamps, also where the clock is coarse.
+void waitForNextTick()
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+// Keys quantize the control points, and profiles that differ by less than half a step share their mesh.
+void checkKeys()
+{
+  const FruitProfile& profile   = getProfile(0);
+  const FruitProfile  quantized = FruitMeshCache::getProfile(FruitMeshCache::makeKey(profile, INTRA_LOD));
+  for (const auto& [a, b] : {std::pair(profile.p0, quantized.p0), std::pair(profile.p1, quantized.p1),
+                             std::pair(profile.p2, quantized.p2), std::pair(profile.p3, quantized.p3)})
+  {
+    CHECK(glm::length(a - b) <= 0.5f * FruitMeshCache::QUANTIZATION_STEP * std::sqrt(3.0f));
+  }
+  FruitProfile nearby = profile;
+  nearby.p1.x += 0.25f * FruitMeshCache::QUANTIZATION_STEP;
+  CHECK(FruitMeshCache::makeKey(nearby, INTRA_LOD) == FruitMeshCache::makeKey(profile, INTRA_LOD));
+  nearby.p1.x += FruitMeshCache::QUANTIZATION_STEP;
+  CHECK(FruitMeshCache::makeKey(nearby, INTRA_LOD) != FruitMeshCache::makeKey(profile, INTRA_LOD));
+  CHECK(FruitMeshCache::makeKey(profile, 9) != FruitMeshCache::makeKey(profile, INTRA_LOD));
+}
+
+// Misses tessellate the quantized profile, hits return the same mesh, and meshes over the budget are not cached.
+void checkHitsAndMisses()
+{
+  const FruitMesh expected    = tessellateQuantized(0, INTRA_LOD);
+  const size_t    sizeInBytes = FruitMeshCache::getSizeInBytes(expected);
+  FruitMeshCache  cache(10 * sizeInBytes);
+  CHECK(!cache.find(getKey(0, INTRA_LOD)));
+
+  const auto miss = cache.getOrTessellate(getProfile(0), INTRA_LOD);
+  CHECK(isEqual(*miss, expected));
+  CHECK(cache.getNumMisses() == 1 && cache.getNumHits() == 0);
+  CHECK(cache.getNumEntries() == 1 && cache.getSizeInBytes() == sizeInBytes);
+
+  const auto hit = cache.getOrTessellate(getProfile(0), INTRA_LOD);
+  CHECK(hit == miss);
+  CHECK(cache.find(getKey(0, INTRA_LOD)) == miss);
+  CHECK(cache.getNumMisses() == 1 && cache.getNumHits() == 2);
+
+  CHECK(cache.getOrTessellate(getProfile(0), 9) != miss);
+  CHECK(cache.getNumMisses() == 2 && cache.getNumEntries() == 2);
+
+  FruitMeshCache small(sizeInBytes - 1);
+  CHECK(isEqual(*small.getOrTessellate(getProfile(0), INTRA_LOD), expected));
+  CHECK(small.getNumEntries() == 0 && small.getSizeInBytes() == 0);
+
+  cache.clear();
+  CHECK(cache.getNumEntries() == 0 && cache.getSizeInBytes() == 0);
+  CHECK(isEqual(*miss, expected));
+}
+
+// Inserting beyond the budget evicts the least recently used entries, where hits count as uses, and evicted meshes
+// stay valid for their holders.
+void checkEviction()
+{
+  const size_t   sizeInBytes = FruitMeshCache::getSizeInBytes(tessellateQuantized(0, INTRA_LOD));
+  FruitMeshCache cache(3 * sizeInBytes + sizeInBytes / 2);
+
+  std::vector<std::shared_ptr<const FruitMesh>> meshes;
+  for (ui32 type = 0; type < 3; type++)
+  {
+    meshes.push_back(cache.getOrTessellate(getProfile(type), INTRA_LOD));
+    waitForNextTick();
+  }
+  CHECK(cache.getNumEntries() == 3);
+  CHECK(cache.getOrTessellate(getProfile(0), INTRA_LOD) == meshes[0]);
+  waitForNextTick();
+
+  meshes.push_back(cache.getOrTessellate(getProfile(3), INTRA_LOD));
+  CHECK(cache.getNumEntries() == 3);
+  CHECK(cache.getSizeInBytes() == 3 * sizeInBytes && cache.getSizeInBytes() <= cache.getByteBudget());
+  CHECK(!cache.find(getKey(1, INTRA_LOD)));
+  CHECK(isEqual(*meshes[1], tessellateQuantized(1, INTRA_LOD)));
+
+  // find() also counts as a use.
+  for (const ui32 type : {2, 0, 3})
+  {
+    CHECK(cache.find(getKey(type, INTRA_LOD)) == meshes[type]);
+    waitForNextTick();
+  }
+  const auto pear = cache.getOrTessellate(getProfile(1), INTRA_LOD);
+  CHECK(pear != meshes[1] && isEqual(*pear, *meshes[1]));
+  CHECK(!cache.find(getKey(2, INTRA_LOD)));
+  CHECK(cache.find(getKey(0, INTRA_LOD)) == meshes[0] && cache.find(getKey(3, INTRA_LOD)) == meshes[3]);
+  CHECK(cache.getNumEntries() == 3);
+}
+
+// Threads that ask for the same and different meshes, with evictions in between, always get the right mesh.
+void checkConcurrency()
+{
+  constexpr ui32 NUM_THREADS = 8;
+  constexpr ui32 LODS[]      = {5, 7, 9, 11};
+
+  std::vector<FruitMesh> expected;
+  for (ui32 type = 0; type < 4; type++)
+  {
+    for (const ui32 lod : LODS)
+    {
+      expected.push_back(tessellateQuantized(type, lod));
+    }
+  }
+  FruitMeshCache cache(FruitMeshCache::getSizeInBytes(expected.back()) * 4);
+
+  std::vector<ui32>        numMismatches(NUM_THREADS, 0);
+  std::vector<std::thread> threads;
+  for (ui32 t = 0; t < NUM_THREADS; t++)
+  {
+    threads.emplace_back(
+        [&, t]()
+        {
+          for (ui32 i = 0; i < 200; i++)
+          {
+            const ui32 k    = (t * 5 + i * (i % 3 + 1)) % expected.size();
+            const auto mesh = cache.getOrTessellate(getProfile(k / 4), LODS[k % 4]);
+            numMismatches[t] += isEqual(*mesh, expected[k]) ? 0 : 1;
+          }
+        });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  for (ui32 t = 0; t < NUM_THREADS; t++)
+  {
+    CHECK(numMismatches[t] == 0);
+  }
+  CHECK(cache.getNumHits() + cache.getNumMisses() == NUM_THREADS * 200);
+  CHECK(cache.getNumHits() > 0 && cache.getNumMisses() >= expected.size());
+  CHECK(cache.getSizeInBytes() <= cache.getByteBudget());
+
+  size_t sizeInBytes = 0;
+  for (ui32 k = 0; k < expected.size(); k++)
+  {
+    if (const auto mesh = cache.find(getKey(k / 4, LODS[k % 4])))
+    {
+      CHECK(isEqual(*mesh, expected[k]));
+      sizeInBytes += FruitMeshCache::getSizeInBytes(*mesh);
+    }
+  }
+  CHECK(sizeInBytes == cache.getSizeInBytes());
+}
+} // namespace
+
+int main()
+{
+  checkKeys();
+  checkHitsAndMisses();
+  checkEviction();
+  checkConcurrency();
+  return finishChecks();
+}
@@ -0,0 +1,191 @@
+#include "Check.hpp"
+#include <cmath>
+#include <gimslib/fruit/FruitMorphAnimation.hpp>
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <stdexcept>
+
+using namespace gims;
+
+namespace
+{
+const FruitProfile& getProfile(FruitType type)
+{
+  return getFruitPreset(type).profile;
+}
+
+// Flower, small green fruit and ripe fruit, at the times 1, 3 and 7.
+std::vector<FruitKeyframe> createGrowth(FruitType type)
+{
+  const FruitProfile& ripe   = getProfile(type);
+  const FruitProfile  flower = {0.1f * ripe.p0, 0.1f * ripe.p1, 0.1f * ripe.p2, 0.1f * ripe.p3};
+  const FruitProfile  green  = {0.5f * ripe.p0, 0.4f * ripe.p1, 0.6f * ripe.p2, 0.5f * ripe.p3};
+  return {{1.0f, flower}, {3.0f, green}, {7.0f, ripe}};
+}
+
+// Linear interpolation of the keyframes in double precision, held before the first and after the last.
+FruitProfile interpolate(const std::vector<FruitKeyframe>& keyframes, f64 time)
+{
+  if (time <= keyframes.front().time)
+  {
+    return keyframes.front().profile;
+  }
+  for (size_t k = 0; k + 1 < keyframes.size(); k++)
+  {
+    if (time < keyframes[k + 1].time)
+    {
+      const f64           w    = (time - keyframes[k].time) / (keyframes[k + 1].time - keyframes[k].time);
+      const FruitProfile& from = keyframes[k].profile;
+      const FruitProfile& to   = keyframes[k + 1].profile;
+      const auto          mix  = [w](const f32v3& a, const f32v3& b)
+      { return f32v3((1.0 - w) * f64v3(a) + w * f64v3(b)); };
+      return {mix(from.p0, to.p0), mix(from.p1, to.p1), mix(from.p2, to.p2), mix(from.p3, to.p3)};
+    }
+  }
+  return keyframes.back().profile;
+}
+
+f32 getMaxDifference(const FruitProfile& a, const FruitProfile& b)
+{
+  return std::max(std::max(glm::length(a.p0 - b.p0), glm::length(a.p1 - b.p1)),
+                  std::max(glm::length(a.p2 - b.p2), glm::length(a.p3 - b.p3)));
+}
+
+// At the keyframe times an instance has exactly the keyframe's profile, before the first and after the last one it is
+// held, and in between it follows the linear interpolation, shifted by its start time and scaled by its rate.
+void checkKeyframes()
+{
+  const std::vector<FruitKeyframe> growth = createGrowth(FruitType::Apple);
+  FruitMorphAnimation              animation;
+  const ui32                       track = animation.addTrack(growth);
+  animation.addInstance(track, 0.0f);
+  animation.addInstance(track, 10.0f, 2.0f);
+  animation.addInstance(track, -4.0f, 0.5f);
+
+  FruitProfileArray profiles;
+  for (const FruitKeyframe& keyframe : growth)
+  {
+    animation.evaluate(keyframe.time, profiles);
+    CHECK(profiles.getProfile(0) == keyframe.profile);
+    animation.evaluate(10.0f + keyframe.time / 2.0f, profiles);
+    CHECK(profiles.getProfile(1) == keyframe.profile);
+    animation.evaluate(-4.0f + keyframe.time / 0.5f, profiles);
+    CHECK(profiles.getProfile(2) == keyframe.profile);
+  }
+  for (const f32 time : {-100.0f, 0.0f, 1.0f})
+  {
+    animation.evaluate(time, profiles);
+    CHECK(profiles.getProfile(0) == growth.front().profile);
+  }
+  for (const f32 time : {7.0f, 7.5f, 1e6f})
+  {
+    animation.evaluate(time, profiles);
+    CHECK(profiles.getProfile(0) == growth.back().profile);
+  }
+  for (ui32 i = 0; i <= 100; i++)
+  {
+    const f32 time = 0.1f * static_cast<f32>(i);
+    animation.evaluate(time, profiles);
+    CHECK(getMaxDifference(profiles.getProfile(0), interpolate(growth, time)) <= 1e-6f);
+    CHECK(getMaxDifference(profiles.getProfile(1), interpolate(growth, (time - 10.0f) * 2.0f)) <= 1e-6f);
+    CHECK(getMaxDifference(profiles.getProfile(2), interpolate(growth, (time + 4.0f) * 0.5f)) <= 1e-6f);
+  }
+}
+
+// All instances at once on all threads, ranges of any size, and single instances give the same profiles, also across
+// tracks of different lengths.
+void checkBatch()
+{
+  FruitMorphAnimation animation;
+  const ui32          apple     = animation.addTrack(createGrowth(FruitType::Apple));
+  const ui32          pear      = animation.addTrack(createGrowth(FruitType::Pear));
+  const ui32          lemon     = animation.addTrack({{0.0f, getProfile(FruitType::Lemon)}});
+  const ui32          tracks[3] = {apple, pear, lemon};
+  for (ui32 i = 0; i < 40001; i++)
+  {
+    animation.addInstance(tracks[i % 3], 0.001f * static_cast<f32>(i % 9000), 0.5f + 0.0001f * static_cast<f32>(i));
+  }
+
+  FruitProfileArray all;
+  animation.evaluate(5.0f, all);
+  CHECK(all.getSize() == animation.getNumInstances());
+
+  FruitProfileArray ranges;
+  ranges.resize(animation.getNumInstances());
+  for (const auto& [first, last] : {std::pair<size_t, size_t>(0, 5), {5, 17}, {17, 20000}, {20000, 40001}})
+  {
+    animation.evaluate(5.0f, first, last, ranges);
+  }
+  FruitProfileArray single;
+  single.resize(animation.getNumInstances());
+  for (size_t i = 0; i < animation.getNumInstances(); i++)
+  {
+    CHECK(ranges.getProfile(i) == all.getProfile(i));
+    if (i % 997 == 0)
+    {
+      animation.evaluate(5.0f, i, i + 1, single);
+      CHECK(single.getProfile(i) == all.getProfile(i));
+    }
+  }
+  CHECK(all.getProfile(2) == getProfile(FruitType::Lemon));
+}
+
+// Only instances whose profile changed are flagged: new ones, growing ones, and replanted ones.
+void checkChanges()
+{
+  FruitMorphAnimation animation;
+  const ui32          track = animation.addTrack(createGrowth(FruitType::Strawberry));
+  animation.addInstance(track, 0.0f);
+  animation.addInstance(track, -100.0f);
+  animation.addInstance(track, 100.0f);
+
+  FruitProfileArray   profiles;
+  std::vector<size_t> changed;
+  animation.evaluate(2.0f, profiles);
+  animation.getChangedInstances(changed);
+  CHECK(changed == std::vector<size_t>({0, 1, 2}));
+
+  animation.evaluate(2.0f, profiles);
+  animation.getChangedInstances(changed);
+  CHECK(changed.empty());
+
+  // Only the first instance grows, the others are ripe or not yet blooming.
+  animation.evaluate(2.5f, profiles);
+  animation.getChangedInstances(changed);
+  CHECK(changed == std::vector<size_t>({0}));
+  CHECK(animation.getChangedFlags() == std::vector<ui8>({1, 0, 0}));
+
+  animation.setInstance(1, track, 2.5f);
+  animation.addInstance(track, 2.5f);
+  animation.evaluate(2.5f, profiles);
+  animation.getChangedInstances(changed);
+  CHECK(changed == std::vector<size_t>({1, 3}));
+  CHECK(profiles.getSize() == 4 && profiles.getProfile(3) == profiles.getProfile(2));
+}
+
+// Invalid tracks and instances are rejected and leave the animation unchanged.
+void checkErrors()
+{
+  FruitMorphAnimation animation;
+  CHECK_THROWS(animation.addTrack({}), std::invalid_argument);
+  const FruitProfile& apple = getProfile(FruitType::Apple);
+  CHECK_THROWS(animation.addTrack({{1.0f, apple}, {1.0f, apple}}), std::invalid_argument);
+  CHECK_THROWS(animation.addTrack({{2.0f, apple}, {1.0f, apple}}), std::invalid_argument);
+  CHECK(animation.getNumTracks() == 0);
+
+  const ui32 track = animation.addTrack({{1.0f, apple}});
+  CHECK_THROWS(animation.addInstance(track + 1, 0.0f), std::out_of_range);
+  CHECK(animation.getNumInstances() == 0 && animation.getChangedFlags().empty());
+  animation.addInstance(track, 0.0f);
+  CHECK_THROWS(animation.setInstance(0, track + 1, 0.0f), std::out_of_range);
+  CHECK_THROWS(animation.setInstance(1, track, 0.0f), std::out_of_range);
+}
+} // namespace
+
+int main()
+{
+  checkKeyframes();
+  checkBatch();
+  checkChanges();
+  checkErrors();
+  return finishChecks();
+}
@@ -0,0 +1,141 @@
+#include "Check.hpp"
+#include <cmath>
+#include <filesystem>
+#include <gimslib/fruit/FruitMeasures.hpp>
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <gimslib/fruit/FruitProfileFitter.hpp>
+#include <gimslib/fruit/FruitTessellator.hpp>
+#include <stdexcept>
+
+using namespace gims;
+
+namespace
+{
+const std::filesystem::path DIRECTORY = "FruitProfileFitterTest";
+
+// A rigid motion of the scan, written out so that it needs nothing beyond the vector operations of glm.
+struct Motion
+{
+  f32v3 axis;
+  f32   angle;
+  f32v3 translation;
+
+  f32v3 rotate(const f32v3& v, f32 sign) const
+  {
+    const f32v3 k = glm::normalize(axis);
+    const f32   c = std::cos(sign * angle);
+    const f32   s = std::sin(sign * angle);
+    return v * c + glm::cross(k, v) * s + k * glm::dot(k, v) * (1.0f - c);
+  }
+
+  f32v3 apply(const f32v3& v) const
+  {
+    return rotate(v, 1.0f) + translation;
+  }
+
+  f32v3 invert(const f32v3& v) const
+  {
+    return rotate(v - translation, -1.0f);
+  }
+};
+
+// One motion per preset. The last one turns the fruit upside down, so the fitted profile runs the other way.
+const Motion MOTIONS[] = {{f32v3(1.0f, 2.0f, 3.0f), 0.7f, f32v3(1.0f, -2.0f, 3.0f)},
+                          {f32v3(-2.0f, 0.5f, 1.0f), 1.9f, f32v3(0.0f, 5.0f, 0.0f)},
+                          {f32v3(0.0f, 1.0f, 0.0f), 1.2f, f32v3(-3.0f, 0.0f, 0.5f)},
+                          {f32v3(1.0f, 0.0f, 0.0f), glm::pi<f32>(), f32v3(0.2f, 0.3f, -0.4f)}};
+
+FruitMesh moveMesh(FruitMesh mesh, const Motion& motion)
+{
+  for (f32v3& position : mesh.positions)
+  {
+    position = motion.apply(position);
+  }
+  return mesh;
+}
+
+f32 getSize(const FruitProfile& profile)
+{
+  const FruitMeasures measures = computeFruitMeasures(profile);
+  return glm::length(measures.aabbMax - measures.aabbMin);
+}
+
+// Fitting a fine ring tessellation of a moved preset recovers the axis and the control points of the preset, and the
+// errors stay below 0.3% of the fruit's size, also for the coarser octahedral grid of the fruit shaders.
+void checkPreset(ui32 type)
+{
+  const FruitProfile& preset = getFruitPreset(static_cast<FruitType>(type)).profile;
+  const Motion&       motion = MOTIONS[type];
+  const f32           size   = getSize(preset);
+
+  const FruitMesh       rings = moveMesh(tessellateFruitRings(preset, 129, 128), motion);
+  const FruitProfileFit fit   = fitFruitProfile(toCograBinaryMeshFile(rings));
+
+  const f32v3 presetAxis = motion.rotate(f32v3(0.0f, 0.0f, 1.0f), 1.0f);
+  const bool  upsideDown = glm::dot(fit.axisDirection, presetAxis) < 0.0f;
+  CHECK(std::abs(glm::dot(fit.axisDirection, presetAxis)) >= 1.0f - 1e-6f);
+  CHECK(upsideDown == (type == 3));
+  CHECK(glm::length(motion.invert(fit.axisOrigin) * f32v3(1.0f, 1.0f, 0.0f)) <= 1e-5f);
+
+  const f32v3 fitted[4]   = {fit.profile.p0, fit.profile.p1, fit.profile.p2, fit.profile.p3};
+  const f32v3 expected[4] = {preset.p0, preset.p1, preset.p2, preset.p3};
+  for (ui32 i = 0; i < 4; i++)
+  {
+    const f32v3 onAxis = motion.invert(fit.axisOrigin + fitted[i].z * fit.axisDirection);
+    const f32v3 point(fitted[i].x, 0.0f, onAxis.z);
+    CHECK(fitted[i].y == 0.0f);
+    CHECK(glm::length(point - expected[upsideDown ? 3 - i : i]) <= 5e-3f);
+  }
+  CHECK(fitted[0].x == 0.0f && fitted[3].x == 0.0f);
+  CHECK(fit.rmsError <= fit.hausdorffError && fit.hausdorffError <= 3e-4f * size);
+
+  const FruitProfileFit gridFit = fitFruitProfile(toCograBinaryMeshFile(moveMesh(tessellateFruit(preset, 65), motion)));
+  CHECK(gridFit.hausdorffError <= 3e-3f * size);
+}
+
+// Invalid meshes are rejected instead of read out of bounds.
+void checkInvalidMeshes()
+{
+  CHECK_THROWS(fitFruitProfile(CograBinaryMeshFile()), std::invalid_argument);
+
+  FruitMesh mesh = tessellateFruit(getFruitPreset(FruitType::Apple).profile, 9);
+  mesh.indices.back().z = static_cast<ui32>(mesh.positions.size());
+  CHECK_THROWS(fitFruitProfile(toCograBinaryMeshFile(mesh)), std::invalid_argument);
+
+  const FruitMesh flat = {{f32v3(0.0f), f32v3(1.0f), f32v3(2.0f)}, {ui32v3(0, 1, 2)}};
+  CHECK_THROWS(fitFruitProfile(toCograBinaryMeshFile(flat)), std::invalid_argument);
+}
+
+// All scans of a directory, sorted by name, with the same fits as one at a time. Other files are skipped.
+void checkDirectory()
+{
+  std::filesystem::remove_all(DIRECTORY);
+  std::filesystem::create_directories(DIRECTORY);
+  const FruitMesh lemon = tessellateFruitRings(getFruitPreset(FruitType::Lemon).profile, 33, 32);
+  const FruitMesh pear  = tessellateFruitRings(getFruitPreset(FruitType::Pear).profile, 33, 32);
+  toCograBinaryMeshFile(pear).save((DIRECTORY / "b.cbm").string());
+  toCograBinaryMeshFile(lemon).save((DIRECTORY / "a.cbm").string());
+  toCograBinaryMeshFile(lemon).save((DIRECTORY / "c.obj").string());
+
+  const std::vector<FruitScanFit> fits = fitFruitProfiles(DIRECTORY);
+  CHECK(fits.size() == 2);
+  if (fits.size() == 2)
+  {
+    CHECK(fits[0].file.filename() == "a.cbm" && fits[1].file.filename() == "b.cbm");
+    CHECK(fits[0].fit.profile == fitFruitProfile(toCograBinaryMeshFile(lemon)).profile);
+    CHECK(fits[1].fit.profile == fitFruitProfile(toCograBinaryMeshFile(pear)).profile);
+  }
+  std::filesystem::remove_all(DIRECTORY);
+}
+} // namespace
+
+int main()
+{
+  for (ui32 type = 0; type < static_cast<ui32>(FruitType::Count); type++)
+  {
+    checkPreset(type);
+  }
+  checkInvalidMeshes();
+  checkDirectory();
+  return finishChecks();
+}
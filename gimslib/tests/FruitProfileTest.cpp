@@ -0,0 +1,112 @@
+#include "Check.hpp"
+#include <algorithm>
+#include <cmath>
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <random>
+
+using namespace gims;
+
+namespace
+{
+// The same fruit with the profile running from the top to the bottom.
+FruitProfile reverse(const FruitProfile& profile)
+{
+  return {profile.p3, profile.p2, profile.p1, profile.p0};
+}
+
+// The derivative agrees with central differences of the curve in double precision.
+void checkDerivative(const FruitProfile& profile)
+{
+  for (ui32 i = 0; i <= 1000; i++)
+  {
+    const f32   t = static_cast<f32>(i) / 1000.0f;
+    const f64   h = 1e-4;
+    const f64v3 expected =
+        (evaluateCubicBezierCurve(profile, f64(t) + h) - evaluateCubicBezierCurve(profile, f64(t) - h)) / (2.0 * h);
+    const f64v3 actual(evaluateCubicBezierDerivative(profile, t));
+    CHECK(glm::length(actual - expected) <= 1e-5 * std::max(1.0, glm::length(expected)));
+  }
+}
+
+// The normal is a unit vector parallel to the cross product of central differences of the surface along two tangents
+// of the sphere. For profiles from the bottom to the top, the sphere and the fruit have the same orientation, so the
+// normal also points the same way. The normal of the reversed profile at the mirrored direction is the same.
+void checkNormals(const FruitProfile& profile)
+{
+  const FruitProfile                  reversed = reverse(profile);
+  std::mt19937                        random(7);
+  std::uniform_real_distribution<f32> uniform(-1.0f, 1.0f);
+  for (ui32 i = 0; i < 20000; i++)
+  {
+    const f32v3 direction = glm::normalize(f32v3(uniform(random), uniform(random), uniform(random)));
+    if (std::abs(direction.z) > 0.999f)
+    {
+      continue;
+    }
+    const f32v3 a  = glm::normalize(glm::cross(direction, f32v3(0.0f, 0.0f, 1.0f)));
+    const f32v3 b  = glm::cross(direction, a);
+    const f32   h  = 1e-3f;
+    const f32v3 du = calculateFruitCoordinates(profile, glm::normalize(direction + h * a)) -
+                     calculateFruitCoordinates(profile, glm::normalize(direction - h * a));
+    const f32v3 dv = calculateFruitCoordinates(profile, glm::normalize(direction + h * b)) -
+                     calculateFruitCoordinates(profile, glm::normalize(direction - h * b));
+    // cross(a, b) is the outward normal of the sphere.
+    const f32v3 expected = glm::normalize(glm::cross(du, dv));
+    const f32v3 normal   = calculateFruitNormal(profile, direction);
+    CHECK(std::abs(glm::length(normal) - 1.0f) <= 1e-6f);
+    CHECK(glm::dot(normal, expected) >= std::cos(glm::radians(1.0f)));
+
+    const f32v3 mirrored(direction.x, direction.y, -direction.z);
+    CHECK(glm::length(calculateFruitCoordinates(reversed, mirrored) - calculateFruitCoordinates(profile, direction)) <=
+          1e-5f);
+    CHECK(glm::length(calculateFruitNormal(reversed, mirrored) - normal) <= 1e-5f);
+  }
+
+  // At the poles, the normals point down at the bottom and up at the top.
+  const f32v3 bottom(0.0f, 0.0f, -1.0f);
+  const f32v3 top(0.0f, 0.0f, 1.0f);
+  CHECK(calculateFruitNormal(profile, bottom).z < -0.99f && calculateFruitNormal(profile, top).z > 0.99f);
+  CHECK(calculateFruitNormal(reversed, bottom).z > 0.99f && calculateFruitNormal(reversed, top).z < -0.99f);
+}
+
+// Forward differencing stays within the documented bounds of the exact curve for the ring counts of the tessellator,
+// also when restarted in the middle of the curve, and direct evaluation in float32 stays within 1e-6.
+void checkForwardDifferencing(const FruitProfile& profile)
+{
+  constexpr ui32 NUM_RINGS[]  = {16, 65, 257, 1025};
+  constexpr f32  MAX_ERRORS[] = {2.5e-6f, 2.5e-6f, 1e-5f, 4e-5f};
+  for (ui32 i = 0; i < 4; i++)
+  {
+    const ForwardDifferencingError error = measureForwardDifferencingError(profile, NUM_RINGS[i]);
+    CHECK(error.numSamples == NUM_RINGS[i]);
+    CHECK(error.forwardDifferencingMaxError <= MAX_ERRORS[i]);
+    CHECK(error.forwardDifferencingRmsError <= error.forwardDifferencingMaxError);
+    CHECK(error.directMaxError <= 1e-6f);
+    CHECK(error.directRmsError <= error.directMaxError);
+  }
+  CHECK(measureForwardDifferencingError(profile, 1).numSamples == 0);
+
+  const f32                dt = 1.0f / 256.0f;
+  BezierForwardDifferencer differencer(profile, 0.5f, dt);
+  for (ui32 i = 0; i <= 128; i++)
+  {
+    const f32 t = 0.5f + static_cast<f32>(i) * dt;
+    CHECK(glm::length(differencer.getValue() - evaluateCubicBezierCurve(profile, t)) <= 1e-5f);
+    differencer.step();
+  }
+}
+} // namespace
+
+int main()
+{
+  for (ui32 type = 0; type < static_cast<ui32>(FruitType::Count); type++)
+  {
+    const FruitProfile& profile = getFruitPreset(static_cast<FruitType>(type)).profile;
+    CHECK(profile.p0.z < profile.p3.z);
+    checkDerivative(profile);
+    checkNormals(profile);
+    checkForwardDifferencing(profile);
+  }
+  return finishChecks();
+}
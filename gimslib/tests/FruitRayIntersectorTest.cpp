@@ -0,0 +1,184 @@
+#include "Check.hpp"
+#include <cmath>
+#include <gimslib/fruit/FruitMeasures.hpp>
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <gimslib/fruit/FruitRayIntersector.hpp>
+#include <gimslib/fruit/FruitTessellator.hpp>
+#include <limits>
+#include <random>
+
+using namespace gims;
+
+namespace
+{
+constexpr ui32 INTRA_LOD = 257;
+constexpr f64  INFINITE  = std::numeric_limits<f64>::infinity();
+
+// Below this cosine between ray and surface, the tessellation may decide differently whether the ray hits.
+constexpr f64 GRAZING_COSINE = 0.05;
+
+struct MeshHit
+{
+  f64 distance = INFINITE;
+  //! Absolute cosine between the ray and the normal of the triangle.
+  f64 cosine = 0.0;
+};
+
+// Moller-Trumbore against every triangle, in double precision.
+MeshHit intersectMesh(const FruitMesh& mesh, const f32v3& origin, const f32v3& direction)
+{
+  const f64v3 o(origin);
+  const f64v3 d(direction);
+  MeshHit     result;
+  for (const ui32v3& triangle : mesh.indices)
+  {
+    const f64v3 v0(mesh.positions[triangle.x]);
+    const f64v3 e1          = f64v3(mesh.positions[triangle.y]) - v0;
+    const f64v3 e2          = f64v3(mesh.positions[triangle.z]) - v0;
+    const f64v3 p           = glm::cross(d, e2);
+    const f64   determinant = glm::dot(e1, p);
+    if (determinant == 0.0)
+    {
+      continue;
+    }
+    const f64v3 s = o - v0;
+    const f64v3 q = glm::cross(s, e1);
+    const f64   u = glm::dot(s, p) / determinant;
+    const f64   v = glm::dot(d, q) / determinant;
+    const f64   t = glm::dot(e2, q) / determinant;
+    if (u >= 0.0 && v >= 0.0 && u + v <= 1.0 && t >= 0.0 && t < result.distance)
+    {
+      result.distance = t;
+      result.cosine   = std::abs(glm::dot(d, glm::normalize(glm::cross(e1, e2))));
+    }
+  }
+  return result;
+}
+
+class Comparison
+{
+public:
+  explicit Comparison(const FruitProfile& profile)
+      : m_profile(profile)
+      , m_intersector(profile)
+      , m_mesh(tessellateFruit(profile, INTRA_LOD))
+      , m_measures(computeFruitMeasures(profile))
+  {
+  }
+
+  const FruitMeasures& getMeasures() const
+  {
+    return m_measures;
+  }
+
+  f32 getSize() const
+  {
+    return glm::length(m_measures.aabbMax - m_measures.aabbMin);
+  }
+
+  // The intersector and the fine tessellation agree on hit or miss unless the ray grazes the surface, and otherwise the
+  // hits lie within the tessellation error of each other. The hit lies on the surface, with its normal.
+  void compare(const f32v3& origin, const f32v3& direction)
+  {
+    const f32v3   d        = glm::normalize(direction);
+    const MeshHit expected = intersectMesh(m_mesh, origin, d);
+    FruitRayHit   hit;
+    const bool    isHit = m_intersector.intersect(origin, d, std::numeric_limits<f32>::infinity(), hit);
+    m_numRays++;
+    m_numHits += isHit ? 1 : 0;
+    if (isHit != (expected.distance < INFINITE))
+    {
+      CHECK((isHit ? std::abs(glm::dot(d, hit.normal)) : expected.cosine) <= GRAZING_COSINE);
+      return;
+    }
+    if (!isHit)
+    {
+      return;
+    }
+    const f32v3 onProfile = evaluateCubicBezierCurve(m_profile, hit.t);
+    CHECK(std::abs(hit.position.z - onProfile.z) <= 1e-5f * getSize());
+    CHECK(std::abs(glm::length(f32v2(hit.position)) - glm::length(f32v2(onProfile))) <= 1e-5f * getSize());
+    CHECK(std::abs(glm::length(hit.normal) - 1.0f) <= 1e-5f);
+    if (expected.cosine > GRAZING_COSINE)
+    {
+      // The distance along the normal between the surface and its tessellation.
+      CHECK(std::abs(hit.distance - expected.distance) * expected.cosine <= 5e-5 * getSize());
+      CHECK(std::abs(std::abs(glm::dot(d, hit.normal)) - expected.cosine) <= 0.02);
+    }
+  }
+
+  // Each set of rays must hit and miss the fruit.
+  void checkHitsAndMisses()
+  {
+    CHECK(m_numHits > m_numRays / 10 && m_numHits < m_numRays);
+    m_numRays = 0;
+    m_numHits = 0;
+  }
+
+private:
+  const FruitProfile&       m_profile;
+  const FruitRayIntersector m_intersector;
+  const FruitMesh           m_mesh;
+  const FruitMeasures       m_measures;
+  ui32                      m_numRays = 0;
+  ui32                      m_numHits = 0;
+};
+
+void checkPreset(ui32 type)
+{
+  const FruitProfile&                 profile = getFruitPreset(static_cast<FruitType>(type)).profile;
+  Comparison                          comparison(profile);
+  const FruitMeasures&                measures = comparison.getMeasures();
+  const f32                           size     = comparison.getSize();
+  const f32v3                         center   = 0.5f * (measures.aabbMin + measures.aabbMax);
+  std::mt19937                        random(type);
+  std::uniform_real_distribution<f32> uniform(-1.0f, 1.0f);
+
+  // Random rays from all directions towards the fruit.
+  for (ui32 i = 0; i < 200; i++)
+  {
+    const f32v3 origin = glm::normalize(f32v3(uniform(random), uniform(random), uniform(random)));
+    const f32v3 target = f32v3(uniform(random), uniform(random), uniform(random));
+    comparison.compare(center + 2.0f * size * origin, 0.4f * size * target - 2.0f * size * origin);
+  }
+  comparison.checkHitsAndMisses();
+
+  // Flat rays from 3 sizes away, which cross the height h next to the axis, with slopes on both sides of the threshold
+  // between horizontal and other rays. Slopes of a few thousandths used to miss in single precision.
+  for (const f32 slope : {0.0f, 2e-5f, -3e-4f, 9e-4f, -9.9e-4f, 1.01e-3f, 1.2e-3f, -1.2e-3f, 3e-3f, 1e-2f, -3e-2f})
+  {
+    for (ui32 i = 0; i < 40; i++)
+    {
+      const f32   h      = center.z + 0.5f * (measures.aabbMax.z - measures.aabbMin.z) * uniform(random);
+      const f32   angle  = glm::pi<f32>() * uniform(random);
+      const f32v3 side   = f32v3(std::cos(angle), std::sin(angle), 0.0f);
+      const f32v3 offset = 0.9f * measures.aabbMax.x * uniform(random) * f32v3(-side.y, side.x, 0.0f);
+      const f32v3 origin = offset - 3.0f * size * side + f32v3(0.0f, 0.0f, h - 3.0f * size * slope);
+      comparison.compare(origin, side + f32v3(0.0f, 0.0f, slope));
+    }
+    comparison.checkHitsAndMisses();
+  }
+
+  // Rays along the tangent plane of random surface points, shifted by 1% of the size in and out.
+  for (ui32 i = 0; i < 100; i++)
+  {
+    const f32v3 direction = octDecode(f32v2(uniform(random), uniform(random)));
+    const f32v3 point     = calculateFruitCoordinates(profile, direction);
+    const f32v3 normal    = calculateFruitNormal(profile, direction);
+    const f32v3 random3   = f32v3(uniform(random), uniform(random), uniform(random));
+    const f32v3 tangent   = glm::normalize(glm::cross(normal, random3));
+    const f32   shift     = (i % 2 == 0 ? 0.01f : -0.01f) * size;
+    comparison.compare(point + shift * normal - 3.0f * size * tangent, tangent);
+  }
+  comparison.checkHitsAndMisses();
+}
+} // namespace
+
+int main()
+{
+  for (ui32 type = 0; type < static_cast<ui32>(FruitType::Count); type++)
+  {
+    checkPreset(type);
+  }
+  return finishChecks();
+}
@@ -0,0 +1,103 @@
+#include "Check.hpp"
+#include <cmath>
+#include <gimslib/fruit/FruitMeasures.hpp>
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <gimslib/fruit/FruitSurfaceSampler.hpp>
+
+using namespace gims;
+
+namespace
+{
+const FruitProfile& getProfile(ui32 type)
+{
+  return getFruitPreset(static_cast<FruitType>(type)).profile;
+}
+
+// The part of the profile with t in [0;0.5], by de Casteljau.
+FruitProfile getLowerHalf(const FruitProfile& profile)
+{
+  const f32v3 p01  = 0.5f * (profile.p0 + profile.p1);
+  const f32v3 p12  = 0.5f * (profile.p1 + profile.p2);
+  const f32v3 p23  = 0.5f * (profile.p2 + profile.p3);
+  const f32v3 p012 = 0.5f * (p01 + p12);
+  const f32v3 p123 = 0.5f * (p12 + p23);
+  return {profile.p0, p01, p012, 0.5f * (p012 + p123)};
+}
+
+// The same seed gives the same samples, another seed different ones.
+void checkDeterminism()
+{
+  const FruitSurfaceSamples a = sampleFruitSurface(getProfile(0), 10000, 42);
+  const FruitSurfaceSamples b = sampleFruitSurface(getProfile(0), 10000, 42);
+  const FruitSurfaceSamples c = sampleFruitSurface(getProfile(0), 10000, 43);
+  CHECK(a.octahedralCoordinates == b.octahedralCoordinates && a.positions == b.positions && a.normals == b.normals);
+  CHECK(a.radius == b.radius && a.radius == c.radius);
+  CHECK(a.positions.size() == c.positions.size() && a.positions != c.positions);
+}
+
+// All requested samples are returned, they lie on the surface with its normal, no two are closer than the radius, and
+// they are spread over the surface in proportion to its area.
+void checkSamples(ui32 type, ui32 numSamples)
+{
+  const FruitProfile&       profile = getProfile(type);
+  const FruitSurfaceSamples samples = sampleFruitSurface(profile, numSamples, type);
+  const f32                 area    = computeFruitMeasures(profile).area;
+  CHECK(samples.positions.size() == numSamples);
+  CHECK(samples.octahedralCoordinates.size() == numSamples && samples.normals.size() == numSamples);
+
+  // The radius fills 60% of the density of random sequential packing, which covers 54.7% of the plane.
+  const f32 fill = glm::pi<f32>() * samples.radius * samples.radius * static_cast<f32>(numSamples) / (4.0f * area);
+  CHECK(std::abs(fill - 0.6f * 0.547f) <= 1e-4f);
+
+  ui32 numLower    = 0;
+  ui32 numPositive = 0;
+  for (size_t i = 0; i < samples.positions.size(); i++)
+  {
+    const f32v2& coordinates = samples.octahedralCoordinates[i];
+    const f32v3  direction   = octDecode(coordinates);
+    CHECK(std::abs(coordinates.x) <= 1.0f && std::abs(coordinates.y) <= 1.0f);
+    CHECK(samples.positions[i] == calculateFruitCoordinates(profile, direction));
+    CHECK(samples.normals[i] == calculateFruitNormal(profile, direction));
+    numLower += direction.z < 0.0f ? 1 : 0;
+    numPositive += samples.positions[i].x > 0.0f ? 1 : 0;
+
+    for (size_t j = 0; j < i; j++)
+    {
+      const f32v3 d = samples.positions[j] - samples.positions[i];
+      CHECK(glm::dot(d, d) >= samples.radius * samples.radius);
+    }
+  }
+
+  // Blue noise deviates less from the area than independent samples, whose standard deviation is 0.5 / sqrt(n).
+  const f32 tolerance     = 2.0f / std::sqrt(static_cast<f32>(numSamples));
+  const f32 lowerFraction = computeFruitMeasures(getLowerHalf(profile)).area / area;
+  CHECK(std::abs(static_cast<f32>(numLower) / numSamples - lowerFraction) <= tolerance);
+  CHECK(std::abs(static_cast<f32>(numPositive) / numSamples - 0.5f) <= tolerance);
+}
+
+// No samples are requested, or the surface has no area.
+void checkEmpty()
+{
+  const FruitSurfaceSamples none = sampleFruitSurface(getProfile(0), 0, 1);
+  CHECK(none.positions.empty() && none.radius == 0.0f);
+
+  const FruitProfile        line = {f32v3(0.0f, 0.0f, -1.0f), f32v3(0.0f, 0.0f, -0.3f), f32v3(0.0f, 0.0f, 0.3f),
+                                    f32v3(0.0f, 0.0f, 1.0f)};
+  const FruitSurfaceSamples axis = sampleFruitSurface(line, 100, 1);
+  CHECK(axis.positions.empty() && axis.octahedralCoordinates.empty() && axis.normals.empty());
+}
+} // namespace
+
+int main()
+{
+  checkDeterminism();
+  for (ui32 type = 0; type < static_cast<ui32>(FruitType::Count); type++)
+  {
+    for (const ui32 numSamples : {1, 100, 5000})
+    {
+      checkSamples(type, numSamples);
+    }
+  }
+  checkEmpty();
+  return finishChecks();
+}
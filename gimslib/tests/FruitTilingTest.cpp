@@ -0,0 +1,95 @@
+#include "Check.hpp"
+#include <algorithm>
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <gimslib/fruit/FruitTessellator.hpp>
+#include <gimslib/fruit/FruitTiling.hpp>
+#include <stdexcept>
+#include <vector>
+
+using namespace gims;
+
+namespace
+{
+// The tiles cover each quad of the grid exactly once, with at most MAX_QUADS x MAX_QUADS quads per tile.
+void checkCoverage(const FruitTiling& tiling)
+{
+  const ui32        numQuads = tiling.gridSize - 1;
+  std::vector<ui32> coverage(static_cast<size_t>(numQuads) * numQuads, 0);
+  for (ui32 i = 0; i < tiling.getNumTiles(); i++)
+  {
+    const FruitTile tile = getFruitTile(tiling, i);
+    CHECK(tile.numQuadsX >= 1 && tile.numQuadsX <= FruitTiling::MAX_QUADS);
+    CHECK(tile.numQuadsY >= 1 && tile.numQuadsY <= FruitTiling::MAX_QUADS);
+    CHECK(tile.getNumVertices() <= 256 && tile.getNumTriangles() <= 256);
+    CHECK(tile.firstX + tile.numQuadsX <= numQuads && tile.firstY + tile.numQuadsY <= numQuads);
+    for (ui32 y = tile.firstY; y < std::min(tile.firstY + tile.numQuadsY, numQuads); y++)
+    {
+      for (ui32 x = tile.firstX; x < std::min(tile.firstX + tile.numQuadsX, numQuads); x++)
+      {
+        coverage[static_cast<size_t>(y) * numQuads + x]++;
+      }
+    }
+  }
+  CHECK(std::all_of(coverage.begin(), coverage.end(), [](ui32 count) { return count == 1; }));
+}
+
+// The meshlets have the triangles of tessellateFruit(), with the same diagonals and the same orientation.
+void checkTriangles(const FruitTiling& tiling)
+{
+  const FruitMesh mesh = tessellateFruit(getFruitPreset(FruitType::Apple).profile, tiling.gridSize);
+
+  // Rotate each triangle so that its smallest index comes first; this keeps the orientation.
+  const auto normalize = [](ui32v3 t)
+  {
+    while (t.x > t.y || t.x > t.z)
+    {
+      t = ui32v3(t.y, t.z, t.x);
+    }
+    return t;
+  };
+  const auto less = [](const ui32v3& a, const ui32v3& b)
+  { return a.x != b.x ? a.x < b.x : a.y != b.y ? a.y < b.y : a.z < b.z; };
+
+  std::vector<ui32v3> expected;
+  for (const ui32v3& triangle : mesh.indices)
+  {
+    expected.push_back(normalize(triangle));
+  }
+  std::vector<ui32v3> actual;
+  for (const FruitMeshlet& meshlet : buildFruitMeshlets(tiling))
+  {
+    CHECK(meshlet.vertices.size() <= 256 && meshlet.triangles.size() <= 256);
+    for (const ui32v3& triangle : meshlet.triangles)
+    {
+      actual.push_back(
+          normalize(ui32v3(meshlet.vertices[triangle.x], meshlet.vertices[triangle.y], meshlet.vertices[triangle.z])));
+    }
+  }
+  std::sort(expected.begin(), expected.end(), less);
+  std::sort(actual.begin(), actual.end(), less);
+  CHECK(actual.size() == tiling.getNumTriangles());
+  CHECK(actual == expected);
+}
+} // namespace
+
+int main()
+{
+  CHECK_THROWS(planFruitTiling(1), std::invalid_argument);
+  CHECK_THROWS(planFruitTiling(FruitTiling::MAX_GRID_SIZE + 1), std::invalid_argument);
+  CHECK_THROWS(getFruitTile(planFruitTiling(13), 4), std::out_of_range);
+
+  // Grids up to one tile, a few tiles with uneven ranges, and the largest grid.
+  CHECK(planFruitTiling(12).getNumTiles() == 1);
+  CHECK(planFruitTiling(13).getNumTiles() == 4);
+  CHECK(planFruitTiling(FruitTiling::MAX_GRID_SIZE).tilesPerSide == 94);
+  for (ui32 gridSize = 2; gridSize <= 300; gridSize++)
+  {
+    const FruitTiling tiling = planFruitTiling(gridSize);
+    checkCoverage(tiling);
+    checkTriangles(tiling);
+  }
+  checkCoverage(planFruitTiling(FruitTiling::MAX_GRID_SIZE));
+  checkTriangles(planFruitTiling(FruitTiling::MAX_GRID_SIZE));
+
+  return finishChecks();
+}
@@ -0,0 +1,136 @@
+#include "Check.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <gimslib/fruit/FruitTessellator.hpp>
+#include <gimslib/fruit/FruitTopology.hpp>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace gims;
+
+namespace
+{
+std::string readFile(const std::filesystem::path& fileName)
+{
+  std::ifstream inFile(fileName, std::ios::in | std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+}
+
+// The triangles of an n x n grid, written out from the diagonal flip rule: the diagonals of all quads point towards
+// the center of the grid.
+std::vector<ui32v3> createTriangles(ui32 n)
+{
+  std::vector<ui32v3> triangles;
+  const ui32          half = n / 2;
+  for (ui32 y = 0; y + 1 < n; y++)
+  {
+    for (ui32 x = 0; x + 1 < n; x++)
+    {
+      const ui32 v00 = y * n + x;
+      const ui32 v10 = v00 + 1;
+      const ui32 v01 = v00 + n;
+      const ui32 v11 = v01 + 1;
+      if ((x < half && y < half) || (x >= half && y >= half))
+      {
+        triangles.push_back(ui32v3(v00, v10, v01));
+        triangles.push_back(ui32v3(v10, v11, v01));
+      }
+      else
+      {
+        triangles.push_back(ui32v3(v00, v10, v11));
+        triangles.push_back(ui32v3(v11, v01, v00));
+      }
+    }
+  }
+  return triangles;
+}
+
+// Vertex y * n + x of an n x n grid has the parameters (2 x / (n - 1) - 1, 2 y / (n - 1) - 1).
+f32v2 getParameters(ui32 n, ui32 vertex)
+{
+  const f64 x = static_cast<f64>(vertex % n);
+  const f64 y = static_cast<f64>(vertex / n);
+  return f32v2(2.0 * x / (n - 1) - 1.0, 2.0 * y / (n - 1) - 1.0);
+}
+
+// All triangles are counterclockwise in the octahedral domain.
+bool isCounterclockwise(ui32 n, const ui32v3& triangle)
+{
+  const f32v2 e1 = getParameters(n, triangle.y) - getParameters(n, triangle.x);
+  const f32v2 e2 = getParameters(n, triangle.z) - getParameters(n, triangle.x);
+  return e1.x * e2.y - e1.y * e2.x > 0.0f;
+}
+
+// The tables and tessellateFruit() follow the grid layout and flip rule written out above, also for grids without a
+// table.
+void checkTables()
+{
+  const FruitProfile& profile = getFruitPreset(FruitType::Apple).profile;
+  for (ui32 lod = 0; lod < FruitTopologyTables::NUM_LODS; lod++)
+  {
+    const ui32                n         = FruitTopologyTables::INTRA_LODS[lod];
+    const std::vector<ui32v3> triangles = createTriangles(n);
+    const ui32                first     = FRUIT_TOPOLOGY.triangleOffsets[lod];
+    CHECK(getFruitTopologyIndex(n) == static_cast<i32>(lod));
+    CHECK(triangles.size() == 2 * (n - 1) * (n - 1));
+    for (size_t i = 0; i < triangles.size(); i++)
+    {
+      const std::array<ui32, 3>& triangle = FRUIT_TOPOLOGY.triangles[first + i];
+      CHECK(triangle[0] == triangles[i].x && triangle[1] == triangles[i].y && triangle[2] == triangles[i].z);
+    }
+    for (ui32 vertex = 0; vertex < n * n; vertex++)
+    {
+      const std::array<f32, 2>& parameters = FRUIT_TOPOLOGY.parameters[FRUIT_TOPOLOGY.vertexOffsets[lod] + vertex];
+      CHECK(std::abs(parameters[0] - getParameters(n, vertex).x) <= 1e-7f);
+      CHECK(std::abs(parameters[1] - getParameters(n, vertex).y) <= 1e-7f);
+    }
+  }
+  CHECK(getFruitTopologyIndex(13) == -1);
+
+  for (const ui32 n : {2u, 3u, 4u, 7u, 11u, 13u, 16u})
+  {
+    const FruitMesh           mesh      = tessellateFruit(profile, n);
+    const std::vector<ui32v3> triangles = createTriangles(n);
+    CHECK(mesh.indices == triangles && mesh.positions.size() == n * n);
+    for (const ui32v3& triangle : triangles)
+    {
+      CHECK(isCounterclockwise(n, triangle));
+    }
+    for (ui32 vertex = 0; vertex < n * n; vertex++)
+    {
+      const f32v3 expected = calculateFruitCoordinates(profile, octDecode(getParameters(n, vertex)));
+      CHECK(glm::length(mesh.positions[vertex] - expected) <= 1e-6f);
+    }
+  }
+}
+} // namespace
+
+//! argv[1] is the FruitTopology.hlsli that Fruits.hlsl includes.
+int main(int argc, char** argv)
+{
+  checkTables();
+
+  // The committed shader tables are the current generator output; regenerate them with FruitTopologyWriter otherwise.
+  CHECK(argc == 2);
+  if (argc == 2)
+  {
+    const bool current = readFile(argv[1]) == fruitTopologyToHLSL();
+    CHECK(current);
+    if (!current)
+    {
+      std::cerr << argv[1] << " is out of date, run FruitTopologyWriter " << argv[1] << std::endl;
+    }
+  }
+
+  const std::filesystem::path fileName = "FruitTopologyTest.hlsli";
+  writeFruitTopologyHLSL(fileName);
+  CHECK(readFile(fileName) == fruitTopologyToHLSL());
+  std::filesystem::remove(fileName);
+  CHECK_THROWS(writeFruitTopologyHLSL("missing-directory/FruitTopology.hlsli"), std::runtime_error);
+
+  return finishChecks();
+}
@@ -0,0 +1,271 @@
+#include "Check.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <gimslib/emu/MeshShaderKernels.hpp>
+#include <gimslib/fruit/FruitGeomorph.hpp>
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <gimslib/fruit/FruitTessellator.hpp>
+#include <vector>
+
+using namespace gims;
+
+namespace
+{
+// A triangle by the positions of its vertices, quantized to 1e-5 and rotated so that the smallest vertex comes first,
+// which keeps the orientation.
+using TriangleKey = std::array<std::array<i64, 3>, 3>;
+
+TriangleKey getTriangleKey(const f32v3& a, const f32v3& b, const f32v3& c)
+{
+  const auto quantize = [](const f32v3& p)
+  { return std::array<i64, 3> {std::llround(p.x * 1e5), std::llround(p.y * 1e5), std::llround(p.z * 1e5)}; };
+  TriangleKey result = {quantize(a), quantize(b), quantize(c)};
+  std::rotate(result.begin(), std::min_element(result.begin(), result.end()), result.end());
+  return result;
+}
+
+// No errors and the counts the kernel requests.
+void checkStats(const MeshShaderDispatchStats& stats, size_t numGroups, size_t numVertices, size_t numPrimitives)
+{
+  CHECK(stats.getNumErrors() == 0);
+  CHECK(stats.firstError.empty());
+  CHECK(stats.numGroups == numGroups);
+  CHECK(stats.numVertices == numVertices);
+  CHECK(stats.numPrimitives == numPrimitives);
+}
+
+// A kernel that makes each kind of error. Thread 0 writes a vertex before SetMeshOutputCounts() and then requests
+// more vertices than the output array holds; thread 1 repeats that request, which is no error, and then requests other
+// counts, which is. In the second phase, thread 0 writes two of the 8 vertices and one past the array, indexes
+// a vertex past the count, writes a degenerate primitive, one past the count, and leaves the third one unwritten.
+struct BrokenMeshShader : MeshShaderKernelTypes<f32v3>
+{
+  MeshShaderLayout getLayout() const
+  {
+    MeshShaderLayout result;
+    result.numThreads    = ui32v3(2, 1, 1);
+    result.maxVertices   = 8;
+    result.maxPrimitives = 4;
+    result.numPhases     = 2;
+    return result;
+  }
+
+  void operator()(const MeshShaderThread& thread, const Payload&, GroupShared&, Outputs& outputs) const
+  {
+    if (thread.phase == 0 && thread.groupIndex == 0)
+    {
+      outputs.setVertex(0, f32v3(0.0f));
+      outputs.setMeshOutputCounts(9, 3);
+    }
+    else if (thread.phase == 0)
+    {
+      outputs.setMeshOutputCounts(9, 3);
+      outputs.setMeshOutputCounts(4, 2);
+    }
+    else if (thread.groupIndex == 0)
+    {
+      outputs.setVertex(0, f32v3(0.0f));
+      outputs.setVertex(1, f32v3(1.0f));
+      outputs.setVertex(8, f32v3(2.0f));
+      outputs.setIndices(0, ui32v3(0, 1, 8));
+      outputs.setIndices(1, ui32v3(0, 1, 1));
+      outputs.setIndices(3, ui32v3(0, 1, 2));
+    }
+  }
+};
+
+// Every error of the broken kernel is counted, in each of two groups, and the first one of group 0 is reported.
+void checkErrors()
+{
+  const MeshShaderDispatchStats stats = dispatchMeshShader(BrokenMeshShader(), ui32v3(2, 1, 1)).stats;
+  CHECK(stats.numGroups == 2);
+  CHECK(stats.numVertices == 2 * 8 && stats.numPrimitives == 2 * 3);
+  CHECK(stats.numInvalidCounts == 2 * 2);
+  CHECK(stats.numEarlyWrites == 2 * 1);
+  CHECK(stats.numOutOfRangeWrites == 2 * 2);
+  CHECK(stats.numUnwrittenVertices == 2 * 6);
+  CHECK(stats.numUnwrittenPrimitives == 2 * 1);
+  CHECK(stats.numOutOfRangeIndices == 2 * 1);
+  CHECK(stats.numDegeneratePrimitives == 2 * 1);
+  CHECK(stats.getNumErrors() == 2 * 13);
+  CHECK(stats.firstError == "Group (0, 0, 0): vertex 0 written before SetMeshOutputCounts");
+}
+
+// AXTwoOctaspheres and the inter LOD slider of AXOctasphereWithInterLOD, 1 to 28 octaspheres.
+void checkOctaspheres()
+{
+  const OctaspheresMeshShader twoOctaspheres;
+  checkStats(dispatchMeshShader(twoOctaspheres, ui32v3(1, 1, 1)).stats, 1, 2 * 9 * 9, 2 * 2 * 8 * 8);
+
+  for (ui32 numOctaspheres = 1; numOctaspheres <= 28; numOctaspheres++)
+  {
+    const size_t          n = OctaspheresMeshShader::getInterLODGridSize(numOctaspheres);
+    OctaspheresMeshShader kernel;
+    kernel.numOctaspheres = numOctaspheres;
+    kernel.gridSize       = static_cast<ui32>(n);
+    checkStats(dispatchMeshShader(kernel, ui32v3(1, 1, 1)).stats, 1, numOctaspheres * n * n,
+               2 * numOctaspheres * (n - 1) * (n - 1));
+  }
+}
+
+// The intra LOD slider of AXOctasphereWithIntraLOD, 1 to 5, i.e., grids 3 to 11.
+void checkOctahedron()
+{
+  for (i32 intraLevelOfDetails = 1; intraLevelOfDetails <= 5; intraLevelOfDetails++)
+  {
+    const size_t         n = static_cast<size_t>(intraLevelOfDetails * 2 + 1);
+    OctahedronMeshShader kernel;
+    kernel.intraLOD = intraLevelOfDetails * 2 + 1;
+    checkStats(dispatchMeshShader(kernel, ui32v3(1, 1, 1)).stats, 1, n * n, 2 * (n - 1) * (n - 1));
+  }
+}
+
+// The inter sphere LOD slider of AXUVSphereWithIntraLOD, 1 to 18 patches per side.
+void checkUVSphere()
+{
+  for (i32 interSphereLOD = 1; interSphereLOD <= 18; interSphereLOD++)
+  {
+    const ui32         patchesPerSide = static_cast<ui32>(interSphereLOD);
+    const size_t       numPatches     = static_cast<size_t>(patchesPerSide) * patchesPerSide;
+    UVSphereMeshShader kernel;
+    kernel.interSphereLOD = interSphereLOD;
+    checkStats(dispatchMeshShader(kernel, ui32v3(patchesPerSide, patchesPerSide, 1)).stats, numPatches,
+               numPatches * 11 * 11, numPatches * 2 * 10 * 10);
+  }
+}
+
+// The inter LOD slider of the four fruit renderers, 1 to 28 fruits, with each preset's profile.
+void checkFruitRenderers()
+{
+  for (ui32 type = 0; type < static_cast<ui32>(FruitType::Count); type++)
+  {
+    for (i32 interLOD = 1; interLOD <= 28; interLOD++)
+    {
+      const size_t            numFruits = static_cast<size_t>(interLOD);
+      const size_t            n         = calculateIntraLOD(128 / static_cast<ui32>(interLOD));
+      FruitRendererMeshShader kernel;
+      kernel.interLOD = interLOD;
+      kernel.profile  = getFruitPreset(static_cast<FruitType>(type)).profile;
+      checkStats(dispatchMeshShader(kernel, ui32v3(1, 1, 1)).stats, 1, numFruits * n * n,
+                 2 * numFruits * (n - 1) * (n - 1));
+    }
+  }
+}
+
+// One record per grid, all with the profile at the origin.
+std::vector<FruitInstanceRecord> createRecords(const FruitProfile& profile, const std::vector<FruitInstanceLOD>& lods)
+{
+  FruitInstanceArray instances;
+  instances.resize(lods.size());
+  for (size_t i = 0; i < lods.size(); i++)
+  {
+    FruitInstance instance;
+    instance.profile = profile;
+    instances.setInstance(i, instance);
+  }
+  std::vector<FruitInstanceRecord> result(lods.size());
+  buildFruitInstanceRecords(instances, lods.data(), 0, lods.size(), result.data());
+  return result;
+}
+
+// groupsPerInstance as the renderer computes it from the finest grid.
+ui32 getGroupsPerInstance(const std::vector<FruitInstanceLOD>& lods)
+{
+  ui32 numTiles = 0;
+  for (const FruitInstanceLOD& lod : lods)
+  {
+    numTiles = std::max(numTiles, planFruitTiling(lod.gridSize).getNumTiles());
+  }
+  return (numTiles + FruitsPayload::AS_GROUP_SIZE - 1) / FruitsPayload::AS_GROUP_SIZE;
+}
+
+// MS_main of Fruits.hlsl outputs the triangles of tessellateFruit(), or of tessellateMorphedFruit() for morphed grids,
+// with the same orientation, over the grid sizes of the slider up to the renderer's finest grid 257. Odd grids up to 11
+// take the topology tables, all others the tiles.
+void checkFruits(bool cullPrimitives)
+{
+  const FruitProfile            profile = getFruitPreset(FruitType::Pear).profile;
+  std::vector<FruitInstanceLOD> lods;
+  for (ui32 gridSize = 2; gridSize <= 40; gridSize++)
+  {
+    lods.push_back({gridSize, 0, 0.0f});
+  }
+  for (const ui32 gridSize : {65u, 129u, 130u, 257u})
+  {
+    lods.push_back({gridSize, 0, 0.0f});
+  }
+  for (const ui32 gridSize : {5u, 9u, 17u, 33u})
+  {
+    lods.push_back({gridSize, 0, 0.5f});
+    lods.push_back({gridSize, 0, 1.0f});
+  }
+  const std::vector<FruitInstanceRecord> records           = createRecords(profile, lods);
+  const ui32                             groupsPerInstance = getGroupsPerInstance(lods);
+
+  FruitsMeshShader kernel;
+  kernel.instances      = records.data();
+  kernel.viewportSize   = f32v2(1280.0f, 720.0f);
+  kernel.cullPrimitives = cullPrimitives;
+
+  const auto launches = emulateFruitsAmplification(records.data(), records.size(), groupsPerInstance, nullptr, nullptr);
+  const auto dispatch = dispatchMeshShader(kernel, launches);
+
+  size_t numGroups     = 0;
+  size_t numVertices   = 0;
+  size_t numPrimitives = 0;
+  for (const FruitInstanceLOD& lod : lods)
+  {
+    const FruitTiling tiling = planFruitTiling(lod.gridSize);
+    numGroups += tiling.getNumTiles();
+    numPrimitives += tiling.getNumTriangles();
+    for (ui32 tile = 0; tile < tiling.getNumTiles(); tile++)
+    {
+      numVertices += getFruitTile(tiling, tile).getNumVertices();
+    }
+  }
+  checkStats(dispatch.stats, numGroups, numVertices, numPrimitives);
+
+  // The groups are in launch order, i.e., by instance.
+  std::vector<std::vector<TriangleKey>> actual(lods.size());
+  for (size_t launch = 0, group = 0; launch < launches.size(); launch++)
+  {
+    for (ui32 i = 0; i < launches[launch].numGroups.x; i++, group++)
+    {
+      const auto& output = dispatch.groups[group];
+      for (const ui32v3& t : output.indices)
+      {
+        actual[launches[launch].payload.instance].push_back(
+            getTriangleKey(output.vertices[t.x].viewSpacePosition, output.vertices[t.y].viewSpacePosition,
+                           output.vertices[t.z].viewSpacePosition));
+      }
+    }
+  }
+  for (size_t i = 0; i < lods.size(); i++)
+  {
+    const FruitMesh mesh = lods[i].morphFactor > 0.0f
+                               ? tessellateMorphedFruit(profile, lods[i].gridSize, lods[i].morphFactor)
+                               : tessellateFruit(profile, lods[i].gridSize);
+    std::vector<TriangleKey> expected;
+    for (const ui32v3& t : mesh.indices)
+    {
+      expected.push_back(getTriangleKey(mesh.positions[t.x], mesh.positions[t.y], mesh.positions[t.z]));
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual[i].begin(), actual[i].end());
+    CHECK(actual[i] == expected);
+  }
+}
+} // namespace
+
+int main()
+{
+  checkErrors();
+  checkOctaspheres();
+  checkOctahedron();
+  checkUVSphere();
+  checkFruitRenderers();
+  checkFruits(false);
+  checkFruits(true);
+  return finishChecks();
+}
@@ -0,0 +1,254 @@
+#include "Check.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <gimslib/fruit/FruitProfile.hpp>
+#include <gimslib/fruit/ProfileCurve.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace gims;
+
+namespace
+{
+// Evaluates the expressions that toHLSL() emits: sums of products of float3(...) literals, numbers, parentheses,
+// scalar variables and elements of a float3 array, e.g., "coefficients[i + 1] + l * (...)".
+class HLSLExpression
+{
+public:
+  HLSLExpression(const std::string& text, const std::map<std::string, f32>& scalars,
+                 const std::vector<f32v3>& coefficients)
+      : m_text(text)
+      , m_position(0)
+      , m_scalars(scalars)
+      , m_coefficients(coefficients)
+  {
+  }
+
+  //! Returns the value of the whole text, or NaN if it is not a complete expression.
+  f32v3 evaluate()
+  {
+    const f32v3 result = parseSum();
+    skipSpaces();
+    return m_position == m_text.size() ? result : f32v3(std::nanf(""));
+  }
+
+private:
+  void skipSpaces()
+  {
+    while (m_position < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_position])))
+    {
+      m_position++;
+    }
+  }
+
+  bool accept(const std::string& token)
+  {
+    skipSpaces();
+    if (m_text.compare(m_position, token.size(), token) != 0)
+    {
+      return false;
+    }
+    m_position += token.size();
+    return true;
+  }
+
+  f32v3 parseSum()
+  {
+    f32v3 result = parseProduct();
+    while (accept("+"))
+    {
+      result += parseProduct();
+    }
+    return result;
+  }
+
+  f32v3 parseProduct()
+  {
+    f32v3 result = parseFactor();
+    while (accept("*"))
+    {
+      result *= parseFactor();
+    }
+    return result;
+  }
+
+  f32v3 parseFactor()
+  {
+    if (accept("("))
+    {
+      const f32v3 result = parseSum();
+      return accept(")") ? result : f32v3(std::nanf(""));
+    }
+    if (accept("float3("))
+    {
+      const f32 x = parseSum().x;
+      accept(",");
+      const f32 y = parseSum().x;
+      accept(",");
+      const f32 z = parseSum().x;
+      return accept(")") ? f32v3(x, y, z) : f32v3(std::nanf(""));
+    }
+    skipSpaces();
+    if (std::isalpha(static_cast<unsigned char>(m_text[m_position])))
+    {
+      const size_t begin = m_position;
+      while (m_position < m_text.size() && std::isalnum(static_cast<unsigned char>(m_text[m_position])))
+      {
+        m_position++;
+      }
+      const std::string name = m_text.substr(begin, m_position - begin);
+      if (name == "coefficients" && accept("["))
+      {
+        const size_t index = static_cast<size_t>(parseSum().x);
+        return accept("]") && index < m_coefficients.size() ? m_coefficients[index] : f32v3(std::nanf(""));
+      }
+      return m_scalars.contains(name) ? f32v3(m_scalars.at(name)) : f32v3(std::nanf(""));
+    }
+    size_t    length = 0;
+    const f32 value  = std::stof(m_text.substr(m_position), &length);
+    m_position += length;
+    return f32v3(value);
+  }
+
+  const std::string&                m_text;
+  size_t                            m_position;
+  const std::map<std::string, f32>& m_scalars;
+  const std::vector<f32v3>&         m_coefficients;
+};
+
+// Returns the text between the first occurrence of begin and the following occurrence of end.
+std::string extract(const std::string& text, const std::string& begin, const std::string& end)
+{
+  const size_t first = text.find(begin);
+  if (first == std::string::npos)
+  {
+    return {};
+  }
+  const size_t last = text.find(end, first + begin.size());
+  return last == std::string::npos ? std::string() : text.substr(first + begin.size(), last - first - begin.size());
+}
+
+// de Casteljau in double precision, independent of the power basis.
+f64v3 evaluateBezierReference(std::vector<f64v3> points, f64 t)
+{
+  for (size_t n = points.size(); n > 1; n--)
+  {
+    for (size_t i = 0; i + 1 < n; i++)
+    {
+      points[i] = (1.0 - t) * points[i] + t * points[i + 1];
+    }
+  }
+  return points[0];
+}
+
+// The uniform cubic B-spline basis functions in double precision.
+f64v3 evaluateBSplineReference(const std::vector<f64v3>& points, ui32 numSegments, f64 t)
+{
+  const f64  u       = t * numSegments;
+  const ui32 segment = std::min(static_cast<ui32>(u), numSegments - 1);
+  const f64  l       = u - segment;
+  return ((1.0 - l) * (1.0 - l) * (1.0 - l) * points[segment] +
+          (3.0 * l * l * l - 6.0 * l * l + 4.0) * points[segment + 1] +
+          (-3.0 * l * l * l + 3.0 * l * l + 3.0 * l + 1.0) * points[segment + 2] + l * l * l * points[segment + 3]) /
+         6.0;
+}
+
+// The cubic Bezier curve and its HLSL function agree with evaluateCubicBezierCurve(), which the fruit shaders use.
+void checkCubicBezier(const FruitProfile& profile)
+{
+  const ProfileCurve<Bezier, 3> curve({profile.p0, profile.p1, profile.p2, profile.p3});
+  const std::string             hlsl = curve.toHLSL("evaluateProfileCurve");
+  CHECK(hlsl.starts_with("float3 evaluateProfileCurve(float t)\n{\n    return "));
+  const std::string expression = extract(hlsl, "return ", ";\n}\n");
+  CHECK(!expression.empty());
+  for (ui32 i = 0; i <= 100; i++)
+  {
+    const f32   t        = static_cast<f32>(i) / 100.0f;
+    const f32v3 expected = evaluateCubicBezierCurve(profile, t);
+    CHECK(glm::length(curve.evaluate(t) - expected) <= 1e-6f);
+    CHECK(glm::length(HLSLExpression(expression, {{"t", t}}, {}).evaluate() - expected) <= 1e-6f);
+  }
+}
+
+// A quintic Bezier curve against de Casteljau, also at compile time.
+void checkBezierDegree()
+{
+  const std::array<f32v3, 6> points = {f32v3(0.0f, 0.0f, -0.5f), f32v3(0.6f, 0.1f, -0.6f), f32v3(1.0f, 0.0f, -0.2f),
+                                       f32v3(0.9f, -0.1f, 0.3f), f32v3(0.4f, 0.0f, 0.5f), f32v3(0.0f, 0.0f, 0.6f)};
+  const ProfileCurve<Bezier, 5> curve(points);
+  static_assert(ProfileCurve<Bezier, 5>::POWER_BASIS[5][0] == -1.0f &&
+                ProfileCurve<Bezier, 5>::POWER_BASIS[2][1] == -20.0f);
+  const std::string expression = extract(curve.toHLSL("f"), "return ", ";\n}\n");
+  for (ui32 i = 0; i <= 100; i++)
+  {
+    const f32   t        = static_cast<f32>(i) / 100.0f;
+    const f64v3 expected = evaluateBezierReference(std::vector<f64v3>(points.begin(), points.end()), t);
+    CHECK(glm::length(f64v3(curve.evaluate(t)) - expected) <= 1e-5);
+    CHECK(glm::length(f64v3(HLSLExpression(expression, {{"t", t}}, {}).evaluate()) - expected) <= 1e-5);
+  }
+}
+
+// The B-spline against its basis functions, and its HLSL function reads the same segments from its table.
+void checkUniformBSpline()
+{
+  constexpr ProfileCurve<UniformBSpline, 5> curve({f32v3(0.0f, 0.0f, -0.5f), f32v3(0.0f, 0.0f, -0.5f),
+                                                   f32v3(0.0f, 0.0f, -0.5f), f32v3(0.9f, 0.0f, -0.3f),
+                                                   f32v3(1.0f, 0.0f, 0.2f), f32v3(0.0f, 0.0f, 0.5f),
+                                                   f32v3(0.0f, 0.0f, 0.5f), f32v3(0.0f, 0.0f, 0.5f)});
+  static_assert(curve.getCoefficients().size() == 20);
+  const std::vector<f64v3> points(curve.getControlPoints().begin(), curve.getControlPoints().end());
+
+  // The repeated end points close the curve on the axis.
+  CHECK(glm::length(curve.evaluate(0.0f) - f32v3(0.0f, 0.0f, -0.5f)) <= 1e-6f);
+  CHECK(glm::length(curve.evaluate(1.0f) - f32v3(0.0f, 0.0f, 0.5f)) <= 1e-6f);
+
+  const std::string  hlsl = curve.toHLSL("evaluateProfileCurve");
+  std::vector<f32v3> table;
+  const std::string  tableText = extract(hlsl, "coefficients[20] =\n    {\n", "    };\n");
+  for (size_t begin = 0; begin < tableText.size();)
+  {
+    const size_t end = std::min(tableText.find("\n", begin), tableText.size());
+    std::string  row = tableText.substr(begin, end - begin);
+    if (row.ends_with(","))
+    {
+      row.pop_back();
+    }
+    table.push_back(HLSLExpression(row, {}, {}).evaluate());
+    begin = end + 1;
+  }
+  CHECK(table.size() == 20);
+  for (size_t k = 0; k < table.size() && k < 20; k++)
+  {
+    CHECK(table[k] == curve.getCoefficients()[k]);
+  }
+  CHECK(hlsl.find("const float u = saturate(t) * 5;\n") != std::string::npos);
+  CHECK(hlsl.find("const uint segment = min((uint)u, 4);\n") != std::string::npos);
+
+  const std::string expression = extract(hlsl, "return ", ";\n}\n");
+  for (ui32 i = 0; i <= 100; i++)
+  {
+    const f32   t        = static_cast<f32>(i) / 100.0f;
+    const f64v3 expected = evaluateBSplineReference(points, 5, t);
+    CHECK(glm::length(f64v3(curve.evaluate(t)) - expected) <= 1e-6);
+
+    const f32                        u         = t * 5.0f;
+    const ui32                       segment   = std::min(static_cast<ui32>(u), 4u);
+    const std::map<std::string, f32> variables = {{"l", u - static_cast<f32>(segment)}, {"i", 4.0f * segment}};
+    CHECK(glm::length(f64v3(HLSLExpression(expression, variables, table).evaluate()) - expected) <= 1e-6);
+  }
+}
+} // namespace
+
+int main()
+{
+  for (ui32 type = 0; type < static_cast<ui32>(FruitType::Count); type++)
+  {
+    checkCubicBezier(getFruitPreset(static_cast<FruitType>(type)).profile);
+  }
+  checkBezierDegree();
+  checkUniformBSpline();
+  return finishChecks();
+}
@@ -0,0 +1,249 @@
+#include "Check.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <gimslib/io/Sha256.hpp>
+#include <gimslib/io/ShaderCache.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace gims;
+
+namespace
+{
+const std::filesystem::path DIRECTORY = "ShaderCacheTest";
+
+std::string hash(const std::string& message)
+{
+  Sha256 sha256;
+  sha256.update(message.data(), message.size());
+  return Sha256::toString(sha256.getDigest());
+}
+
+ShaderCacheKey getKey(const std::string& string)
+{
+  ShaderCacheKeyBuilder builder;
+  builder.add(string);
+  return builder.getKey();
+}
+
+std::vector<ui8> createBlob(size_t size, ui8 seed)
+{
+  std::vector<ui8> result(size);
+  for (size_t i = 0; i < size; i++)
+  {
+    result[i] = static_cast<ui8>(seed + 31 * i);
+  }
+  return result;
+}
+
+void writeFile(const std::filesystem::path& file, const std::string& content)
+{
+  std::ofstream(file, std::ios::binary) << content;
+}
+
+std::filesystem::path getEntryPath(const ShaderCache& cache, const ShaderCacheKey& key)
+{
+  return cache.getDirectory() / (key.toString() + ".shader");
+}
+
+// The test vectors of FIPS 180-4, also in chunks that straddle the blocks, and the truncated key.
+void checkSha256()
+{
+  CHECK(hash("") == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  CHECK(hash("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  const std::string twoBlocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+  CHECK(hash(twoBlocks) == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+  CHECK(hash(std::string(1000000, 'a')) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+  Sha256 chunked;
+  for (size_t i = 0, size = 1; i < twoBlocks.size(); i += size, size = size * 2 + 1)
+  {
+    chunked.update(twoBlocks.data() + i, std::min(size, twoBlocks.size() - i));
+    // Taking a digest in between does not change the message.
+    chunked.getDigest();
+  }
+  CHECK(Sha256::toString(chunked.getDigest()) == hash(twoBlocks));
+
+  ShaderCacheKeyBuilder builder;
+  builder.add("abc", 3);
+  CHECK(builder.getKey().toString() == "ba7816bf8f01cfea414140de5dae2223");
+}
+
+// Every part of the key matters, strings cannot be split differently, and the sources include their included files.
+void checkKeys()
+{
+  CHECK(getKey("ps_6_5") == getKey("ps_6_5"));
+  CHECK(getKey("ps_6_5") != getKey("ps_6_6"));
+  CHECK(getKey("") != ShaderCacheKeyBuilder().getKey());
+  ShaderCacheKeyBuilder wide;
+  wide.add(std::wstring(L"-DFOO"));
+  CHECK(wide.getKey() != getKey("-DFOO"));
+
+  ShaderCacheKeyBuilder split;
+  split.add(std::string("ab"));
+  split.add(std::string("c"));
+  ShaderCacheKeyBuilder otherSplit;
+  otherSplit.add(std::string("a"));
+  otherSplit.add(std::string("bc"));
+  CHECK(split.getKey() != otherSplit.getKey());
+
+  std::filesystem::create_directories(DIRECTORY / "include");
+  const auto shaderFile = DIRECTORY / "Shader.hlsl";
+  writeFile(shaderFile, "#include \"Common.hlsli\"\n  #  include <Missing.hlsli>\nfloat4 main() : SV_Target;\n");
+  writeFile(DIRECTORY / "include" / "Common.hlsli", "#include \"Common.hlsli\"\nstatic const float A = 1;\n");
+  const auto getSourceKey = [&]()
+  {
+    ShaderCacheKeyBuilder builder;
+    builder.addSourceFiles(shaderFile, {DIRECTORY / "include"});
+    return builder.getKey();
+  };
+  const ShaderCacheKey original = getSourceKey();
+  CHECK(getSourceKey() == original);
+  writeFile(DIRECTORY / "include" / "Common.hlsli", "#include \"Common.hlsli\"\nstatic const float A = 2;\n");
+  const ShaderCacheKey changedInclude = getSourceKey();
+  CHECK(changedInclude != original);
+  writeFile(DIRECTORY / "Missing.hlsli", "");
+  CHECK(getSourceKey() != changedInclude);
+  CHECK_THROWS(ShaderCacheKeyBuilder().addSourceFiles(DIRECTORY / "None.hlsl", {}), std::runtime_error);
+}
+
+// Entries round trip; truncated, corrupted or misnamed entries are misses and removed.
+void checkEntries()
+{
+  ShaderCache            cache(DIRECTORY / "entries", 1 << 20);
+  const ShaderCacheKey   key  = getKey("entry");
+  const std::vector<ui8> blob = createBlob(1000, 1);
+  CHECK(!cache.load(key));
+  CHECK(cache.store(key, blob.data(), blob.size()));
+  CHECK(cache.load(key) == blob);
+  CHECK(cache.getNumHits() == 1 && cache.getNumMisses() == 1);
+  CHECK(cache.getSizeInBytes() > blob.size());
+
+  const auto path = getEntryPath(cache, key);
+  const auto size = std::filesystem::file_size(path);
+  {
+    std::fstream stream(path, std::ios::binary | std::ios::in | std::ios::out);
+    stream.seekp(static_cast<std::streamoff>(size - 10));
+    stream.put('x');
+  }
+  CHECK(!cache.load(key));
+  CHECK(!std::filesystem::exists(path));
+
+  CHECK(cache.store(key, blob.data(), blob.size()));
+  std::filesystem::resize_file(path, size - 1);
+  CHECK(!cache.load(key));
+  CHECK(!std::filesystem::exists(path));
+
+  // The entry of another key under this key's name.
+  const ShaderCacheKey other = getKey("other");
+  CHECK(cache.store(other, blob.data(), blob.size()));
+  std::filesystem::copy_file(getEntryPath(cache, other), path);
+  CHECK(!cache.load(key));
+  CHECK(cache.load(other) == blob);
+
+  // Blobs over the budget are not stored.
+  ShaderCache small(DIRECTORY / "small", 100);
+  CHECK(!small.store(key, blob.data(), blob.size()));
+  CHECK(small.getSizeInBytes() == 0);
+
+  cache.clear();
+  CHECK(cache.getSizeInBytes() == 0);
+}
+
+// Stores evict the least recently used entries, where loads count as uses.
+void checkEviction()
+{
+  const std::vector<ui8> blob = createBlob(1000, 2);
+  ShaderCache            cache(DIRECTORY / "eviction", 3500);
+  const ShaderCacheKey   keys[4] = {getKey("a"), getKey("b"), getKey("c"), getKey("d")};
+  const auto             now     = std::filesystem::file_time_type::clock::now();
+  for (ui32 i = 0; i < 3; i++)
+  {
+    CHECK(cache.store(keys[i], blob.data(), blob.size()));
+    std::filesystem::last_write_time(getEntryPath(cache, keys[i]), now - std::chrono::hours(3 - i));
+  }
+  CHECK(cache.load(keys[0]) == blob);
+  CHECK(cache.store(keys[3], blob.data(), blob.size()));
+  CHECK(std::filesystem::exists(getEntryPath(cache, keys[0])));
+  CHECK(!std::filesystem::exists(getEntryPath(cache, keys[1])));
+  CHECK(std::filesystem::exists(getEntryPath(cache, keys[2])));
+  CHECK(std::filesystem::exists(getEntryPath(cache, keys[3])));
+  CHECK(cache.getSizeInBytes() <= cache.getByteBudget());
+}
+
+// Threads that store and load the same and different keys only ever load complete entries of their key.
+void checkConcurrency()
+{
+  constexpr ui32 NUM_THREADS = 8;
+  constexpr ui32 NUM_KEYS    = 16;
+  ShaderCache    cache(DIRECTORY / "concurrency", 1 << 20);
+
+  std::vector<ShaderCacheKey>   keys;
+  std::vector<std::vector<ui8>> blobs;
+  for (ui32 i = 0; i < NUM_KEYS; i++)
+  {
+    keys.push_back(getKey(std::to_string(i)));
+    blobs.push_back(createBlob(1000 + 997 * i, static_cast<ui8>(i)));
+  }
+  std::vector<ui32>        numLoads(NUM_THREADS, 0);
+  std::vector<ui32>        numMismatches(NUM_THREADS, 0);
+  std::vector<std::thread> threads;
+  for (ui32 t = 0; t < NUM_THREADS; t++)
+  {
+    threads.emplace_back(
+        [&, t]()
+        {
+          for (ui32 i = 0; i < 200; i++)
+          {
+            const ui32 k = (t * 7 + i) % NUM_KEYS;
+            if ((i + t) % 3 == 0)
+            {
+              cache.store(keys[k], blobs[k].data(), blobs[k].size());
+              continue;
+            }
+            numLoads[t]++;
+            if (const auto blob = cache.load(keys[k]))
+            {
+              numMismatches[t] += *blob == blobs[k] ? 0 : 1;
+            }
+          }
+        });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  ui64 totalLoads = 0;
+  for (ui32 t = 0; t < NUM_THREADS; t++)
+  {
+    CHECK(numMismatches[t] == 0);
+    totalLoads += numLoads[t];
+  }
+  CHECK(cache.getNumHits() + cache.getNumMisses() == totalLoads);
+  CHECK(cache.getNumHits() > 0);
+  for (ui32 i = 0; i < NUM_KEYS; i++)
+  {
+    const auto blob = cache.load(keys[i]);
+    CHECK(!blob || *blob == blobs[i]);
+  }
+  // No temporary files are left behind.
+  for (const auto& entry : std::filesystem::directory_iterator(cache.getDirectory()))
+  {
+    CHECK(entry.path().extension() == ".shader");
+  }
+}
+} // namespace
+
+int main()
+{
+  std::filesystem::remove_all(DIRECTORY);
+  checkSha256();
+  checkKeys();
+  checkEntries();
+  checkEviction();
+  checkConcurrency();
+  std::filesystem::remove_all(DIRECTORY);
+  return finishChecks();
+}
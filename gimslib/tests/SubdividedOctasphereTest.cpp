@@ -0,0 +1,136 @@
+#include "Check.hpp"
+#include <algorithm>
+#include <cmath>
+#include <gimslib/mesh/SubdividedOctasphere.hpp>
+#include <stdexcept>
+#include <vector>
+
+using namespace gims;
+
+namespace
+{
+// The mesh is closed and manifold: every directed edge occurs once and its opposite also once, and the triangles
+// around every vertex form a single fan. With V - E + T = 2, the surface is a sphere.
+void checkTopology(const SubdividedOctasphere& octasphere)
+{
+  const size_t numVertices = octasphere.positions.size();
+
+  // The directed edges (from, to), sorted.
+  std::vector<ui64> edges;
+  edges.reserve(3 * octasphere.indices.size());
+  for (const ui32v3& triangle : octasphere.indices)
+  {
+    for (ui32 i = 0; i < 3; i++)
+    {
+      const ui32 from = triangle[i];
+      const ui32 to   = triangle[(i + 1) % 3];
+      CHECK(from < numVertices && from != to);
+      edges.push_back(static_cast<ui64>(from) << 32 | to);
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  CHECK(std::adjacent_find(edges.begin(), edges.end()) == edges.end());
+  size_t numOpen = 0;
+  for (const ui64 edge : edges)
+  {
+    const ui64 opposite = (edge & 0xffffffffull) << 32 | edge >> 32;
+    numOpen += std::binary_search(edges.begin(), edges.end(), opposite) ? 0 : 1;
+  }
+  CHECK(numOpen == 0);
+
+  const size_t numEdges = edges.size() / 2;
+  CHECK(static_cast<i64>(numVertices) - static_cast<i64>(numEdges) + static_cast<i64>(octasphere.indices.size()) == 2);
+
+  // Each vertex has as many outgoing edges as triangles, and walking from one outgoing edge to the next around the
+  // vertex visits all of them before returning.
+  std::vector<size_t> firstEdge(numVertices + 1, 0);
+  for (const ui64 edge : edges)
+  {
+    firstEdge[(edge >> 32) + 1]++;
+  }
+  for (size_t v = 0; v < numVertices; v++)
+  {
+    firstEdge[v + 1] += firstEdge[v];
+  }
+  const auto findEdge = [&](ui32 from, ui32 to)
+  {
+    return std::lower_bound(edges.begin() + firstEdge[from], edges.begin() + firstEdge[from + 1],
+                            static_cast<ui64>(from) << 32 | to) -
+           edges.begin();
+  };
+  // In triangle (a, b, c), the edge a -> b is followed by a -> c around a.
+  std::vector<ui32> next(edges.size());
+  for (const ui32v3& triangle : octasphere.indices)
+  {
+    for (ui32 i = 0; i < 3; i++)
+    {
+      next[findEdge(triangle[i], triangle[(i + 1) % 3])] = triangle[(i + 2) % 3];
+    }
+  }
+  size_t numNonManifold = 0;
+  for (size_t v = 0; v < numVertices; v++)
+  {
+    const size_t valence = firstEdge[v + 1] - firstEdge[v];
+    if (valence < 3)
+    {
+      numNonManifold++;
+      continue;
+    }
+    const ui32 start = static_cast<ui32>(edges[firstEdge[v]] & 0xffffffffull);
+    ui32       to    = start;
+    size_t     steps = 0;
+    do
+    {
+      to = next[findEdge(static_cast<ui32>(v), to)];
+      steps++;
+    } while (to != start && steps <= valence);
+    numNonManifold += steps == valence ? 0 : 1;
+  }
+  CHECK(numNonManifold == 0);
+}
+
+// Unit positions, outward facing triangles, and vertices numbered in the order of their first use.
+void checkGeometry(const SubdividedOctasphere& octasphere)
+{
+  f32 maxLengthError = 0.0f;
+  for (const f32v3& position : octasphere.positions)
+  {
+    maxLengthError = std::max(maxLengthError, std::abs(glm::length(position) - 1.0f));
+  }
+  CHECK(maxLengthError <= 1e-6f);
+
+  size_t numInward = 0;
+  ui32   numUsed   = 0;
+  for (const ui32v3& triangle : octasphere.indices)
+  {
+    const f32v3& a = octasphere.positions[triangle.x];
+    const f32v3  n = glm::cross(octasphere.positions[triangle.y] - a, octasphere.positions[triangle.z] - a);
+    numInward += glm::dot(n, a + octasphere.positions[triangle.y] + octasphere.positions[triangle.z]) > 0.0f ? 0 : 1;
+    for (ui32 i = 0; i < 3; i++)
+    {
+      CHECK(triangle[i] <= numUsed);
+      numUsed = std::max(numUsed, triangle[i] + 1);
+    }
+  }
+  CHECK(numInward == 0);
+  CHECK(numUsed == octasphere.positions.size());
+}
+} // namespace
+
+int main()
+{
+  for (ui32 depth = 0; depth <= 7; depth++)
+  {
+    const SubdividedOctasphere octasphere = subdivideOctasphere(depth);
+    CHECK(octasphere.positions.size() == (size_t(1) << 2 * (depth + 1)) + 2);
+    CHECK(octasphere.indices.size() == size_t(8) << 2 * depth);
+    checkTopology(octasphere);
+    checkGeometry(octasphere);
+  }
+  CHECK_THROWS(subdivideOctasphere(SubdividedOctasphere::MAX_DEPTH + 1), std::invalid_argument);
+
+  const CograBinaryMeshFile file = toCograBinaryMeshFile(subdivideOctasphere(2), 2);
+  CHECK(file.getNumVertices() == 66 && file.getNumTriangles() == 128);
+  CHECK(file.getIntegerConstant("subdivisionDepth") == 2);
+  return finishChecks();
+}
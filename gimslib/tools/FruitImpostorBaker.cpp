@@ -0,0 +1,57 @@
+#include <exception>
+#include <filesystem>
+#include <gimslib/fruit/FruitImpostor.hpp>
+#include <gimslib/fruit/FruitPresets.hpp>
+#include <iostream>
+#include <string>
+
+using namespace gims;
+
+namespace
+{
+void printUsage()
+{
+  std::cerr << "Usage: FruitImpostorBaker <outputDirectory> [viewsPerSide=16] [viewResolution=64] [sphere|hemisphere]\n"
+               "Bakes an impostor atlas <name>.frim of each fruit preset into the output directory.\n";
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc < 2 || argc > 5)
+  {
+    printUsage();
+    return 1;
+  }
+  try
+  {
+    const std::filesystem::path outputDirectory = argv[1];
+    const ui32                  viewsPerSide    = argc > 2 ? static_cast<ui32>(std::stoul(argv[2])) : 16;
+    const ui32                  viewResolution  = argc > 3 ? static_cast<ui32>(std::stoul(argv[3])) : 64;
+    const std::string           layoutName      = argc > 4 ? argv[4] : "sphere";
+    if (layoutName != "sphere" && layoutName != "hemisphere")
+    {
+      printUsage();
+      return 1;
+    }
+    const FruitImpostorLayout layout =
+        layoutName == "sphere" ? FruitImpostorLayout::Sphere : FruitImpostorLayout::Hemisphere;
+
+    std::filesystem::create_directories(outputDirectory);
+    for (ui32 type = 0; type < static_cast<ui32>(FruitType::Count); type++)
+    {
+      const FruitPreset&          preset   = getFruitPreset(static_cast<FruitType>(type));
+      const FruitImpostorAtlas    atlas    = bakeFruitImpostor(preset.profile, preset.color, layout, viewsPerSide,
+                                                               viewResolution);
+      const std::filesystem::path fileName = outputDirectory / (std::string(preset.name) + ".frim");
+      atlas.save(fileName);
+      std::cout << fileName.string() << ": " << atlas.getSize() << " x " << atlas.getSize() << " texels\n";
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
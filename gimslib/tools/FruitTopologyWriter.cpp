@@ -0,0 +1,26 @@
+#include <exception>
+#include <gimslib/fruit/FruitTopology.hpp>
+#include <iostream>
+
+using namespace gims;
+
+int main(int argc, char** argv)
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: FruitTopologyWriter <FruitTopology.hlsli>\n"
+                 "Writes the topology tables of FRUIT_TOPOLOGY as HLSL, e.g., to "
+                 "Assignments/AXFruitsGenerator/shaders/FruitTopology.hlsli.\n";
+    return 1;
+  }
+  try
+  {
+    writeFruitTopologyHLSL(argv[1]);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,47 @@
+#include <exception>
+#include <format>
+#include <gimslib/mesh/SphereTessellationBenchmark.hpp>
+#include <gimslib/sys/ThreadPool.hpp>
+#include <iostream>
+#include <string>
+
+using namespace gims;
+
+int main(int argc, char** argv)
+{
+  if (argc > 2)
+  {
+    std::cerr << "Usage: SphereTessellationBenchmark [maxDepth]\n"
+                 "Benchmarks the UV sphere, the octasphere and the subdivided octasphere with the triangle budgets of "
+                 "the subdivision depths 2, 4, ..., maxDepth (default 8).\n";
+    return 1;
+  }
+  try
+  {
+    const ui32 maxDepth = argc == 2 ? static_cast<ui32>(std::stoul(argv[1])) : 8;
+    std::cout << std::format("{} threads\n", ThreadPool::getDefault().getNumThreads());
+    std::cout << std::format("{:<22} {:>10} {:>10} {:>9} {:>9} {:>7} {:>7} {:>7} {:>6} {:>6} {:>10}\n", "Tessellation",
+                             "Resolution", "Triangles", "Max error", "RMS error", "Area", "Shape", "Mean", "V/T",
+                             "MS V/T", "M tris/s");
+    for (ui32 depth = 2; depth <= maxDepth; depth += 2)
+    {
+      for (ui32 tessellation = 0; tessellation < static_cast<ui32>(SphereTessellation::Count); tessellation++)
+      {
+        const SphereTessellationBenchmark benchmark =
+            benchmarkSphereTessellation(static_cast<SphereTessellation>(tessellation), size_t(8) << (2 * depth));
+        std::cout << std::format(
+            "{:<22} {:>10} {:>10} {:>9.2e} {:>9.2e} {:>7.2f} {:>7.2f} {:>7.2f} {:>6.2f} {:>6.2f} {:>10.1f}\n",
+            getSphereTessellationName(benchmark.tessellation), benchmark.resolution, benchmark.numTriangles,
+            benchmark.maxDeviation, benchmark.rmsDeviation, benchmark.minMaxAreaRatio, benchmark.minShapeQuality,
+            benchmark.meanShapeQuality, benchmark.verticesPerTriangle, benchmark.meshletVerticesPerTriangle,
+            benchmark.trianglesPerSecond * 1e-6);
+      }
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}